@@ -26,6 +26,7 @@
 */
 
 #include <my_global.h>
+#include <my_sys.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -115,6 +116,25 @@ buf_calc_page_new_checksum(
     return(checksum);
 }
 
+ulint
+buf_calc_page_crc32(
+/*================*/
+               /* out: checksum */
+    uchar*    page) /* in: buffer page */
+{
+    ulint checksum;
+
+    /* Written by innodb_checksum_algorithm=crc32 to both checksum
+    fields; covers the same bytes as buf_calc_page_new_checksum() */
+    checksum= my_crc32c(0, page + FIL_PAGE_OFFSET,
+                        FIL_PAGE_FILE_FLUSH_LSN - FIL_PAGE_OFFSET);
+    checksum= my_crc32c(checksum, page + FIL_PAGE_DATA,
+                        UNIV_PAGE_SIZE - FIL_PAGE_DATA
+                        - FIL_PAGE_END_LSN_OLD_CHKSUM);
+
+    return(checksum);
+}
+
 ulint
 buf_calc_page_old_checksum(
 /*=======================*/
@@ -278,26 +298,37 @@ int main(int argc, char **argv)
       return 1;
     }
 
-    /* check old method of checksumming */
-    oldcsum= buf_calc_page_old_checksum(p);
     oldcsumfield= mach_read_from_4(p + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN_OLD_CHKSUM);
-    if (debug)
-      printf("page %lu: old style: calculated = %lu; recorded = %lu\n", ct, oldcsum, oldcsumfield);
-    if (oldcsumfield != mach_read_from_4(p + FIL_PAGE_LSN) && oldcsumfield != oldcsum)
+    csumfield= mach_read_from_4(p + FIL_PAGE_SPACE_OR_CHKSUM);
+
+    /* check crc32 checksumming, which stores the same value to both fields */
+    if (csumfield == oldcsumfield)
     {
-      fprintf(stderr, "page %lu invalid (fails old style checksum)\n", ct);
-      return 1;
+      csum= buf_calc_page_crc32(p);
+      if (debug)
+        printf("page %lu: crc32: calculated = %lu; recorded = %lu\n", ct, csum, csumfield);
     }
-
-    /* now check the new method */
-    csum= buf_calc_page_new_checksum(p);
-    csumfield= mach_read_from_4(p + FIL_PAGE_SPACE_OR_CHKSUM);
-    if (debug)
-      printf("page %lu: new style: calculated = %lu; recorded = %lu\n", ct, csum, csumfield);
-    if (csumfield != 0 && csum != csumfield)
+    if (csumfield != oldcsumfield || csum != csumfield)
     {
-      fprintf(stderr, "page %lu invalid (fails new style checksum)\n", ct);
-      return 1;
+      /* check old method of checksumming */
+      oldcsum= buf_calc_page_old_checksum(p);
+      if (debug)
+        printf("page %lu: old style: calculated = %lu; recorded = %lu\n", ct, oldcsum, oldcsumfield);
+      if (oldcsumfield != mach_read_from_4(p + FIL_PAGE_LSN) && oldcsumfield != oldcsum)
+      {
+        fprintf(stderr, "page %lu invalid (fails old style checksum)\n", ct);
+        return 1;
+      }
+
+      /* now check the new method */
+      csum= buf_calc_page_new_checksum(p);
+      if (debug)
+        printf("page %lu: new style: calculated = %lu; recorded = %lu\n", ct, csum, csumfield);
+      if (csumfield != 0 && csum != csumfield)
+      {
+        fprintf(stderr, "page %lu invalid (fails new style checksum)\n", ct);
+        return 1;
+      }
     }
 
     /* end if this was the last page we were supposed to check */
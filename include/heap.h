@@ -109,6 +109,26 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+/*
+  Rows with VARCHAR or BLOB columns may be stored in variable-length
+  format: the record up to HP_SHARE::fixed_length is kept as is in the
+  row, and the remaining columns are packed into a chain of fixed-size
+  chunks, which are allocated from HP_SHARE::chunk_block.
+  HP_COLUMNDEF describes how one of the packed columns is stored.
+*/
+
+#define HP_COLUMN_FIXED		0	/* Stored with its full length */
+#define HP_COLUMN_VARCHAR	1	/* Stored with its actual length */
+#define HP_COLUMN_BLOB		2	/* Length and data of the blob */
+
+typedef struct st_hp_columndef
+{
+  uint offset;				/* Offset of the column in record */
+  uint length;				/* Length of the column in record */
+  uint8 type;				/* HP_COLUMN_FIXED... */
+  uint8 length_bytes;			/* Size of VARCHAR/BLOB length */
+} HP_COLUMNDEF;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -143,11 +163,20 @@ typedef struct st_heap_share
   uint blength;				/* records rounded up to 2^n */
   uint deleted;				/* Deleted records in database */
   uint reclength;			/* Length of one record */
+  uint fixed_length;			/* Bytes of record stored in row */
+  uint visible;				/* Offset of the not-deleted flag */
   uint changed;
   uint keys,max_key_length;
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
+  HP_COLUMNDEF *columndef;		/* Columns stored in chunks */
+  uint columns;				/* 0 if rows have fixed length */
+  uint chunk_length;			/* Bytes of data in one chunk */
+  HP_BLOCK chunk_block;			/* Where the chunks are saved */
+  uchar *chunk_del_link;		/* Link to next free chunk */
+  ulong chunks;				/* Chunks in use */
+  ulong deleted_chunks;			/* Chunks in chunk_del_link */
   char * name;			/* Name of "memory-file" */
   time_t create_time;
   THR_LOCK lock;
@@ -172,6 +201,8 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar *blob_buffer;                   /* Data of blobs in last row read */
+  size_t blob_buffer_length;
   enum ha_rkey_function last_find_flag;
   TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
   TREE_ELEMENT **last_pos;
@@ -193,6 +224,16 @@ typedef struct st_heap_create_info
   uint auto_key_type;
   uint keys;
   uint reclength;
+  /*
+    If columns is not 0, rows are stored in variable-length format:
+    the first fixed_length bytes of the record are stored in the row,
+    and the columns in columndef, which cover the rest of the record,
+    are packed into chunks of chunk_length bytes.
+  */
+  HP_COLUMNDEF *columndef;
+  uint columns;
+  uint fixed_length;
+  uint chunk_length;
   ulonglong max_table_size;
   ulonglong auto_increment;
   my_bool with_auto_increment;
@@ -60,7 +60,8 @@ typedef struct st_key_cache_statistics
 typedef enum key_cache_type
 {
   SIMPLE_KEY_CACHE,         
-  PARTITIONED_KEY_CACHE
+  PARTITIONED_KEY_CACHE,
+  CLOCK_KEY_CACHE
 } KEY_CACHE_TYPE;
 
 
@@ -113,11 +114,11 @@ typedef
 /*
   An object of the type KEY_CACHE_FUNCS contains pointers to all functions
   from the key cache interface.
-  Currently a key cache can be of two types: simple and partitioned.
-  For each of them its own static structure of the type KEY_CACHE_FUNCS is
-  defined . The structures contain the pointers to the implementations of
-  the interface functions used by simple key caches and partitioned key
-  caches respectively. Pointers to these structures are assigned to key cache
+  Currently a key cache can be of three types: simple, partitioned and
+  with CLOCK replacement. For each of them its own static structure of the
+  type KEY_CACHE_FUNCS is defined . The structures contain the pointers to
+  the implementations of the interface functions used by the key caches of
+  the respective type. Pointers to these structures are assigned to key cache
   objects at the time of their creation.
 */   
 
@@ -146,6 +147,7 @@ typedef struct st_key_cache
   ulonglong param_division_limit;/* min. percentage of warm blocks           */
   ulonglong param_age_threshold; /* determines when hot block is downgraded  */
   ulonglong param_partitions;    /* number of the key cache partitions       */
+  ulonglong param_clock_replacement; /* <=> use CLOCK replacement            */
   my_bool key_cache_inited;      /* <=> key cache has been created           */
   my_bool can_be_used;           /* usage of cache for read/write is allowed */
   my_bool in_init;               /* set to 1 in MySQL during init/resize     */
@@ -308,6 +308,13 @@ int my_pthread_mutex_trylock(pthread_mutex_t *mutex);
 #endif
 #endif
 
+/* Give up the processor; glibc deprecates pthread_yield() */
+#ifdef HAVE_SCHED_YIELD
+#define my_yield() sched_yield()
+#else
+#define my_yield() pthread_yield()
+#endif
+
 /*
   The defines set_timespec and set_timespec_nsec should be used
   for calculating an absolute time at which
@@ -756,6 +763,10 @@ struct st_my_thread_var
   uint  lock_type; /* used by conditional release the queue */
   void  *stack_ends_here;
   safe_mutex_t *mutex_in_use;
+  /* Memory root blocks kept for reuse by the thread, see my_alloc.c */
+  struct st_used_mem *alloc_cache;
+  size_t alloc_cache_size;              /* Total size of alloc_cache */
+  ulong alloc_cache_hits;               /* Blocks taken from alloc_cache */
 #ifndef DBUG_OFF
   void *dbug;
   char name[THREAD_NAME_SIZE+1];
@@ -339,6 +339,13 @@ typedef struct st_dynamic_string
   size_t length,max_length,alloc_increment;
 } DYNAMIC_STRING;
 
+/* State of a stream compressed with my_lz_stream_compress() */
+typedef struct st_my_lz_stream
+{
+  size_t history;                       /* Length of the history */
+  uint32 *table;                        /* Match finder; 0 if decompressing */
+} MY_LZ_STREAM;
+
 struct st_io_cache;
 typedef int (*IO_CACHE_CALLBACK)(struct st_io_cache*);
 
@@ -813,6 +820,7 @@ extern void *alloc_root(MEM_ROOT *mem_root, size_t Size);
 extern void *multi_alloc_root(MEM_ROOT *mem_root, ...);
 extern void free_root(MEM_ROOT *root, myf MyFLAGS);
 extern void set_prealloc_root(MEM_ROOT *root, char *ptr);
+extern void free_alloc_cache(struct st_my_thread_var *thread_var);
 extern void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
                                 size_t prealloc_size);
 extern char *strdup_root(MEM_ROOT *root,const char *str);
@@ -846,11 +854,26 @@ extern void *my_az_allocator(void *dummy, unsigned int items, unsigned int size)
 extern void my_az_free(void *dummy, void *address);
 extern int my_compress_buffer(uchar *dest, size_t *destLen,
                               const uchar *source, size_t sourceLen);
+extern size_t my_lz_compress(const uchar *src, size_t src_len,
+                             uchar *dst, size_t dst_len);
+extern my_bool my_lz_decompress(const uchar *src, size_t src_len,
+                                uchar *dst, size_t *dst_len);
+extern my_bool my_lz_stream_init(MY_LZ_STREAM *stream);
+extern void my_lz_stream_end(MY_LZ_STREAM *stream);
+extern size_t my_lz_stream_compress(MY_LZ_STREAM *stream, const uchar *buf,
+                                    size_t src_len,
+                                    uchar *dst, size_t dst_len);
+extern my_bool my_lz_stream_decompress(MY_LZ_STREAM *stream,
+                                       const uchar *src, size_t src_len,
+                                       uchar *buf, size_t *dst_len);
+extern void my_lz_stream_shift(MY_LZ_STREAM *stream, size_t shift);
 extern int packfrm(uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
 extern ha_checksum my_checksum(ha_checksum crc, const uchar *mem,
                                size_t count);
+extern uint32 my_crc32c(uint32 crc, const uchar *pos, size_t length);
+extern my_bool my_crc32c_is_hw_accelerated(void);
 #ifndef DBUG_OFF
 extern void my_debug_put_break_here(void);
 #else
@@ -322,6 +322,12 @@ typedef struct st_sort_info
   uchar *buff;
   SORT_KEY_BLOCKS *key_block, *key_block_end;
   SORT_FT_BUF *ft_buf;
+  /*
+    Set when several threads build indexes of the table at the same time:
+    serializes the allocation of index pages and the removal of records
+    with duplicate keys
+  */
+  mysql_mutex_t *write_lock;
   my_off_t filelength, dupp, buff_length;
   ha_rows max_records;
   uint current_key, total_keys;
@@ -420,6 +426,7 @@ int write_data_suffix(MI_SORT_INFO *sort_info, my_bool fix_datafile);
 int flush_pending_blocks(MI_SORT_PARAM *param);
 int sort_ft_buf_flush(MI_SORT_PARAM *sort_param);
 int thr_write_keys(MI_SORT_PARAM *sort_param);
+uint mi_write_keys_threads(HA_CHECK *param, uint keys);
 int sort_write_record(MI_SORT_PARAM *sort_param);
 int _create_index_by_sort(MI_SORT_PARAM *info,my_bool no_messages, ulonglong);
 
@@ -454,6 +454,9 @@ int             STDCALL mysql_send_query_start(int *ret, MYSQL *mysql,
                                                unsigned long length);
 int             STDCALL mysql_send_query_cont(int *ret, MYSQL *mysql,
                                               int status);
+int             STDCALL mysql_send_queries(MYSQL *mysql, const char **queries,
+                                           const unsigned long *lengths,
+                                           unsigned int count);
 int		STDCALL mysql_real_query(MYSQL *mysql, const char *q,
 					unsigned long length);
 int             STDCALL mysql_real_query_start(int *ret, MYSQL *mysql,
@@ -763,7 +766,13 @@ enum enum_stmt_attr_type
     Amount of rows to retrieve from server per one fetch if using cursors.
     Accepts unsigned long attribute in the range 1 - ulong_max
   */
-  STMT_ATTR_PREFETCH_ROWS
+  STMT_ATTR_PREFETCH_ROWS,
+  /*
+    Number of parameter rows sent by one mysql_stmt_execute(); the bound
+    parameter buffers, lengths and NULL indicators are arrays of this
+    size. Accepts unsigned long attribute in the range 1 - ulong_max
+  */
+  STMT_ATTR_ARRAY_SIZE
 };
 
 MYSQL_STMT * STDCALL mysql_stmt_init(MYSQL *mysql);
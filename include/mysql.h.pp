@@ -453,6 +453,9 @@ int mysql_send_query_start(int *ret, MYSQL *mysql,
                                                unsigned long length);
 int mysql_send_query_cont(int *ret, MYSQL *mysql,
                                               int status);
+int mysql_send_queries(MYSQL *mysql, const char **queries,
+                                           const unsigned long *lengths,
+                                           unsigned int count);
 int mysql_real_query(MYSQL *mysql, const char *q,
      unsigned long length);
 int mysql_real_query_start(int *ret, MYSQL *mysql,
@@ -644,7 +647,8 @@ enum enum_stmt_attr_type
 {
   STMT_ATTR_UPDATE_MAX_LENGTH,
   STMT_ATTR_CURSOR_TYPE,
-  STMT_ATTR_PREFETCH_ROWS
+  STMT_ATTR_PREFETCH_ROWS,
+  STMT_ATTR_ARRAY_SIZE
 };
 MYSQL_STMT * mysql_stmt_init(MYSQL *mysql);
 int mysql_stmt_prepare(MYSQL_STMT *stmt, const char *query,
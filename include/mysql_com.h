@@ -218,6 +218,19 @@ enum enum_server_command
 */
 #define CLIENT_REMEMBER_OPTIONS (1UL << 31)
 
+/*
+  MariaDB extended capabilities. The 32 bits above are shared with MySQL,
+  so these are sent in the last 4 bytes of the filler of the handshake
+  packets, which older servers and clients leave zero. Newer MariaDB
+  servers assign their extended capabilities from bit 32 up, so these
+  are taken from the top.
+*/
+#define MARIADB_CLIENT_LZ_COMPRESS (1ULL << 63) /* Compression protocol uses LZ */
+#define MARIADB_CLIENT_STMT_BULK (1ULL << 62) /* Many parameter rows per execute */
+
+#define MARIADB_CLIENT_EXTENDED_FLAGS (MARIADB_CLIENT_LZ_COMPRESS | \
+                                       MARIADB_CLIENT_STMT_BULK)
+
 #ifdef HAVE_COMPRESS
 #define CAN_CLIENT_COMPRESS CLIENT_COMPRESS
 #else
@@ -352,7 +365,7 @@ typedef struct st_net {
   char save_char;
   char net_skip_rest_factor;
   my_bool unused1; /* Please remove with the next incompatible ABI change */
-  my_bool compress;
+  my_bool compress;                     /* 0 or NET_COMPRESS_ZLIB/LZ */
   my_bool unused3; /* Please remove with the next incompatible ABI change. */
   /*
     Pointer to query object in query cache, do not equal NULL (0) for
@@ -377,6 +390,10 @@ typedef struct st_net {
 
 #define packet_error (~(unsigned long) 0)
 
+/* Compression protocol in NET::compress */
+#define NET_COMPRESS_ZLIB 1
+#define NET_COMPRESS_LZ   2
+
 enum enum_field_types { MYSQL_TYPE_DECIMAL, MYSQL_TYPE_TINY,
 			MYSQL_TYPE_SHORT,  MYSQL_TYPE_LONG,
 			MYSQL_TYPE_FLOAT,  MYSQL_TYPE_DOUBLE,
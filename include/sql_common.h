@@ -39,8 +39,27 @@ struct st_mysql_options_extention {
                           const char *proc_info,
                           uint proc_info_length);
   struct mysql_async_context *async_context;
+  /*
+    Queries of mysql_send_queries(): the packet number that the result
+    of each one starts with, their lengths, how many are sent and how
+    many results are read, the queries that are not sent yet and the
+    bytes sent whose results are not read
+  */
+  unsigned char *pipeline_pkt_nr;
+  unsigned long *pipeline_lengths;
+  unsigned int pipeline_count, pipeline_sent, pipeline_read;
+  char *pipeline_queries, *pipeline_next;
+  unsigned long pipeline_in_flight;
+  /* MARIADB_CLIENT_* capabilities of the server and of the connection */
+  unsigned long long server_ext_capabilities, ext_client_flag;
 };
 
+#define mysql_server_ext_capabilities(M)                         \
+  ((M)->options.extension ?                                      \
+   (M)->options.extension->server_ext_capabilities : 0)
+#define mysql_ext_client_flag(M)                                 \
+  ((M)->options.extension ? (M)->options.extension->ext_client_flag : 0)
+
 typedef struct st_mysql_methods
 {
   my_bool (*read_query_result)(MYSQL *mysql);
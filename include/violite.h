@@ -22,6 +22,9 @@
 #define	vio_violite_h_
 
 #include "my_net.h"			/* needed because of struct in_addr */
+#ifndef _WIN32
+#include <sys/uio.h>			/* struct iovec */
+#endif
 
 
 /* Simple vio interface in C;  The functions are implemented in violite.c */
@@ -34,6 +37,15 @@ extern "C" {
 typedef struct st_vio Vio;
 #endif /* __cplusplus */
 
+#ifdef _WIN32
+/* Buffer description for vio_writev(), as in POSIX */
+struct iovec
+{
+  void *iov_base;
+  size_t iov_len;
+};
+#endif
+
 enum enum_vio_type
 {
   VIO_CLOSED, VIO_TYPE_TCPIP, VIO_TYPE_SOCKET, VIO_TYPE_NAMEDPIPE,
@@ -66,9 +78,11 @@ void	vio_delete(Vio* vio);
 int	vio_close(Vio* vio);
 void    vio_reset(Vio* vio, enum enum_vio_type type,
                   my_socket sd, HANDLE hPipe, uint flags);
+void	vio_set_buffered_read(Vio *vio);
 size_t	vio_read(Vio *vio, uchar *	buf, size_t size);
 size_t  vio_read_buff(Vio *vio, uchar * buf, size_t size);
 size_t	vio_write(Vio *vio, const uchar * buf, size_t size);
+size_t	vio_writev(Vio *vio, const struct iovec *iov, int iovcnt);
 int	vio_blocking(Vio *vio, my_bool onoff, my_bool *old_mode);
 my_bool	vio_is_blocking(Vio *vio);
 /* setsockopt TCP_NODELAY at IPPROTO_TCP level, when possible */
@@ -99,6 +99,7 @@ static my_bool org_my_init_done= 0;
 typedef struct st_mysql_stmt_extension
 {
   MEM_ROOT fields_mem_root;
+  ulong array_size;                     /* STMT_ATTR_ARRAY_SIZE */
 } MYSQL_STMT_EXT;
 
 
@@ -1533,6 +1534,7 @@ mysql_stmt_init(MYSQL *mysql)
   /* The rest of statement members was bzeroed inside malloc */
 
   init_alloc_root(&stmt->extension->fields_mem_root, 2048, 0);
+  stmt->extension->array_size= 1;
 
   DBUG_RETURN(stmt);
 }
@@ -1878,6 +1880,10 @@ static void store_param_type(unsigned char **pos, MYSQL_BIND *param)
 }
 
 
+static my_bool int_is_null_true= 1;		/* Used for MYSQL_TYPE_NULL */
+static my_bool int_is_null_false= 0;
+
+
 /*
   Functions to store parameter data in network packet.
 
@@ -2019,13 +2025,15 @@ static void store_param_str(NET *net, MYSQL_BIND *param)
   DESCRIPTION
     A data package starts with a string of bits where we set a bit
     if a parameter is NULL. Unlike bit string in result set row, here
-    we don't have reserved bits for OK/error packet.
+    we don't have reserved bits for OK/error packet. With
+    STMT_ATTR_ARRAY_SIZE each row of parameters has its own bit string,
+    which starts null_pos bytes into the packet.
 */
 
-static void store_param_null(NET *net, MYSQL_BIND *param)
+static void store_param_null(NET *net, MYSQL_BIND *param, ulong null_pos)
 {
   uint pos= param->param_number;
-  net->buff[pos/8]|=  (uchar) (1 << (pos & 7));
+  net->buff[null_pos + pos/8]|=  (uchar) (1 << (pos & 7));
 }
 
 
@@ -2035,7 +2043,8 @@ static void store_param_null(NET *net, MYSQL_BIND *param)
   of store_param_xxxx functions.
 */
 
-static my_bool store_param(MYSQL_STMT *stmt, MYSQL_BIND *param)
+static my_bool store_param(MYSQL_STMT *stmt, MYSQL_BIND *param,
+                           ulong null_pos)
 {
   NET *net= &stmt->mysql->net;
   DBUG_ENTER("store_param");
@@ -2045,7 +2054,7 @@ static my_bool store_param(MYSQL_STMT *stmt, MYSQL_BIND *param)
                       *param->length, *param->is_null));
 
   if (*param->is_null)
-    store_param_null(net, param);
+    store_param_null(net, param, null_pos);
   else
   {
     /*
@@ -2080,7 +2089,7 @@ static my_bool execute(MYSQL_STMT *stmt, char *packet, ulong length)
 
   int4store(buff, stmt->stmt_id);		/* Send stmt id to server */
   buff[4]= (char) stmt->flags;
-  int4store(buff+5, 1);                         /* iteration count */
+  int4store(buff+5, stmt->extension->array_size); /* iteration count */
 
   res= test(cli_advanced_command(mysql, COM_STMT_EXECUTE, buff, sizeof(buff),
                                  (uchar*) packet, length, 1, stmt) ||
@@ -2104,18 +2113,120 @@ static my_bool execute(MYSQL_STMT *stmt, char *packet, ulong length)
 }
 
 
+/*
+  Point a copy of a bound parameter at row 'row' of the arrays bound
+  with STMT_ATTR_ARRAY_SIZE.
+
+  DESCRIPTION
+    buffer is an array of values: MYSQL_TIME structures for temporal
+    types, buffer_length bytes per value for other types. length and
+    is_null, if given by the user, are arrays too.
+*/
+
+static void param_array_row(MYSQL_BIND *to, MYSQL_BIND *param, ulong row)
+{
+  ulong size;
+  *to= *param;
+  switch (param->buffer_type) {
+  case MYSQL_TYPE_NULL:
+    return;
+  case MYSQL_TYPE_TIME:
+  case MYSQL_TYPE_DATE:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_TIMESTAMP:
+    size= sizeof(MYSQL_TIME);
+    break;
+  default:
+    size= param->buffer_length;
+    break;
+  }
+  to->buffer= (char*) param->buffer + row * size;
+  if (param->length != &param->buffer_length)
+    to->length= param->length + row;
+  if (param->is_null != &int_is_null_false)
+    to->is_null= param->is_null + row;
+}
+
+
+/*
+  Store one row of parameters in network packet: the NULL bit string,
+  the parameter types if they have to be sent (only in the first row)
+  and the values.
+*/
+
+static my_bool store_param_row(MYSQL_STMT *stmt, ulong row)
+{
+  NET *net= &stmt->mysql->net;
+  MYSQL_BIND *param, *param_end= stmt->params + stmt->param_count;
+  MYSQL_BIND row_param;
+  uint null_count= (stmt->param_count+7) /8;
+  my_bool send_types= stmt->send_types_to_server && !row;
+  ulong null_pos;
+
+  /* Reserve place for null-marker bytes */
+  if (my_realloc_str(net, null_count + 1))
+  {
+    set_stmt_errmsg(stmt, net);
+    return 1;
+  }
+  null_pos= (ulong) (net->write_pos - net->buff);
+  bzero((char*) net->write_pos, null_count);
+  net->write_pos+= null_count;
+
+  /* In case if buffers (type) altered, indicate to server */
+  *(net->write_pos)++= (uchar) send_types;
+  if (send_types)
+  {
+    if (my_realloc_str(net, 2 * stmt->param_count))
+    {
+      set_stmt_errmsg(stmt, net);
+      return 1;
+    }
+    /*
+      Store types of parameters in first in first package
+      that is sent to the server.
+    */
+    for (param= stmt->params; param < param_end ; param++)
+      store_param_type(&net->write_pos, param);
+  }
+
+  for (param= stmt->params; param < param_end; param++)
+  {
+    /* check if mysql_stmt_send_long_data() was used */
+    if (param->long_data_used)
+      param->long_data_used= 0;	/* Clear for next execute call */
+    else if (row)
+    {
+      param_array_row(&row_param, param, row);
+      if (store_param(stmt, &row_param, null_pos))
+        return 1;
+    }
+    else if (store_param(stmt, param, null_pos))
+      return 1;
+  }
+  return 0;
+}
+
+
 int cli_stmt_execute(MYSQL_STMT *stmt)
 {
+  ulong array_size= stmt->extension->array_size;
   DBUG_ENTER("cli_stmt_execute");
 
+  if (array_size > 1 &&
+      !(mysql_ext_client_flag(stmt->mysql) & MARIADB_CLIENT_STMT_BULK))
+  {
+    set_stmt_error(stmt, CR_NOT_IMPLEMENTED, unknown_sqlstate, NULL);
+    DBUG_RETURN(1);
+  }
+
   if (stmt->param_count)
   {
     MYSQL *mysql= stmt->mysql;
     NET        *net= &mysql->net;
     MYSQL_BIND *param, *param_end;
     char       *param_data;
-    ulong length;
-    uint null_count;
+    ulong length, row;
     my_bool    result;
 
     if (!stmt->bind_param_done)
@@ -2129,6 +2240,16 @@ int cli_stmt_execute(MYSQL_STMT *stmt)
       set_stmt_error(stmt, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate, NULL);
       DBUG_RETURN(1);
     }
+    /* Long data can't be given per row: it is sent before execute */
+    param_end= stmt->params + stmt->param_count;
+    for (param= stmt->params; array_size > 1 && param < param_end; param++)
+    {
+      if (param->long_data_used)
+      {
+        set_stmt_error(stmt, CR_NOT_IMPLEMENTED, unknown_sqlstate, NULL);
+        DBUG_RETURN(1);
+      }
+    }
 
     if (net->vio)
       net_clear(net, 1);          /* Sets net->write_pos */
@@ -2138,41 +2259,10 @@ int cli_stmt_execute(MYSQL_STMT *stmt)
       DBUG_RETURN(1);             
     }
 
-    /* Reserve place for null-marker bytes */
-    null_count= (stmt->param_count+7) /8;
-    if (my_realloc_str(net, null_count + 1))
+    for (row= 0; row < array_size; row++)
     {
-      set_stmt_errmsg(stmt, net);
-      DBUG_RETURN(1);
-    }
-    bzero((char*) net->write_pos, null_count);
-    net->write_pos+= null_count;
-    param_end= stmt->params + stmt->param_count;
-
-    /* In case if buffers (type) altered, indicate to server */
-    *(net->write_pos)++= (uchar) stmt->send_types_to_server;
-    if (stmt->send_types_to_server)
-    {
-      if (my_realloc_str(net, 2 * stmt->param_count))
-      {
-        set_stmt_errmsg(stmt, net);
+      if (store_param_row(stmt, row))
         DBUG_RETURN(1);
-      }
-      /*
-	Store types of parameters in first in first package
-	that is sent to the server.
-      */
-      for (param= stmt->params;	param < param_end ; param++)
-        store_param_type(&net->write_pos, param);
-    }
-
-    for (param= stmt->params; param < param_end; param++)
-    {
-      /* check if mysql_stmt_send_long_data() was used */
-      if (param->long_data_used)
-	param->long_data_used= 0;	/* Clear for next execute call */
-      else if (store_param(stmt, param))
-	DBUG_RETURN(1);
     }
     length= (ulong) (net->write_pos - net->buff);
     /* TODO: Look into avoding the following memdup */
@@ -2396,6 +2486,16 @@ my_bool STDCALL mysql_stmt_attr_set(MYSQL_STMT *stmt,
     stmt->prefetch_rows= prefetch_rows;
     break;
   }
+  case STMT_ATTR_ARRAY_SIZE:
+  {
+    ulong array_size= value ? *(ulong*) value : 1UL;
+#ifdef EMBEDDED_LIBRARY
+    if (array_size > 1)
+      goto err_not_implemented;
+#endif
+    stmt->extension->array_size= max(array_size, 1);
+    break;
+  }
   default:
     goto err_not_implemented;
   }
@@ -2420,6 +2520,9 @@ my_bool STDCALL mysql_stmt_attr_get(MYSQL_STMT *stmt,
   case STMT_ATTR_PREFETCH_ROWS:
     *(ulong*) value= stmt->prefetch_rows;
     break;
+  case STMT_ATTR_ARRAY_SIZE:
+    *(ulong*) value= stmt->extension->array_size;
+    break;
   default:
     return TRUE;
   }
@@ -2626,10 +2729,6 @@ my_ulonglong STDCALL mysql_stmt_insert_id(MYSQL_STMT *stmt)
 }
 
 
-static my_bool int_is_null_true= 1;		/* Used for MYSQL_TYPE_NULL */
-static my_bool int_is_null_false= 0;
-
-
 /*
   Set up input data buffers for a statement.
 
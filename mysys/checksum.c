@@ -38,3 +38,180 @@ ha_checksum my_checksum(ha_checksum crc, const uchar *pos, size_t length)
     my_debug_put_break_here();
   return crc;
 }
+
+
+/*
+  CRC-32C (Castagnoli polynomial, as used by iSCSI and SSE4.2).
+
+  On x86-64 CPUs that support SSE4.2 the crc32 instruction is used,
+  otherwise a table driven slicing-by-8 implementation. Both give the
+  same result. The tables and the choice of implementation are set up
+  on the first call; concurrent first calls compute identical values,
+  so no locking is needed.
+*/
+
+#define CRC32C_POLY 0x82F63B78
+
+typedef uint32 (*crc32c_func_t)(uint32 crc, const uchar *pos, size_t length);
+
+static uint32 crc32c_table[8][256];
+
+static uint32 crc32c_init_and_calc(uint32 crc, const uchar *pos,
+                                   size_t length);
+
+static crc32c_func_t crc32c_func= crc32c_init_and_calc;
+
+
+static void crc32c_init_table(void)
+{
+  uint32 n, k, c;
+
+  for (n= 0; n < 256; n++)
+  {
+    c= n;
+    for (k= 0; k < 8; k++)
+      c= (c & 1) ? (c >> 1) ^ CRC32C_POLY : (c >> 1);
+    crc32c_table[0][n]= c;
+  }
+
+  for (n= 0; n < 256; n++)
+  {
+    c= crc32c_table[0][n];
+    for (k= 1; k < 8; k++)
+    {
+      c= crc32c_table[0][c & 0xFF] ^ (c >> 8);
+      crc32c_table[k][n]= c;
+    }
+  }
+}
+
+
+/* Software implementation, processing 8 bytes per step */
+
+static uint32 crc32c_sw(uint32 crc, const uchar *pos, size_t length)
+{
+  const uchar *end= pos + length;
+
+  crc= ~crc;
+
+  while (pos < end && ((size_t) pos & 7))
+    crc= crc32c_table[0][(crc ^ *pos++) & 0xFF] ^ (crc >> 8);
+
+  while (end - pos >= 8)
+  {
+    uint32 high;
+
+    crc^= uint4korr(pos);
+    high= uint4korr(pos + 4);
+    crc= crc32c_table[7][crc & 0xFF] ^
+         crc32c_table[6][(crc >> 8) & 0xFF] ^
+         crc32c_table[5][(crc >> 16) & 0xFF] ^
+         crc32c_table[4][crc >> 24] ^
+         crc32c_table[3][high & 0xFF] ^
+         crc32c_table[2][(high >> 8) & 0xFF] ^
+         crc32c_table[1][(high >> 16) & 0xFF] ^
+         crc32c_table[0][high >> 24];
+    pos+= 8;
+  }
+
+  while (pos < end)
+    crc= crc32c_table[0][(crc ^ *pos++) & 0xFF] ^ (crc >> 8);
+
+  return ~crc;
+}
+
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define HAVE_CRC32C_SSE42
+
+static my_bool crc32c_cpu_has_sse42(void)
+{
+  uint32 eax, ebx, ecx, edx;
+
+  __asm__ __volatile__("cpuid"
+                       : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+                       : "a" (1));
+  return (ecx >> 20) & 1;
+}
+
+
+/* Hardware implementation using the SSE4.2 crc32 instruction */
+
+static uint32 crc32c_sse42(uint32 crc, const uchar *pos, size_t length)
+{
+  const uchar *end= pos + length;
+  uint64 crc64;
+
+  crc= ~crc;
+
+  while (pos < end && ((size_t) pos & 7))
+  {
+    __asm__("crc32b %1, %0" : "+r" (crc) : "rm" (*pos));
+    pos++;
+  }
+
+  crc64= crc;
+  while (end - pos >= 8)
+  {
+    __asm__("crc32q %1, %0" : "+r" (crc64) : "rm" (*(const uint64*) pos));
+    pos+= 8;
+  }
+  crc= (uint32) crc64;
+
+  while (pos < end)
+  {
+    __asm__("crc32b %1, %0" : "+r" (crc) : "rm" (*pos));
+    pos++;
+  }
+
+  return ~crc;
+}
+#endif /* __GNUC__ && __x86_64__ */
+
+
+static uint32 crc32c_init_and_calc(uint32 crc, const uchar *pos,
+                                   size_t length)
+{
+  crc32c_func_t func= crc32c_sw;
+
+#ifdef HAVE_CRC32C_SSE42
+  if (crc32c_cpu_has_sse42())
+    func= crc32c_sse42;
+#endif
+  if (func == crc32c_sw)
+    crc32c_init_table();
+
+  crc32c_func= func;
+  return func(crc, pos, length);
+}
+
+
+/*
+  Calculate a CRC-32C checksum for a memoryblock.
+
+  SYNOPSIS
+    my_crc32c()
+      crc       start value for crc (0, or the result of a previous call
+                when checksumming a block in pieces)
+      pos       pointer to memory block
+      length    length of the block
+*/
+
+uint32 my_crc32c(uint32 crc, const uchar *pos, size_t length)
+{
+  return crc32c_func(crc, pos, length);
+}
+
+
+/*
+  Returns TRUE if my_crc32c() uses the SSE4.2 crc32 instruction.
+*/
+
+my_bool my_crc32c_is_hw_accelerated(void)
+{
+#ifdef HAVE_CRC32C_SSE42
+  return crc32c_cpu_has_sse42();
+#else
+  return FALSE;
+#endif
+}
@@ -34,6 +34,7 @@
 #include "my_static.h"
 #include <m_string.h>
 #include <my_bit.h>
+#include <my_atomic.h>
 #include <errno.h>
 #include <stdarg.h>
 #include "probes_mysql.h"
@@ -5784,18 +5785,1419 @@ static KEY_CACHE_FUNCS partitioned_key_cache_funcs =
 };
 
 
+/****************************************************************************** 
+  CLOCK Key Cache Module
+
+  The module contains implementations of all key cache interface functions
+  employed by key caches with CLOCK replacement.
+
+  A simple key cache acquires its cache_lock for every block request, and
+  every hit relinks the block in the LRU chain. A partitioned key cache only
+  spreads this over several locks: all lookups in an index still start from
+  the same root page, and so from the same partition. When many threads
+  read the same hot index blocks they queue on the lock although none of
+  them changes anything in the cache.
+
+  A CLOCK key cache serves read hits without taking any lock:
+  - The blocks of a bucket of the hash table are linked through the field
+    'next_hash'. The chains are changed only under cache_lock, and the
+    block descriptors are not freed while the cache is in use, so a reader
+    may walk a chain at any time. If it follows a block that is moved to
+    another chain meanwhile, it just misses the page and takes the
+    locked path.
+  - Every block has a version that is odd while the block cannot be read:
+    while it is assigned to another page, while the page is read from file,
+    and while the block is free. A reader checks the version before and
+    after copying the data, like a sequence lock.
+  - A hit sets the 'referenced' bit of the block only if it is not set
+    yet, so the cache lines of the hot blocks stay shared by all CPUs.
+  - A lock-free reader registers in one of CLOCK_READER_SLOTS counters,
+    chosen by its thread id, each in a cache line of its own. A resize
+    waits until all the counters are 0 before it frees any memory.
+
+  Misses, writes and flushes acquire cache_lock as in a simple key cache.
+  A thread that works on a block with cache_lock released registers a
+  request on the block, which prevents the eviction of the block.
+  Eviction uses the second chance (CLOCK) algorithm: the clock hand
+  sweeps over the blocks and clears their 'referenced' bits, and the first
+  clean block that is neither referenced nor requested is evicted. Dirty
+  blocks that the hand finds are flushed when no clean block is left.
+
+  As in a simple key cache, the locks of the storage engine guarantee that
+  nobody reads the part of a block that is being written. The parameters
+  division_limit and age_threshold are not used, and a CLOCK key cache is
+  never divided into partitions: it needs neither of them to avoid
+  contention on hot blocks.
+
+******************************************************************************/
+
+#ifndef MY_ATOMIC_MODE_RWLOCKS
+
+/* Number of counters of lock-free readers of a CLOCK key cache */
+#define CLOCK_READER_SLOTS  64
+
+/* states of a block of a CLOCK key cache */
+#define CLOCK_BLOCK_READ        1 /* file block is in the block buffer      */
+#define CLOCK_BLOCK_IN_READ     2 /* file block is being read into buffer   */
+#define CLOCK_BLOCK_CHANGED     4 /* block buffer contains a dirty page     */
+#define CLOCK_BLOCK_IN_FLUSH    8 /* block buffer is being written to file  */
+#define CLOCK_BLOCK_FOR_UPDATE 16 /* block buffer is being modified         */
+
+typedef struct st_clock_block_link CLOCK_BLOCK_LINK;
+
+/* block of a CLOCK key cache */
+struct st_clock_block_link
+{
+  CLOCK_BLOCK_LINK
+    * volatile next_hash;  /* next block in hash bucket or free list         */
+  CLOCK_BLOCK_LINK
+    *next_changed, **prev_changed; /* for lists of file dirty/clean blocks   */
+  volatile int32 version;  /* incremented when readability changes          */
+  volatile File file;      /* file to which the page belongs                */
+  volatile my_off_t filepos; /* position of the page in the file            */
+  volatile uint length;    /* end of data in the buffer                      */
+  uint status;             /* state of the block                             */
+  uint requests;           /* threads using the block with cache_lock free   */
+  volatile uchar referenced; /* block was hit since the clock hand passed   */
+  uchar *buffer;           /* buffer for the block page                      */
+};
+
+/* counter of lock-free readers, in a cache line of its own */
+typedef struct st_clock_reader_slot
+{
+  volatile int32 readers;      /* lock-free readers using the cache          */
+  volatile int64 read_requests;/* read hits served without cache_lock        */
+  char pad[64 - 2 * sizeof(int64)]; /* fill up a cache line                */
+} CLOCK_READER_SLOT;
+
+/* Control block for a key cache with CLOCK replacement */
+
+typedef struct st_clock_key_cache_cb
+{
+  my_bool key_cache_inited;      /* <=> control block is allocated           */
+  my_bool can_be_used;           /* usage of cache for read/write is allowed */
+  volatile int32 in_resize;      /* true during resize operation             */
+  size_t key_cache_mem_size;     /* specified size of the cache memory       */
+  uint key_cache_block_size;     /* size of the page buffer of a cache block */
+  uint hash_entries;             /* number of entries in the hash table      */
+  ulong disk_blocks;             /* number of blocks in the cache            */
+  ulong blocks_used;           /* maximum number of concurrently used blocks */
+  ulong blocks_unused;           /* number of currently unused blocks        */
+  ulong clock_hand;              /* next block to be examined for eviction   */
+  ulong cnt_for_resize_op;       /* operations working with cache_lock free  */
+  uint waiting;                  /* number of threads waiting on 'cond'      */
+  CLOCK_BLOCK_LINK * volatile *hash_root; /* entries into hash buckets       */
+  CLOCK_BLOCK_LINK *block_root;  /* memory for block links                   */
+  CLOCK_BLOCK_LINK *free_block_list; /* list of free blocks                  */
+  uchar *block_mem;              /* memory for block buffers                 */
+  CLOCK_READER_SLOT *reader_slots; /* counters of lock-free readers          */
+  mysql_mutex_t cache_lock;      /* to lock access to the cache structure    */
+  mysql_cond_t cond;             /* signalled when a block or resize is done */
+  CLOCK_BLOCK_LINK *changed_blocks[CHANGED_BLOCKS_HASH]; /* dirty file blocks*/
+  CLOCK_BLOCK_LINK *file_blocks[CHANGED_BLOCKS_HASH];    /* other file blocks*/
+
+  /* Statistics variables. These are reset in reset_key_cache_counters(). */
+  ulong global_blocks_changed;      /* number of currently dirty blocks      */
+  ulonglong global_cache_w_requests;/* number of write requests (write hits) */
+  ulonglong global_cache_write;     /* number of writes from cache to files  */
+  ulonglong global_cache_r_requests;/* read requests that took cache_lock    */
+  ulonglong global_cache_read;      /* number of reads from files to cache   */
+} CLOCK_KEY_CACHE_CB;
+
+#define CLOCK_HASH(f, pos)                                                    \
+  (((ulong) ((pos) / keycache->key_cache_block_size) + (ulong) (f)) &         \
+   (keycache->hash_entries-1))
+
+/*
+  Full memory barrier for a lock-free reader. It is an atomic operation on
+  the reader slot of the thread, so it does not make the cache lines of
+  the blocks bounce between CPUs.
+*/
+#define clock_reader_barrier(slot) (void) my_atomic_add32(&(slot)->readers, 0)
+
+
+static void clock_wait(CLOCK_KEY_CACHE_CB *keycache)
+{
+  keycache->waiting++;
+  keycache_pthread_cond_wait(&keycache->cond, &keycache->cache_lock);
+  keycache->waiting--;
+}
+
+
+static inline void clock_wake(CLOCK_KEY_CACHE_CB *keycache)
+{
+  if (keycache->waiting)
+    mysql_cond_broadcast(&keycache->cond);
+}
+
+
+static inline void clock_link_to_list(CLOCK_BLOCK_LINK *block,
+                                      CLOCK_BLOCK_LINK **phead)
+{
+  if ((block->next_changed= *phead))
+    (*phead)->prev_changed= &block->next_changed;
+  block->prev_changed= phead;
+  *phead= block;
+}
+
+
+static inline void clock_unlink_from_list(CLOCK_BLOCK_LINK *block)
+{
+  if (block->next_changed)
+    block->next_changed->prev_changed= block->prev_changed;
+  *block->prev_changed= block->next_changed;
+}
+
+
+/* Mark a block dirty and move it to the list of dirty blocks of its file */
+
+static void clock_mark_changed(CLOCK_KEY_CACHE_CB *keycache,
+                               CLOCK_BLOCK_LINK *block)
+{
+  DBUG_ASSERT(!(block->status & CLOCK_BLOCK_CHANGED));
+  block->status|= CLOCK_BLOCK_CHANGED;
+  keycache->global_blocks_changed++;
+  clock_unlink_from_list(block);
+  clock_link_to_list(block, &keycache->changed_blocks[FILE_HASH(block->file)]);
+}
+
+
+/* Mark a block clean and move it to the list of clean blocks of its file */
+
+static void clock_mark_clean(CLOCK_KEY_CACHE_CB *keycache,
+                             CLOCK_BLOCK_LINK *block)
+{
+  DBUG_ASSERT(block->status & CLOCK_BLOCK_CHANGED);
+  block->status&= ~CLOCK_BLOCK_CHANGED;
+  keycache->global_blocks_changed--;
+  clock_unlink_from_list(block);
+  clock_link_to_list(block, &keycache->file_blocks[FILE_HASH(block->file)]);
+}
+
+
+/*
+  Find the block of a page in a CLOCK key cache
+
+  NOTES
+    Must be called with cache_lock held.
+*/
+
+static CLOCK_BLOCK_LINK *clock_find_block(CLOCK_KEY_CACHE_CB *keycache,
+                                          File file, my_off_t filepos)
+{
+  CLOCK_BLOCK_LINK *block;
+  for (block= keycache->hash_root[CLOCK_HASH(file, filepos)];
+       block;
+       block= block->next_hash)
+  {
+    if (block->file == file && block->filepos == filepos)
+      return block;
+  }
+  return NULL;
+}
+
+
+/*
+  Remove a block from its hash chain and file list and put it into the
+  free list
+
+  NOTES
+    Must be called with cache_lock held. The block must be clean, and
+    nobody else may have a request on it.
+*/
+
+static void clock_free_block(CLOCK_KEY_CACHE_CB *keycache,
+                             CLOCK_BLOCK_LINK *block)
+{
+  CLOCK_BLOCK_LINK * volatile *pos;
+  DBUG_ASSERT(!(block->status & CLOCK_BLOCK_CHANGED));
+
+  /* Make the block unreadable before it leaves the page. */
+  if (!(block->version & 1))
+    my_atomic_add32(&block->version, 1);
+
+  for (pos= &keycache->hash_root[CLOCK_HASH(block->file, block->filepos)];
+       *pos != block;
+       pos= &(*pos)->next_hash)
+    DBUG_ASSERT(*pos);
+  /*
+    block->next_hash is kept, so that a lock-free reader that stands on
+    the block can go on walking the chain.
+  */
+  *pos= block->next_hash;
+  clock_unlink_from_list(block);
+
+  block->status= 0;
+  block->requests= 0;
+  block->referenced= 0;
+  block->next_changed= keycache->free_block_list;
+  keycache->free_block_list= block;
+  keycache->blocks_unused++;
+}
+
+
+/*
+  Write a dirty block of a CLOCK key cache to its file
+
+  NOTES
+    Must be called with cache_lock held. The lock is released during the
+    write. The block is marked clean even if the write fails, as a simple
+    key cache does.
+
+  RETURN
+    0 on success, otherwise the errno of the failed write
+*/
+
+static int clock_flush_block(CLOCK_KEY_CACHE_CB *keycache,
+                             CLOCK_BLOCK_LINK *block)
+{
+  int error;
+  DBUG_ASSERT(block->status & CLOCK_BLOCK_CHANGED);
+  DBUG_ASSERT(!(block->status & (CLOCK_BLOCK_IN_FLUSH |
+                                 CLOCK_BLOCK_FOR_UPDATE)));
+  block->status|= CLOCK_BLOCK_IN_FLUSH;
+  block->requests++;
+  keycache_pthread_mutex_unlock(&keycache->cache_lock);
+  error= (int) my_pwrite(block->file, block->buffer, block->length,
+                         block->filepos, MYF(MY_NABP | MY_WAIT_IF_FULL));
+  if (error)
+    error= errno ? errno : -1;
+  keycache_pthread_mutex_lock(&keycache->cache_lock);
+  keycache->global_cache_write++;
+  block->status&= ~CLOCK_BLOCK_IN_FLUSH;
+  clock_mark_clean(keycache, block);
+  block->requests--;
+  clock_wake(keycache);
+  return error;
+}
+
+
+/*
+  Get a block of a CLOCK key cache that can be assigned to a new page
+
+  DESCRIPTION
+    Takes an unused block if there is one. Otherwise the clock hand sweeps
+    over the blocks and evicts the first clean block that is neither
+    referenced nor requested. If only dirty blocks can be evicted, the
+    first of them is flushed, and if all blocks are in use, the function
+    waits until a request is released. In both cases cache_lock is
+    released, and NULL is returned so that the caller can restart its
+    search for the page.
+
+  NOTES
+    Must be called with cache_lock held.
+
+  RETURN
+    a block that is not in the hash table, or NULL
+*/
+
+static CLOCK_BLOCK_LINK *clock_get_free_block(CLOCK_KEY_CACHE_CB *keycache)
+{
+  CLOCK_BLOCK_LINK *block, *dirty= NULL;
+  ulong i;
+
+  if ((block= keycache->free_block_list))
+  {
+    keycache->free_block_list= block->next_changed;
+    keycache->blocks_unused--;
+    return block;
+  }
+  if (keycache->blocks_used < keycache->disk_blocks)
+  {
+    keycache->blocks_unused--;
+    return keycache->block_root + keycache->blocks_used++;
+  }
+
+  for (i= 0; i < 2 * keycache->disk_blocks; i++)
+  {
+    block= keycache->block_root + keycache->clock_hand;
+    if (++keycache->clock_hand == keycache->disk_blocks)
+      keycache->clock_hand= 0;
+    if (block->requests || !(block->status & CLOCK_BLOCK_READ))
+      continue;
+    if (block->referenced)
+    {
+      /* Second chance */
+      block->referenced= 0;
+      continue;
+    }
+    if (block->status & CLOCK_BLOCK_CHANGED)
+    {
+      if (!dirty)
+        dirty= block;
+      continue;
+    }
+    /* Evict the block */
+    clock_free_block(keycache, block);
+    keycache->free_block_list= block->next_changed;
+    keycache->blocks_unused--;
+    return block;
+  }
+
+  if (dirty)
+    (void) clock_flush_block(keycache, dirty);
+  else
+    clock_wait(keycache);
+  return NULL;
+}
+
+
+/*
+  Get the block of a page of a CLOCK key cache and register a request on it
+
+  DESCRIPTION
+    If the page is being read into a block by another thread, the function
+    waits until the read is done. If the page is not in the cache, a block
+    is assigned to it, and *page_st is set to PAGE_TO_BE_READ: the caller
+    must then either read the page with clock_read_block() or overwrite
+    the whole block, and mark it readable with clock_block_read_done().
+
+  NOTES
+    Must be called with cache_lock held.
+*/
+
+static CLOCK_BLOCK_LINK *clock_get_block(CLOCK_KEY_CACHE_CB *keycache,
+                                         File file, my_off_t filepos,
+                                         int *page_st)
+{
+  CLOCK_BLOCK_LINK *block;
+  CLOCK_BLOCK_LINK * volatile *bucket;
+
+restart:
+  if ((block= clock_find_block(keycache, file, filepos)))
+  {
+    if (block->status & CLOCK_BLOCK_IN_READ)
+    {
+      clock_wait(keycache);
+      goto restart;
+    }
+    block->requests++;
+    block->referenced= 1;
+    *page_st= PAGE_READ;
+    return block;
+  }
+
+  if (!(block= clock_get_free_block(keycache)))
+    goto restart;
+
+  DBUG_ASSERT(block->version & 1);
+  block->file= file;
+  block->filepos= filepos;
+  block->length= 0;
+  block->status= CLOCK_BLOCK_IN_READ;
+  block->requests= 1;
+  block->referenced= 1;
+  clock_link_to_list(block, &keycache->file_blocks[FILE_HASH(file)]);
+  bucket= &keycache->hash_root[CLOCK_HASH(file, filepos)];
+  block->next_hash= *bucket;
+  /* Publish the block only after it has been assigned to the page. */
+  my_atomic_storeptr((void * volatile *) bucket, block);
+  *page_st= PAGE_TO_BE_READ;
+  return block;
+}
+
+
+/* Make a block that has been assigned to a page readable */
+
+static void clock_block_read_done(CLOCK_KEY_CACHE_CB *keycache,
+                                  CLOCK_BLOCK_LINK *block)
+{
+  DBUG_ASSERT(block->status & CLOCK_BLOCK_IN_READ);
+  DBUG_ASSERT(block->version & 1);
+  block->status= (block->status & ~CLOCK_BLOCK_IN_READ) | CLOCK_BLOCK_READ;
+  my_atomic_add32(&block->version, 1);
+  clock_wake(keycache);
+}
+
+
+/*
+  Read a page into the block that has been assigned to it
+
+  NOTES
+    Must be called with cache_lock held. The lock is released during the
+    read. If the read fails or returns less than min_length bytes, the
+    block is freed.
+
+  RETURN
+    0 on success, 1 on error
+*/
+
+static int clock_read_block(CLOCK_KEY_CACHE_CB *keycache,
+                            CLOCK_BLOCK_LINK *block, uint min_length)
+{
+  size_t got_length;
+  keycache->global_cache_read++;
+  keycache_pthread_mutex_unlock(&keycache->cache_lock);
+  got_length= my_pread(block->file, block->buffer,
+                       keycache->key_cache_block_size, block->filepos, MYF(0));
+  keycache_pthread_mutex_lock(&keycache->cache_lock);
+  if (got_length == (size_t) -1 || got_length < min_length)
+  {
+    DBUG_ASSERT(block->requests == 1);
+    clock_free_block(keycache, block);
+    clock_wake(keycache);
+    return 1;
+  }
+  block->length= (uint) got_length;
+  clock_block_read_done(keycache, block);
+  return 0;
+}
+
+
+static inline void clock_release_block(CLOCK_KEY_CACHE_CB *keycache,
+                                       CLOCK_BLOCK_LINK *block)
+{
+  if (!--block->requests)
+    clock_wake(keycache);
+}
+
+
+/*
+  Start an operation on a CLOCK key cache with cache_lock held: wait until
+  a resize is done and register the operation for the next resize
+*/
+
+static void clock_start_locked_op(CLOCK_KEY_CACHE_CB *keycache)
+{
+  keycache_pthread_mutex_lock(&keycache->cache_lock);
+  while (keycache->in_resize)
+    clock_wait(keycache);
+  keycache->cnt_for_resize_op++;
+}
+
+
+static void clock_end_locked_op(CLOCK_KEY_CACHE_CB *keycache)
+{
+  if (!--keycache->cnt_for_resize_op)
+    clock_wake(keycache);
+  keycache_pthread_mutex_unlock(&keycache->cache_lock);
+}
+
+
+static inline CLOCK_READER_SLOT *clock_reader_slot(CLOCK_KEY_CACHE_CB *keycache)
+{
+  return keycache->reader_slots +
+         (my_thread_var->id & (CLOCK_READER_SLOTS - 1));
+}
+
+
+/* Allocate the blocks and the hash table of a CLOCK key cache */
+
+static ulong clock_alloc_blocks(CLOCK_KEY_CACHE_CB *keycache,
+                                uint key_cache_block_size, size_t use_mem)
+{
+  ulong blocks, i;
+  size_t length;
+
+  keycache->key_cache_mem_size= use_mem;
+  keycache->key_cache_block_size= key_cache_block_size;
+  keycache->disk_blocks= 0;
+  keycache->block_mem= NULL;
+  keycache->block_root= NULL;
+
+  blocks= (ulong) (use_mem / (sizeof(CLOCK_BLOCK_LINK) +
+                              sizeof(CLOCK_BLOCK_LINK*) * 5/4 +
+                              key_cache_block_size));
+  /* It doesn't make sense to have too few blocks (less than 8) */
+  if (blocks < 8)
+    return 0;
+  for ( ; ; )
+  {
+    /* Set hash_entries to the next bigger 2 power */
+    if ((keycache->hash_entries= next_power(blocks)) < blocks * 5/4)
+      keycache->hash_entries<<= 1;
+    while ((length= (ALIGN_SIZE(blocks * sizeof(CLOCK_BLOCK_LINK)) +
+                     sizeof(CLOCK_BLOCK_LINK*) * keycache->hash_entries)) +
+           ((size_t) blocks * key_cache_block_size) > use_mem)
+      blocks--;
+    if ((keycache->block_mem=
+         my_large_malloc((size_t) blocks * key_cache_block_size, MYF(0))))
+    {
+      if ((keycache->block_root= (CLOCK_BLOCK_LINK*) my_malloc(length,
+                                                               MYF(0))))
+        break;
+      my_large_free(keycache->block_mem);
+      keycache->block_mem= NULL;
+    }
+    if (blocks < 8)
+    {
+      my_errno= ENOMEM;
+      my_error(EE_OUTOFMEMORY, MYF(ME_FATALERROR),
+               blocks * key_cache_block_size);
+      return 0;
+    }
+    blocks= blocks / 4*3;
+  }
+
+  keycache->hash_root= (CLOCK_BLOCK_LINK**) ((char*) keycache->block_root +
+                       ALIGN_SIZE(blocks * sizeof(CLOCK_BLOCK_LINK)));
+  bzero((uchar*) keycache->block_root, length);
+  for (i= 0; i < blocks; i++)
+  {
+    CLOCK_BLOCK_LINK *block= keycache->block_root + i;
+    block->buffer= keycache->block_mem + (size_t) i * key_cache_block_size;
+    /* Unused blocks are not readable */
+    block->version= 1;
+  }
+  keycache->disk_blocks= blocks;
+  keycache->blocks_used= 0;
+  keycache->blocks_unused= blocks;
+  keycache->clock_hand= 0;
+  keycache->free_block_list= NULL;
+  keycache->global_blocks_changed= 0;
+  bzero((uchar*) keycache->changed_blocks,
+        sizeof(keycache->changed_blocks[0]) * CHANGED_BLOCKS_HASH);
+  bzero((uchar*) keycache->file_blocks,
+        sizeof(keycache->file_blocks[0]) * CHANGED_BLOCKS_HASH);
+  return blocks;
+}
+
+
+static void clock_free_blocks(CLOCK_KEY_CACHE_CB *keycache)
+{
+  if (keycache->block_mem)
+  {
+    my_large_free(keycache->block_mem);
+    keycache->block_mem= NULL;
+  }
+  if (keycache->block_root)
+  {
+    my_free(keycache->block_root);
+    keycache->block_root= NULL;
+  }
+  keycache->disk_blocks= 0;
+  keycache->blocks_used= keycache->blocks_unused= 0;
+  keycache->global_blocks_changed= 0;
+}
+
+
+/*
+  Initialize a key cache with CLOCK replacement
+
+  SYNOPSIS
+    init_clock_key_cache()
+    keycache                pointer to the control block of a CLOCK key cache
+    key_cache_block_size    size of blocks to keep cached data
+    use_mem                 memory to use for the key cache buffers/structures
+    division_limit          not used
+    age_threshold           not used
+
+  DESCRIPTION
+    This function is the implementation of the init_key_cache interface
+    function that is employed by key caches with CLOCK replacement.
+    The function builds a CLOCK key cache and initializes the control block
+    structure of the type CLOCK_KEY_CACHE_CB that is used for this key cache.
+    If use_mem is too small for 8 blocks, the cache is disabled and all
+    reads and writes go directly to the files.
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    <= 0 - otherwise.
+*/
+
+static
+int init_clock_key_cache(CLOCK_KEY_CACHE_CB *keycache,
+                         uint key_cache_block_size, size_t use_mem,
+                         uint division_limit __attribute__((unused)),
+                         uint age_threshold __attribute__((unused)))
+{
+  DBUG_ENTER("init_clock_key_cache");
+  DBUG_ASSERT(key_cache_block_size >= 512);
+
+  if (keycache->key_cache_inited && keycache->disk_blocks > 0)
+  {
+    DBUG_PRINT("warning",("key cache already in use"));
+    DBUG_RETURN(0);
+  }
+
+  if (!keycache->key_cache_inited)
+  {
+    if (!(keycache->reader_slots= (CLOCK_READER_SLOT*)
+          my_malloc(sizeof(CLOCK_READER_SLOT) * CLOCK_READER_SLOTS,
+                    MYF(MY_ZEROFILL))))
+      DBUG_RETURN(0);
+    keycache->key_cache_inited= 1;
+    /*
+      Initialize these variables once only.
+      Their value must survive re-initialization during resizing.
+    */
+    keycache->in_resize= 0;
+    keycache->cnt_for_resize_op= 0;
+    keycache->waiting= 0;
+    keycache->global_cache_w_requests= keycache->global_cache_r_requests= 0;
+    keycache->global_cache_read= keycache->global_cache_write= 0;
+    mysql_mutex_init(key_KEY_CACHE_cache_lock,
+                     &keycache->cache_lock, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_KEY_CACHE_clock_cond, &keycache->cond, NULL);
+  }
+
+  keycache->can_be_used=
+    clock_alloc_blocks(keycache, key_cache_block_size, use_mem) > 0;
+
+  DBUG_PRINT("exit", ("disk_blocks: %lu  hash_entries: %u",
+                      keycache->disk_blocks, keycache->hash_entries));
+  DBUG_RETURN((int) keycache->disk_blocks);
+}
+
+
+/*
+  Write all dirty blocks of a CLOCK key cache to their files
+
+  NOTES
+    Must be called with cache_lock held, while no other thread uses the
+    cache.
+*/
+
+static int clock_flush_all_blocks(CLOCK_KEY_CACHE_CB *keycache)
+{
+  int error= 0;
+  uint idx;
+  CLOCK_BLOCK_LINK *block;
+
+  for (idx= 0; idx < CHANGED_BLOCKS_HASH; idx++)
+  {
+    while ((block= keycache->changed_blocks[idx]))
+    {
+      int res= clock_flush_block(keycache, block);
+      if (res && !error)
+        error= res;
+    }
+  }
+  return error;
+}
+
+
+/*
+  Resize a key cache with CLOCK replacement
+
+  SYNOPSIS
+    resize_clock_key_cache()
+    keycache                pointer to the control block of a CLOCK key cache
+    key_cache_block_size    size of blocks to keep cached data
+    use_mem                 memory to use for the new key cache
+    division_limit          not used
+    age_threshold           not used
+
+  DESCRIPTION
+    This function is the implementation of the resize_key_cache interface
+    function that is employed by key caches with CLOCK replacement.
+    The function waits until no other thread is in the key cache, while
+    new requests wait for the resize to be done. Then it writes all dirty
+    blocks to their files and rebuilds the key cache with the new block
+    size and memory.
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    0 - otherwise.
+*/
+
+static
+int resize_clock_key_cache(CLOCK_KEY_CACHE_CB *keycache,
+                           uint key_cache_block_size, size_t use_mem,
+                           uint division_limit __attribute__((unused)),
+                           uint age_threshold __attribute__((unused)))
+{
+  int blocks= 0;
+  uint i;
+  DBUG_ENTER("resize_clock_key_cache");
+
+  if (!keycache->key_cache_inited)
+    DBUG_RETURN((int) keycache->disk_blocks);
+
+  keycache_pthread_mutex_lock(&keycache->cache_lock);
+  while (keycache->in_resize)
+    clock_wait(keycache);
+  /* A full barrier: the readers must see in_resize before we count them. */
+  my_atomic_add32(&keycache->in_resize, 1);
+
+  /* Wait for the operations with cache_lock ... */
+  while (keycache->cnt_for_resize_op)
+    clock_wait(keycache);
+  /* ... and for the lock-free readers. They see in_resize and leave. */
+  keycache_pthread_mutex_unlock(&keycache->cache_lock);
+  for (i= 0; i < CLOCK_READER_SLOTS; i++)
+  {
+    while (my_atomic_load32(&keycache->reader_slots[i].readers))
+      my_yield();
+  }
+  keycache_pthread_mutex_lock(&keycache->cache_lock);
+
+  if (clock_flush_all_blocks(keycache))
+  {
+    /* TODO: if this happens, we should write a warning in the log file ! */
+    keycache->can_be_used= 0;
+    goto finish;
+  }
+  clock_free_blocks(keycache);
+  blocks= (int) clock_alloc_blocks(keycache, key_cache_block_size, use_mem);
+  keycache->can_be_used= blocks > 0;
+
+finish:
+  my_atomic_add32(&keycache->in_resize, -1);
+  clock_wake(keycache);
+  keycache_pthread_mutex_unlock(&keycache->cache_lock);
+  DBUG_RETURN(blocks);
+}
+
+
+/*
+  Change key cache parameters of a key cache with CLOCK replacement
+
+  DESCRIPTION
+    This function is the implementation of the change_key_cache_param
+    interface function that is employed by key caches with CLOCK
+    replacement. A CLOCK key cache does not use the midpoint insertion
+    strategy, so the function does nothing.
+*/
+
+static
+void change_clock_key_cache_param(CLOCK_KEY_CACHE_CB *keycache
+                                  __attribute__((unused)),
+                                  uint division_limit __attribute__((unused)),
+                                  uint age_threshold __attribute__((unused)))
+{
+}
+
+
+/*
+  Destroy a key cache with CLOCK replacement
+
+  SYNOPSIS
+    end_clock_key_cache()
+    keycache            pointer to the control block of a CLOCK key cache
+    cleanup             <=> complete free (free also mutex and cond)
+
+  DESCRIPTION
+    This function is the implementation of the end_key_cache interface
+    function that is employed by key caches with CLOCK replacement.
+    The function frees the memory of the blocks, and with cleanup also the
+    synchronization objects of the key cache. The dirty blocks must have
+    been flushed before.
+*/
+
+static
+void end_clock_key_cache(CLOCK_KEY_CACHE_CB *keycache, my_bool cleanup)
+{
+  DBUG_ENTER("end_clock_key_cache");
+  if (!keycache->key_cache_inited)
+    DBUG_VOID_RETURN;
+
+  clock_free_blocks(keycache);
+  keycache->can_be_used= 0;
+  if (cleanup)
+  {
+    mysql_mutex_destroy(&keycache->cache_lock);
+    mysql_cond_destroy(&keycache->cond);
+    my_free(keycache->reader_slots);
+    keycache->reader_slots= NULL;
+    keycache->key_cache_inited= 0;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Copy the data of a page from a CLOCK key cache without locking
+
+  RETURN
+    TRUE if the data was copied, FALSE if the page must be requested with
+    cache_lock held
+*/
+
+static my_bool clock_read_hit(CLOCK_KEY_CACHE_CB *keycache,
+                              CLOCK_READER_SLOT *slot,
+                              File file, my_off_t filepos, uint offset,
+                              uchar *buff, uint read_length)
+{
+  CLOCK_BLOCK_LINK *block;
+  ulong n;
+
+  /* Do not loop forever if blocks are moved around while we walk. */
+  for (block= keycache->hash_root[CLOCK_HASH(file, filepos)], n= 0;
+       block && n < keycache->disk_blocks;
+       block= block->next_hash, n++)
+  {
+    int32 version;
+    if (block->file != file || block->filepos != filepos)
+      continue;
+    version= block->version;
+    clock_reader_barrier(slot);
+    if ((version & 1) ||
+        block->file != file || block->filepos != filepos ||
+        block->length < offset + read_length)
+      return FALSE;
+    memcpy(buff, block->buffer + offset, read_length);
+    clock_reader_barrier(slot);
+    if (block->version != version)
+      return FALSE;
+    if (!block->referenced)
+      block->referenced= 1;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*
+  Read a block of data from a CLOCK key cache into a buffer
+
+  SYNOPSIS
+    clock_key_cache_read()
+    keycache            pointer to the control block of a CLOCK key cache
+    file                handler for the file for the block of data to be read
+    filepos             position of the block of data in the file
+    level               not used
+    buff                buffer to where the data must be placed
+    length              length of the buffer
+    block_length        not used
+    return_buffer       not used
+
+  DESCRIPTION
+    This function is the implementation of the key_cache_read interface
+    function that is employed by key caches with CLOCK replacement.
+    The data is read in key_cache_block_size increments. The function
+    first copies the cached blocks without any lock. From the first block
+    that it cannot copy this way on, it continues with cache_lock held and
+    reads the missing blocks from the file into the key cache.
+
+  RETURN VALUE
+    Returns address from where the data is placed if successful, 0 - otherwise.
+*/
+
+static
+uchar *clock_key_cache_read(CLOCK_KEY_CACHE_CB *keycache,
+                            File file, my_off_t filepos,
+                            int level __attribute__((unused)),
+                            uchar *buff, uint length,
+                            uint block_length __attribute__((unused)),
+                            int return_buffer __attribute__((unused)))
+{
+  CLOCK_READER_SLOT *slot;
+  CLOCK_BLOCK_LINK *block;
+  uchar *start= buff;
+  uint offset, read_length;
+  int page_st, error= 0;
+  DBUG_ENTER("clock_key_cache_read");
+  DBUG_PRINT("enter", ("fd: %u  pos: %lu  length: %u",
+               (uint) file, (ulong) filepos, length));
+
+  if (!keycache->key_cache_inited)
+    goto no_key_cache;
+
+  slot= clock_reader_slot(keycache);
+  my_atomic_add32(&slot->readers, 1);
+  /* The increment is a full barrier, so a plain read of in_resize is safe. */
+  if (!keycache->in_resize && keycache->can_be_used)
+  {
+    while (length)
+    {
+      /* Requested data may not always be aligned to cache blocks. */
+      offset= (uint) (filepos % keycache->key_cache_block_size);
+      read_length= min(length, keycache->key_cache_block_size - offset);
+      if (!clock_read_hit(keycache, slot, file, filepos - offset, offset,
+                          buff, read_length))
+        break;
+      my_atomic_add64(&slot->read_requests, (int64) 1);
+      buff+= read_length;
+      filepos+= read_length;
+      length-= read_length;
+    }
+  }
+  my_atomic_add32(&slot->readers, -1);
+  if (!length)
+    DBUG_RETURN(start);
+
+  clock_start_locked_op(keycache);
+  while (length)
+  {
+    /* Cache could be disabled by a resize. */
+    if (!keycache->can_be_used)
+    {
+      keycache->global_cache_r_requests++;
+      keycache->global_cache_read++;
+      keycache_pthread_mutex_unlock(&keycache->cache_lock);
+      error= (my_pread(file, buff, length, filepos, MYF(MY_NABP)) != 0);
+      keycache_pthread_mutex_lock(&keycache->cache_lock);
+      break;
+    }
+    offset= (uint) (filepos % keycache->key_cache_block_size);
+    read_length= min(length, keycache->key_cache_block_size - offset);
+    keycache->global_cache_r_requests++;
+
+    block= clock_get_block(keycache, file, filepos - offset, &page_st);
+    if (page_st == PAGE_TO_BE_READ &&
+        clock_read_block(keycache, block, offset + read_length))
+    {
+      error= 1;
+      break;
+    }
+    if (block->length < offset + read_length)
+    {
+      /*
+        Impossible if nothing goes wrong: this could only happen if we
+        are trying to read outside the file
+      */
+      clock_release_block(keycache, block);
+      my_errno= -1;
+      error= 1;
+      break;
+    }
+    keycache_pthread_mutex_unlock(&keycache->cache_lock);
+    memcpy(buff, block->buffer + offset, read_length);
+    keycache_pthread_mutex_lock(&keycache->cache_lock);
+    clock_release_block(keycache, block);
+
+    buff+= read_length;
+    filepos+= read_length;
+    length-= read_length;
+  }
+  clock_end_locked_op(keycache);
+  DBUG_RETURN(error ? (uchar*) 0 : start);
+
+no_key_cache:
+  if (my_pread(file, buff, length, filepos, MYF(MY_NABP)))
+    DBUG_RETURN((uchar*) 0);
+  DBUG_RETURN(start);
+}
+
+
+/*
+  Insert a block of file data from a buffer into a CLOCK key cache
+
+  SYNOPSIS
+    clock_key_cache_insert()
+    keycache            pointer to the control block of a CLOCK key cache
+    file                handler for the file to insert data from
+    filepos             position of the block of data in the file to insert
+    level               not used
+    buff                buffer to read data from
+    length              length of the data in the buffer
+
+  DESCRIPTION
+    This function is the implementation of the key_cache_insert interface
+    function that is employed by key caches with CLOCK replacement.
+    The function copies the pages of the buffer that are not in the key
+    cache yet into the cache. Pages that start before the buffer are
+    skipped.
+
+  RETURN VALUE
+    0 if a success, 1 - otherwise.
+*/
+
+static
+int clock_key_cache_insert(CLOCK_KEY_CACHE_CB *keycache,
+                           File file, my_off_t filepos,
+                           int level __attribute__((unused)),
+                           uchar *buff, uint length)
+{
+  CLOCK_BLOCK_LINK *block;
+  uint offset, read_length;
+  int page_st;
+  DBUG_ENTER("clock_key_cache_insert");
+
+  if (!keycache->key_cache_inited)
+    DBUG_RETURN(0);
+
+  clock_start_locked_op(keycache);
+  while (length && keycache->can_be_used)
+  {
+    offset= (uint) (filepos % keycache->key_cache_block_size);
+    read_length= min(length, keycache->key_cache_block_size - offset);
+    if (!offset && !clock_find_block(keycache, file, filepos))
+    {
+      block= clock_get_block(keycache, file, filepos, &page_st);
+      if (page_st == PAGE_TO_BE_READ)
+      {
+        keycache_pthread_mutex_unlock(&keycache->cache_lock);
+        memcpy(block->buffer, buff, read_length);
+        keycache_pthread_mutex_lock(&keycache->cache_lock);
+        block->length= read_length;
+        clock_block_read_done(keycache, block);
+      }
+      clock_release_block(keycache, block);
+    }
+    buff+= read_length;
+    filepos+= read_length;
+    length-= read_length;
+  }
+  clock_end_locked_op(keycache);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Write a buffer into a CLOCK key cache
+
+  SYNOPSIS
+    clock_key_cache_write()
+    keycache            pointer to the control block of a CLOCK key cache
+    file                handler for the file to write data to
+    file_extra          not used
+    filepos             position in the file to write data to
+    level               not used
+    buff                buffer with the data
+    length              length of the buffer
+    block_length        not used
+    dont_write          if is 0 then the data is also written to the file
+
+  DESCRIPTION
+    This function is the implementation of the key_cache_write interface
+    function that is employed by key caches with CLOCK replacement.
+    The function copies the data into the key cache in key_cache_block_size
+    increments. A block that is only partly overwritten is read from the
+    file first if it is not in the cache. If dont_write is TRUE, the blocks
+    are marked dirty, otherwise the data is written to the file too.
+
+  RETURN VALUE
+    0 if a success, 1 - otherwise.
+*/
+
+static
+int clock_key_cache_write(CLOCK_KEY_CACHE_CB *keycache,
+                          File file,
+                          void *file_extra __attribute__((unused)),
+                          my_off_t filepos,
+                          int level __attribute__((unused)),
+                          uchar *buff, uint length,
+                          uint block_length __attribute__((unused)),
+                          int dont_write)
+{
+  CLOCK_BLOCK_LINK *block;
+  uint offset, read_length;
+  int page_st, error= 0;
+  DBUG_ENTER("clock_key_cache_write");
+  DBUG_PRINT("enter", ("fd: %u  pos: %lu  length: %u",
+                       (uint) file, (ulong) filepos, length));
+
+  if (!dont_write)
+  {
+    /* Not used in the server. */
+    /* Force writing from buff into disk. */
+    keycache->global_cache_w_requests++;
+    keycache->global_cache_write++;
+    if (my_pwrite(file, buff, length, filepos, MYF(MY_NABP | MY_WAIT_IF_FULL)))
+      DBUG_RETURN(1);
+  }
+
+  if (!keycache->key_cache_inited)
+    goto no_key_cache;
+
+  clock_start_locked_op(keycache);
+  while (length)
+  {
+    /* Cache could be disabled by a resize. */
+    if (!keycache->can_be_used)
+    {
+      keycache_pthread_mutex_unlock(&keycache->cache_lock);
+      if (dont_write)
+      {
+        keycache->global_cache_w_requests++;
+        keycache->global_cache_write++;
+        error= (my_pwrite(file, buff, length, filepos,
+                          MYF(MY_NABP | MY_WAIT_IF_FULL)) != 0);
+      }
+      keycache_pthread_mutex_lock(&keycache->cache_lock);
+      break;
+    }
+    offset= (uint) (filepos % keycache->key_cache_block_size);
+    read_length= min(length, keycache->key_cache_block_size - offset);
+    keycache->global_cache_w_requests++;
+
+    block= clock_get_block(keycache, file, filepos - offset, &page_st);
+    if (page_st == PAGE_TO_BE_READ &&
+        (offset || read_length < keycache->key_cache_block_size) &&
+        clock_read_block(keycache, block, offset))
+    {
+      error= 1;
+      break;
+    }
+
+    /*
+      Do not modify the buffer while it is written to the file, and keep
+      it from being flushed while we modify it.
+    */
+    while (block->status & (CLOCK_BLOCK_IN_FLUSH | CLOCK_BLOCK_FOR_UPDATE))
+      clock_wait(keycache);
+    block->status|= CLOCK_BLOCK_FOR_UPDATE;
+    keycache_pthread_mutex_unlock(&keycache->cache_lock);
+    memcpy(block->buffer + offset, buff, read_length);
+    keycache_pthread_mutex_lock(&keycache->cache_lock);
+    block->status&= ~CLOCK_BLOCK_FOR_UPDATE;
+    set_if_bigger(block->length, offset + read_length);
+
+    if (dont_write)
+    {
+      if (!(block->status & CLOCK_BLOCK_CHANGED))
+        clock_mark_changed(keycache, block);
+    }
+    else if ((block->status & CLOCK_BLOCK_CHANGED) &&
+             !offset && read_length >= keycache->key_cache_block_size)
+      clock_mark_clean(keycache, block);
+
+    if (block->status & CLOCK_BLOCK_IN_READ)
+      clock_block_read_done(keycache, block);
+    else
+      clock_wake(keycache);
+    clock_release_block(keycache, block);
+
+    buff+= read_length;
+    filepos+= read_length;
+    length-= read_length;
+  }
+  clock_end_locked_op(keycache);
+  DBUG_RETURN(error);
+
+no_key_cache:
+  if (dont_write)
+  {
+    keycache->global_cache_w_requests++;
+    keycache->global_cache_write++;
+    if (my_pwrite(file, buff, length, filepos, MYF(MY_NABP | MY_WAIT_IF_FULL)))
+      error= 1;
+  }
+  DBUG_RETURN(error);
+}
+
+
+static int cmp_clock_block_pos(CLOCK_BLOCK_LINK **a, CLOCK_BLOCK_LINK **b)
+{
+  return (((*a)->filepos < (*b)->filepos) ? -1 :
+          ((*a)->filepos > (*b)->filepos) ? 1 : 0);
+}
+
+
+/*
+  Flush the blocks of a file in a CLOCK key cache
+
+  SYNOPSIS
+    flush_clock_key_cache_blocks()
+    keycache            pointer to the control block of a CLOCK key cache
+    file                handler for the file to flush to
+    file_extra          not used
+    type                type of the flush operation
+
+  DESCRIPTION
+    This function is the implementation of the flush_key_blocks interface
+    function that is employed by key caches with CLOCK replacement.
+    The dirty blocks of the file are written to the file in the order of
+    their positions, FLUSH_CACHE blocks at a time, with cache_lock
+    released. With FLUSH_IGNORE_CHANGED they are marked clean without
+    being written. With FLUSH_RELEASE and FLUSH_IGNORE_CHANGED all blocks
+    of the file are freed afterwards.
+
+  RETURN
+    0   ok
+    1  error
+*/
+
+static
+int flush_clock_key_cache_blocks(CLOCK_KEY_CACHE_CB *keycache,
+                                 File file,
+                                 void *file_extra __attribute__((unused)),
+                                 enum flush_type type)
+{
+  CLOCK_BLOCK_LINK *cache_buff[FLUSH_CACHE];
+  CLOCK_BLOCK_LINK *block, *next;
+  uint count, i;
+  int last_errno= 0;
+  my_bool busy;
+  DBUG_ENTER("flush_clock_key_cache_blocks");
+  DBUG_PRINT("enter", ("file: %d  type: %d", file, (int) type));
+
+  if (!keycache->key_cache_inited)
+    DBUG_RETURN(0);
+
+  clock_start_locked_op(keycache);
+  if (!keycache->can_be_used)
+    goto end;
+
+restart:
+  count= 0;
+  busy= FALSE;
+  for (block= keycache->changed_blocks[FILE_HASH(file)]; block; block= next)
+  {
+    next= block->next_changed;
+    if (block->file != file)
+      continue;
+    if (block->status & (CLOCK_BLOCK_IN_FLUSH | CLOCK_BLOCK_FOR_UPDATE))
+    {
+      busy= TRUE;
+      continue;
+    }
+    if (type == FLUSH_IGNORE_CHANGED)
+      clock_mark_clean(keycache, block);
+    else if (count < FLUSH_CACHE)
+    {
+      block->status|= CLOCK_BLOCK_IN_FLUSH;
+      block->requests++;
+      cache_buff[count++]= block;
+    }
+  }
+
+  if (count)
+  {
+    keycache_pthread_mutex_unlock(&keycache->cache_lock);
+    my_qsort((uchar*) cache_buff, count, sizeof(*cache_buff),
+             (qsort_cmp) cmp_clock_block_pos);
+    for (i= 0; i < count; i++)
+    {
+      block= cache_buff[i];
+      if (my_pwrite(file, block->buffer, block->length, block->filepos,
+                    MYF(MY_NABP | MY_WAIT_IF_FULL)) && !last_errno)
+        last_errno= errno ? errno : -1;
+    }
+    keycache_pthread_mutex_lock(&keycache->cache_lock);
+    for (i= 0; i < count; i++)
+    {
+      block= cache_buff[i];
+      keycache->global_cache_write++;
+      block->status&= ~CLOCK_BLOCK_IN_FLUSH;
+      clock_mark_clean(keycache, block);
+      block->requests--;
+    }
+    clock_wake(keycache);
+    goto restart;
+  }
+
+  if (busy && type != FLUSH_KEEP_LAZY)
+  {
+    /* Wait for the other flushes and modifications of our blocks. */
+    clock_wait(keycache);
+    goto restart;
+  }
+
+  if (type == FLUSH_RELEASE || type == FLUSH_IGNORE_CHANGED)
+  {
+    for (block= keycache->file_blocks[FILE_HASH(file)]; block; block= next)
+    {
+      next= block->next_changed;
+      if (block->file != file)
+        continue;
+      if (block->requests || (block->status & CLOCK_BLOCK_CHANGED))
+      {
+        /* A block in use, or a block that has been changed meanwhile */
+        clock_wait(keycache);
+        goto restart;
+      }
+      clock_free_block(keycache, block);
+    }
+  }
+
+end:
+  clock_end_locked_op(keycache);
+  DBUG_RETURN(last_errno != 0);
+}
+
+
+/*
+  Reset the counters of a key cache with CLOCK replacement
+
+  DESCRIPTION
+    This function is the implementation of the reset_key_cache_counters
+    interface function that is employed by key caches with CLOCK
+    replacement. Read hits that happen meanwhile may be lost or counted.
+
+  RETURN
+    0 on success (always because it can't fail)
+*/
+
+static
+int reset_clock_key_cache_counters(const char *name __attribute__((unused)),
+                                   CLOCK_KEY_CACHE_CB *keycache)
+{
+  uint i;
+  DBUG_ENTER("reset_clock_key_cache_counters");
+  if (!keycache->key_cache_inited)
+  {
+    DBUG_PRINT("info", ("Key cache %s not initialized.", name));
+    DBUG_RETURN(0);
+  }
+  DBUG_PRINT("info", ("Resetting counters for key cache %s.", name));
+
+  for (i= 0; i < CLOCK_READER_SLOTS; i++)
+    my_atomic_store64(&keycache->reader_slots[i].read_requests, (int64) 0);
+  keycache->global_cache_r_requests= 0; /* Key_read_requests */
+  keycache->global_cache_read= 0;       /* Key_reads */
+  keycache->global_cache_w_requests= 0; /* Key_write_requests */
+  keycache->global_cache_write= 0;      /* Key_writes */
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Get statistics for a key cache with CLOCK replacement
+
+  DESCRIPTION
+    This function is the implementation of the get_key_cache_statistics
+    interface function that is employed by key caches with CLOCK
+    replacement. The read requests are the sum of the hits served without
+    cache_lock and the requests that took it.
+*/
+
+static
+void get_clock_key_cache_statistics(CLOCK_KEY_CACHE_CB *keycache,
+                                    uint partition_no __attribute__((unused)),
+                                    KEY_CACHE_STATISTICS *keycache_stats)
+{
+  ulonglong read_requests= keycache->global_cache_r_requests;
+  uint i;
+  DBUG_ENTER("get_clock_key_cache_statistics");
+
+  if (keycache->reader_slots)
+  {
+    for (i= 0; i < CLOCK_READER_SLOTS; i++)
+      read_requests+= (ulonglong) keycache->reader_slots[i].read_requests;
+  }
+  keycache_stats->mem_size= (longlong) keycache->key_cache_mem_size;
+  keycache_stats->block_size= (longlong) keycache->key_cache_block_size;
+  keycache_stats->blocks_used= keycache->blocks_used;
+  keycache_stats->blocks_unused= keycache->blocks_unused;
+  keycache_stats->blocks_changed= keycache->global_blocks_changed;
+  keycache_stats->blocks_warm= 0;
+  keycache_stats->read_requests= read_requests;
+  keycache_stats->reads= keycache->global_cache_read;
+  keycache_stats->write_requests= keycache->global_cache_w_requests;
+  keycache_stats->writes= keycache->global_cache_write;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  The array of pointers to the key cache interface functions used by key
+  caches with CLOCK replacement.
+*/
+
+static KEY_CACHE_FUNCS clock_key_cache_funcs =
+{
+  (INIT_KEY_CACHE) init_clock_key_cache,
+  (RESIZE_KEY_CACHE) resize_clock_key_cache,
+  (CHANGE_KEY_CACHE_PARAM) change_clock_key_cache_param,
+  (KEY_CACHE_READ) clock_key_cache_read,
+  (KEY_CACHE_INSERT) clock_key_cache_insert,
+  (KEY_CACHE_WRITE) clock_key_cache_write,
+  (FLUSH_KEY_BLOCKS) flush_clock_key_cache_blocks,
+  (RESET_KEY_CACHE_COUNTERS) reset_clock_key_cache_counters,
+  (END_KEY_CACHE) end_clock_key_cache,
+  (GET_KEY_CACHE_STATISTICS) get_clock_key_cache_statistics,
+};
+
+#endif /* MY_ATOMIC_MODE_RWLOCKS */
+
+
 /****************************************************************************** 
   Key Cache Interface Module
 
   The module contains wrappers for all key cache interface functions. 
   
-  Currently there are key caches of two types: simple key caches and
-  partitioned key caches. Each type (class) has its own implementation of the
-  basic key cache operations used the MyISAM storage engine. The pointers
-  to the implementation functions are stored in two static structures of the
-  type KEY_CACHE_FUNC: simple_key_cache_funcs - for simple key caches, and
-  partitioned_key_cache_funcs - for partitioned key caches. When a key cache
-  object is created the constructor procedure init_key_cache places a pointer
+  Currently there are key caches of three types: simple key caches,
+  partitioned key caches and key caches with CLOCK replacement. Each type
+  (class) has its own implementation of the basic key cache operations used
+  the MyISAM storage engine. The pointers to the implementation functions
+  are stored in static structures of the type KEY_CACHE_FUNC:
+  simple_key_cache_funcs - for simple key caches,
+  partitioned_key_cache_funcs - for partitioned key caches, and
+  clock_key_cache_funcs - for key caches with CLOCK replacement.
+  When a key cache object is created the constructor procedure init_key_cache places a pointer
   to the corresponding table into one of its fields. The procedure also
   initializes a control block for the key cache oject and saves the pointer
   to this block in another field of the key cache object.
@@ -5819,6 +7221,42 @@ int repartition_key_cache_internal(KEY_CACHE *keycache,
                                    uint division_limit, uint age_threshold,
                                    uint partitions, my_bool use_op_lock);
 
+
+/* Get the size of the memory used by the control block of a key cache */
+
+static size_t get_key_cache_cb_mem_size(KEY_CACHE *keycache)
+{
+  switch (keycache->key_cache_type) {
+  case PARTITIONED_KEY_CACHE:
+    return ((PARTITIONED_KEY_CACHE_CB *) keycache->keycache_cb)->
+             key_cache_mem_size;
+#ifndef MY_ATOMIC_MODE_RWLOCKS
+  case CLOCK_KEY_CACHE:
+    return ((CLOCK_KEY_CACHE_CB *) keycache->keycache_cb)->key_cache_mem_size;
+#endif
+  default:
+    return ((SIMPLE_KEY_CACHE_CB *) keycache->keycache_cb)->key_cache_mem_size;
+  }
+}
+
+
+/*
+  Check whether the parameters of a key cache require a key cache of
+  another type or with another number of partitions
+*/
+
+static my_bool key_cache_type_changed(KEY_CACHE *keycache)
+{
+#ifndef MY_ATOMIC_MODE_RWLOCKS
+  /* A key cache with CLOCK replacement ignores the number of partitions */
+  if (keycache->param_clock_replacement ||
+      keycache->key_cache_type == CLOCK_KEY_CACHE)
+    return test(keycache->param_clock_replacement) !=
+           test(keycache->key_cache_type == CLOCK_KEY_CACHE);
+#endif
+  return (uint) keycache->param_partitions != keycache->partitions;
+}
+
 /*
   Initialize a key cache : internal
 
@@ -5864,6 +7302,18 @@ int init_key_cache_internal(KEY_CACHE *keycache, uint key_cache_block_size,
   }
   else
   {
+#ifndef MY_ATOMIC_MODE_RWLOCKS
+    if (keycache->param_clock_replacement)
+    {
+      if (!(keycache_cb= (void *)  my_malloc(sizeof(CLOCK_KEY_CACHE_CB),
+                                             MYF(0)))) 
+        return 0;
+      ((CLOCK_KEY_CACHE_CB *) keycache_cb)->key_cache_inited= 0;
+      keycache->key_cache_type= CLOCK_KEY_CACHE;
+      keycache->interface_funcs= &clock_key_cache_funcs;
+    }
+    else
+#endif
     if (partitions == 0)
     {
       if (!(keycache_cb= (void *)  my_malloc(sizeof(SIMPLE_KEY_CACHE_CB),
@@ -5895,6 +7345,8 @@ int init_key_cache_internal(KEY_CACHE *keycache, uint key_cache_block_size,
       pthread_mutex_lock(&keycache->op_lock);
   }
 
+  if (keycache->key_cache_type != PARTITIONED_KEY_CACHE)
+    partitions= 0;
   if (partitions != 0)
   {
     ((PARTITIONED_KEY_CACHE_CB *) keycache_cb)->partitions= partitions;
@@ -5907,10 +7359,7 @@ int init_key_cache_internal(KEY_CACHE *keycache, uint key_cache_block_size,
                         ((PARTITIONED_KEY_CACHE_CB *) keycache_cb)->partitions :
                         0;
   DBUG_ASSERT(partitions <= MAX_KEY_CACHE_PARTITIONS);
-  keycache->key_cache_mem_size=
-    keycache->partitions ?
-    ((PARTITIONED_KEY_CACHE_CB *) keycache_cb)->key_cache_mem_size :
-    ((SIMPLE_KEY_CACHE_CB *) keycache_cb)->key_cache_mem_size;
+  keycache->key_cache_mem_size= get_key_cache_cb_mem_size(keycache);
   if (blocks > 0)
     keycache->can_be_used= 1;
   if (use_op_lock)
@@ -5936,7 +7385,9 @@ int init_key_cache_internal(KEY_CACHE *keycache, uint key_cache_block_size,
     places the pointer to this block in the structure keycache. 
     If the value of the parameter 'partitions' is 0 then a simple key cache
     is created. Otherwise a partitioned key cache with the specified number
-    of partitions is created.  
+    of partitions is created. If keycache->param_clock_replacement is set,
+    a key cache with CLOCK replacement is created instead, and the value of
+    'partitions' is ignored.
     The parameter key_cache_block_size specifies the size of the blocks in
     the key cache to be created. The parameters division_limit and
     age_threshold determine the initial values of those characteristics of
@@ -6005,7 +7456,7 @@ int resize_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
   if (keycache->key_cache_inited)
   {
     pthread_mutex_lock(&keycache->op_lock);
-    if ((uint) keycache->param_partitions != keycache->partitions && use_mem)
+    if (key_cache_type_changed(keycache) && use_mem)
       blocks= repartition_key_cache_internal(keycache,
                                              key_cache_block_size, use_mem,
                                              division_limit, age_threshold, 
@@ -6023,10 +7474,7 @@ int resize_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
           ((PARTITIONED_KEY_CACHE_CB *)(keycache->keycache_cb))->partitions;
     }
 
-    keycache->key_cache_mem_size=
-    keycache->partitions ?
-    ((PARTITIONED_KEY_CACHE_CB *)(keycache->keycache_cb))->key_cache_mem_size :
-    ((SIMPLE_KEY_CACHE_CB *)(keycache->keycache_cb))->key_cache_mem_size;
+    keycache->key_cache_mem_size= get_key_cache_cb_mem_size(keycache);
 
     keycache->can_be_used= (blocks >= 0);
     pthread_mutex_unlock(&keycache->op_lock);
@@ -22,6 +22,91 @@
 #undef EXTRA_DEBUG
 #define EXTRA_DEBUG
 
+/*
+  Blocks freed by free_root(root, MYF(MY_KEEP_PREALLOC)), which is how the
+  memory of a statement is released, are kept in a cache of the thread
+  instead of being returned to malloc. alloc_root() takes new blocks from
+  this cache first, so that a connection running similar statements does
+  not malloc and free the same blocks over and over. The cache never holds
+  more than what the thread has used at a time, and at most
+  ALLOC_CACHE_SIZE bytes.
+*/
+#define ALLOC_CACHE_SIZE (256*1024)
+
+#if !(defined(HAVE_valgrind) && defined(EXTRA_DEBUG))
+
+/*
+  Get the smallest block of at least 'size' bytes from the cache of the
+  thread. As free_root() resets the block sizes, a statement usually asks
+  for the same sizes as the previous one.
+*/
+
+static USED_MEM *get_cached_block(size_t size)
+{
+  struct st_my_thread_var *thread_var= my_thread_var;
+  USED_MEM *mem, **prev, **best= 0;
+
+  if (!thread_var)
+    return 0;
+  for (prev= &thread_var->alloc_cache; (mem= *prev); prev= &mem->next)
+  {
+    if (mem->size >= size && (!best || mem->size < (*best)->size))
+    {
+      best= prev;
+      if (mem->size == size)
+        break;
+    }
+  }
+  if (!best)
+    return 0;
+  mem= *best;
+  *best= mem->next;
+  thread_var->alloc_cache_size-= mem->size;
+  thread_var->alloc_cache_hits++;
+  return mem;
+}
+#endif
+
+
+/* Free a block of a memory root or keep it in the cache of the thread */
+
+static void free_block(USED_MEM *mem, myf MyFlags)
+{
+#if !(defined(HAVE_valgrind) && defined(EXTRA_DEBUG))
+  struct st_my_thread_var *thread_var;
+  if ((MyFlags & MY_KEEP_PREALLOC) && (thread_var= my_thread_var) &&
+      thread_var->alloc_cache_size + mem->size <= ALLOC_CACHE_SIZE)
+  {
+    mem->next= thread_var->alloc_cache;
+    thread_var->alloc_cache= mem;
+    thread_var->alloc_cache_size+= mem->size;
+    return;
+  }
+#endif
+  my_free(mem);
+}
+
+
+/*
+  Free the blocks cached by a thread
+
+  SYNOPSIS
+    free_alloc_cache()
+    thread_var      Thread, called by my_thread_end()
+*/
+
+void free_alloc_cache(struct st_my_thread_var *thread_var)
+{
+  USED_MEM *next, *old;
+  for (next= thread_var->alloc_cache; next ;)
+  {
+    old= next; next= next->next;
+    my_free(old);
+  }
+  thread_var->alloc_cache= 0;
+  thread_var->alloc_cache_size= 0;
+}
+
 /*
   Initialize memory root
 
@@ -214,7 +299,10 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
     get_size= length+ALIGN_SIZE(sizeof(USED_MEM));
     get_size= max(get_size, block_size);
 
-    if (!(next = (USED_MEM*) my_malloc(get_size,MYF(MY_WME | ME_FATALERROR))))
+    if ((next= get_cached_block(get_size)))
+      get_size= next->size;
+    else if (!(next = (USED_MEM*) my_malloc(get_size,
+                                            MYF(MY_WME | ME_FATALERROR))))
     {
       if (mem_root->error_handler)
 	(*mem_root->error_handler)();
@@ -337,7 +425,9 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 
         MY_MARK_BLOCKS_FREED	Don't free blocks, just mark them free
         MY_KEEP_PREALLOC	If this is not set, then free also the
-        		        preallocated block
+        		        preallocated block. If it is set, the
+                                other blocks may be kept in the cache
+                                of the thread for reuse by alloc_root()
 
   NOTES
     One can call this function either with root block initialised with
@@ -363,13 +453,13 @@ void free_root(MEM_ROOT *root, myf MyFlags)
   {
     old=next; next= next->next ;
     if (old != root->pre_alloc)
-      my_free(old);
+      free_block(old, MyFlags);
   }
   for (next=root->free ; next ;)
   {
     old=next; next= next->next;
     if (old != root->pre_alloc)
-      my_free(old);
+      free_block(old, MyFlags);
   }
   root->used=root->free=0;
   if (root->pre_alloc)
@@ -488,14 +488,15 @@ static PSI_mutex_info all_mysys_mutexes[]=
 };
 
 PSI_cond_key key_COND_alarm, key_IO_CACHE_SHARE_cond,
-  key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
-  key_THR_COND_threads, key_WT_RESOURCE_cond;
+  key_IO_CACHE_SHARE_cond_writer, key_KEY_CACHE_clock_cond,
+  key_my_thread_var_suspend, key_THR_COND_threads, key_WT_RESOURCE_cond;
 
 static PSI_cond_info all_mysys_conds[]=
 {
   { &key_COND_alarm, "COND_alarm", PSI_FLAG_GLOBAL},
   { &key_IO_CACHE_SHARE_cond, "IO_CACHE_SHARE::cond", 0},
   { &key_IO_CACHE_SHARE_cond_writer, "IO_CACHE_SHARE::cond_writer", 0},
+  { &key_KEY_CACHE_clock_cond, "KEY_CACHE::clock_cond", 0},
   { &key_my_thread_var_suspend, "my_thread_var::suspend", 0},
   { &key_THR_COND_threads, "THR_COND_threads", PSI_FLAG_GLOBAL},
   { &key_WT_RESOURCE_cond, "WT_RESOURCE::cond", 0}
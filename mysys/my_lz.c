@@ -0,0 +1,362 @@
+/* Copyright (c) 2013, Monty Program Ab
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  A fast LZ77 compressor without entropy coding, in the spirit of LZ4.
+
+  The compressed data is a sequence of blocks. Each block starts with a
+  token byte: the high 4 bits are the number of literals, the low 4 bits
+  the match length minus MY_LZ_MIN_MATCH. The value 15 in either field
+  means that more length bytes follow, each adding up to 255 (a byte
+  smaller than 255 ends the length). The token is followed by the
+  literal length bytes, the literals, a 2 byte little endian offset of
+  the match and the match length bytes. The last block has literals
+  only, and ends at the end of the compressed data.
+
+  The stream functions compress a buffer that follows earlier data of
+  the same stream, the history, in one memory area. Matches may refer
+  to the last 64K of the history, so that small pieces of a stream,
+  like network packets, still compress well. The history is not part
+  of the compressed data; the decompressing side must have the same
+  history in front of the output buffer.
+*/
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+
+#define MY_LZ_MIN_MATCH   4
+#define MY_LZ_MAX_OFFSET  65535
+#define MY_LZ_HASH_BITS   12
+#define MY_LZ_TABLE_SIZE  (1 << MY_LZ_HASH_BITS)
+#define MY_LZ_RUN_MASK    15
+
+static inline uint32 lz_read32(const uchar *pos)
+{
+  uint32 val;
+  memcpy(&val, pos, sizeof(val));
+  return val;
+}
+
+static inline uint lz_hash(uint32 seq)
+{
+  return (uint) ((seq * 2654435761U) >> (32 - MY_LZ_HASH_BITS));
+}
+
+/* Number of bytes needed to store a length in a token and extra bytes */
+static inline size_t lz_length_bytes(size_t len)
+{
+  return len < MY_LZ_RUN_MASK ? 0 : (len - MY_LZ_RUN_MASK) / 255 + 1;
+}
+
+static inline uchar *lz_store_length(uchar *pos, size_t len)
+{
+  if (len < MY_LZ_RUN_MASK)
+    return pos;
+  for (len-= MY_LZ_RUN_MASK; len >= 255; len-= 255)
+    *pos++= 255;
+  *pos++= (uchar) len;
+  return pos;
+}
+
+
+/*
+  Compress src_len bytes at src. Matches may start at base, which is src
+  or the start of the history in front of src. table holds positions
+  relative to base.
+*/
+
+static size_t lz_compress(const uchar *base, const uchar *src,
+                          size_t src_len, uint32 *table,
+                          uchar *dst, size_t dst_len)
+{
+  const uchar *pos= src, *anchor= src;
+  const uchar *end= src + src_len;
+  uchar *out= dst, *out_end= dst + dst_len;
+  size_t literals;
+
+  while (end - pos >= MY_LZ_MIN_MATCH)
+  {
+    uint32 seq= lz_read32(pos);
+    uint hash= lz_hash(seq);
+    const uchar *ref= base + table[hash];
+    const uchar *match_end;
+    size_t match_len, offset;
+
+    table[hash]= (uint32) (pos - base);
+
+    if (ref >= pos || (size_t) (pos - ref) > MY_LZ_MAX_OFFSET ||
+        lz_read32(ref) != seq)
+    {
+      pos++;
+      continue;
+    }
+
+    for (match_end= pos + MY_LZ_MIN_MATCH, ref+= MY_LZ_MIN_MATCH;
+         match_end < end && *match_end == *ref; match_end++, ref++)
+    {}
+
+    literals= (size_t) (pos - anchor);
+    match_len= (size_t) (match_end - pos) - MY_LZ_MIN_MATCH;
+    offset= (size_t) (match_end - ref);
+
+    if ((size_t) (out_end - out) < 1 + lz_length_bytes(literals) + literals +
+                                   2 + lz_length_bytes(match_len))
+      return 0;
+
+    *out++= (uchar) ((min(literals, MY_LZ_RUN_MASK) << 4) |
+                     min(match_len, MY_LZ_RUN_MASK));
+    out= lz_store_length(out, literals);
+    memcpy(out, anchor, literals);
+    out+= literals;
+    *out++= (uchar) (offset & 255);
+    *out++= (uchar) (offset >> 8);
+    out= lz_store_length(out, match_len);
+
+    pos= anchor= match_end;
+  }
+
+  /* The last block holds the remaining literals */
+  literals= (size_t) (end - anchor);
+  if ((size_t) (out_end - out) < 1 + lz_length_bytes(literals) + literals)
+    return 0;
+  *out++= (uchar) (min(literals, MY_LZ_RUN_MASK) << 4);
+  out= lz_store_length(out, literals);
+  memcpy(out, anchor, literals);
+  out+= literals;
+
+  return (size_t) (out - dst);
+}
+
+
+/**
+  Compress a buffer
+
+  @param src      Data to compress
+  @param src_len  Length of src
+  @param dst      Buffer for the compressed data
+  @param dst_len  Size of dst
+
+  @return Length of the compressed data
+  @retval 0  The compressed data did not fit in dst_len bytes
+*/
+
+size_t my_lz_compress(const uchar *src, size_t src_len,
+                      uchar *dst, size_t dst_len)
+{
+  uint32 table[MY_LZ_TABLE_SIZE];
+  bzero(table, sizeof(table));
+  return lz_compress(src, src, src_len, table, dst, dst_len);
+}
+
+
+/**
+  Init a stream compressor
+
+  @param stream  Stream to init. The history is empty.
+
+  @retval 0  ok
+  @retval 1  out of memory
+*/
+
+my_bool my_lz_stream_init(MY_LZ_STREAM *stream)
+{
+  stream->history= 0;
+  return !(stream->table= (uint32*) my_malloc(MY_LZ_TABLE_SIZE *
+                                              sizeof(uint32),
+                                              MYF(MY_WME | MY_ZEROFILL)));
+}
+
+
+void my_lz_stream_end(MY_LZ_STREAM *stream)
+{
+  my_free(stream->table);
+  stream->table= 0;
+}
+
+
+/**
+  Compress the next part of a stream
+
+  @param stream   Stream
+  @param buf      History of the stream followed by the data to compress
+  @param src_len  Length of the data to compress, at buf + stream->history
+  @param dst      Buffer for the compressed data
+  @param dst_len  Size of dst
+
+  @note
+    The data becomes part of the history, whether it was compressed or
+    not. The caller moves the history with my_lz_stream_shift().
+
+  @return Length of the compressed data
+  @retval 0  The compressed data did not fit in dst_len bytes
+*/
+
+size_t my_lz_stream_compress(MY_LZ_STREAM *stream, const uchar *buf,
+                             size_t src_len, uchar *dst, size_t dst_len)
+{
+  size_t res= lz_compress(buf, buf + stream->history, src_len, stream->table,
+                          dst, dst_len);
+  stream->history+= src_len;
+  return res;
+}
+
+
+/**
+  Note that the history was moved to the start of its buffer
+
+  @param stream  Stream
+  @param shift   Number of bytes removed from the start of the history
+*/
+
+void my_lz_stream_shift(MY_LZ_STREAM *stream, size_t shift)
+{
+  uint32 *pos, *end;
+  DBUG_ASSERT(shift <= stream->history);
+  stream->history-= shift;
+  if (!stream->table)
+    return;
+  /* Positions before the new start are dropped; they fail the match test */
+  for (pos= stream->table, end= pos + MY_LZ_TABLE_SIZE; pos < end; pos++)
+    *pos= *pos >= shift ? *pos - (uint32) shift : 0;
+}
+
+
+/* Read the rest of a length from the extra length bytes */
+static inline const uchar *lz_read_length(const uchar *pos, const uchar *end,
+                                          size_t *len)
+{
+  uint byte;
+  if (*len != MY_LZ_RUN_MASK)
+    return pos;
+  do
+  {
+    if (pos >= end)
+      return NULL;
+    byte= *pos++;
+    *len+= byte;
+  } while (byte == 255);
+  return pos;
+}
+
+
+/*
+  Decompress into dst. Matches may refer back to base, which is dst or
+  the start of the history in front of dst.
+*/
+
+static my_bool lz_decompress(const uchar *src, size_t src_len,
+                             const uchar *base, uchar *dst, size_t *dst_len)
+{
+  const uchar *pos= src, *end= src + src_len;
+  uchar *out= dst, *out_end= dst + *dst_len;
+
+  for (;;)
+  {
+    uint token;
+    size_t literals, match_len, offset;
+    const uchar *ref;
+
+    if (pos >= end)
+      return 1;                                 /* No last block */
+    token= *pos++;
+    literals= token >> 4;
+    match_len= token & MY_LZ_RUN_MASK;
+
+    if (!(pos= lz_read_length(pos, end, &literals)) ||
+        literals > (size_t) (end - pos) ||
+        literals > (size_t) (out_end - out))
+      return 1;
+    memcpy(out, pos, literals);
+    out+= literals;
+    pos+= literals;
+
+    if (pos == end)
+      break;                                    /* The last block */
+
+    if (end - pos < 2)
+      return 1;
+    offset= pos[0] | ((size_t) pos[1] << 8);
+    pos+= 2;
+    if (offset == 0 || offset > (size_t) (out - base))
+      return 1;
+
+    if (!(pos= lz_read_length(pos, end, &match_len)))
+      return 1;
+    match_len+= MY_LZ_MIN_MATCH;
+    if (match_len > (size_t) (out_end - out))
+      return 1;
+
+    ref= out - offset;
+    if (offset >= match_len)
+    {
+      memcpy(out, ref, match_len);
+      out+= match_len;
+    }
+    else
+    {
+      /* Overlapping copy, repeating the last offset bytes */
+      while (match_len--)
+        *out++= *ref++;
+    }
+  }
+
+  *dst_len= (size_t) (out - dst);
+  return 0;
+}
+
+
+/**
+  Decompress data compressed with my_lz_compress()
+
+  @param src      Compressed data
+  @param src_len  Length of src
+  @param dst      Buffer for the decompressed data
+  @param dst_len  in: size of dst, out: length of the decompressed data
+
+  @retval 0  ok
+  @retval 1  src is corrupted, or does not decompress into dst_len bytes
+*/
+
+my_bool my_lz_decompress(const uchar *src, size_t src_len,
+                         uchar *dst, size_t *dst_len)
+{
+  return lz_decompress(src, src_len, dst, dst, dst_len);
+}
+
+
+/**
+  Decompress the next part of a stream compressed with
+  my_lz_stream_compress()
+
+  @param stream   Stream; only the length of the history is used
+  @param src      Compressed data
+  @param src_len  Length of src
+  @param buf      History of the stream. The data is decompressed after it.
+  @param dst_len  in: size of the buffer after the history,
+                  out: length of the decompressed data
+
+  @retval 0  ok. The data is added to the history.
+  @retval 1  src is corrupted, or does not decompress into dst_len bytes
+*/
+
+my_bool my_lz_stream_decompress(MY_LZ_STREAM *stream, const uchar *src,
+                                size_t src_len, uchar *buf, size_t *dst_len)
+{
+  if (lz_decompress(src, src_len, buf, buf + stream->history, dst_len))
+    return 1;
+  stream->history+= *dst_len;
+  return 0;
+}
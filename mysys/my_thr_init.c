@@ -388,6 +388,7 @@ void my_thread_end(void)
 
   if (tmp && tmp->init)
   {
+    free_alloc_cache(tmp);
 #if !defined(DBUG_OFF)
     /* tmp->dbug is allocated inside DBUG library */
     if (tmp->dbug)
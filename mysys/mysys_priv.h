@@ -45,8 +45,8 @@ extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
   key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap;
 
 extern PSI_cond_key key_COND_alarm, key_IO_CACHE_SHARE_cond,
-  key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
-  key_THR_COND_threads;
+  key_IO_CACHE_SHARE_cond_writer, key_KEY_CACHE_clock_cond,
+  key_my_thread_var_suspend, key_THR_COND_threads;
 
 #ifdef USE_ALARM_THREAD
 extern PSI_thread_key key_thread_alarm;
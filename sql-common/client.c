@@ -823,6 +823,23 @@ void free_rows(MYSQL_DATA *cur)
   }
 }
 
+/*
+  Most bytes of queries of mysql_send_queries() that are sent before
+  their results are read. As long as the queries that the server has not
+  read fit in the socket buffers, writing them can't block, even when the
+  server is waiting for the client to read a big result.
+*/
+#define PIPELINE_MAX_IN_FLIGHT 8192
+
+/* Number of queries of mysql_send_queries() with results to read */
+
+static uint pipelined_queries(MYSQL *mysql)
+{
+  struct st_mysql_options_extention *ext= mysql->options.extension;
+  return ext ? ext->pipeline_count - ext->pipeline_read : 0;
+}
+
+
 my_bool
 cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
 		     const uchar *header, ulong header_length,
@@ -840,7 +857,8 @@ cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
       DBUG_RETURN(1);
   }
   if (mysql->status != MYSQL_STATUS_READY ||
-      mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS ||
+      (command != COM_QUIT && pipelined_queries(mysql)))
   {
     DBUG_PRINT("error",("state: %d", mysql->status));
     set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
@@ -1089,6 +1107,12 @@ void end_server(MYSQL *mysql)
     mysql->net.vio= 0;          /* Marker */
     mysql_prune_stmt_list(mysql);
   }
+  if (mysql->options.extension)
+  {
+    struct st_mysql_options_extention *ext= mysql->options.extension;
+    ext->pipeline_count= ext->pipeline_sent= ext->pipeline_read= 0;
+    ext->pipeline_in_flight= 0;
+  }
   net_end(&mysql->net);
   free_old_query(mysql);
   errno= save_errno;
@@ -2448,7 +2472,8 @@ error:
     4           client capabilities
     4           max packet size
     1           charset number
-    23          reserved (always 0)
+    19          reserved (always 0)
+    4           MariaDB extended capabilities
     n           user name, \0-terminated
     n           plugin auth data (e.g. scramble), length (1 byte) coded
     n           database name, \0-terminated
@@ -2465,6 +2490,7 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
   MYSQL *mysql= mpvio->mysql;
   NET *net= &mysql->net;
   char *buff, *end;
+  ulonglong ext_client_flag= 0;
 
   /* see end= buff+32 below, fixed size of the packet is 32 bytes */
   buff= my_alloca(33 + USERNAME_LENGTH + data_len + NAME_LEN + NAME_LEN);
@@ -2495,13 +2521,23 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
   mysql->client_flag&= ~CLIENT_COMPRESS;
 #endif
 
+  /* Prefer the LZ compressed protocol if the server has it */
+  if (mysql->client_flag & CLIENT_COMPRESS)
+    ext_client_flag|= MARIADB_CLIENT_LZ_COMPRESS;
+  /* Allow STMT_ATTR_ARRAY_SIZE if the server has it */
+  ext_client_flag|= MARIADB_CLIENT_STMT_BULK;
+  ext_client_flag&= mysql_server_ext_capabilities(mysql);
+  if (ext_client_flag)
+    mysql->options.extension->ext_client_flag= ext_client_flag;
+
   if (mysql->client_flag & CLIENT_PROTOCOL_41)
   {
     /* 4.1 server and 4.1 client has a 32 byte option flag */
     int4store(buff,mysql->client_flag);
     int4store(buff+4, net->max_packet_size);
     buff[8]= (char) mysql->charset->number;
-    bzero(buff+9, 32-9);
+    bzero(buff+9, 28-9);
+    int4store(buff+28, (uint32) (ext_client_flag >> 32));
     end= buff+32;
   }
   else
@@ -3008,6 +3044,9 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
   mysql->methods= &client_methods;
   net->vio = 0;				/* If something goes wrong */
   mysql->client_flag=0;			/* For handshake */
+  if (mysql->options.extension)
+    mysql->options.extension->server_ext_capabilities=
+      mysql->options.extension->ext_client_flag= 0;
 
   /* use default options */
   if (mysql->options.my_cnf_file || mysql->options.my_cnf_group)
@@ -3375,6 +3414,12 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
     mysql->server_language=end[2];
     mysql->server_status=uint2korr(end+3);
     mysql->server_capabilities|= uint2korr(end+5) << 16;
+    /* MariaDB extended capabilities in the last 4 bytes of the filler */
+    if (uint4korr(end+14))
+    {
+      EXTENSION_SET(&mysql->options, server_ext_capabilities,
+                    ((ulonglong) uint4korr(end+14)) << 32);
+    }
     pkt_scramble_len= end[7];
     if (pkt_scramble_len < 0)
     {
@@ -3469,7 +3514,9 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
   */
 
   if (mysql->client_flag & CLIENT_COMPRESS)      /* We will use compression */
-    net->compress=1;
+    net->compress= ((mysql_ext_client_flag(mysql) &
+                     MARIADB_CLIENT_LZ_COMPRESS) ?
+                    NET_COMPRESS_LZ : NET_COMPRESS_ZLIB);
 
   if (db && !mysql->db && mysql_select_db(mysql, db))
   {
@@ -3704,6 +3751,9 @@ static void mysql_close_free_options(MYSQL *mysql)
     struct mysql_async_context *ctxt= mysql->options.extension->async_context;
     my_free(mysql->options.extension->plugin_dir);
     my_free(mysql->options.extension->default_auth);
+    my_free(mysql->options.extension->pipeline_pkt_nr);
+    my_free(mysql->options.extension->pipeline_lengths);
+    my_free(mysql->options.extension->pipeline_queries);
     if (ctxt)
     {
       my_context_destroy(&ctxt->async_context);
@@ -3865,6 +3915,51 @@ void STDCALL mysql_close(MYSQL *mysql)
 }
 
 
+/*
+  Send the queries of mysql_send_queries() that are not sent yet, as long
+  as at most PIPELINE_MAX_IN_FLIGHT bytes of queries have results that
+  are not read. One query is always sent if no result is outstanding.
+*/
+
+static my_bool send_pipelined_queries(MYSQL *mysql)
+{
+#ifndef EMBEDDED_LIBRARY
+  NET *net= &mysql->net;
+  struct st_mysql_options_extention *ext= mysql->options.extension;
+  DBUG_ENTER("send_pipelined_queries");
+
+  while (ext->pipeline_sent < ext->pipeline_count)
+  {
+    ulong length= ext->pipeline_lengths[ext->pipeline_sent];
+    ulong bytes= length + NET_HEADER_SIZE + 1;
+    if (ext->pipeline_in_flight &&
+        ext->pipeline_in_flight + bytes > PIPELINE_MAX_IN_FLIGHT)
+      break;
+    /* Each query is sent as a new command, with its own packet numbers */
+    net->pkt_nr= net->compress_pkt_nr= 0;
+    if (net_write_command(net, (uchar) COM_QUERY, 0, 0,
+                          (const uchar*) ext->pipeline_next, length))
+    {
+      uint error= (net->last_errno == ER_NET_PACKET_TOO_LARGE ?
+                   CR_NET_PACKET_TOO_LARGE : CR_SERVER_GONE_ERROR);
+      DBUG_PRINT("error",("Can't send command to server. Error: %d",
+                          socket_errno));
+      /* The queries that were sent may run; the connection can't be used */
+      end_server(mysql);
+      set_mysql_error(mysql, error, unknown_sqlstate);
+      DBUG_RETURN(1);
+    }
+    ext->pipeline_pkt_nr[ext->pipeline_sent++]= (uchar) net->pkt_nr;
+    ext->pipeline_next+= length;
+    ext->pipeline_in_flight+= bytes;
+  }
+  DBUG_RETURN(0);
+#else
+  return 0;
+#endif
+}
+
+
 static my_bool cli_read_query_result(MYSQL *mysql)
 {
   uchar *pos;
@@ -3873,6 +3968,26 @@ static my_bool cli_read_query_result(MYSQL *mysql)
   ulong length;
   DBUG_ENTER("cli_read_query_result");
 
+  if (pipelined_queries(mysql) &&
+      !(mysql->server_status & SERVER_MORE_RESULTS_EXISTS))
+  {
+    struct st_mysql_options_extention *ext= mysql->options.extension;
+    if (mysql->status != MYSQL_STATUS_READY)
+    {
+      set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+      DBUG_RETURN(1);
+    }
+    /* The result of the previous query has been read */
+    if (ext->pipeline_read)
+      ext->pipeline_in_flight-=
+        ext->pipeline_lengths[ext->pipeline_read - 1] + NET_HEADER_SIZE + 1;
+    if (send_pipelined_queries(mysql))
+      DBUG_RETURN(1);
+    /* The server started a new packet sequence for each query */
+    mysql->net.pkt_nr= mysql->net.compress_pkt_nr=
+      ext->pipeline_pkt_nr[ext->pipeline_read++];
+  }
+
   if ((length = cli_safe_read(mysql)) == packet_error)
     DBUG_RETURN(1);
   free_old_query(mysql);		/* Free old result */
@@ -3951,6 +4066,96 @@ mysql_send_query(MYSQL* mysql, const char* query, ulong length)
 }
 
 
+/*
+  Send several queries without waiting for their results.
+
+  The server runs the queries one after another, as if they were sent
+  one by one, but the client waits for the network only once. The
+  results must be read in order with one mysql_read_query_result() per
+  query (and mysql_next_result() for more results of one query), each
+  result set fetched or freed before the next one is read. No other
+  command can be sent until all the results have been read.
+  An error in one query does not stop the following ones.
+
+  The queries are copied, and sent ahead only while the ones with unread
+  results take at most PIPELINE_MAX_IN_FLIGHT bytes. The rest are sent by
+  mysql_read_query_result() as the earlier results are read, so the
+  client never waits for the server to read a query while the server
+  waits for the client to read a result.
+*/
+
+int STDCALL
+mysql_send_queries(MYSQL *mysql, const char **queries, const ulong *lengths,
+                   uint count)
+{
+#ifndef EMBEDDED_LIBRARY
+  NET *net= &mysql->net;
+  struct st_mysql_options_extention *ext;
+  uchar *pkt_nr;
+  ulong *pipeline_lengths;
+  char *pos;
+  size_t total= 0;
+  uint i;
+  DBUG_ENTER("mysql_send_queries");
+
+  if (mysql->net.vio == 0 && mysql_reconnect(mysql))
+    DBUG_RETURN(1);
+  if (mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS ||
+      pipelined_queries(mysql))
+  {
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  if (!mysql->options.extension &&
+      !(mysql->options.extension= (struct st_mysql_options_extention *)
+        my_malloc(sizeof(struct st_mysql_options_extention),
+                  MYF(MY_WME | MY_ZEROFILL))))
+    goto oom;
+  ext= mysql->options.extension;
+  ext->pipeline_count= ext->pipeline_sent= ext->pipeline_read= 0;
+  ext->pipeline_in_flight= 0;
+  if (!(pkt_nr= (uchar*) my_realloc(ext->pipeline_pkt_nr, max(count, 1),
+                                    MYF(MY_WME | MY_ALLOW_ZERO_PTR))))
+    goto oom;
+  ext->pipeline_pkt_nr= pkt_nr;
+  if (!(pipeline_lengths= (ulong*) my_realloc(ext->pipeline_lengths,
+                                              max(count, 1) * sizeof(ulong),
+                                              MYF(MY_WME | MY_ALLOW_ZERO_PTR))))
+    goto oom;
+  ext->pipeline_lengths= pipeline_lengths;
+  for (i= 0; i < count; i++)
+    total+= lengths[i];
+  my_free(ext->pipeline_queries);
+  if (!(ext->pipeline_queries= (char*) my_malloc(max(total, 1), MYF(MY_WME))))
+    goto oom;
+  for (i= 0, pos= ext->pipeline_queries; i < count; i++)
+  {
+    memcpy(pos, queries[i], lengths[i]);
+    pos+= lengths[i];
+    pipeline_lengths[i]= lengths[i];
+  }
+  ext->pipeline_next= ext->pipeline_queries;
+
+  net_clear_error(net);
+  mysql->info=0;
+  mysql->affected_rows= ~(my_ulonglong) 0;
+  net_clear(net, 1);
+
+  ext->pipeline_count= count;
+  DBUG_RETURN((int) send_pipelined_queries(mysql));
+
+oom:
+  set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+  DBUG_RETURN(1);
+#else
+  DBUG_ENTER("mysql_send_queries");
+  set_mysql_error(mysql, CR_NOT_IMPLEMENTED, unknown_sqlstate);
+  DBUG_RETURN(1);
+#endif
+}
+
+
 int STDCALL
 mysql_real_query(MYSQL *mysql, const char *query, ulong length)
 {
@@ -119,6 +119,8 @@ KEY_CACHE *create_key_cache(const char *name, uint length)
       key_cache->param_division_limit= dflt_key_cache_var.param_division_limit;
       key_cache->param_age_threshold=  dflt_key_cache_var.param_age_threshold;
       key_cache->param_partitions=     dflt_key_cache_var.param_partitions;
+      key_cache->param_clock_replacement=
+        dflt_key_cache_var.param_clock_replacement;
     }
   }
   DBUG_RETURN(key_cache);
@@ -16,7 +16,7 @@
 
 #include "sql_class.h"
 #include "debug_sync.h"
-#include <hash.h>
+#include <lf.h>
 #include <mysqld_error.h>
 #include <mysql/plugin.h>
 #include <mysql/service_thd_wait.h>
@@ -91,8 +91,7 @@ const char *MDL_key::m_namespace_to_wait_state_name[NAMESPACE_END]=
 static bool mdl_initialized= 0;
 
 
-class MDL_object_lock;
-class MDL_object_lock_cache_adapter;
+class MDL_lock_cache_adapter;
 
 
 /**
@@ -106,34 +105,54 @@ class MDL_map
 public:
   void init();
   void destroy();
-  MDL_lock *find_or_insert(const MDL_key *key);
-  void remove(MDL_lock *lock);
+  MDL_lock *find_or_insert(LF_PINS *pins, LF_PINS *lock_pins,
+                           const MDL_key *key);
+  void remove(LF_PINS *pins, LF_PINS *lock_pins, MDL_lock *lock);
+  LF_PINS *get_pins() { return lf_hash_get_pins(&m_locks); }
+  LF_PINS *get_lock_pins() { return lf_pinbox_get_pins(&m_lock_pinbox); }
 private:
-  bool move_from_hash_to_lock_mutex(MDL_lock *lock);
+  MDL_lock *get_unused_lock(const MDL_key *key);
+  void put_unused_lock(LF_PINS *lock_pins, MDL_lock *lock);
 private:
-  /** All acquired locks in the server. */
-  HASH m_locks;
-  /* Protects access to m_locks hash. */
+  /**
+    All acquired locks in the server. The elements of the lock-free hash
+    are pointers to MDL_lock objects, so that looking up a lock does not
+    serialize on any mutex.
+
+    A thread which has found a lock in the hash pins the MDL_lock object
+    in m_lock_pinbox, and checks that the element of the hash still
+    points to it, before it uses the object. The element is set to NULL
+    before the lock is removed from the hash. So the object cannot be
+    freed while the thread uses it, though it can be re-used for another
+    key. The thread therefore locks MDL_lock::m_rwlock and checks
+    MDL_lock::m_is_in_hash and the key to see if the object still
+    represents the lock it was looking for.
+  */
+  LF_HASH m_locks;
+  /**
+    Pins for the MDL_lock objects found in m_locks. The objects which do
+    not fit in the lists of unused objects go to the purgatory of the
+    pins of the thread that removed them, and are freed once no thread
+    has them pinned.
+  */
+  LF_PINBOX m_lock_pinbox;
+  /* Protects the lists of unused objects. */
   mysql_mutex_t m_mutex;
   /**
-    Cache of (unused) MDL_lock objects available for re-use.
-
-    On some systems (e.g. Windows XP) constructing/destructing
-    MDL_lock objects can be fairly expensive. We use this cache
-    to avoid these costs in scenarios in which they can have
-    significant negative effect on performance. For example, when
-    there is only one thread constantly executing statements in
-    auto-commit mode and thus constantly causing creation/
-    destruction of MDL_lock objects for the tables it uses.
+    Lists of (unused) MDL_lock objects available for re-use, one for
+    MDL_object_lock and one for MDL_scoped_lock objects. Each list keeps
+    at most mdl_locks_cache_size objects.
 
-    Note that this cache contains only MDL_object_lock objects.
+    Besides making the re-use of the objects possible, this also avoids
+    the costs of constructing/destructing MDL_lock objects, which can be
+    fairly expensive on some systems (e.g. Windows XP).
 
     Protected by m_mutex mutex.
   */
-  typedef I_P_List<MDL_object_lock, MDL_object_lock_cache_adapter,
-                   I_P_List_counter>
-          Lock_cache;
+  typedef I_P_List<MDL_lock, MDL_lock_cache_adapter,
+                   I_P_List_counter> Lock_cache;
   Lock_cache m_unused_locks_cache;
+  Lock_cache m_unused_scoped_locks_cache;
   /** Pre-allocated MDL_lock object for GLOBAL namespace. */
   MDL_lock *m_global_lock;
   /** Pre-allocated MDL_lock object for COMMIT namespace. */
@@ -385,7 +404,8 @@ public:
 
   void reschedule_waiters();
 
-  void remove_ticket(Ticket_list MDL_lock::*queue, MDL_ticket *ticket);
+  void remove_ticket(LF_PINS *pins, LF_PINS *lock_pins,
+                     Ticket_list MDL_lock::*queue, MDL_ticket *ticket);
 
   bool visit_subgraph(MDL_ticket *waiting_ticket,
                       MDL_wait_for_graph_visitor *gvisitor);
@@ -411,10 +431,7 @@ public:
   MDL_lock(const MDL_key *key_arg)
   : key(key_arg),
     m_hog_lock_count(0),
-    m_ref_usage(0),
-    m_ref_release(0),
-    m_is_destroyed(FALSE),
-    m_version(0)
+    m_is_in_hash(FALSE)
   {
     mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock);
   }
@@ -424,47 +441,44 @@ public:
     mysql_prlock_destroy(&m_rwlock);
   }
   inline static void destroy(MDL_lock *lock);
+
+  /**
+    Reset unused MDL_lock object to represent the lock context for a
+    different object.
+  */
+  void reset(const MDL_key *new_key)
+  {
+    /* We need to change only object's key. */
+    key.mdl_key_init(new_key);
+    /* m_granted and m_waiting should be already in the empty/initial state. */
+    DBUG_ASSERT(is_empty());
+    DBUG_ASSERT(! m_is_in_hash);
+  }
 public:
   /**
-    These three members are used to make it possible to separate
-    the mdl_locks.m_mutex mutex and MDL_lock::m_rwlock in
-    MDL_map::find_or_insert() for increased scalability.
-    The 'm_is_destroyed' member is only set by destroyers that
-    have both the mdl_locks.m_mutex and MDL_lock::m_rwlock, thus
-    holding any of the mutexes is sufficient to read it.
-    The 'm_ref_usage; is incremented under protection by
-    mdl_locks.m_mutex, but when 'm_is_destroyed' is set to TRUE, this
-    member is moved to be protected by the MDL_lock::m_rwlock.
-    This means that the MDL_map::find_or_insert() which only
-    holds the MDL_lock::m_rwlock can compare it to 'm_ref_release'
-    without acquiring mdl_locks.m_mutex again and if equal it can also
-    destroy the lock object safely.
-    The 'm_ref_release' is incremented under protection by
-    MDL_lock::m_rwlock.
-    Note since we are only interested in equality of these two
-    counters we don't have to worry about overflows as long as
-    their size is big enough to hold maximum number of concurrent
-    threads on the system.
+    TRUE while the object is in MDL_map::m_locks hash, i.e. it represents
+    the lock for the object given by its key. Protected by m_rwlock.
+    Threads which have found the object in the hash check it after
+    acquiring m_rwlock, as the object may have been removed from the hash
+    and even re-used for another key while they held no locks.
   */
-  uint m_ref_usage;
-  uint m_ref_release;
-  bool m_is_destroyed;
+  bool m_is_in_hash;
   /**
-    We use the same idea and an additional version counter to support
-    caching of unused MDL_lock object for further re-use.
-    This counter is incremented while holding both MDL_map::m_mutex and
-    MDL_lock::m_rwlock locks each time when a MDL_lock is moved from
-    the hash to the unused objects list (or destroyed).
-    A thread, which has found a MDL_lock object for the key in the hash
-    and then released the MDL_map::m_mutex before acquiring the
-    MDL_lock::m_rwlock, can determine that this object was moved to the
-    unused objects list (or destroyed) while it held no locks by comparing
-    the version value which it read while holding the MDL_map::m_mutex
-    with the value read after acquiring the MDL_lock::m_rwlock.
-    Note that since it takes several years to overflow this counter such
-    theoretically possible overflows should not have any practical effects.
+    Members for linking the object into the list of unused objects.
+    next_in_cache also links the object into a purgatory of
+    MDL_map::m_lock_pinbox.
   */
-  ulonglong m_version;
+  MDL_lock *next_in_cache, **prev_in_cache;
+};
+
+
+/**
+  Helper class for linking MDL_lock objects into the lists of unused objects.
+*/
+class MDL_lock_cache_adapter :
+      public I_P_List_adapter<MDL_lock, &MDL_lock::next_in_cache,
+                              &MDL_lock::prev_in_cache>
+{
 };
 
 
@@ -522,26 +536,6 @@ public:
     : MDL_lock(key_arg)
   { }
 
-  /**
-    Reset unused MDL_object_lock object to represent the lock context for a
-    different object.
-  */
-  void reset(const MDL_key *new_key)
-  {
-    /* We need to change only object's key. */
-    key.mdl_key_init(new_key);
-    /* m_granted and m_waiting should be already in the empty/initial state. */
-    DBUG_ASSERT(is_empty());
-    /* Object should not be marked as destroyed. */
-    DBUG_ASSERT(! m_is_destroyed);
-    /*
-      Values of the rest of the fields should be preserved between old and
-      new versions of the object. E.g., m_version and m_ref_usage/release
-      should be kept intact to properly handle possible remaining references
-      to the old version of the object.
-    */
-  }
-
   virtual const bitmap_t *incompatible_granted_types_bitmap() const
   {
     return m_granted_incompatible;
@@ -571,26 +565,14 @@ public:
 private:
   static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
   static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
-
-public:
-  /** Members for linking the object into the list of unused objects. */
-  MDL_object_lock *next_in_cache, **prev_in_cache;
-};
-
-
-/**
-  Helper class for linking MDL_object_lock objects into the unused objects list.
-*/
-class MDL_object_lock_cache_adapter :
-      public I_P_List_adapter<MDL_object_lock, &MDL_object_lock::next_in_cache,
-                              &MDL_object_lock::prev_in_cache>
-{
 };
 
 
 static MDL_map mdl_locks;
 /**
-  Start-up parameter for the maximum size of the unused MDL_lock objects cache.
+  Start-up parameter for the number of unused MDL_object_lock objects
+  which are created in advance, and the maximum number of unused objects
+  of each kind which are kept for re-use.
 */
 ulong mdl_locks_cache_size;
 
@@ -601,10 +583,30 @@ static uchar *
 mdl_locks_key(const uchar *record, size_t *length,
               my_bool not_used __attribute__((unused)))
 {
-  MDL_lock *lock=(MDL_lock*) record;
+  MDL_lock *lock= *(MDL_lock**) record;
   *length= lock->key.length();
   return (uchar*) lock->key.ptr();
 }
+
+
+/**
+  Free the MDL_lock objects from first to last, linked through
+  next_in_cache, which are no longer pinned by any thread.
+*/
+
+static void mdl_lock_free(void *first, void *last,
+                          void *arg __attribute__((unused)))
+{
+  MDL_lock *lock= (MDL_lock*) first, *next;
+  for (;;)
+  {
+    next= lock->next_in_cache;
+    MDL_lock::destroy(lock);
+    if (lock == last)
+      break;
+    lock= next;
+  }
+}
 } /* extern "C" */
 
 
@@ -655,12 +657,27 @@ void MDL_map::init()
 {
   MDL_key global_lock_key(MDL_key::GLOBAL, "", "");
   MDL_key commit_lock_key(MDL_key::COMMIT, "", "");
+  MDL_key unused_lock_key(MDL_key::TABLE, "", "");
+  MDL_lock *lock;
 
   mysql_mutex_init(key_MDL_map_mutex, &m_mutex, NULL);
-  my_hash_init(&m_locks, &my_charset_bin, 16 /* FIXME */, 0, 0,
-               mdl_locks_key, 0, 0);
+  lf_hash_init(&m_locks, sizeof(MDL_lock*), LF_HASH_UNIQUE, 0, 0,
+               mdl_locks_key, &my_charset_bin);
+  lf_pinbox_init(&m_lock_pinbox, my_offsetof(MDL_lock, next_in_cache),
+                 mdl_lock_free, NULL);
   m_global_lock= MDL_lock::create(&global_lock_key);
   m_commit_lock= MDL_lock::create(&commit_lock_key);
+
+  /*
+    Create the unused objects in advance, so that the cache does not need
+    to grow under the load.
+  */
+  for (ulong i= 0; i < mdl_locks_cache_size; i++)
+  {
+    if (!(lock= MDL_lock::create(&unused_lock_key)))
+      break;
+    m_unused_locks_cache.push_front(lock);
+  }
 }
 
 
@@ -671,15 +688,81 @@ void MDL_map::init()
 
 void MDL_map::destroy()
 {
-  DBUG_ASSERT(!m_locks.records);
+  MDL_lock *lock;
+
+  DBUG_ASSERT(!my_atomic_load32(&m_locks.count));
   mysql_mutex_destroy(&m_mutex);
-  my_hash_free(&m_locks);
+  lf_hash_destroy(&m_locks);
+  lf_pinbox_destroy(&m_lock_pinbox);
   MDL_lock::destroy(m_global_lock);
   MDL_lock::destroy(m_commit_lock);
 
-  MDL_object_lock *lock;
   while ((lock= m_unused_locks_cache.pop_front()))
     MDL_lock::destroy(lock);
+  while ((lock= m_unused_scoped_locks_cache.pop_front()))
+    MDL_lock::destroy(lock);
+}
+
+
+/**
+  Get an unused MDL_lock object of the type needed for the key, or create
+  a new one if there is none.
+
+  @retval non-NULL - Success. MDL_lock object with the key set, which is
+                     not in the hash.
+  @retval NULL     - Failure (OOM).
+*/
+
+MDL_lock *MDL_map::get_unused_lock(const MDL_key *mdl_key)
+{
+  MDL_lock *lock;
+  Lock_cache *cache= (mdl_key->mdl_namespace() == MDL_key::SCHEMA ?
+                      &m_unused_scoped_locks_cache : &m_unused_locks_cache);
+
+  mysql_mutex_lock(&m_mutex);
+  lock= cache->pop_front();
+  mysql_mutex_unlock(&m_mutex);
+
+  if (!lock)
+    return MDL_lock::create(mdl_key);
+
+  /*
+    Threads which have found the object in the hash before it was removed
+    from there only look at its key after they have seen that
+    m_is_in_hash is set, so the key can be changed without locking.
+  */
+  lock->reset(mdl_key);
+  return lock;
+}
+
+
+/**
+  Put an MDL_lock object, which is not in the hash, to the list of
+  unused objects for re-use. If the list is full, the object is freed
+  once no thread has it pinned.
+
+  @param lock_pins  Pins of the calling context for MDL_lock objects.
+  @param lock       The object.
+*/
+
+void MDL_map::put_unused_lock(LF_PINS *lock_pins, MDL_lock *lock)
+{
+  Lock_cache *cache;
+  DBUG_ASSERT(lock->key.mdl_namespace() != MDL_key::GLOBAL &&
+              lock->key.mdl_namespace() != MDL_key::COMMIT);
+
+  cache= (lock->key.mdl_namespace() == MDL_key::SCHEMA ?
+          &m_unused_scoped_locks_cache : &m_unused_locks_cache);
+  mysql_mutex_lock(&m_mutex);
+  if (cache->elements() < mdl_locks_cache_size)
+  {
+    cache->push_front(lock);
+    lock= NULL;
+  }
+  mysql_mutex_unlock(&m_mutex);
+
+  if (lock)
+    lf_pinbox_free(lock_pins, lock);
 }
 
 
@@ -687,23 +770,28 @@ void MDL_map::destroy()
   Find MDL_lock object corresponding to the key, create it
   if it does not exist.
 
+  @param pins       Pins of the calling context for m_locks hash.
+  @param lock_pins  Pins of the calling context for MDL_lock objects.
+  @param mdl_key    Key of the lock.
+
   @retval non-NULL - Success. MDL_lock instance for the key with
                      locked MDL_lock::m_rwlock.
   @retval NULL     - Failure (OOM).
 */
 
-MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
+MDL_lock* MDL_map::find_or_insert(LF_PINS *pins, LF_PINS *lock_pins,
+                                  const MDL_key *mdl_key)
 {
-  MDL_lock *lock;
-  my_hash_value_type hash_value;
+  MDL_lock *lock, **found;
+  int res;
 
   if (mdl_key->mdl_namespace() == MDL_key::GLOBAL ||
       mdl_key->mdl_namespace() == MDL_key::COMMIT)
   {
     /*
-      Avoid locking m_mutex when lock for GLOBAL or COMMIT namespace is
+      Avoid looking up the hash when lock for GLOBAL or COMMIT namespace is
       requested. Return pointer to pre-allocated MDL_lock instance instead.
-      Such an optimization allows to save one mutex lock/unlock for any
+      Such an optimization allows to save one hash lookup for any
       statement changing data.
 
       It works since these namespaces contain only one element so keys
@@ -719,151 +807,88 @@ MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
     return lock;
   }
 
-
-  hash_value= my_calc_hash(&m_locks, mdl_key->ptr(), mdl_key->length());
-
 retry:
-  mysql_mutex_lock(&m_mutex);
-  if (!(lock= (MDL_lock*) my_hash_search_using_hash_value(&m_locks,
-                                                          hash_value,
-                                                          mdl_key->ptr(),
-                                                          mdl_key->length())))
-  {
-    MDL_object_lock *unused_lock= NULL;
+  found= (MDL_lock**) lf_hash_search(&m_locks, pins, mdl_key->ptr(),
+                                     mdl_key->length());
+  if (found == MY_ERRPTR)
+    return NULL;
 
+  if (found)
+  {
     /*
-      No lock object found so we need to create a new one
-      or reuse an existing unused object.
+      Pin the object, then check that it has not been removed from the
+      hash meanwhile, which sets the element to NULL first. After that it
+      can't be freed until it is unpinned.
     */
-    if (mdl_key->mdl_namespace() != MDL_key::SCHEMA &&
-        m_unused_locks_cache.elements())
+    lock= (MDL_lock*) my_atomic_loadptr((void* volatile*) found);
+    if (lock)
     {
-      /*
-        We need a MDL_object_lock type of object and the unused objects
-        cache has some. Get the first object from the cache and set a new
-        key for it.
-      */
-      DBUG_ASSERT(mdl_key->mdl_namespace() != MDL_key::GLOBAL &&
-                  mdl_key->mdl_namespace() != MDL_key::COMMIT);
-
-      unused_lock= m_unused_locks_cache.pop_front();
-      unused_lock->reset(mdl_key);
-
-      lock= unused_lock;
+      lf_pin(lock_pins, 0, lock);
+      if (my_atomic_loadptr((void* volatile*) found) != lock)
+        lock= NULL;
     }
-    else
+    lf_hash_search_unpin(pins);
+    if (!lock)
     {
-      lock= MDL_lock::create(mdl_key);
+      /* The lock is being removed; look up or insert it again. */
+      lf_unpin(lock_pins, 0);
+      goto retry;
     }
 
-    if (!lock || my_hash_insert(&m_locks, (uchar*)lock))
+    /*
+      The object could have been removed from the hash (and even re-used
+      for another key) while we held no locks. As it is pinned, it is safe
+      to lock it and check that.
+    */
+    mysql_prlock_wrlock(&lock->m_rwlock);
+    if (unlikely(!lock->m_is_in_hash || !lock->key.is_equal(mdl_key)))
     {
-      if (unused_lock)
-      {
-        /*
-          Note that we can't easily destroy an object from cache here as it
-          still might be referenced by other threads. So we simply put it
-          back into the cache.
-        */
-        m_unused_locks_cache.push_front(unused_lock);
-      }
-      else
-      {
-        MDL_lock::destroy(lock);
-      }
-      mysql_mutex_unlock(&m_mutex);
-      return NULL;
+      mysql_prlock_unlock(&lock->m_rwlock);
+      lf_unpin(lock_pins, 0);
+      goto retry;
     }
+    /* While we hold m_rwlock the object stays in the hash. */
+    lf_unpin(lock_pins, 0);
+    return lock;
   }
 
-  if (move_from_hash_to_lock_mutex(lock))
-    goto retry;
-
-  return lock;
-}
-
-
-/**
-  Release mdl_locks.m_mutex mutex and lock MDL_lock::m_rwlock for lock
-  object from the hash. Handle situation when object was released
-  while we held no locks.
-
-  @retval FALSE - Success.
-  @retval TRUE  - Object was released while we held no mutex, caller
-                  should re-try looking up MDL_lock object in the hash.
-*/
-
-bool MDL_map::move_from_hash_to_lock_mutex(MDL_lock *lock)
-{
-  ulonglong version;
-
-  DBUG_ASSERT(! lock->m_is_destroyed);
-  mysql_mutex_assert_owner(&m_mutex);
-
   /*
-    We increment m_ref_usage which is a reference counter protected by
-    mdl_locks.m_mutex under the condition it is present in the hash and
-    m_is_destroyed is FALSE.
+    No lock object found so we need to create a new one or reuse an
+    existing unused object. It is inserted with locked m_rwlock, so that
+    other threads which find it wait until we are done with it.
   */
-  lock->m_ref_usage++;
-  /* Read value of the version counter under protection of m_mutex lock. */
-  version= lock->m_version;
-  mysql_mutex_unlock(&m_mutex);
+  if (!(lock= get_unused_lock(mdl_key)))
+    return NULL;
 
   mysql_prlock_wrlock(&lock->m_rwlock);
-  lock->m_ref_release++;
-
-  if (unlikely(lock->m_version != version))
+  if ((res= lf_hash_insert(&m_locks, pins, &lock)))
   {
-    /*
-      If the current value of version differs from one that was read while
-      we held m_mutex mutex, this MDL_lock object was moved to the unused
-      objects list or destroyed while we held no locks.
-      We should retry our search. But first we should destroy the MDL_lock
-      object if necessary.
-    */
-    if (unlikely(lock->m_is_destroyed))
-    {
-      /*
-        Object was released while we held no locks, we need to
-        release it if no others hold references to it, while our own
-        reference count ensured that the object as such haven't got
-        its memory released yet. We can also safely compare
-        m_ref_usage and m_ref_release since the object is no longer
-        present in the hash (or unused objects list) so no one will
-        be able to find it and increment m_ref_usage anymore.
-      */
-      uint ref_usage= lock->m_ref_usage;
-      uint ref_release= lock->m_ref_release;
-      mysql_prlock_unlock(&lock->m_rwlock);
-      if (ref_usage == ref_release)
-        MDL_lock::destroy(lock);
-    }
-    else
+    mysql_prlock_unlock(&lock->m_rwlock);
+    put_unused_lock(lock_pins, lock);
+    if (res > 0)
     {
-      /*
-        Object was not destroyed but its version has changed.
-        This means that it was moved to the unused objects list
-        (and even might be already re-used). So now it might
-        correspond to a different key, therefore we should simply
-        retry our search.
-      */
-      mysql_prlock_unlock(&lock->m_rwlock);
+      /* Some other thread has inserted a lock for the key meanwhile. */
+      goto retry;
     }
-    return TRUE;
+    return NULL;
   }
-  return FALSE;
+  lock->m_is_in_hash= TRUE;
+  return lock;
 }
 
 
 /**
-  Destroy MDL_lock object or delegate this responsibility to
-  whatever thread that holds the last outstanding reference to
-  it.
+  Remove MDL_lock object from the hash and put it to the list of
+  unused objects.
+
+  @pre MDL_lock::m_rwlock is locked, the lock has no tickets.
+  @post MDL_lock::m_rwlock is unlocked.
 */
 
-void MDL_map::remove(MDL_lock *lock)
+void MDL_map::remove(LF_PINS *pins, LF_PINS *lock_pins, MDL_lock *lock)
 {
+  MDL_lock **found;
+
   if (lock->key.mdl_namespace() == MDL_key::GLOBAL ||
       lock->key.mdl_namespace() == MDL_key::COMMIT)
   {
@@ -875,65 +900,27 @@ void MDL_map::remove(MDL_lock *lock)
     return;
   }
 
-  mysql_mutex_lock(&m_mutex);
-  my_hash_delete(&m_locks, (uchar*) lock);
+  DBUG_ASSERT(lock->m_is_in_hash);
   /*
-    To let threads holding references to the MDL_lock object know that it was
-    moved to the list of unused objects or destroyed, we increment the version
-    counter under protection of both MDL_map::m_mutex and MDL_lock::m_rwlock
-    locks. This allows us to read the version value while having either one
-    of those locks.
+    Threads which look up the lock from now on don't use the object, and
+    those which have pinned it before see that it is no longer in the
+    hash once they acquire m_rwlock. No other thread can remove the lock
+    or insert one for the key while we hold m_rwlock, so the search
+    can't fail.
   */
-  lock->m_version++;
-
-  if ((lock->key.mdl_namespace() != MDL_key::SCHEMA) &&
-      (m_unused_locks_cache.elements() < mdl_locks_cache_size))
+  found= (MDL_lock**) lf_hash_search(&m_locks, pins, lock->key.ptr(),
+                                     lock->key.length());
+  DBUG_ASSERT(found && found != MY_ERRPTR && *found == lock);
+  if (found && found != MY_ERRPTR)
   {
-    /*
-      This is an object of MDL_object_lock type and the cache of unused
-      objects has not reached its maximum size yet. So instead of destroying
-      object we move it to the list of unused objects to allow its later
-      re-use with possibly different key. Any threads holding references to
-      this object (owning MDL_map::m_mutex or MDL_lock::m_rwlock) will notice
-      this thanks to the fact that we have changed the MDL_lock::m_version
-      counter.
-    */
-    DBUG_ASSERT(lock->key.mdl_namespace() != MDL_key::GLOBAL &&
-                lock->key.mdl_namespace() != MDL_key::COMMIT);
-
-    m_unused_locks_cache.push_front((MDL_object_lock*)lock);
-    mysql_mutex_unlock(&m_mutex);
-    mysql_prlock_unlock(&lock->m_rwlock);
+    my_atomic_storeptr((void* volatile*) found, NULL);
+    lf_hash_search_unpin(pins);
   }
-  else
-  {
-    /*
-      Destroy the MDL_lock object, but ensure that anyone that is
-      holding a reference to the object is not remaining, if so he
-      has the responsibility to release it.
-
-      Setting of m_is_destroyed to TRUE while holding _both_
-      mdl_locks.m_mutex and MDL_lock::m_rwlock mutexes transfers the
-      protection of m_ref_usage from mdl_locks.m_mutex to
-      MDL_lock::m_rwlock while removal of the object from the hash
-      (and cache of unused objects) makes it read-only. Therefore
-      whoever acquires MDL_lock::m_rwlock next will see the most up
-      to date version of m_ref_usage.
-
-      This means that when m_is_destroyed is TRUE and we hold the
-      MDL_lock::m_rwlock we can safely read the m_ref_usage
-      member.
-    */
-    uint ref_usage, ref_release;
+  lf_hash_delete(&m_locks, pins, lock->key.ptr(), lock->key.length());
+  lock->m_is_in_hash= FALSE;
+  mysql_prlock_unlock(&lock->m_rwlock);
 
-    lock->m_is_destroyed= TRUE;
-    ref_usage= lock->m_ref_usage;
-    ref_release= lock->m_ref_release;
-    mysql_mutex_unlock(&m_mutex);
-    mysql_prlock_unlock(&lock->m_rwlock);
-    if (ref_usage == ref_release)
-      MDL_lock::destroy(lock);
-  }
+  put_unused_lock(lock_pins, lock);
 }
 
 
@@ -946,7 +933,9 @@ void MDL_map::remove(MDL_lock *lock)
 MDL_context::MDL_context()
   : m_thd(NULL),
   m_needs_thr_lock_abort(FALSE),
-  m_waiting_for(NULL)
+  m_waiting_for(NULL),
+  m_pins(NULL),
+  m_lock_pins(NULL)
 {
   mysql_prlock_init(key_MDL_context_LOCK_waiting_for, &m_LOCK_waiting_for);
 }
@@ -971,6 +960,30 @@ void MDL_context::destroy()
               m_tickets[MDL_EXPLICIT].is_empty());
 
   mysql_prlock_destroy(&m_LOCK_waiting_for);
+  if (m_pins)
+    lf_hash_put_pins(m_pins);
+  if (m_lock_pins)
+    lf_pinbox_put_pins(m_lock_pins);
+}
+
+
+/**
+  Get the pins of this context for the hash of all MDL locks and for
+  the MDL_lock objects, if it does not have them yet.
+
+  @retval FALSE  Success.
+  @retval TRUE   Failure (OOM).
+*/
+
+bool MDL_context::fix_pins()
+{
+  if ((!m_pins && !(m_pins= mdl_locks.get_pins())) ||
+      (!m_lock_pins && !(m_lock_pins= mdl_locks.get_lock_pins())))
+  {
+    my_error(ER_OUT_OF_RESOURCES, MYF(0));
+    return TRUE;
+  }
+  return FALSE;
 }
 
 
@@ -1623,12 +1636,13 @@ MDL_lock::can_grant_lock(enum_mdl_type type_arg,
 
 /** Remove a ticket from waiting or pending queue and wakeup up waiters. */
 
-void MDL_lock::remove_ticket(Ticket_list MDL_lock::*list, MDL_ticket *ticket)
+void MDL_lock::remove_ticket(LF_PINS *pins, LF_PINS *lock_pins,
+                             Ticket_list MDL_lock::*list, MDL_ticket *ticket)
 {
   mysql_prlock_wrlock(&m_rwlock);
   (this->*list).remove_ticket(ticket);
   if (is_empty())
-    mdl_locks.remove(this);
+    mdl_locks.remove(pins, lock_pins, this);
   else
   {
     /*
@@ -1877,6 +1891,9 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
     return FALSE;
   }
 
+  if (fix_pins())
+    return TRUE;
+
   if (!(ticket= MDL_ticket::create(this, mdl_request->type
 #ifndef DBUG_OFF
                                    , mdl_request->duration
@@ -1885,7 +1902,7 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
     return TRUE;
 
   /* The below call implicitly locks MDL_lock::m_rwlock on success. */
-  if (!(lock= mdl_locks.find_or_insert(key)))
+  if (!(lock= mdl_locks.find_or_insert(m_pins, m_lock_pins, key)))
   {
     MDL_ticket::destroy(ticket);
     return TRUE;
@@ -1929,6 +1946,15 @@ MDL_context::clone_ticket(MDL_request *mdl_request)
   MDL_ticket *ticket;
 
   mysql_mutex_assert_not_owner(&LOCK_open);
+
+  /*
+    The clone is released through the hash of all MDL locks, so the
+    context needs pins even if it has never acquired a lock itself,
+    as in the INSERT DELAYED handler thread.
+  */
+  if (fix_pins())
+    return TRUE;
+
   /*
     By submitting mdl_request->type to MDL_ticket::create()
     we effectively downgrade the cloned lock to the level of
@@ -2126,7 +2152,7 @@ MDL_context::acquire_lock(MDL_request *mdl_request, ulong lock_wait_timeout)
 
   if (wait_status != MDL_wait::GRANTED)
   {
-    lock->remove_ticket(&MDL_lock::m_waiting, ticket);
+    lock->remove_ticket(m_pins, m_lock_pins, &MDL_lock::m_waiting, ticket);
     MDL_ticket::destroy(ticket);
     switch (wait_status)
     {
@@ -2577,9 +2603,11 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
                                         lock->key.name()));
 
   DBUG_ASSERT(this == ticket->get_ctx());
+  /* Every way to get a ticket into this context sets up the pins. */
+  DBUG_ASSERT(m_pins && m_lock_pins);
   mysql_mutex_assert_not_owner(&LOCK_open);
 
-  lock->remove_ticket(&MDL_lock::m_granted, ticket);
+  lock->remove_ticket(m_pins, m_lock_pins, &MDL_lock::m_granted, ticket);
 
   m_tickets[duration].remove(ticket);
   MDL_ticket::destroy(ticket);
@@ -29,6 +29,7 @@
 #include <my_pthread.h>
 #include <m_string.h>
 #include <mysql_com.h>
+#include <lf.h>
 
 class THD;
 
@@ -406,17 +407,16 @@ public:
 
   virtual bool inspect_edge(MDL_context *dest) = 0;
   virtual ~MDL_wait_for_graph_visitor();
-  MDL_wait_for_graph_visitor() :m_lock_open_count(0) {}
+  MDL_wait_for_graph_visitor() :m_table_cache_lock_count(0) {}
 public:
   /**
    XXX, hack: During deadlock search, we may need to
-   inspect TABLE_SHAREs and acquire LOCK_open. Since
-   LOCK_open is not a recursive mutex, count here how many
-   times we "took" it (but only take and release once).
-   Not using a native recursive mutex or rwlock in 5.5 for
-   LOCK_open since it has significant performance impacts.
+   inspect TABLE_SHAREs and lock all instances of the table
+   cache. Since their mutexes are not recursive, count here
+   how many times we "took" them (but only take and release
+   once).
   */
-  uint m_lock_open_count;
+  uint m_table_cache_lock_count;
 };
 
 /**
@@ -798,7 +798,12 @@ private:
     readily available to the wait-for graph iterator.
    */
   MDL_wait_for_subgraph *m_waiting_for;
+  /** Pins of this context for the hash of all MDL locks. */
+  LF_PINS *m_pins;
+  /** Pins of this context for the MDL_lock objects found in the hash. */
+  LF_PINS *m_lock_pins;
 private:
+  bool fix_pins();
   MDL_ticket *find_ticket(MDL_request *mdl_req,
                           enum_mdl_duration *duration);
   void release_locks_stored_before(enum_mdl_duration duration, MDL_ticket *sentinel);
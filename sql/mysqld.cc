@@ -468,7 +468,7 @@ uint volatile thread_count;
 int32 thread_running;
 ulong thread_created;
 ulong back_log, connect_timeout, concurrency, server_id;
-ulong table_cache_size, table_def_size;
+ulong table_cache_size, table_cache_instances, table_def_size;
 ulong what_to_log;
 ulong slow_launch_time, slave_open_temp_tables;
 ulong open_files_limit, max_binlog_size, max_relay_log_size;
@@ -6981,6 +6981,7 @@ SHOW_VAR status_vars[]= {
   {"Aborted_clients",          (char*) &aborted_threads,        SHOW_LONG},
   {"Aborted_connects",         (char*) &aborted_connects,       SHOW_LONG},
   {"Access_denied_errors",     (char*) offsetof(STATUS_VAR, access_denied_errors), SHOW_LONG_STATUS},
+  {"Alloc_cache_hits",         (char*) offsetof(STATUS_VAR, alloc_cache_hits), SHOW_LONG_STATUS},
   {"Binlog_bytes_written",     (char*) offsetof(STATUS_VAR, binlog_bytes_written), SHOW_LONGLONG_STATUS},
   {"Binlog_cache_disk_use",    (char*) &binlog_cache_disk_use,  SHOW_LONG},
   {"Binlog_cache_use",         (char*) &binlog_cache_use,       SHOW_LONG},
@@ -7782,6 +7783,7 @@ mysql_getopt_value(const char *keyname, uint key_length,
   switch (option->id) {
   case OPT_KEY_BUFFER_SIZE:
   case OPT_KEY_CACHE_BLOCK_SIZE:
+  case OPT_KEY_CACHE_CLOCK_REPLACEMENT:
   case OPT_KEY_CACHE_DIVISION_LIMIT:
   case OPT_KEY_CACHE_AGE_THRESHOLD:
   case OPT_KEY_CACHE_PARTITIONS:
@@ -7798,6 +7800,8 @@ mysql_getopt_value(const char *keyname, uint key_length,
       return &key_cache->param_buff_size;
     case OPT_KEY_CACHE_BLOCK_SIZE:
       return &key_cache->param_block_size;
+    case OPT_KEY_CACHE_CLOCK_REPLACEMENT:
+      return &key_cache->param_clock_replacement;
     case OPT_KEY_CACHE_DIVISION_LIMIT:
       return &key_cache->param_division_limit;
     case OPT_KEY_CACHE_AGE_THRESHOLD:
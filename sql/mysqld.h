@@ -155,7 +155,7 @@ extern ulong slave_open_temp_tables;
 extern ulonglong query_cache_size;
 extern ulong query_cache_min_res_unit;
 extern ulong slow_launch_threads, slow_launch_time;
-extern ulong table_cache_size, table_def_size;
+extern ulong table_cache_size, table_cache_instances, table_def_size;
 extern MYSQL_PLUGIN_IMPORT ulong max_connections;
 extern ulong max_connect_errors, connect_timeout;
 extern my_bool slave_allow_batching;
@@ -379,6 +379,7 @@ enum options_mysqld
   OPT_KEY_BUFFER_SIZE,
   OPT_KEY_CACHE_AGE_THRESHOLD,
   OPT_KEY_CACHE_BLOCK_SIZE,
+  OPT_KEY_CACHE_CLOCK_REPLACEMENT,
   OPT_KEY_CACHE_DIVISION_LIMIT,
   OPT_KEY_CACHE_PARTITIONS,
   OPT_LOG_BASENAME,
@@ -116,6 +116,266 @@ extern void query_cache_insert(const char *packet, ulong length,
 #define MAX_PACKET_LENGTH (256L*256L*256L-1)
 
 static my_bool net_write_buff(NET *net,const uchar *packet,ulong len);
+static int net_real_writev(NET *net, struct iovec *iov, int iovcnt);
+
+#ifdef HAVE_COMPRESS
+/*
+  The LZ compressed protocol (NET_COMPRESS_LZ)
+
+  Each direction of the connection is one stream compressed with
+  my_lz_stream_compress(). A packet of up to NET_LZ_STREAM_PACKET bytes
+  is compressed with the last 64K of the earlier packets as history, so
+  that small packets, which repeat a lot of column names and values,
+  still get smaller. Both sides add every packet they send or receive to
+  the history, whether it was compressed or not. Bigger packets are
+  compressed on their own, and only their last 64K is added to the
+  history.
+
+  After NET_LZ_MAX_MISSES packets in a row that do not get smaller by
+  at least 1/8, the next NET_LZ_SKIP packets are sent without trying to
+  compress them.
+
+  The state is allocated with the first compressed packet and kept in
+  NET::extension. The history buffer of each direction starts small and
+  grows with the history, up to NET_LZ_BUFFER bytes.
+*/
+
+#define NET_LZ_WINDOW        65535
+#define NET_LZ_STREAM_PACKET (16*1024L)
+#define NET_LZ_BUFFER        (2*NET_LZ_WINDOW + NET_LZ_STREAM_PACKET)
+#define NET_LZ_MIN_BUFFER    4096
+#define NET_LZ_MIN_LENGTH    16
+#define NET_LZ_MAX_MISSES    4
+#define NET_LZ_SKIP          32
+
+/* History of one direction of the connection */
+
+typedef struct st_net_lz_history
+{
+  MY_LZ_STREAM stream;
+  uchar *buff;                          /* History, then the next packet */
+  size_t buff_length;                   /* Allocated length of buff */
+} NET_LZ_HISTORY;
+
+typedef struct st_net_lz
+{
+  NET_LZ_HISTORY sent, received;
+  uint misses;                          /* Packets in a row not compressed */
+  uint skip;                            /* Packets to send uncompressed */
+} NET_LZ;
+
+
+static NET_LZ *net_lz(NET *net)
+{
+  NET_LZ *lz;
+  if ((lz= (NET_LZ*) net->extension))
+    return lz;
+  if (!(lz= (NET_LZ*) my_malloc(sizeof(NET_LZ), MYF(MY_WME | MY_ZEROFILL))))
+    return 0;
+  if (my_lz_stream_init(&lz->sent.stream))
+  {
+    my_free(lz);
+    return 0;
+  }
+  return (NET_LZ*) (net->extension= lz);
+}
+
+
+static void net_lz_free(NET *net)
+{
+  NET_LZ *lz;
+  if ((lz= (NET_LZ*) net->extension))
+  {
+    my_lz_stream_end(&lz->sent.stream);
+    my_free(lz->sent.buff);
+    my_free(lz->received.buff);
+    my_free(lz);
+    net->extension= 0;
+  }
+}
+
+
+/*
+  Make room for length bytes after the history, by moving its last
+  64K to the start of the buffer or by growing the buffer. Returns the
+  end of the history, or 0 if out of memory.
+*/
+
+static uchar *net_lz_reserve(NET_LZ_HISTORY *hist, size_t length)
+{
+  MY_LZ_STREAM *stream= &hist->stream;
+  DBUG_ASSERT(length <= NET_LZ_WINDOW);
+  if (stream->history + length > NET_LZ_BUFFER)
+  {
+    size_t keep= min(stream->history, NET_LZ_WINDOW);
+    size_t shift= stream->history - keep;
+    memmove(hist->buff, hist->buff + shift, keep);
+    my_lz_stream_shift(stream, shift);
+  }
+  if (stream->history + length > hist->buff_length)
+  {
+    size_t new_length= max(hist->buff_length * 2, NET_LZ_MIN_BUFFER);
+    uchar *buff;
+    set_if_bigger(new_length, stream->history + length);
+    set_if_smaller(new_length, NET_LZ_BUFFER);
+    if (!(buff= (uchar*) my_realloc(hist->buff, new_length,
+                                    MYF(MY_WME | MY_ALLOW_ZERO_PTR))))
+      return 0;
+    hist->buff= buff;
+    hist->buff_length= new_length;
+  }
+  return hist->buff + stream->history;
+}
+
+
+/* Add data, of which only the last 64K matter, to the history */
+
+static my_bool net_lz_add_history(NET_LZ_HISTORY *hist, const uchar *data,
+                                  size_t length)
+{
+  uchar *pos;
+  if (length > NET_LZ_WINDOW)
+  {
+    data+= length - NET_LZ_WINDOW;
+    length= NET_LZ_WINDOW;
+  }
+  if (!(pos= net_lz_reserve(hist, length)))
+    return 1;
+  memcpy(pos, data, length);
+  hist->stream.history+= length;
+  return 0;
+}
+
+
+/*
+  Compress a packet for sending
+
+  @param lz       LZ protocol state
+  @param packet   Packet to send
+  @param len      Length of the packet
+  @param dst      Buffer of len bytes for the packet to send
+  @param complen  out: Length of the compressed packet, 0 if the packet is
+                  sent uncompressed and was copied to dst
+
+  @retval 0  ok
+  @retval 1  Out of memory
+*/
+
+static my_bool net_lz_compress(NET_LZ *lz, const uchar *packet, size_t len,
+                               uchar *dst, size_t *complen_arg)
+{
+  size_t complen= 0;
+  my_bool try_compress= !lz->skip && len >= NET_LZ_MIN_LENGTH;
+
+  if (len <= NET_LZ_STREAM_PACKET)
+  {
+    uchar *pos;
+    if (!(pos= net_lz_reserve(&lz->sent, len)))
+      return 1;
+    memcpy(pos, packet, len);
+    if (try_compress)
+      complen= my_lz_stream_compress(&lz->sent.stream, lz->sent.buff, len,
+                                     dst, len - 1);
+    else
+      lz->sent.stream.history+= len;
+  }
+  else
+  {
+    if (try_compress)
+      complen= my_lz_compress(packet, len, dst, len - 1);
+    if (net_lz_add_history(&lz->sent, packet, len))
+      return 1;
+  }
+
+  if (lz->skip)
+    lz->skip--;
+  else if (try_compress)
+  {
+    if (!complen || complen > len - len / 8)
+    {
+      if (++lz->misses >= NET_LZ_MAX_MISSES)
+      {
+        lz->skip= NET_LZ_SKIP;
+        lz->misses= 0;
+      }
+    }
+    else
+      lz->misses= 0;
+  }
+
+  if (!complen)
+    memcpy(dst, packet, len);
+  *complen_arg= complen;
+  return 0;
+}
+
+
+/*
+  Uncompress a received packet in place
+
+  @param lz       LZ protocol state
+  @param packet   Packet; has room for the uncompressed data
+  @param len      Length of the packet
+  @param complen  in: Length of the uncompressed data, 0 if the packet is
+                  not compressed. out: Length of the data
+
+  @retval 0  ok
+  @retval 1  The packet is corrupted, or out of memory
+*/
+
+static my_bool net_lz_uncompress(NET_LZ *lz, uchar *packet, size_t len,
+                                 size_t *complen)
+{
+  size_t length= *complen;
+
+  if (!length)
+  {
+    *complen= len;
+    return net_lz_add_history(&lz->received, packet, len);
+  }
+  if (length <= NET_LZ_STREAM_PACKET)
+  {
+    uchar *pos;
+    if (!(pos= net_lz_reserve(&lz->received, length)) ||
+        my_lz_stream_decompress(&lz->received.stream, packet, len,
+                                lz->received.buff, &length) ||
+        length != *complen)
+      return 1;
+    memcpy(packet, pos, length);
+  }
+  else
+  {
+    uchar *data;
+    if (!(data= (uchar*) my_malloc(length, MYF(MY_WME))))
+      return 1;
+    if (my_lz_decompress(packet, len, data, &length) || length != *complen)
+    {
+      my_free(data);
+      return 1;
+    }
+    memcpy(packet, data, length);
+    if (net_lz_add_history(&lz->received, data, length))
+    {
+      my_free(data);
+      return 1;
+    }
+    my_free(data);
+  }
+  return 0;
+}
+
+
+/* Uncompress a received packet with the compression of the connection */
+
+static my_bool net_uncompress(NET *net, uchar *packet, size_t len,
+                              size_t *complen)
+{
+  NET_LZ *lz;
+  if (net->compress != NET_COMPRESS_LZ)
+    return my_uncompress(packet, len, complen);
+  return !(lz= net_lz(net)) || net_lz_uncompress(lz, packet, len, complen);
+}
+#endif /* HAVE_COMPRESS */
 
 
 /** Init with packet info. */
@@ -139,6 +399,7 @@ my_bool my_net_init(NET *net, Vio* vio)
   net->net_skip_rest_factor= 0;
   net->last_errno=0;
   net->unused= 0;
+  net->extension= 0;
 
   if (vio != 0)					/* If real connection */
   {
@@ -161,6 +422,9 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff);
   net->buff=0;
+#ifdef HAVE_COMPRESS
+  net_lz_free(net);
+#endif
   DBUG_VOID_RETURN;
 }
 
@@ -295,12 +559,14 @@ void net_clear(NET *net, my_bool clear_buffer __attribute__((unused)))
   {
     size_t count;
     int ready;
+    my_bool skipped= FALSE;
     while ((ready= net_data_is_ready(net->vio->sd)) > 0)
     {
       /* The socket is ready */
       if ((long) (count= vio_read(net->vio, net->buff,
                                   (size_t) net->max_packet)) > 0)
       {
+        skipped= TRUE;
         DBUG_PRINT("info",("skipped %ld bytes from file: %s",
                            (long) count, vio_description(net->vio)));
         EXTRA_DEBUG_fprintf(stderr,"Note: net_clear() skipped %ld bytes from file: %s\n",
@@ -323,12 +589,25 @@ void net_clear(NET *net, my_bool clear_buffer __attribute__((unused)))
       {
         while ((long) (count= vio_read(net->vio, net->buff,
                                        (size_t) net->max_packet)) > 0)
+        {
+          skipped= TRUE;
           DBUG_PRINT("info",("skipped %ld bytes from file: %s",
                              (long) count, vio_description(net->vio)));
+        }
         vio_blocking(net->vio, TRUE, &old_mode);
       }
     }
 #endif /* NET_DATA_IS_READY_CAN_RETURN_MINUS_ONE */
+#ifdef HAVE_COMPRESS
+    /*
+      The skipped packets are missing from the LZ history of the received
+      packets, while the other side has them in its history. The next
+      compressed packet could then not be uncompressed correctly, so the
+      connection can't be used any more.
+    */
+    if (skipped && net->compress == NET_COMPRESS_LZ)
+      net->error= 2;
+#endif
   }
 #endif /* EMBEDDED_LIBRARY */
   net->pkt_nr=net->compress_pkt_nr=0;		/* Ready for new command */
@@ -498,6 +777,8 @@ net_write_command(NET *net,uchar command,
 
     If the rest of the to-be-sent-packet is bigger than buffer,
     send it in one big block (to avoid copying to internal buffer).
+    Without compression, a packet bigger than the buffer is sent together
+    with the buffered data with one vectored write.
     If not, copy the rest of the data to the buffer and return without
     sending data.
 
@@ -531,6 +812,20 @@ net_write_buff(NET *net, const uchar *packet, ulong len)
 #endif
   if (len > left_length)
   {
+    if (!net->compress && len > net->max_packet)
+    {
+      /*
+        Send the buffered data and the packet with one vectored write,
+        without copying the start of the packet to the buffer first.
+      */
+      struct iovec iov[2];
+      iov[0].iov_base= net->buff;
+      iov[0].iov_len= (size_t) (net->write_pos - net->buff);
+      iov[1].iov_base= (void*) packet;
+      iov[1].iov_len= len;
+      net->write_pos= net->buff;
+      return net_real_writev(net, iov, 2) ? 1 : 0;
+    }
     if (net->write_pos != net->buff)
     {
       /* Fill up already used packet and write it */
@@ -577,19 +872,43 @@ net_write_buff(NET *net, const uchar *packet, ulong len)
 
 int
 net_real_write(NET *net,const uchar *packet, size_t len)
+{
+  struct iovec iov;
+  iov.iov_base= (void*) packet;
+  iov.iov_len= len;
+  return net_real_writev(net, &iov, 1);
+}
+
+
+/**
+  Write data gathered from several buffers using timeouts.
+
+  @param net     Network handler
+  @param iov     Buffers to write; changed to track the progress
+  @param iovcnt  Number of buffers; must be 1 when using compression
+
+  @retval 0  ok
+  @retval #  error
+*/
+
+static int
+net_real_writev(NET *net, struct iovec *iov, int iovcnt)
 {
   size_t length;
-  const uchar *pos,*end;
   thr_alarm_t alarmed;
 #ifndef NO_ALARM
   ALARM alarm_buff;
 #endif
   uint retry_count=0;
   my_bool net_blocking = vio_is_blocking(net->vio);
-  DBUG_ENTER("net_real_write");
+#ifdef HAVE_COMPRESS
+  uchar *compressed= 0;
+#endif
+  DBUG_ENTER("net_real_writev");
 
 #if defined(MYSQL_SERVER) && defined(USE_QUERY_CACHE)
-  query_cache_insert((char*) packet, len, net->pkt_nr);
+  for (int i= 0; i < iovcnt; i++)
+    query_cache_insert((char*) iov[i].iov_base, iov[i].iov_len, net->pkt_nr);
 #endif
 
   if (net->error == 2)
@@ -600,31 +919,55 @@ net_real_write(NET *net,const uchar *packet, size_t len)
   if (net->compress)
   {
     size_t complen;
+    size_t len= iov->iov_len;
     uchar *b;
+    NET_LZ *lz= 0;
+    DBUG_ASSERT(iovcnt == 1);
     uint header_length=NET_HEADER_SIZE+COMP_HEADER_SIZE;
     if (!(b= (uchar*) my_malloc(len + NET_HEADER_SIZE +
-                                COMP_HEADER_SIZE + 1, MYF(MY_WME))))
+                                COMP_HEADER_SIZE + 1, MYF(MY_WME))) ||
+        (net->compress == NET_COMPRESS_LZ && !(lz= net_lz(net))))
     {
+      my_free(b);
       net->error= 2;
       net->last_errno= ER_OUT_OF_RESOURCES;
       /* In the server, the error is reported by MY_WME flag. */
       net->reading_or_writing= 0;
       DBUG_RETURN(1);
     }
-    memcpy(b+header_length,packet,len);
-
-    if (my_compress(b+header_length, &len, &complen))
-      complen=0;
+    if (lz)
+    {
+      size_t clen;
+      if (net_lz_compress(lz, (uchar*) iov->iov_base, len,
+                          b + header_length, &clen))
+      {
+        my_free(b);
+        net->error= 2;
+        net->last_errno= ER_OUT_OF_RESOURCES;
+        net->reading_or_writing= 0;
+        DBUG_RETURN(1);
+      }
+      complen= clen ? len : 0;
+      if (clen)
+        len= clen;
+    }
+    else
+    {
+      memcpy(b+header_length,iov->iov_base,len);
+      if (my_compress(b+header_length, &len, &complen))
+        complen=0;
+    }
     int3store(&b[NET_HEADER_SIZE],complen);
     int3store(b,len);
     b[3]=(uchar) (net->compress_pkt_nr++);
-    len+= header_length;
-    packet= b;
+    iov->iov_base= compressed= b;
+    iov->iov_len= len + header_length;
   }
 #endif /* HAVE_COMPRESS */
 
 #ifdef DEBUG_DATA_PACKETS
-  DBUG_DUMP("data", packet, len);
+  for (int i= 0; i < iovcnt; i++)
+    DBUG_DUMP("data", (uchar*) iov[i].iov_base, iov[i].iov_len);
 #endif
 
 #ifndef NO_ALARM
@@ -636,11 +979,17 @@ net_real_write(NET *net,const uchar *packet, size_t len)
   /* Write timeout is set in my_net_set_write_timeout */
 #endif /* NO_ALARM */
 
-  pos= packet;
-  end=pos+len;
-  while (pos != end)
+  for (;;)
   {
-    if ((long) (length= vio_write(net->vio,pos,(size_t) (end-pos))) <= 0)
+    /* Skip the buffers that are completely written */
+    while (iovcnt && !iov->iov_len)
+    {
+      iov++;
+      iovcnt--;
+    }
+    if (!iovcnt)
+      break;
+    if ((long) (length= vio_writev(net->vio, iov, iovcnt)) <= 0)
     {
       my_bool interrupted = vio_should_retry(net->vio);
 #if !defined(__WIN__)
@@ -688,15 +1037,20 @@ net_real_write(NET *net,const uchar *packet, size_t len)
       MYSQL_SERVER_my_error(net->last_errno, MYF(0));
       break;
     }
-    pos+=length;
     update_statistics(thd_increment_bytes_sent(length));
+    for (; iovcnt && length >= iov->iov_len; iov++, iovcnt--)
+      length-= iov->iov_len;
+    if (iovcnt)
+    {
+      iov->iov_base= (char*) iov->iov_base + length;
+      iov->iov_len-= length;
+    }
   }
 #ifndef __WIN__
  end:
 #endif
 #ifdef HAVE_COMPRESS
-  if (net->compress)
-    my_free((void*) packet);
+  my_free(compressed);
 #endif
   if (thr_alarm_in_use(&alarmed))
   {
@@ -706,7 +1060,7 @@ net_real_write(NET *net,const uchar *packet, size_t len)
       vio_blocking(net->vio, net_blocking, &old_mode);
   }
   net->reading_or_writing=0;
-  DBUG_RETURN(((int) (pos != end)));
+  DBUG_RETURN(iovcnt != 0);
 }
 
 
@@ -1130,8 +1484,8 @@ my_net_read(NET *net)
         MYSQL_NET_READ_DONE(1, 0);
 	return packet_error;
       }
-      if (my_uncompress(net->buff + net->where_b, packet_len,
-			&complen))
+      if (net_uncompress(net, net->buff + net->where_b, packet_len,
+                         &complen))
       {
 	net->error= 2;			/* caller will close socket */
         net->last_errno= ER_NET_UNCOMPRESS_ERROR;
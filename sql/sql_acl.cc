@@ -8069,6 +8069,10 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
     thd->client_capabilities|= CLIENT_TRANSACTIONS;
 
   thd->client_capabilities|= CAN_CLIENT_COMPRESS;
+#ifdef HAVE_COMPRESS
+  thd->client_capabilities|= MARIADB_CLIENT_LZ_COMPRESS;
+#endif
+  thd->client_capabilities|= MARIADB_CLIENT_STMT_BULK;
 
   if (ssl_acceptor_fd)
   {
@@ -8131,7 +8135,9 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
   int2store(end+5, thd->client_capabilities >> 16);
   end[7]= data_len;
   DBUG_EXECUTE_IF("poison_srv_handshake_scramble_len", end[7]= -100;);
-  bzero(end + 8, 10);
+  bzero(end + 8, 6);
+  /* MariaDB extended capabilities in the last 4 bytes of the filler */
+  int4store(end + 14, (uint32) (thd->client_capabilities >> 32));
   end+= 18;
   /* write scramble tail */
   end= (char*) memcpy(end, data + SCRAMBLE_LENGTH_323,
@@ -8508,18 +8514,21 @@ static ulong parse_client_handshake_packet(MPVIO_EXT *mpvio,
   if (mpvio->connect_errors)
     reset_host_errors(thd->main_security_ctx.ip);
 
-  ulong client_capabilities= uint2korr(net->read_pos);
+  ulonglong client_capabilities= uint2korr(net->read_pos);
   if (client_capabilities & CLIENT_PROTOCOL_41)
   {
     if (pkt_len < 4)
       return packet_error;
     client_capabilities|= ((ulong) uint2korr(net->read_pos+2)) << 16;
+    /* MariaDB extended capabilities in the last 4 bytes of the filler */
+    if (pkt_len >= 32)
+      client_capabilities|= ((ulonglong) uint4korr(net->read_pos+28)) << 32;
   }
 
   /* Disable those bits which are not supported by the client. */
   thd->client_capabilities&= client_capabilities;
 
-  DBUG_PRINT("info", ("client capabilities: %lu", thd->client_capabilities));
+  DBUG_PRINT("info", ("client capabilities: %llu", thd->client_capabilities));
   if (thd->client_capabilities & CLIENT_SSL)
   {
     unsigned long errptr __attribute__((unused));
@@ -9288,7 +9297,7 @@ bool acl_authenticate(THD *thd, uint connect_errors,
   }
 
   DBUG_PRINT("info",
-             ("Capabilities: %lu  packet_length: %ld  Host: '%s'  "
+             ("Capabilities: %llu  packet_length: %ld  Host: '%s'  "
               "Login user: '%s' Priv_user: '%s'  Using password: %s "
               "Access: %lu  db: '%s'",
               thd->client_capabilities, thd->max_client_packet_length,
@@ -163,16 +163,18 @@ Repair_mrg_table_error_handler::handle_condition(THD *,
 */
 
 /**
-  Protects table_def_hash, used and unused lists in the
-  TABLE_SHARE object, LRU lists of used TABLEs and used
-  TABLE_SHAREs, refresh_version and the table id counter.
+  Protects table_def_hash, the reference counts and the LRU list of
+  unused TABLE_SHAREs and the table id counter. refresh_version and
+  the versions of the shares are changed while holding both LOCK_open
+  and the mutexes of all table cache instances.
 */
 mysql_mutex_t LOCK_open;
 
 #ifdef HAVE_PSI_INTERFACE
-static PSI_mutex_key key_LOCK_open;
+static PSI_mutex_key key_LOCK_open, key_TABLE_CACHE_lock;
 static PSI_mutex_info all_tdc_mutexes[]= {
-  { &key_LOCK_open, "LOCK_open", PSI_FLAG_GLOBAL }
+  { &key_LOCK_open, "LOCK_open", PSI_FLAG_GLOBAL },
+  { &key_TABLE_CACHE_lock, "TABLE_CACHE::lock", 0 }
 };
 
 /**
@@ -195,18 +197,40 @@ static void init_tdc_psi_keys(void)
 
 
 /**
-   Total number of TABLE instances for tables in the table definition cache
-   (both in use by threads and not in use). This value is accessible to user
-   as "Open_tables" status variable.
-*/
-uint  table_cache_count= 0;
-/**
-   List that contains all TABLE instances for tables in the table definition
-   cache that are not in use by any thread. Recently used TABLE instances are
-   appended to the end of the list. Thus the beginning of the list contains
-   tables which have been least recently used.
+   An instance of the cache of TABLE objects. The table cache is split
+   into table_cache_instances instances, and a connection opens and
+   closes its tables in the instance chosen by its thread id. A TABLE
+   object is found in an instance without locking LOCK_open, which is
+   only needed for getting, creating and releasing a TABLE_SHARE.
+
+   Lock order: LOCK_open, then the instances in the order of the array.
 */
-TABLE *unused_tables;
+
+typedef struct st_table_cache
+{
+  /**
+     Protects the members of the instance, the elements of the shares
+     for the instance (TABLE_SHARE::cache_element) and TABLE::in_use of
+     their TABLE objects.
+  */
+  mysql_mutex_t lock;
+  /** Shares which have TABLE objects in this instance. */
+  HASH shares;
+  /**
+     List that contains all TABLE instances of this instance that are
+     not in use by any thread. Recently used TABLE instances are appended
+     to the end of the list. Thus the beginning of the list contains
+     tables which have been least recently used.
+  */
+  TABLE *unused_tables;
+  /**
+     Number of TABLE instances in this instance (both in use by threads
+     and not in use).
+  */
+  uint table_count;
+} TABLE_CACHE;
+
+static TABLE_CACHE *table_cache;
 HASH table_def_cache;
 static TABLE_SHARE *oldest_unused_share, end_of_unused_share;
 static bool table_def_inited= 0;
@@ -223,20 +247,115 @@ static bool
 has_write_table_with_auto_increment_and_select(TABLE_LIST *tables);
 static bool has_write_table_auto_increment_not_first_in_pk(TABLE_LIST *tables);
 
+/**
+   Total number of TABLE instances for tables in the table definition cache
+   (both in use by threads and not in use). This value is accessible to user
+   as "Open_tables" status variable.
+*/
+
 uint cached_open_tables(void)
 {
-  return table_cache_count;
+  uint count= 0;
+  for (uint i= 0; i < table_cache_instances; i++)
+    count+= table_cache[i].table_count;
+  return count;
+}
+
+
+/**
+   Number of table cache instances in use.
+
+   table_open_cache is dynamic while the number of instances is not, so
+   when table_open_cache is lower than table_cache_instances only the
+   first table_open_cache instances are used. This keeps the total size
+   of the instances within table_open_cache.
+*/
+
+static inline uint table_cache_active_instances()
+{
+  return (uint) max(min(table_cache_instances, table_cache_size), 1);
+}
+
+
+/** The table cache instance used by a connection. */
+
+static inline uint table_cache_instance(THD *thd)
+{
+  return (uint) (thd->thread_id % table_cache_active_instances());
+}
+
+
+/**
+   Maximum number of TABLE instances in one table cache instance.
+*/
+
+static inline uint table_cache_instance_size()
+{
+  return (uint) (table_cache_size / table_cache_active_instances());
+}
+
+
+/**
+   Lock all instances of the table cache, e.g. for changing the version
+   of a share, which is checked when a TABLE is taken from an instance.
+*/
+
+void table_cache_lock_all()
+{
+  for (uint i= 0; i < table_cache_instances; i++)
+    mysql_mutex_lock(&table_cache[i].lock);
+}
+
+
+void table_cache_unlock_all()
+{
+  for (uint i= 0; i < table_cache_instances; i++)
+    mysql_mutex_unlock(&table_cache[i].lock);
+}
+
+
+/**
+   Check the links of the unused TABLE list of a table cache instance.
+
+   The caller must hold the lock of the instance.
+
+   @param      instance  The table cache instance to check.
+   @param[out] count     Number of TABLE instances in the list.
+
+   @return NULL if the list is consistent, otherwise a description of
+           the problem.
+*/
+
+const char *table_cache_check_unused_links(uint instance, uint *count)
+{
+  TABLE_CACHE *tc= table_cache + instance;
+  TABLE *start_link, *lnk;
+
+  *count= 0;
+  if ((start_link=lnk=tc->unused_tables))
+  {
+    do
+    {
+      if (lnk != lnk->next->prev || lnk != lnk->prev->next)
+        return "unused_links isn't linked properly";
+    } while ((*count)++ < tc->table_count &&
+             (lnk=lnk->next) != start_link);
+    if (lnk != start_link)
+      return "Unused_links aren't connected";
+  }
+  return NULL;
 }
 
 
 #ifdef EXTRA_DEBUG
-static void check_unused(THD *thd)
+static void check_unused(THD *thd, TABLE_CACHE *tc)
 {
   uint count= 0, open_files= 0, idx= 0;
+  uint instance= (uint) (tc - table_cache);
   TABLE *cur_link, *start_link, *entry;
   TABLE_SHARE *share;
 
-  if ((start_link=cur_link=unused_tables))
+  if ((start_link=cur_link=tc->unused_tables))
   {
     do
     {
@@ -245,18 +364,19 @@ static void check_unused(THD *thd)
 	DBUG_PRINT("error",("Unused_links aren't linked properly")); /* purecov: inspected */
 	return; /* purecov: inspected */
       }
-    } while (count++ < table_cache_count &&
+    } while (count++ < tc->table_count &&
 	     (cur_link=cur_link->next) != start_link);
     if (cur_link != start_link)
     {
       DBUG_PRINT("error",("Unused_links aren't connected")); /* purecov: inspected */
     }
   }
-  for (idx=0 ; idx < table_def_cache.records ; idx++)
+  for (idx=0 ; idx < tc->shares.records ; idx++)
   {
-    share= (TABLE_SHARE*) my_hash_element(&table_def_cache, idx);
+    share= (TABLE_SHARE*) my_hash_element(&tc->shares, idx);
 
-    I_P_List_iterator<TABLE, TABLE_share> it(share->free_tables);
+    I_P_List_iterator<TABLE, TABLE_share>
+      it(share->cache_element[instance].free_tables);
     while ((entry= it++))
     {
       /*
@@ -276,7 +396,7 @@ static void check_unused(THD *thd)
       count--;
       open_files++;
     }
-    it.init(share->used_tables);
+    it.init(share->cache_element[instance].used_tables);
     while ((entry= it++))
     {
       if (!entry->in_use)
@@ -293,7 +413,7 @@ static void check_unused(THD *thd)
   }
 }
 #else
-#define check_unused(A)
+#define check_unused(A, B)
 #endif
 
 
@@ -378,6 +498,20 @@ bool table_def_init(void)
   oldest_unused_share= &end_of_unused_share;
   end_of_unused_share.prev= &oldest_unused_share;
 
+  if (!(table_cache= (TABLE_CACHE*) my_malloc(sizeof(TABLE_CACHE) *
+                                              table_cache_instances,
+                                              MYF(MY_WME | MY_ZEROFILL))))
+    return TRUE;
+  for (uint i= 0; i < table_cache_instances; i++)
+    mysql_mutex_init(key_TABLE_CACHE_lock, &table_cache[i].lock,
+                     MY_MUTEX_INIT_FAST);
+  for (uint i= 0; i < table_cache_instances; i++)
+  {
+    if (my_hash_init(&table_cache[i].shares, &my_charset_bin,
+                     table_def_size / table_cache_instances + 1,
+                     0, 0, table_def_key, 0, 0))
+      return TRUE;
+  }
 
   return my_hash_init(&table_def_cache, &my_charset_bin, table_def_size,
                       0, 0, table_def_key,
@@ -418,6 +552,14 @@ void table_def_free(void)
     table_def_inited= 0;
     /* Free table definitions. */
     my_hash_free(&table_def_cache);
+    for (uint i= 0; table_cache && i < table_cache_instances; i++)
+    {
+      DBUG_ASSERT(!table_cache[i].table_count);
+      my_hash_free(&table_cache[i].shares);
+      mysql_mutex_destroy(&table_cache[i].lock);
+    }
+    my_free(table_cache);
+    table_cache= NULL;
     mysql_mutex_destroy(&LOCK_open);
   }
   DBUG_VOID_RETURN;
@@ -432,56 +574,75 @@ uint cached_table_definitions(void)
 
 /*
   Auxiliary routines for manipulating with per-share used/unused and
-  global unused lists of TABLE objects and table_cache_count counter.
-  Responsible for preserving invariants between those lists, counter
-  and TABLE::in_use member.
+  per-instance unused lists of TABLE objects and table count of the
+  table cache instances. Responsible for preserving invariants between
+  those lists, counter and TABLE::in_use member.
   In fact those routines implement sort of implicit table cache as
   part of table definition cache.
+  They must be called with the mutex of the table cache instance of the
+  TABLE object locked.
 */
 
 
 /**
    Add newly created TABLE object for table share which is going
    to be used right away.
+
+   @retval FALSE  Success.
+   @retval TRUE   Failure (OOM).
 */
 
-static void table_def_add_used_table(THD *thd, TABLE *table)
+static bool table_def_add_used_table(THD *thd, TABLE *table)
 {
+  TABLE_CACHE *tc= table_cache + table->cache_instance;
+  Table_cache_element *el= table->s->cache_element + table->cache_instance;
   DBUG_ASSERT(table->in_use == thd);
-  table->s->used_tables.push_front(table);
-  table_cache_count++;
+  mysql_mutex_assert_owner(&tc->lock);
+
+  /* The share is in the hash of the instance while it has TABLEs here. */
+  if (el->is_empty() && my_hash_insert(&tc->shares, (uchar*) table->s))
+    return TRUE;
+  el->used_tables.push_front(table);
+  tc->table_count++;
+  return FALSE;
 }
 
 
 /**
    Prepare used or unused TABLE instance for destruction by removing
-   it from share's and global list.
+   it from share's and instance's list.
 */
 
 static void table_def_remove_table(TABLE *table)
 {
+  TABLE_CACHE *tc= table_cache + table->cache_instance;
+  Table_cache_element *el= table->s->cache_element + table->cache_instance;
+  mysql_mutex_assert_owner(&tc->lock);
+
   if (table->in_use)
   {
     /* Remove from per-share chain of used TABLE objects. */
-    table->s->used_tables.remove(table);
+    el->used_tables.remove(table);
   }
   else
   {
     /* Remove from per-share chain of unused TABLE objects. */
-    table->s->free_tables.remove(table);
+    el->free_tables.remove(table);
 
-    /* And global unused chain. */
+    /* And instance's unused chain. */
     table->next->prev=table->prev;
     table->prev->next=table->next;
-    if (table == unused_tables)
+    if (table == tc->unused_tables)
     {
-      unused_tables=unused_tables->next;
-      if (table == unused_tables)
-	unused_tables=0;
+      tc->unused_tables=tc->unused_tables->next;
+      if (table == tc->unused_tables)
+	tc->unused_tables=0;
     }
-    check_unused(current_thd);
+    check_unused(current_thd, tc);
   }
-  table_cache_count--;
+  if (el->is_empty())
+    (void) my_hash_delete(&tc->shares, (uchar*) table->s);
+  tc->table_count--;
 }
 
 
@@ -491,22 +652,25 @@ static void table_def_remove_table(TABLE *table)
 
 static void table_def_use_table(THD *thd, TABLE *table)
 {
+  TABLE_CACHE *tc= table_cache + table->cache_instance;
+  Table_cache_element *el= table->s->cache_element + table->cache_instance;
   DBUG_ASSERT(!table->in_use);
+  mysql_mutex_assert_owner(&tc->lock);
 
   /* Unlink table from list of unused tables for this share. */
-  table->s->free_tables.remove(table);
-  /* Unlink able from global unused tables list. */
-  if (table == unused_tables)
+  el->free_tables.remove(table);
+  /* Unlink able from instance's unused tables list. */
+  if (table == tc->unused_tables)
   {						// First unused
-    unused_tables=unused_tables->next;	        // Remove from link
-    if (table == unused_tables)
-      unused_tables=0;
+    tc->unused_tables=tc->unused_tables->next;	// Remove from link
+    if (table == tc->unused_tables)
+      tc->unused_tables=0;
   }
   table->prev->next=table->next;		/* Remove from unused list */
   table->next->prev=table->prev;
-  check_unused(thd);
+  check_unused(thd, tc);
   /* Add table to list of used tables for this share. */
-  table->s->used_tables.push_front(table);
+  el->used_tables.push_front(table);
   table->in_use= thd;
   /* The ex-unused table must be fully functional. */
   DBUG_ASSERT(table->db_stat && table->file);
@@ -522,27 +686,70 @@ static void table_def_use_table(THD *thd, TABLE *table)
 static void table_def_unuse_table(TABLE *table)
 {
   THD *thd __attribute__((unused))= table->in_use;
+  TABLE_CACHE *tc= table_cache + table->cache_instance;
+  Table_cache_element *el= table->s->cache_element + table->cache_instance;
   DBUG_ASSERT(table->in_use);
+  mysql_mutex_assert_owner(&tc->lock);
 
   /* We shouldn't put the table to 'unused' list if the share is old. */
   DBUG_ASSERT(! table->s->has_old_version());
 
   table->in_use= 0;
   /* Remove table from the list of tables used in this share. */
-  table->s->used_tables.remove(table);
+  el->used_tables.remove(table);
   /* Add table to the list of unused TABLE objects for this share. */
-  table->s->free_tables.push_front(table);
-  /* Also link it last in the global list of unused TABLE objects. */
-  if (unused_tables)
+  el->free_tables.push_front(table);
+  /* Also link it last in the instance's list of unused TABLE objects. */
+  if (tc->unused_tables)
   {
-    table->next=unused_tables;
-    table->prev=unused_tables->prev;
-    unused_tables->prev=table;
+    table->next=tc->unused_tables;
+    table->prev=tc->unused_tables->prev;
+    tc->unused_tables->prev=table;
     table->prev->next=table;
   }
   else
-    unused_tables=table->next=table->prev=table;
-  check_unused(thd);
+    tc->unused_tables=table->next=table->prev=table;
+  check_unused(thd, tc);
+}
+
+
+/**
+   Take an unused TABLE instance of a table from the table cache
+   instance of the connection, without locking LOCK_open.
+
+   This is the fast path of open_table(): the TABLE object holds a
+   reference to its share, so the share need not be looked up in the
+   table definition cache. Versions of the shares are only changed
+   while all instances are locked, so checking them here is as good
+   as checking them under LOCK_open.
+
+   @return The TABLE instance, marked as used, or NULL if there is no
+           unused TABLE for the table or its share is being flushed.
+*/
+
+static TABLE *table_def_acquire_unused_table(THD *thd, const char *key,
+                                             uint key_length,
+                                             my_hash_value_type hash_value)
+{
+  uint instance= table_cache_instance(thd);
+  TABLE_CACHE *tc= table_cache + instance;
+  TABLE_SHARE *share;
+  TABLE *table= NULL;
+
+  mysql_mutex_lock(&tc->lock);
+  if ((share= (TABLE_SHARE*) my_hash_search_using_hash_value(&tc->shares,
+                                                             hash_value,
+                                                             (uchar*) key,
+                                                             key_length)) &&
+      !share->cache_element[instance].free_tables.is_empty() &&
+      !share->has_old_version() &&
+      !(thd->open_tables && thd->open_tables->s->version != share->version))
+  {
+    table= share->cache_element[instance].free_tables.front();
+    table_def_use_table(thd, table);
+  }
+  mysql_mutex_unlock(&tc->lock);
+  return table;
 }
 
 
@@ -896,9 +1103,15 @@ OPEN_TABLE_LIST *list_open_tables(THD *thd, const char *db, const char *wild)
 		  share->db.str)+1,
 	   share->table_name.str);
     (*start_list)->in_use= 0;
-    I_P_List_iterator<TABLE, TABLE_share> it(share->used_tables);
-    while (it++)
-      ++(*start_list)->in_use;
+    for (uint i= 0; i < table_cache_instances; i++)
+    {
+      mysql_mutex_lock(&table_cache[i].lock);
+      I_P_List_iterator<TABLE, TABLE_share>
+        it(share->cache_element[i].used_tables);
+      while (it++)
+        ++(*start_list)->in_use;
+      mysql_mutex_unlock(&table_cache[i].lock);
+    }
     (*start_list)->locked= 0;                   /* Obsolete. */
     start_list= &(*start_list)->next;
     *start_list=0;
@@ -936,7 +1149,8 @@ void intern_close_table(TABLE *table)
     table		Table to remove
 
   NOTE
-    We need to have a lock on LOCK_open when calling this
+    We need to have a lock on LOCK_open and on the table cache instance
+    of the table when calling this
 */
 
 static void free_cache_entry(TABLE *table)
@@ -973,32 +1187,37 @@ void free_io_cache(TABLE *table)
 
    @param share Table share.
 
-   @pre Caller should have LOCK_open mutex.
+   @pre Caller should have LOCK_open mutex and all instances of the
+        table cache locked.
 */
 
 static void kill_delayed_threads_for_table(TABLE_SHARE *share)
 {
-  I_P_List_iterator<TABLE, TABLE_share> it(share->used_tables);
   TABLE *tab;
 
   mysql_mutex_assert_owner(&LOCK_open);
 
-  while ((tab= it++))
+  for (uint i= 0; i < table_cache_instances; i++)
   {
-    THD *in_use= tab->in_use;
-
-    if ((in_use->system_thread & SYSTEM_THREAD_DELAYED_INSERT) &&
-        ! in_use->killed)
+    I_P_List_iterator<TABLE, TABLE_share>
+      it(share->cache_element[i].used_tables);
+    while ((tab= it++))
     {
-      in_use->killed= KILL_SYSTEM_THREAD;
-      mysql_mutex_lock(&in_use->mysys_var->mutex);
-      if (in_use->mysys_var->current_cond)
+      THD *in_use= tab->in_use;
+
+      if ((in_use->system_thread & SYSTEM_THREAD_DELAYED_INSERT) &&
+          ! in_use->killed)
       {
-        mysql_mutex_lock(in_use->mysys_var->current_mutex);
-        mysql_cond_broadcast(in_use->mysys_var->current_cond);
-        mysql_mutex_unlock(in_use->mysys_var->current_mutex);
+        in_use->killed= KILL_SYSTEM_THREAD;
+        mysql_mutex_lock(&in_use->mysys_var->mutex);
+        if (in_use->mysys_var->current_cond)
+        {
+          mysql_mutex_lock(in_use->mysys_var->current_mutex);
+          mysql_cond_broadcast(in_use->mysys_var->current_cond);
+          mysql_mutex_unlock(in_use->mysys_var->current_mutex);
+        }
+        mysql_mutex_unlock(&in_use->mysys_var->mutex);
       }
-      mysql_mutex_unlock(&in_use->mysys_var->mutex);
     }
   }
 }
@@ -1044,16 +1263,21 @@ bool close_cached_tables(THD *thd, TABLE_LIST *tables,
       or putting it another way that TDC does not contain old shares
       which don't have any tables used.
     */
+    table_cache_lock_all();
     refresh_version++;
     DBUG_PRINT("tcache", ("incremented global refresh_version to: %lu",
                           refresh_version));
-    kill_delayed_threads();
     /*
       Get rid of all unused TABLE and TABLE_SHARE instances. By doing
       this we automatically close all tables which were marked as "old".
     */
-    while (unused_tables)
-      free_cache_entry(unused_tables);
+    for (uint i= 0; i < table_cache_instances; i++)
+    {
+      while (table_cache[i].unused_tables)
+        free_cache_entry(table_cache[i].unused_tables);
+    }
+    table_cache_unlock_all();
+    kill_delayed_threads();
     /* Free table shares which were not freed implicitly by loop above. */
     while (oldest_unused_share->next)
       (void) my_hash_delete(&table_def_cache, (uchar*) oldest_unused_share);
@@ -1067,7 +1291,9 @@ bool close_cached_tables(THD *thd, TABLE_LIST *tables,
 
       if (share)
       {
+        table_cache_lock_all();
         kill_delayed_threads_for_table(share);
+        table_cache_unlock_all();
         /* tdc_remove_table() calls share->remove_from_cache_at_close() */
         tdc_remove_table(thd, TDC_RT_REMOVE_UNUSED, table->db,
                          table->table_name, TRUE);
@@ -1592,6 +1818,7 @@ bool close_thread_table(THD *thd, TABLE **table_ptr)
 {
   bool found_old_table= 0;
   TABLE *table= *table_ptr;
+  TABLE_CACHE *tc;
   DBUG_ENTER("close_thread_table");
   DBUG_PRINT("tcache", ("table: '%s'.'%s' 0x%lx", table->s->db.str,
                         table->s->table_name.str, (long) table));
@@ -1628,12 +1855,13 @@ bool close_thread_table(THD *thd, TABLE **table_ptr)
     table->file->ha_reset();
   }
 
-  mysql_mutex_lock(&LOCK_open);
+  tc= table_cache + table->cache_instance;
+  mysql_mutex_lock(&tc->lock);
 
   if (table->s->has_old_version() || table->needs_reopen() ||
       table_def_shutdown_in_progress)
   {
-    free_cache_entry(table);
+    table_def_remove_table(table);
     found_old_table= 1;
   }
   else
@@ -1644,10 +1872,27 @@ bool close_thread_table(THD *thd, TABLE **table_ptr)
       We free the least used table, not the subject table,
       to keep the LRU order.
     */
-    if (table_cache_count > table_cache_size)
-      free_cache_entry(unused_tables);
+    if (tc->table_count > table_cache_instance_size())
+    {
+      table= tc->unused_tables;
+      table_def_remove_table(table);
+    }
+    else
+      table= NULL;
+  }
+  mysql_mutex_unlock(&tc->lock);
+
+  if (table)
+  {
+    /*
+      The table is no longer in the table cache. LOCK_open is needed
+      for releasing its reference to the share.
+    */
+    mysql_mutex_lock(&LOCK_open);
+    intern_close_table(table);
+    my_free(table);
+    mysql_mutex_unlock(&LOCK_open);
   }
-  mysql_mutex_unlock(&LOCK_open);
   DBUG_RETURN(found_old_table);
 }
 
@@ -2731,6 +2976,8 @@ bool open_table(THD *thd, TABLE_LIST *table_list, MEM_ROOT *mem_root,
   MDL_ticket *mdl_ticket;
   int error;
   TABLE_SHARE *share;
+  TABLE_CACHE *tc;
+  uint instance;
   my_hash_value_type hash_value;
   DBUG_ENTER("open_table");
 
@@ -3006,6 +3253,15 @@ bool open_table(THD *thd, TABLE_LIST *table_list, MEM_ROOT *mem_root,
 
 retry_share:
 
+  /*
+    Try to find an unused TABLE instance in the table cache first, which
+    does not need LOCK_open. Views are never in the table cache.
+  */
+  if (!(table_list->i_s_requested_object & OPEN_VIEW_ONLY) &&
+      (table= table_def_acquire_unused_table(thd, key, key_length,
+                                             hash_value)))
+    goto opened;
+
   mysql_mutex_lock(&LOCK_open);
 
   if (!(share= get_table_share_with_discover(thd, table_list, key,
@@ -3135,19 +3391,25 @@ retry_share:
     }
   }
 
-  if (!share->free_tables.is_empty())
+  instance= table_cache_instance(thd);
+  tc= table_cache + instance;
+  mysql_mutex_lock(&tc->lock);
+  if (!share->cache_element[instance].free_tables.is_empty())
   {
-    table= share->free_tables.front();
+    table= share->cache_element[instance].free_tables.front();
     table_def_use_table(thd, table);
+    mysql_mutex_unlock(&tc->lock);
     /* We need to release share as we have EXTRA reference to it in our hands. */
     release_table_share(share);
+    mysql_mutex_unlock(&LOCK_open);
   }
   else
   {
     /* We have too many TABLE instances around let us try to get rid of them. */
-    while (table_cache_count > table_cache_size && unused_tables)
-      free_cache_entry(unused_tables);
+    while (tc->table_count > table_cache_instance_size() && tc->unused_tables)
+      free_cache_entry(tc->unused_tables);
 
+    mysql_mutex_unlock(&tc->lock);
     mysql_mutex_unlock(&LOCK_open);
 
     /* make a new table */
@@ -3184,13 +3446,20 @@ retry_share:
       goto err_lock;
     }
 
-    mysql_mutex_lock(&LOCK_open);
     /* Add table to the share's used tables list. */
-    table_def_add_used_table(thd, table);
+    table->cache_instance= instance;
+    mysql_mutex_lock(&tc->lock);
+    if (table_def_add_used_table(thd, table))
+    {
+      mysql_mutex_unlock(&tc->lock);
+      closefrm(table, 0);
+      my_free(table);
+      goto err_lock;
+    }
+    mysql_mutex_unlock(&tc->lock);
   }
 
-  mysql_mutex_unlock(&LOCK_open);
-
+opened:
   table->mdl_ticket= mdl_ticket;
 
   table->next= thd->open_tables;		/* Link into simple list */
@@ -9264,8 +9533,13 @@ my_bool mysql_rm_tmp_tables(void)
 void tdc_flush_unused_tables()
 {
   mysql_mutex_lock(&LOCK_open);
-  while (unused_tables)
-    free_cache_entry(unused_tables);
+  for (uint i= 0; i < table_cache_instances; i++)
+  {
+    mysql_mutex_lock(&table_cache[i].lock);
+    while (table_cache[i].unused_tables)
+      free_cache_entry(table_cache[i].unused_tables);
+    mysql_mutex_unlock(&table_cache[i].lock);
+  }
   mysql_mutex_unlock(&LOCK_open);
 }
 
@@ -9399,21 +9673,25 @@ void tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
   {
     if (share->ref_count)
     {
-      I_P_List_iterator<TABLE, TABLE_share> it(share->free_tables);
+      table_cache_lock_all();
 #ifndef DBUG_OFF
-      if (remove_type == TDC_RT_REMOVE_ALL)
+      for (uint i= 0; i < table_cache_instances; i++)
       {
-        DBUG_ASSERT(share->used_tables.is_empty());
-      }
-      else if (remove_type == TDC_RT_REMOVE_NOT_OWN ||
-               remove_type == TDC_RT_REMOVE_NOT_OWN_AND_MARK_NOT_USABLE)
-      {
-        I_P_List_iterator<TABLE, TABLE_share> it2(share->used_tables);
-        while ((table= it2++))
-          if (table->in_use != thd)
-          {
-            DBUG_ASSERT(0);
-          }
+        if (remove_type == TDC_RT_REMOVE_ALL)
+        {
+          DBUG_ASSERT(share->cache_element[i].used_tables.is_empty());
+        }
+        else if (remove_type == TDC_RT_REMOVE_NOT_OWN ||
+                 remove_type == TDC_RT_REMOVE_NOT_OWN_AND_MARK_NOT_USABLE)
+        {
+          I_P_List_iterator<TABLE, TABLE_share>
+            it2(share->cache_element[i].used_tables);
+          while ((table= it2++))
+            if (table->in_use != thd)
+            {
+              DBUG_ASSERT(0);
+            }
+        }
       }
 #endif
       /*
@@ -9423,9 +9701,9 @@ void tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
         Note that code in TABLE_SHARE::wait_for_old_version() assumes
         that marking share as old and removal of its unused tables
         and of the share itself from TDC happens atomically under
-        protection of LOCK_open, or, putting it another way, that
-        TDC does not contain old shares which don't have any tables
-        used.
+        protection of LOCK_open and the table cache instances, or,
+        putting it another way, that TDC does not contain old shares
+        which don't have any tables used.
       */
       if (remove_type == TDC_RT_REMOVE_NOT_OWN)
         share->remove_from_cache_at_close();
@@ -9435,8 +9713,20 @@ void tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
         share->protect_against_usage();
       }
 
-      while ((table= it++))
-        free_cache_entry(table);
+      /*
+        Keep a reference to the share while freeing its tables, as the
+        last of them would destroy it.
+      */
+      share->ref_count++;
+      for (uint i= 0; i < table_cache_instances; i++)
+      {
+        I_P_List_iterator<TABLE, TABLE_share>
+          it(share->cache_element[i].free_tables);
+        while ((table= it++))
+          free_cache_entry(table);
+      }
+      table_cache_unlock_all();
+      release_table_share(share);
     }
     else
       (void) my_hash_delete(&table_def_cache, (uchar*) share);
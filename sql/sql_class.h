@@ -46,6 +46,7 @@
 
 
 class Reprepare_observer;
+class Prepared_statement;
 class Relay_log_info;
 
 class Query_log_event;
@@ -660,6 +661,7 @@ typedef struct system_status_var
 
   ulong empty_queries;
   ulong access_denied_errors;
+  ulong alloc_cache_hits;           /* Memory blocks reused, see my_alloc.c */
   ulong lost_connections;
   /*
     Number of statements sent from the client
@@ -1233,7 +1235,7 @@ public:
   Discrete_intervals_list auto_inc_intervals_forced;
   ulonglong limit_found_rows;
   ha_rows    cuted_fields, sent_row_count, examined_row_count;
-  ulong client_capabilities;
+  ulonglong client_capabilities;
   ulong query_plan_flags; 
   uint in_sub_stmt;
   bool enable_slow_log;
@@ -1613,6 +1615,11 @@ public:
 
   /* all prepared statements and cursors of this connection */
   Statement_map stmt_map;
+  /*
+    The prepared statement whose parameter rows are being read by an
+    INSERT during a bulk COM_STMT_EXECUTE, see bulk_parameters_set()
+  */
+  Prepared_statement *bulk_param;
   /*
     A pointer to the stack frame of handle_one_connection(),
     which is called first in the thread for handling a client
@@ -1661,7 +1668,7 @@ public:
   */
   const char *where;
 
-  ulong client_capabilities;		/* What the client supports */
+  ulonglong client_capabilities;	/* What the client supports */
   ulong max_client_packet_length;
 
   HASH		handler_tables_hash;
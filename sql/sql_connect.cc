@@ -1042,6 +1042,12 @@ bool login_connection(THD *thd)
   my_net_set_read_timeout(net, thd->variables.net_read_timeout);
   my_net_set_write_timeout(net, thd->variables.net_write_timeout);
 
+  /*
+    Read commands through a buffer, so that commands pipelined by the
+    client are read together. This has to wait until SSL is set up.
+  */
+  vio_set_buffered_read(net->vio);
+
   /*  Updates global user connection stats. */
   if (increment_connection_count(thd, TRUE))
   {
@@ -1100,8 +1106,9 @@ void prepare_new_connection_state(THD* thd)
 {
   Security_context *sctx= thd->security_ctx;
 
-  if (thd->client_capabilities & CLIENT_COMPRESS)
-    thd->net.compress=1;				// Use compression
+  if (thd->client_capabilities & CLIENT_COMPRESS)	// Use compression
+    thd->net.compress= (thd->client_capabilities & MARIADB_CLIENT_LZ_COMPRESS ?
+                        NET_COMPRESS_LZ : NET_COMPRESS_ZLIB);
 
   /*
     Much of this is duplicated in create_embedded_thd() for the
@@ -111,6 +111,8 @@
 #define USER_VARS_HASH_SIZE     16
 #define TABLE_OPEN_CACHE_MIN    400
 #define TABLE_OPEN_CACHE_DEFAULT 400
+#define TABLE_OPEN_CACHE_INSTANCES_DEFAULT 1
+#define TABLE_OPEN_CACHE_INSTANCES_MAX 64
 #define TABLE_DEF_CACHE_DEFAULT 400
 /**
   We must have room for at least 400 table definitions in the table
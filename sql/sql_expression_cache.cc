@@ -133,6 +133,16 @@ void Expression_cache_tmptable::init()
     goto error;
   }
 
+  /* The parameters are the key of the cache; HEAP can't index blobs */
+  for (Field **field= cache_table->field + 1; *field; field++)
+  {
+    if ((*field)->flags & BLOB_FLAG)
+    {
+      DBUG_PRINT("error", ("blob parameters can't be cached"));
+      goto error;
+    }
+  }
+
   field_counter= 1;
 
   if (cache_table->alloc_keys(1) ||
@@ -78,6 +78,7 @@
 #include "transaction.h"
 #include "sql_audit.h"
 #include "sql_derived.h"                        // mysql_handle_derived
+#include "sql_prepare.h"                        // bulk_parameters_set
 
 #include "debug_sync.h"
 
@@ -704,6 +705,9 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
   bool using_bulk_insert= 0;
   uint value_count;
   ulong counter = 1;
+  /* A bulk COM_STMT_EXECUTE repeats the VALUES list for each parameter row */
+  ulong iterations= bulk_parameters_iterations(thd), iteration= 0;
+  ulong row_count= values_list.elements * iterations;
   ulonglong id;
   COPY_INFO info;
   TABLE *table= 0;
@@ -833,7 +837,7 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
     For single line insert, generate an error if try to set a NOT NULL field
     to NULL.
   */
-  thd->count_cuted_fields= ((values_list.elements == 1 &&
+  thd->count_cuted_fields= ((row_count == 1 &&
                              !ignore) ?
 			    CHECK_FIELD_ERROR_FOR_NULL :
 			    CHECK_FIELD_WARN);
@@ -881,10 +885,10 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
       same table in the same connection.
     */
     if (thd->locked_tables_mode <= LTM_LOCK_TABLES &&
-       values_list.elements > 1)
+       row_count > 1)
     {
       using_bulk_insert= 1;
-      table->file->ha_start_bulk_insert(values_list.elements);
+      table->file->ha_start_bulk_insert(row_count);
     }
   }
 
@@ -899,6 +903,7 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
       table_list->prepare_check_option(thd))
     error= 1;
 
+next_bulk_row:
   while ((values= its++))
   {
     if (fields.elements || !value_count)
@@ -908,7 +913,7 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
                                                table->triggers,
                                                TRG_EVENT_INSERT))
       {
-	if (values_list.elements != 1 && ! thd->is_error())
+	if (row_count != 1 && ! thd->is_error())
 	{
 	  info.records++;
 	  continue;
@@ -953,7 +958,7 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
                                                table->triggers,
                                                TRG_EVENT_INSERT))
       {
-	if (values_list.elements != 1 && ! thd->is_error())
+	if (row_count != 1 && ! thd->is_error())
 	{
 	  info.records++;
 	  continue;
@@ -964,7 +969,7 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
     }
 
     if ((res= table_list->view_check_option(thd,
-					    (values_list.elements == 1 ?
+					    (row_count == 1 ?
 					     0 :
 					     ignore))) ==
         VIEW_CHECK_SKIP)
@@ -988,6 +993,15 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
       break;
     thd->warning_info->inc_current_row_for_warning();
   }
+  if (!error && ++iteration < iterations)
+  {
+    /* Insert the VALUES list again with the next parameter row */
+    if (!(error= bulk_parameters_set(thd)))
+    {
+      its.rewind();
+      goto next_bulk_row;
+    }
+  }
 
   free_underlaid_joins(thd, &thd->lex->select_lex);
   joins_freed= TRUE;
@@ -1126,7 +1140,7 @@ bool mysql_insert(THD *thd,TABLE_LIST *table_list,
 
   if (error)
     goto abort;
-  if (values_list.elements == 1 && (!(thd->variables.option_bits & OPTION_WARNINGS) ||
+  if (row_count == 1 && (!(thd->variables.option_bits & OPTION_WARNINGS) ||
 				    !thd->cuted_fields))
   {
     my_ok(thd, info.copied + info.deleted +
@@ -439,7 +439,7 @@ void execute_init_command(THD *thd, LEX_STRING *init_command,
                           mysql_rwlock_t *var_lock)
 {
   Vio* save_vio;
-  ulong save_client_capabilities;
+  ulonglong save_client_capabilities;
 
   mysql_rwlock_rdlock(var_lock);
   if (!init_command->length)
@@ -1471,6 +1471,9 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   thd_proc_info(thd, 0);
   thd->packet.shrink(thd->variables.net_buffer_length);	// Reclaim some memory
   free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
+  /* Count the memory blocks the thread got from its cache of freed blocks */
+  thd->status_var.alloc_cache_hits+= thd->mysys_var->alloc_cache_hits;
+  thd->mysys_var->alloc_cache_hits= 0;
 
 #if defined(ENABLED_PROFILING)
   thd->profiling.finish_current_query();
@@ -159,9 +159,16 @@ public:
   uint last_errno;
   uint flags;
   char last_error[MYSQL_ERRMSG_SIZE];
+  /*
+    Bulk execution: number of parameter rows in the packet, where the
+    row after the last one read starts and where the packet ends
+  */
+  ulong bulk_rows;
+  uchar *bulk_pos, *bulk_end;
 #ifndef EMBEDDED_LIBRARY
-  bool (*set_params)(Prepared_statement *st, uchar *data, uchar *data_end,
-                     uchar *read_pos, String *expanded_query);
+  bool (*set_params)(Prepared_statement *st, uchar *null_array,
+                     uchar **read_pos, uchar *data_end,
+                     String *expanded_query);
 #else
   bool (*set_params_data)(Prepared_statement *st, String *expanded_query);
 #endif
@@ -183,6 +190,11 @@ public:
   bool execute_loop(String *expanded_query,
                     bool open_cursor,
                     uchar *packet_arg, uchar *packet_end_arg);
+#ifndef EMBEDDED_LIBRARY
+  bool execute_bulk_loop(String *expanded_query,
+                         bool open_cursor, ulong iterations,
+                         uchar *packet_arg, uchar *packet_end_arg);
+#endif
   bool execute_server_runnable(Server_runnable *server_runnable);
   /* Destroy this statement */
   void deallocate();
@@ -196,6 +208,7 @@ private:
   bool set_db(const char *db, uint db_length);
   bool set_parameters(String *expanded_query,
                       uchar *packet, uchar *packet_end);
+  friend bool bulk_parameters_set(THD *thd);
   bool execute(String *expanded_query, bool open_cursor);
   bool reprepare();
   bool validate_metadata(Prepared_statement  *copy);
@@ -850,12 +863,13 @@ inline bool is_param_long_data_type(Item_param *param)
 */
 
 static bool insert_params_with_log(Prepared_statement *stmt, uchar *null_array,
-                                   uchar *read_pos, uchar *data_end,
+                                   uchar **data, uchar *data_end,
                                    String *query)
 {
   THD  *thd= stmt->thd;
   Item_param **begin= stmt->param_array;
   Item_param **end= begin + stmt->param_count;
+  uchar *read_pos= *data;
   uint32 length= 0;
   String str;
   const String *res;
@@ -905,16 +919,18 @@ static bool insert_params_with_log(Prepared_statement *stmt, uchar *null_array,
 
     length+= res->length()-1;
   }
+  *data= read_pos;
   DBUG_RETURN(0);
 }
 
 
 static bool insert_params(Prepared_statement *stmt, uchar *null_array,
-                          uchar *read_pos, uchar *data_end,
+                          uchar **data, uchar *data_end,
                           String *expanded_query)
 {
   Item_param **begin= stmt->param_array;
   Item_param **end= begin + stmt->param_count;
+  uchar *read_pos= *data;
 
   DBUG_ENTER("insert_params");
 
@@ -945,6 +961,7 @@ static bool insert_params(Prepared_statement *stmt, uchar *null_array,
     if (param->convert_str_value(stmt->thd))
       DBUG_RETURN(1);                           /* out of memory */
   }
+  *data= read_pos;
   DBUG_RETURN(0);
 }
 
@@ -2642,6 +2659,7 @@ void mysqld_stmt_execute(THD *thd, char *packet_arg, uint packet_length)
   uchar *packet= (uchar*)packet_arg; // GCC 4.0.1 workaround
   ulong stmt_id= uint4korr(packet);
   ulong flags= (ulong) packet[4];
+  ulong iterations= uint4korr(packet + 5);
   /* Query text for binary, general or slow log, if any of them is open */
   String expanded_query;
   uchar *packet_end= packet + packet_length;
@@ -2672,7 +2690,14 @@ void mysqld_stmt_execute(THD *thd, char *packet_arg, uint packet_length)
   open_cursor= test(flags & (ulong) CURSOR_TYPE_READ_ONLY);
 
   thd->protocol= &thd->protocol_binary;
-  stmt->execute_loop(&expanded_query, open_cursor, packet, packet_end);
+#ifndef EMBEDDED_LIBRARY
+  /* Old clients may send any iteration count, it was never used before */
+  if (iterations > 1 && (thd->client_capabilities & MARIADB_CLIENT_STMT_BULK))
+    stmt->execute_bulk_loop(&expanded_query, open_cursor, iterations,
+                            packet, packet_end);
+  else
+#endif
+    stmt->execute_loop(&expanded_query, open_cursor, packet, packet_end);
   thd->protocol= save_protocol;
 
   sp_cache_enforce_limit(thd->sp_proc_cache, stored_program_cache_size);
@@ -3136,7 +3161,10 @@ Prepared_statement::Prepared_statement(THD *thd_arg)
   cursor(0),
   param_count(0),
   last_errno(0),
-  flags((uint) IS_IN_USE)
+  flags((uint) IS_IN_USE),
+  bulk_rows(1),
+  bulk_pos(0),
+  bulk_end(0)
 {
   init_sql_alloc(&main_mem_root, thd_arg->variables.query_alloc_block_size,
                   thd_arg->variables.query_prealloc_size);
@@ -3465,7 +3493,7 @@ Prepared_statement::set_parameters(String *expanded_query,
 #ifndef EMBEDDED_LIBRARY
     uchar *null_array= packet;
     res= (setup_conversion_functions(this, &packet, packet_end) ||
-          set_params(this, null_array, packet, packet_end, expanded_query));
+          set_params(this, null_array, &packet, packet_end, expanded_query));
 #else
     /*
       In embedded library we re-install conversion routines each time
@@ -3481,6 +3509,8 @@ Prepared_statement::set_parameters(String *expanded_query,
              is_sql_ps ? "EXECUTE" : "mysqld_stmt_execute");
     reset_stmt_params(this);
   }
+  /* The next parameter row of a bulk execution starts here */
+  bulk_pos= packet;
   return res;
 }
 
@@ -3583,6 +3613,183 @@ reexecute:
 }
 
 
+#ifndef EMBEDDED_LIBRARY
+static bool bulk_items_are_simple(List<Item> &items)
+{
+  List_iterator_fast<Item> it(items);
+  Item *item;
+  while ((item= it++))
+  {
+    if (item->type() != Item::PARAM_ITEM && !item->basic_const_item())
+      return FALSE;
+  }
+  return TRUE;
+}
+
+
+/**
+  Check that the values of an INSERT, and those of its ON DUPLICATE KEY
+  UPDATE, are parameter markers or literals.
+
+  Other items are fixed only once, and one that depends on a parameter
+  may keep a value computed from the first parameter row, like the
+  charset conversion of a constant argument of a function.
+*/
+
+static bool bulk_insert_values_are_simple(LEX *lex)
+{
+  List_iterator_fast<List_item> its(lex->many_values);
+  List_item *values;
+  while ((values= its++))
+  {
+    if (!bulk_items_are_simple(*values))
+      return FALSE;
+  }
+  return bulk_items_are_simple(lex->value_list);
+}
+
+
+/**
+  Execute a prepared statement once for each parameter row of a bulk
+  COM_STMT_EXECUTE (the client has set MARIADB_CLIENT_STMT_BULK and sent an
+  iteration count greater than one).
+
+    Each parameter row is laid out like the parameter data of an
+    ordinary COM_STMT_EXECUTE; only the first one can carry the
+    parameter types.
+
+    INSERT and REPLACE with a VALUES list are executed only once:
+    mysql_insert() reads the remaining rows with bulk_parameters_set(),
+    so the table is opened and locked once and the rows reach the
+    engine as one bulk insert. This needs the parameter markers to be
+    left in the query text, so it's not done if the query is expanded
+    for the binary, general or slow log. It's also not done unless all
+    the values, including those of ON DUPLICATE KEY UPDATE, are
+    parameter markers or literals. Other statements are executed once
+    per row.
+
+    Each row is ended like a statement of its own, so its memory is
+    freed and its row counters are reset, but the warnings of all rows
+    are kept. A single OK packet with the total number of affected rows
+    and warnings is sent. Execution stops at the first row that fails.
+
+  @return TRUE if an error, FALSE if success
+*/
+
+bool
+Prepared_statement::execute_bulk_loop(String *expanded_query,
+                                      bool open_cursor,
+                                      ulong iterations,
+                                      uchar *packet,
+                                      uchar *packet_end)
+{
+  ulonglong affected_rows= 0, insert_id= 0;
+  bool error= FALSE, userstat_running;
+  ulong row, warn_count= 0;
+
+  switch (lex->sql_command) {
+  case SQLCOM_INSERT:
+  case SQLCOM_REPLACE:
+  case SQLCOM_INSERT_SELECT:
+  case SQLCOM_REPLACE_SELECT:
+  case SQLCOM_UPDATE:
+  case SQLCOM_UPDATE_MULTI:
+  case SQLCOM_DELETE:
+  case SQLCOM_DELETE_MULTI:
+    if (!open_cursor)
+      break;
+    /* fall through */
+  default:
+    /* The client can't read more than one result */
+    my_error(ER_UNSUPPORTED_PS, MYF(0));
+    return TRUE;
+  }
+
+  bulk_end= packet_end;
+  if ((lex->sql_command == SQLCOM_INSERT ||
+       lex->sql_command == SQLCOM_REPLACE) &&
+      lex->query_tables->lock_type != TL_WRITE_DELAYED &&
+      set_params == insert_params &&
+      bulk_insert_values_are_simple(lex))
+  {
+    bulk_rows= iterations;
+    thd->bulk_param= this;
+    error= execute_loop(expanded_query, FALSE, packet, packet_end);
+    thd->bulk_param= 0;
+    bulk_rows= 1;
+    return error;
+  }
+
+  for (row= 0; row < iterations; row++)
+  {
+    if (row)
+    {
+      /* End the previous row as if it was a statement of its own */
+      packet= bulk_pos;
+      thd->cleanup_after_query();
+      free_root(thd->mem_root, MYF(MY_KEEP_PREALLOC));
+      warn_count+= thd->warning_info->statement_warn_count();
+      /* The user statistics keep counting from the first row */
+      userstat_running= thd->userstat_running;
+      mysql_reset_thd_for_next_command(thd, FALSE);
+      thd->userstat_running= userstat_running;
+    }
+    if ((error= execute_loop(expanded_query, FALSE, packet, packet_end)))
+      break;
+    if (thd->stmt_da->is_ok())
+    {
+      affected_rows+= thd->stmt_da->affected_rows();
+      if (!insert_id)
+        insert_id= thd->stmt_da->last_insert_id();
+    }
+  }
+  if (!error)
+  {
+    thd->stmt_da->reset_diagnostics_area();
+    my_ok(thd, affected_rows, insert_id);
+    /* Count the warnings of the earlier rows too */
+    for (; warn_count; warn_count--)
+      thd->stmt_da->increment_warning();
+  }
+  return error;
+}
+#endif /* EMBEDDED_LIBRARY */
+
+
+/**
+  Number of parameter rows the statement being executed has to process.
+
+  @return the number of rows of a bulk COM_STMT_EXECUTE that is run in
+  one execution, 1 otherwise (also for the statements of stored
+  routines and triggers invoked by it)
+*/
+
+ulong bulk_parameters_iterations(THD *thd)
+{
+  Prepared_statement *stmt= thd->bulk_param;
+  if (!stmt || stmt->lex != thd->lex)
+    return 1;
+  return stmt->bulk_rows;
+}
+
+
+/**
+  Assign the next parameter row of a bulk COM_STMT_EXECUTE to the
+  parameter markers of the statement being executed.
+
+  @retval TRUE  malformed packet or conversion error, reported to the client
+  @retval FALSE success
+*/
+
+bool bulk_parameters_set(THD *thd)
+{
+  Prepared_statement *stmt= thd->bulk_param;
+  String unused;
+  DBUG_ASSERT(stmt && stmt->lex == thd->lex);
+  return stmt->set_parameters(&unused, stmt->bulk_pos, stmt->bulk_end);
+}
+
+
 bool
 Prepared_statement::execute_server_runnable(Server_runnable *server_runnable)
 {
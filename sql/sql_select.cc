@@ -14694,9 +14694,15 @@ create_tmp_table(THD *thd, TMP_TABLE_PARAM *param, List<Item> &fields,
   share->fields= field_count;
   share->column_bitmap_size= bitmap_buffer_size(share->fields);
 
-  /* If result table is small; use a heap */
+  /*
+    If result table is small; use a heap. HEAP can store blobs, but not
+    the unique constraint over all columns that DISTINCT needs for them.
+    Information schema tables with blobs keep using the on-disk engine,
+    as their engine is shown to the users.
+  */
   /* future: storage engine selection can be made dynamic? */
-  if (blob_count || using_unique_constraint
+  if ((blob_count && (distinct || param->schema_table)) ||
+      using_unique_constraint
       || (thd->variables.big_tables && !(select_options & SELECT_SMALL_RESULT))
       || (select_options & TMP_TABLE_FORCE_MYISAM)
       || thd->variables.tmp_table_size == 0)
@@ -19500,8 +19506,8 @@ remove_duplicates(JOIN *join, TABLE *table, List<Item> &fields, Item *having)
 
   free_io_cache(table);				// Safety
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
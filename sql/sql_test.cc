@@ -20,7 +20,7 @@
 #include "sql_priv.h"
 #include "unireg.h"
 #include "sql_test.h"
-#include "sql_base.h" // table_def_cache, table_cache_count, unused_tables
+#include "sql_base.h" // table_def_cache, table_cache_lock_all
 #include "sql_show.h" // calc_sum_of_all_status
 #include "sql_select.h"
 #include "keycaches.h"
@@ -78,56 +78,59 @@ print_where(COND *cond,const char *info, enum_query_type query_type)
 
 static void print_cached_tables(void)
 {
-  uint idx,count,unused;
+  uint idx,i,count,unused;
+  const char *error;
   TABLE_SHARE *share;
-  TABLE *start_link, *lnk, *entry;
+  TABLE *entry;
 
   compile_time_assert(TL_WRITE_ONLY+1 == array_elements(lock_descriptions));
 
   /* purecov: begin tested */
   mysql_mutex_lock(&LOCK_open);
+  table_cache_lock_all();
   puts("DB             Table                            Version  Thread  Open  Lock");
 
-  for (idx=unused=0 ; idx < table_def_cache.records ; idx++)
+  for (idx=0 ; idx < table_def_cache.records ; idx++)
   {
     share= (TABLE_SHARE*) my_hash_element(&table_def_cache, idx);
 
-    I_P_List_iterator<TABLE, TABLE_share> it(share->used_tables);
-    while ((entry= it++))
+    for (i= 0; i < table_cache_instances; i++)
     {
-      printf("%-14.14s %-32s%6ld%8ld%6d  %s\n",
-             entry->s->db.str, entry->s->table_name.str, entry->s->version,
-             entry->in_use->thread_id, entry->db_stat ? 1 : 0,
-             lock_descriptions[(int)entry->reginfo.lock_type]);
-    }
-    it.init(share->free_tables);
-    while ((entry= it++))
-    {
-      unused++;
-      printf("%-14.14s %-32s%6ld%8ld%6d  %s\n",
-             entry->s->db.str, entry->s->table_name.str, entry->s->version,
-             0L, entry->db_stat ? 1 : 0, "Not in use");
+      I_P_List_iterator<TABLE, TABLE_share>
+        it(share->cache_element[i].used_tables);
+      while ((entry= it++))
+      {
+        printf("%-14.14s %-32s%6ld%8ld%6d  %s\n",
+               entry->s->db.str, entry->s->table_name.str, entry->s->version,
+               entry->in_use->thread_id, entry->db_stat ? 1 : 0,
+               lock_descriptions[(int)entry->reginfo.lock_type]);
+      }
+      it.init(share->cache_element[i].free_tables);
+      while ((entry= it++))
+      {
+        printf("%-14.14s %-32s%6ld%8ld%6d  %s\n",
+               entry->s->db.str, entry->s->table_name.str, entry->s->version,
+               0L, entry->db_stat ? 1 : 0, "Not in use");
+      }
     }
   }
-  count=0;
-  if ((start_link=lnk=unused_tables))
+  for (i= 0; i < table_cache_instances; i++)
   {
-    do
-    {
-      if (lnk != lnk->next->prev || lnk != lnk->prev->next)
-      {
-	printf("unused_links isn't linked properly\n");
-	return;
-      }
-    } while (count++ < cached_open_tables() && (lnk=lnk->next) != start_link);
-    if (lnk != start_link)
+    for (idx=unused=0 ; idx < table_def_cache.records ; idx++)
     {
-      printf("Unused_links aren't connected\n");
+      share= (TABLE_SHARE*) my_hash_element(&table_def_cache, idx);
+      I_P_List_iterator<TABLE, TABLE_share>
+        it(share->cache_element[i].free_tables);
+      while (it++)
+        unused++;
     }
+    if ((error= table_cache_check_unused_links(i, &count)))
+      printf("Table cache instance %u: %s\n", i, error);
+    else if (count != unused)
+      printf("Table cache instance %u: Unused_links (%d) doesn't match "
+             "table_def_cache: %d\n", i, count, unused);
   }
-  if (count != unused)
-    printf("Unused_links (%d) doesn't match table_def_cache: %d\n", count,
-           unused);
+  table_cache_unlock_all();
   printf("\nCurrent refresh version: %ld\n",refresh_version);
   if (my_hash_check(&table_def_cache))
     printf("Error: Table definition hash table is corrupted\n");
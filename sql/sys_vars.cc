@@ -2272,6 +2272,17 @@ static Sys_var_ulong Sys_table_cache_size(
        VALID_RANGE(1, 512*1024), DEFAULT(TABLE_OPEN_CACHE_DEFAULT),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_table_cache_instances(
+       "table_open_cache_instances",
+       "The number of instances of the open tables cache. A connection "
+       "uses the instance chosen by its thread id, so that connections "
+       "using different instances do not contend for the same mutex. "
+       "table_open_cache is divided between the instances, so raise it "
+       "together with this value",
+       READ_ONLY GLOBAL_VAR(table_cache_instances), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, TABLE_OPEN_CACHE_INSTANCES_MAX),
+       DEFAULT(TABLE_OPEN_CACHE_INSTANCES_DEFAULT), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_thread_cache_size(
        "thread_cache_size",
        "How many threads we should keep in a cache for reuse",
@@ -3703,6 +3714,18 @@ static Sys_var_keycache Sys_key_cache_segments(
        BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(repartition_keycache));
 
+static Sys_var_keycache Sys_key_cache_clock_replacement(
+       "key_cache_clock_replacement",
+       "Use CLOCK replacement instead of LRU in a key cache. Such a key "
+       "cache serves the reads of cached blocks without locking, and "
+       "ignores key_cache_segments, key_cache_division_limit and "
+       "key_cache_age_threshold",
+       KEYCACHE_VAR(param_clock_replacement),
+       CMD_LINE(REQUIRED_ARG, OPT_KEY_CACHE_CLOCK_REPLACEMENT),
+       VALID_RANGE(0, 1), DEFAULT(0),
+       BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(repartition_keycache));
+
 static const char *log_slow_filter_names[]= 
 { "admin", "filesort", "filesort_on_disk", "full_join", "full_scan",
   "query_cache", "query_cache_miss", "tmp_table", "tmp_table_on_disk", 0
@@ -296,6 +296,7 @@ TABLE_SHARE *alloc_table_share(TABLE_LIST *table_list, char *key,
 {
   MEM_ROOT mem_root;
   TABLE_SHARE *share;
+  Table_cache_element *cache_element;
   char *key_buff, *path_buff;
   char path[FN_REFLEN];
   uint path_length;
@@ -311,6 +312,8 @@ TABLE_SHARE *alloc_table_share(TABLE_LIST *table_list, char *key,
                        &share, sizeof(*share),
                        &key_buff, key_length,
                        &path_buff, path_length + 1,
+                       &cache_element, (sizeof(*cache_element) *
+                                        table_cache_instances),
                        NULL))
   {
     bzero((char*) share, sizeof(*share));
@@ -335,8 +338,12 @@ TABLE_SHARE *alloc_table_share(TABLE_LIST *table_list, char *key,
     share->table_map_id= ~0UL;
     share->cached_row_logging_check= -1;
 
-    share->used_tables.empty();
-    share->free_tables.empty();
+    share->cache_element= cache_element;
+    for (uint i= 0; i < table_cache_instances; i++)
+    {
+      cache_element[i].used_tables.empty();
+      cache_element[i].free_tables.empty();
+    }
     share->m_flush_tickets.empty();
 
     memcpy((char*) &share->mem_root, (char*) &mem_root, sizeof(mem_root));
@@ -400,8 +407,6 @@ void init_tmp_table_share(THD *thd, TABLE_SHARE *share, const char *key,
   */
   share->table_map_id= (ulong) thd->query_id;
 
-  share->used_tables.empty();
-  share->free_tables.empty();
   share->m_flush_tickets.empty();
 
   DBUG_VOID_RETURN;
@@ -3748,18 +3753,17 @@ bool TABLE_SHARE::visit_subgraph(Wait_for_flush *wait_for_flush,
   TABLE *table;
   MDL_context *src_ctx= wait_for_flush->get_ctx();
   bool result= TRUE;
+  uint i;
 
   /*
-    To protect used_tables list from being concurrently modified
-    while we are iterating through it we acquire LOCK_open.
-    This does not introduce deadlocks in the deadlock detector
-    because we won't try to acquire LOCK_open while
-    holding a write-lock on MDL_lock::m_rwlock.
+    To protect used_tables lists from being concurrently modified
+    while we are iterating through them we lock all instances of the
+    table cache. This does not introduce deadlocks in the deadlock
+    detector because we won't try to lock them while holding a
+    write-lock on MDL_lock::m_rwlock.
   */
-  if (gvisitor->m_lock_open_count++ == 0)
-    mysql_mutex_lock(&LOCK_open);
-
-  I_P_List_iterator <TABLE, TABLE_share> tables_it(used_tables);
+  if (gvisitor->m_table_cache_lock_count++ == 0)
+    table_cache_lock_all();
 
   /*
     In case of multiple searches running in parallel, avoid going
@@ -3775,20 +3779,29 @@ bool TABLE_SHARE::visit_subgraph(Wait_for_flush *wait_for_flush,
   if (gvisitor->enter_node(src_ctx))
     goto end;
 
-  while ((table= tables_it++))
+  for (i= 0; i < table_cache_instances; i++)
   {
-    if (gvisitor->inspect_edge(&table->in_use->mdl_context))
+    I_P_List_iterator <TABLE, TABLE_share>
+      tables_it(cache_element[i].used_tables);
+    while ((table= tables_it++))
     {
-      goto end_leave_node;
+      if (gvisitor->inspect_edge(&table->in_use->mdl_context))
+      {
+        goto end_leave_node;
+      }
     }
   }
 
-  tables_it.rewind();
-  while ((table= tables_it++))
+  for (i= 0; i < table_cache_instances; i++)
   {
-    if (table->in_use->mdl_context.visit_subgraph(gvisitor))
+    I_P_List_iterator <TABLE, TABLE_share>
+      tables_it(cache_element[i].used_tables);
+    while ((table= tables_it++))
     {
-      goto end_leave_node;
+      if (table->in_use->mdl_context.visit_subgraph(gvisitor))
+      {
+        goto end_leave_node;
+      }
     }
   }
 
@@ -3798,8 +3811,8 @@ end_leave_node:
   gvisitor->leave_node(src_ctx);
 
 end:
-  if (gvisitor->m_lock_open_count-- == 1)
-    mysql_mutex_unlock(&LOCK_open);
+  if (gvisitor->m_table_cache_lock_count-- == 1)
+    table_cache_unlock_all();
 
   return result;
 }
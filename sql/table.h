@@ -465,6 +465,23 @@ struct TABLE_share;
 
 extern ulong refresh_version;
 
+
+/**
+  Used and unused TABLE objects of a share which belong to one instance
+  of the table cache. Protected by the mutex of that instance.
+*/
+
+struct Table_cache_element
+{
+  I_P_List <TABLE, TABLE_share> used_tables;
+  I_P_List <TABLE, TABLE_share> free_tables;
+
+  bool is_empty() const
+  {
+    return used_tables.is_empty() && free_tables.is_empty();
+  }
+};
+
 typedef struct st_table_field_type
 {
   LEX_STRING name;
@@ -569,10 +586,9 @@ struct TABLE_SHARE
 
   /*
     Doubly-linked (back-linked) lists of used and unused TABLE objects
-    for this share.
+    for this share, one element for each instance of the table cache.
   */
-  I_P_List <TABLE, TABLE_share> used_tables;
-  I_P_List <TABLE, TABLE_share> free_tables;
+  Table_cache_element *cache_element;
 
   engine_option_value *option_list;     /* text options for table */
   ha_table_option_struct *option_struct; /* structure with parsed options */
@@ -977,6 +993,7 @@ private:
 public:
 
   THD	*in_use;                        /* Which thread uses this */
+  uint  cache_instance;                 /* Table cache instance of this */
   Field **field;			/* Pointer to fields */
 
   uchar *record[2];			/* Pointer to records */
@@ -98,6 +98,16 @@ const char **ha_heap::bas_ext() const
 */
 #define HEAP_STATS_UPDATE_THRESHOLD 10
 
+/*
+  Rows are stored in variable-length format if they have BLOBs, if they
+  have VARCHARs after the last key column and ROW_FORMAT=DYNAMIC is used,
+  or if such VARCHARs of an internal temporary table can hold at least
+  HEAP_MIN_VARCHAR_TAIL bytes. Their variable-length part is stored in
+  chunks with HEAP_CHUNK_LENGTH bytes of data.
+*/
+#define HEAP_MIN_VARCHAR_TAIL 256
+#define HEAP_CHUNK_LENGTH 256
+
 int ha_heap::open(const char *name, int mode, uint test_if_locked)
 {
   internal_table= test(test_if_locked & HA_OPEN_INTERNAL_TABLE);
@@ -368,6 +378,22 @@ int ha_heap::rnd_next(uchar *buf)
   return error;
 }
 
+int ha_heap::remember_rnd_pos()
+{
+  position((uchar*) 0);
+  saved_current_record= file->current_record;
+  saved_next_block= file->next_block;
+  return 0;
+}
+
+int ha_heap::restart_rnd_next(uchar *buf)
+{
+  /* heap_rrnd() doesn't change the scan position; restore it first */
+  file->current_record= saved_current_record;
+  file->next_block= saved_next_block;
+  return rnd_pos(buf, ref);
+}
+
 int ha_heap::rnd_pos(uchar * buf, uchar *pos)
 {
   int error;
@@ -619,6 +645,159 @@ ha_rows ha_heap::records_in_range(uint inx, key_range *min_key,
 }
 
 
+/*
+  Choose the format of the rows
+
+  SYNOPSIS
+    heap_prepare_columndef()
+    table_arg       Table
+    internal_table  Whether the table is an internal temporary table
+    fixed_length    Length of the start of the record that must be
+                    stored in the row, as it has key columns
+    hp_create_info  Where the format is stored
+    columndef       Room for 2 * fields + 1 columns
+
+  DESCRIPTION
+    If the table has BLOBs or long VARCHARs after the key columns, the
+    columns after the key columns are stored in chunks. Otherwise
+    hp_create_info->columns is left 0 and rows have fixed length.
+    BLOBs that lie between the key columns are stored in chunks too, as
+    the fixed part of the row could only hold the pointer to their data.
+
+  RETURN
+    0                     ok
+    HA_ERR_UNSUPPORTED    The table has BLOBs and its fields are not in
+                          record order
+*/
+
+static int heap_prepare_columndef(TABLE *table_arg, bool internal_table,
+                                   uint fixed_length,
+                                   HP_CREATE_INFO *hp_create_info,
+                                   HP_COLUMNDEF *columndef)
+{
+  TABLE_SHARE *share= table_arg->s;
+  uchar *record= table_arg->record[0];
+  HP_COLUMNDEF *column= columndef;
+  Field **field;
+  uint offset, varchar_length= 0, blobs= 0;
+  bool extended;
+
+  /* Columns that start in the fixed part are stored there as a whole */
+  do
+  {
+    extended= 0;
+    for (field= table_arg->field; *field; field++)
+    {
+      uint start= (uint) (*field)->offset(record);
+      uint end= start + (*field)->pack_length();
+      if (start < fixed_length && end > fixed_length)
+      {
+        fixed_length= end;
+        extended= 1;
+      }
+    }
+  } while (extended);
+
+  for (offset= fixed_length, field= table_arg->field; *field; field++)
+  {
+    uint start= (uint) (*field)->offset(record);
+    uint length= (*field)->pack_length();
+    if (start < fixed_length)
+    {
+      if ((*field)->flags & BLOB_FLAG)
+      {
+        column->type= HP_COLUMN_BLOB;
+        column->offset= start;
+        column->length= length;
+        column->length_bytes=
+          (uint8) ((Field_blob*) *field)->pack_length_no_ptr();
+        column++;
+        blobs++;
+      }
+      continue;
+    }
+    if (start < offset)
+    {
+      /* Not in record order; only rows without BLOBs can be fixed */
+      return share->blob_fields ? HA_ERR_UNSUPPORTED : 0;
+    }
+    if (start > offset)
+    {
+      /* Bytes which don't belong to a column */
+      if (column > columndef && column[-1].type == HP_COLUMN_FIXED)
+        column[-1].length+= start - offset;
+      else
+      {
+        column->type= HP_COLUMN_FIXED;
+        column->offset= offset;
+        column->length= start - offset;
+        column->length_bytes= 0;
+        column++;
+      }
+    }
+    if ((*field)->flags & BLOB_FLAG)
+    {
+      column->type= HP_COLUMN_BLOB;
+      column->length_bytes= (uint8) ((Field_blob*) *field)->pack_length_no_ptr();
+      blobs++;
+    }
+    else if ((*field)->real_type() == MYSQL_TYPE_VARCHAR)
+    {
+      column->type= HP_COLUMN_VARCHAR;
+      column->length_bytes= (uint8) ((Field_varstring*) *field)->length_bytes;
+      varchar_length+= length - column->length_bytes;
+    }
+    else if (column > columndef && column[-1].type == HP_COLUMN_FIXED)
+    {
+      column[-1].length+= length;
+      offset= start + length;
+      continue;
+    }
+    else
+    {
+      column->type= HP_COLUMN_FIXED;
+      column->length_bytes= 0;
+    }
+    column->offset= start;
+    column->length= length;
+    column++;
+    offset= start + length;
+  }
+  if (offset < share->reclength)
+  {
+    if (column > columndef && column[-1].type == HP_COLUMN_FIXED)
+      column[-1].length+= share->reclength - offset;
+    else
+    {
+      column->type= HP_COLUMN_FIXED;
+      column->offset= offset;
+      column->length= share->reclength - offset;
+      column->length_bytes= 0;
+      column++;
+    }
+  }
+
+  /*
+    The row format of information schema tables is shown to the users;
+    don't change it
+  */
+  if (!blobs &&
+      (!varchar_length ||
+       (share->row_type != ROW_TYPE_DYNAMIC &&
+        (!internal_table || varchar_length < HEAP_MIN_VARCHAR_TAIL ||
+         is_infoschema_db(share->db.str, share->db.length)))))
+    return 0;
+
+  hp_create_info->columndef= columndef;
+  hp_create_info->columns= (uint) (column - columndef);
+  hp_create_info->fixed_length= fixed_length;
+  hp_create_info->chunk_length= blobs ? HEAP_CHUNK_LENGTH :
+                                min(share->reclength - fixed_length,
+                                    HEAP_CHUNK_LENGTH);
+  return 0;
+}
+
+
 static int
 heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                             HP_CREATE_INFO *hp_create_info)
@@ -628,8 +807,10 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_COLUMNDEF *columndef;
   TABLE_SHARE *share= table_arg->s;
   bool found_real_auto_increment= 0;
+  uint fixed_length= share->null_bytes;
 
   bzero(hp_create_info, sizeof(*hp_create_info));
 
@@ -637,10 +818,13 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
     parts+= table_arg->key_info[key].key_parts;
 
   if (!(keydef= (HP_KEYDEF*) my_malloc(keys * sizeof(HP_KEYDEF) +
-				       parts * sizeof(HA_KEYSEG),
+				       parts * sizeof(HA_KEYSEG) +
+                                       (2 * share->fields + 1) *
+                                       sizeof(HP_COLUMNDEF),
 				       MYF(MY_WME))))
     return my_errno;
   seg= reinterpret_cast<HA_KEYSEG*>(keydef + keys);
+  columndef= reinterpret_cast<HP_COLUMNDEF*>(seg + parts);
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -669,6 +853,15 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
     {
       Field *field= key_part->field;
 
+      if (field->flags & BLOB_FLAG)
+      {
+        /* Blobs are stored in chunks, which can't be indexed */
+        my_free(keydef);
+        return HA_ERR_UNSUPPORTED;
+      }
+      set_if_bigger(fixed_length, (uint) field->offset(table_arg->record[0]) +
+                                  field->pack_length());
+
       if (pos->algorithm == HA_KEY_ALG_BTREE)
 	seg->type= field->key_type();
       else
@@ -716,15 +909,30 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
         seg->bit_start= ((Field_bit *) field)->bit_ofs;
         seg->bit_pos= (uint) (((Field_bit *) field)->bit_ptr -
                                           (uchar*) table_arg->record[0]);
+        set_if_bigger(fixed_length, seg->bit_pos + 1);
       }
       else
       {
         seg->bit_length= seg->bit_start= 0;
         seg->bit_pos= 0;
       }
+      if (seg->null_bit)
+        set_if_bigger(fixed_length, seg->null_pos + 1);
     }
   }
-  mem_per_row+= MY_ALIGN(share->reclength + 1, sizeof(char*));
+  if (heap_prepare_columndef(table_arg, internal_table, fixed_length,
+                             hp_create_info, columndef))
+  {
+    my_free(keydef);
+    return HA_ERR_UNSUPPORTED;
+  }
+  if (hp_create_info->columns)
+    mem_per_row+= (MY_ALIGN(hp_create_info->fixed_length + sizeof(char*) + 1,
+                            sizeof(char*)) +
+                   MY_ALIGN(hp_create_info->chunk_length + sizeof(char*),
+                            sizeof(char*)));
+  else
+    mem_per_row+= MY_ALIGN(share->reclength + 1, sizeof(char*));
   if (table_arg->found_next_number_field)
   {
     keydef[share->next_number_index].flag|= HA_AUTO_KEY;
@@ -733,6 +941,14 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  /*
+    The number of rows of internal temporary tables is limited by
+    tmp_table_size / reclength, which doesn't limit their memory if the
+    rows have BLOBs.
+  */
+  if (internal_table)
+    set_if_smaller(hp_create_info->max_table_size,
+                   current_thd->variables.tmp_table_size);
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
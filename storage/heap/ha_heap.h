@@ -33,6 +33,8 @@ class ha_heap: public handler
   /* number of records changed since last statistics update */
   uint    records_changed;
   uint    key_stat_version;
+  /* scan position saved by remember_rnd_pos() */
+  ulong   saved_current_record, saved_next_block;
   my_bool internal_table;
 public:
   ha_heap(handlerton *hton, TABLE_SHARE *table);
@@ -48,12 +50,15 @@ public:
     return ((table_share->key_info[inx].algorithm == HA_KEY_ALG_BTREE) ?
             "BTREE" : "HASH");
   }
-  /* Rows also use a fixed-size format */
-  enum row_type get_row_type() const { return ROW_TYPE_FIXED; }
+  /* Rows with BLOBs or long VARCHARs use a variable-length format */
+  enum row_type get_row_type() const
+  {
+    return (file && file->s->columns) ? ROW_TYPE_DYNAMIC : ROW_TYPE_FIXED;
+  }
   const char **bas_ext() const;
   ulonglong table_flags() const
   {
-    return (HA_FAST_KEY_READ | HA_NO_BLOBS | HA_NULL_IN_KEY |
+    return (HA_FAST_KEY_READ | HA_NULL_IN_KEY |
             HA_BINLOG_ROW_CAPABLE | HA_BINLOG_STMT_CAPABLE |
             HA_CAN_SQL_HANDLER |
             HA_REC_NOT_IN_SEQ | HA_CAN_INSERT_DELAYED | HA_NO_TRANSACTIONS |
@@ -96,6 +101,8 @@ public:
   int rnd_init(bool scan);
   int rnd_next(uchar *buf);
   int rnd_pos(uchar * buf, uchar *pos);
+  int remember_rnd_pos();
+  int restart_rnd_next(uchar *buf);
   void position(const uchar *record);
   int can_continue_handler_scan();
   int info(uint);
@@ -41,6 +41,12 @@ if (!(info->update & HA_STATE_AKTIV))\
 { my_errno=HA_ERR_NO_ACTIVE_RECORD; DBUG_RETURN(-1); }
 #define hp_find_hash(A,B) ((HASH_INFO*) hp_find_block((A),(B)))
 
+	/* Get/set the chain of chunks of a variable-length row */
+#define hp_get_chunks(share,pos,chunks) \
+  memcpy((chunks), (pos) + (share)->fixed_length, sizeof(uchar*))
+#define hp_set_chunks(share,pos,chunks) \
+  memcpy((pos) + (share)->fixed_length, (chunks), sizeof(uchar*))
+
 	/* Find pos for record and update it in info->current_ptr */
 #define hp_find_record(info,pos) (info)->current_ptr= hp_find_block(&(info)->s->block,pos)
 
@@ -63,6 +69,11 @@ extern HP_SHARE *hp_find_named_heap(const char *name);
 extern int hp_rectest(HP_INFO *info,const uchar *old);
 extern uchar *hp_find_block(HP_BLOCK *info,ulong pos);
 extern int hp_get_new_block(HP_BLOCK *info, size_t* alloc_length);
+extern uchar *hp_alloc_chunk(HP_SHARE *info);
+extern void hp_free_chunks(HP_SHARE *info, uchar *chunk);
+extern int hp_write_chunks(HP_INFO *info, const uchar *record,
+                           uchar **chunks);
+extern int hp_extract_record(HP_INFO *info, uchar *record, const uchar *pos);
 extern void hp_free(HP_SHARE *info);
 extern uchar *hp_free_level(HP_BLOCK *block,uint level,HP_PTRS *pos,
 			   uchar *last_pos);
@@ -149,3 +149,79 @@ uchar *hp_free_level(HP_BLOCK *block, uint level, HP_PTRS *pos, uchar *last_pos)
   }
   return next_ptr;			/* next memory position */
 }
+
+
+/*
+  Allocate a chunk for the variable-length part of a row
+
+  SYNOPSIS
+    hp_alloc_chunk()
+      info              Heap table
+
+  NOTES
+    Chunks of deleted rows are reused before the chunk block is grown.
+    The link to the next chunk of the row, stored at the start of the
+    chunk, is cleared.
+
+  RETURN
+    #     Chunk
+    0     Out of memory or table full; my_errno is set
+*/
+
+uchar *hp_alloc_chunk(HP_SHARE *info)
+{
+  HP_BLOCK *block= &info->chunk_block;
+  ulong block_pos;
+  uchar *chunk;
+  size_t length;
+
+  if (info->chunk_del_link)
+  {
+    chunk= info->chunk_del_link;
+    info->chunk_del_link= *((uchar**) chunk);
+    info->deleted_chunks--;
+  }
+  else
+  {
+    if (!(block_pos= (info->chunks % block->records_in_block)))
+    {
+      if (info->data_length + info->index_length >= info->max_table_size)
+      {
+        my_errno= HA_ERR_RECORD_FILE_FULL;
+        return 0;
+      }
+      if (hp_get_new_block(block, &length))
+        return 0;
+      info->data_length+= length;
+    }
+    chunk= (uchar*) block->level_info[0].last_blocks +
+           block_pos * block->recbuffer;
+  }
+  info->chunks++;
+  *((uchar**) chunk)= 0;
+  return chunk;
+}
+
+
+/*
+  Put a chain of chunks to the list of free chunks
+
+  SYNOPSIS
+    hp_free_chunks()
+      info              Heap table
+      chunk             First chunk of the chain, may be 0
+*/
+
+void hp_free_chunks(HP_SHARE *info, uchar *chunk)
+{
+  uchar *next;
+
+  for (; chunk; chunk= next)
+  {
+    next= *((uchar**) chunk);
+    *((uchar**) chunk)= info->chunk_del_link;
+    info->chunk_del_link= chunk;
+    info->chunks--;
+    info->deleted_chunks++;
+  }
+}
@@ -24,7 +24,7 @@ static void init_block(HP_BLOCK *block,uint reclength,ulong min_records,
 int heap_create(const char *name, HP_CREATE_INFO *create_info,
                 HP_SHARE **res, my_bool *created_new_share)
 {
-  uint i, j, key_segs, max_length, length;
+  uint i, j, key_segs, max_length, length, fixed_length;
   HP_SHARE *share= 0;
   HA_KEYSEG *keyseg;
   HP_KEYDEF *keydef= create_info->keydef;
@@ -60,6 +60,15 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
       so the record length should be at least sizeof(uchar*)
     */
     set_if_bigger(reclength, sizeof (uchar*));
+    fixed_length= reclength;
+    if (create_info->columns)
+    {
+      /*
+        Variable-length rows store the del_link in the fixed part of the
+        row, followed by the link to the chunks of the row
+      */
+      fixed_length= max(create_info->fixed_length, sizeof(uchar*));
+    }
     
     for (i= key_segs= max_length= 0, keyinfo= keydef; i < keys; i++, keyinfo++)
     {
@@ -145,13 +154,29 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     }
     if (!(share= (HP_SHARE*) my_malloc((uint) sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+				       create_info->columns*sizeof(HP_COLUMNDEF),
 				       MYF(MY_ZEROFILL))))
       goto err;
     share->keydef= (HP_KEYDEF*) (share + 1);
     share->key_stat_version= 1;
     keyseg= (HA_KEYSEG*) (share->keydef + keys);
-    init_block(&share->block, reclength + 1, min_records, max_records);
+    share->fixed_length= fixed_length;
+    if ((share->columns= create_info->columns))
+    {
+      share->columndef= (HP_COLUMNDEF*) (keyseg + key_segs);
+      memcpy(share->columndef, create_info->columndef,
+             (size_t) (sizeof(HP_COLUMNDEF) * create_info->columns));
+      share->visible= fixed_length + sizeof(uchar*);
+      init_block(&share->chunk_block,
+                 max(create_info->chunk_length, 1) + sizeof(uchar*),
+                 min_records, max_records);
+      /* Use the padding of the chunks for data as well */
+      share->chunk_length= share->chunk_block.recbuffer - sizeof(uchar*);
+    }
+    else
+      share->visible= reclength;
+    init_block(&share->block, share->visible + 1, min_records, max_records);
 	/* Fix keys */
     memcpy(share->keydef, keydef, (size_t) (sizeof(keydef[0]) * keys));
     for (i= 0, keyinfo= share->keydef; i < keys; i++, keyinfo++)
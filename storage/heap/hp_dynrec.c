@@ -0,0 +1,252 @@
+/* Copyright (c) 2013, Monty Program Ab
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Functions to handle variable-length rows
+
+  A variable-length row stores the first HP_SHARE::fixed_length bytes of
+  the record as is, followed by a pointer to a chain of chunks. The
+  columns in HP_SHARE::columndef are packed into the chunks:
+  HP_COLUMN_FIXED columns with their full length, VARCHAR columns with
+  their actual length and BLOB columns as the length followed by the
+  data of the blob. Each chunk starts with a pointer to the next chunk
+  of the row, followed by HP_SHARE::chunk_length bytes of data.
+*/
+
+#include "heapdef.h"
+
+typedef struct st_hp_chunk_pos
+{
+  uchar *chunk;                         /* Current chunk */
+  uint used;                            /* Bytes of data used in chunk */
+} HP_CHUNK_POS;
+
+
+static ulong hp_blob_length(uint length_bytes, const uchar *pos)
+{
+  switch (length_bytes) {
+  case 1:
+    return (ulong) *pos;
+  case 2:
+    return (ulong) uint2korr(pos);
+  case 3:
+    return (ulong) uint3korr(pos);
+  case 4:
+    return (ulong) uint4korr(pos);
+  default:
+    break;
+  }
+  return 0;
+}
+
+
+static inline uint hp_varchar_length(uint length_bytes, const uchar *pos)
+{
+  return length_bytes == 1 ? (uint) *pos : uint2korr(pos);
+}
+
+
+/* Append data to the chain of chunks, allocating chunks as needed */
+
+static my_bool hp_put_data(HP_SHARE *share, HP_CHUNK_POS *pos,
+                           const uchar *data, size_t length)
+{
+  while (length)
+  {
+    size_t part;
+    if (pos->used == share->chunk_length)
+    {
+      uchar *chunk;
+      if (!(chunk= hp_alloc_chunk(share)))
+        return 1;
+      *((uchar**) pos->chunk)= chunk;
+      pos->chunk= chunk;
+      pos->used= 0;
+    }
+    part= min(length, share->chunk_length - pos->used);
+    memcpy(pos->chunk + sizeof(uchar*) + pos->used, data, part);
+    pos->used+= (uint) part;
+    data+= part;
+    length-= part;
+  }
+  return 0;
+}
+
+
+/* Read data from the chain of chunks */
+
+static void hp_get_data(HP_SHARE *share, HP_CHUNK_POS *pos,
+                        uchar *data, size_t length)
+{
+  while (length)
+  {
+    size_t part;
+    if (pos->used == share->chunk_length)
+    {
+      pos->chunk= *((uchar**) pos->chunk);
+      pos->used= 0;
+    }
+    part= min(length, share->chunk_length - pos->used);
+    memcpy(data, pos->chunk + sizeof(uchar*) + pos->used, part);
+    pos->used+= (uint) part;
+    data+= part;
+    length-= part;
+  }
+}
+
+
+/*
+  Pack the variable-length part of a record into a new chain of chunks
+
+  SYNOPSIS
+    hp_write_chunks()
+      info              Heap table
+      record            Record to pack
+      chunks      OUT   First chunk of the chain, 0 if no data was packed
+
+  RETURN
+    0   ok
+    #   Error; nothing is allocated
+*/
+
+int hp_write_chunks(HP_INFO *info, const uchar *record, uchar **chunks)
+{
+  HP_SHARE *share= info->s;
+  HP_COLUMNDEF *column, *end;
+  HP_CHUNK_POS pos;
+  uchar *first= 0;
+  DBUG_ENTER("hp_write_chunks");
+
+  /* The first chunk is linked to 'first', as if it was the next chunk */
+  pos.chunk= (uchar*) &first;
+  pos.used= share->chunk_length;
+
+  for (column= share->columndef, end= column + share->columns;
+       column < end; column++)
+  {
+    const uchar *field= record + column->offset;
+    const uchar *data;
+    ulong length;
+
+    switch (column->type) {
+    case HP_COLUMN_VARCHAR:
+      length= column->length_bytes +
+              hp_varchar_length(column->length_bytes, field);
+      if (hp_put_data(share, &pos, field, length))
+        goto err;
+      break;
+    case HP_COLUMN_BLOB:
+      length= hp_blob_length(column->length_bytes, field);
+      memcpy(&data, field + column->length_bytes, sizeof(data));
+      if (hp_put_data(share, &pos, field, column->length_bytes) ||
+          hp_put_data(share, &pos, data, length))
+        goto err;
+      break;
+    default:
+      if (hp_put_data(share, &pos, field, column->length))
+        goto err;
+      break;
+    }
+  }
+  *chunks= first;
+  DBUG_RETURN(0);
+
+err:
+  hp_free_chunks(share, first);
+  DBUG_RETURN(my_errno);
+}
+
+
+/*
+  Copy a row to the record buffer
+
+  SYNOPSIS
+    hp_extract_record()
+      info              Heap table
+      record      OUT   Record buffer
+      pos               Row
+
+  NOTES
+    The data of blobs is copied to info->blob_buffer, which is valid
+    until the next row is read.
+
+  RETURN
+    0   ok
+    #   Error
+*/
+
+int hp_extract_record(HP_INFO *info, uchar *record, const uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  HP_COLUMNDEF *column, *end;
+  HP_CHUNK_POS chunk_pos;
+  uchar *first, *blob_data;
+  size_t blob_length= 0;
+
+  memcpy(record, pos, (size_t) share->fixed_length);
+  if (!share->columns)
+    return 0;
+
+  hp_get_chunks(share, pos, &first);
+  chunk_pos.chunk= (uchar*) &first;
+  chunk_pos.used= share->chunk_length;
+
+  for (column= share->columndef, end= column + share->columns;
+       column < end; column++)
+  {
+    uchar *field= record + column->offset;
+    ulong length;
+
+    switch (column->type) {
+    case HP_COLUMN_VARCHAR:
+      hp_get_data(share, &chunk_pos, field, column->length_bytes);
+      length= hp_varchar_length(column->length_bytes, field);
+      hp_get_data(share, &chunk_pos, field + column->length_bytes, length);
+      break;
+    case HP_COLUMN_BLOB:
+      hp_get_data(share, &chunk_pos, field, column->length_bytes);
+      length= hp_blob_length(column->length_bytes, field);
+      if (blob_length + length > info->blob_buffer_length)
+      {
+        size_t new_length= max(blob_length + length,
+                               info->blob_buffer_length * 2);
+        if (!(blob_data= (uchar*) my_realloc(info->blob_buffer, new_length,
+                                             MYF(MY_ALLOW_ZERO_PTR))))
+          return (my_errno= HA_ERR_OUT_OF_MEM);
+        info->blob_buffer= blob_data;
+        info->blob_buffer_length= new_length;
+      }
+      hp_get_data(share, &chunk_pos, info->blob_buffer + blob_length, length);
+      blob_length+= length;
+      break;
+    default:
+      hp_get_data(share, &chunk_pos, field, column->length);
+      break;
+    }
+  }
+
+  /* The blob buffer may have moved; set the blob pointers at the end */
+  for (column= share->columndef, blob_data= info->blob_buffer;
+       column < end; column++)
+  {
+    if (column->type == HP_COLUMN_BLOB)
+    {
+      uchar *field= record + column->offset;
+      memcpy(field + column->length_bytes, &blob_data, sizeof(blob_data));
+      blob_data+= hp_blob_length(column->length_bytes, field);
+    }
+  }
+  return 0;
+}
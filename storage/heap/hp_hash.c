@@ -104,6 +104,7 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
   reg1 HASH_INFO *pos,*prev_ptr;
   int flag;
   uint old_nextflag;
+  ulong hashnr;
   HP_SHARE *share=info->s;
   DBUG_ENTER("hp_search");
   old_nextflag=nextflag;
@@ -112,11 +113,17 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
 
   if (share->records)
   {
-    pos=hp_find_hash(&keyinfo->block, hp_mask(hp_hashnr(keyinfo, key),
+    hashnr= hp_hashnr(keyinfo, key);
+    pos=hp_find_hash(&keyinfo->block, hp_mask(hashnr,
 					      share->blength, share->records));
     do
     {
-      if (!hp_key_cmp(keyinfo, pos->ptr_to_rec, key))
+      /*
+        Compare the stored hash first, so that rows with another key in
+        the same chain are skipped without touching the row itself.
+      */
+      if (pos->hash_of_key == hashnr &&
+          !hp_key_cmp(keyinfo, pos->ptr_to_rec, key))
       {
 	switch (nextflag) {
 	case 0:					/* Search after key */
@@ -179,11 +186,13 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
 uchar *hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
 		      HASH_INFO *pos)
 {
+  ulong hashnr= pos->hash_of_key;        /* pos has the searched key */
   DBUG_ENTER("hp_search_next");
 
   while ((pos= pos->next_key))
   {
-    if (! hp_key_cmp(keyinfo, pos->ptr_to_rec, key))
+    if (pos->hash_of_key == hashnr &&
+        ! hp_key_cmp(keyinfo, pos->ptr_to_rec, key))
     {
       info->current_hash_ptr=pos;
       DBUG_RETURN (info->current_ptr= pos->ptr_to_rec);
@@ -57,6 +57,7 @@ C_MODE_END
 #define THD_TRN (*(TRN **)thd_ha_data(thd, maria_hton))
 
 ulong pagecache_division_limit, pagecache_age_threshold;
+ulong pagecache_segments;
 ulonglong pagecache_buffer_size;
 const char *zerofill_error_msg=
   "Table is from another system and must be zerofilled or repaired to be "
@@ -249,6 +250,14 @@ static MYSQL_SYSVAR_ULONG(pagecache_division_limit, pagecache_division_limit,
        "The minimum percentage of warm blocks in key cache", 0, 0,
        100,  1, 100, 1);
 
+static MYSQL_SYSVAR_ULONG(pagecache_segments, pagecache_segments,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "The number of segments in the page cache. Every segment has its "
+       "own lock and caches a share of the pages of every file, so that "
+       "flushing one segment does not block the others. "
+       "0 or 1 means one page cache for all pages.", 0, 0,
+       0, 0, MAX_PAGECACHE_PARTITIONS, 1);
+
 static MYSQL_SYSVAR_SET(recover, maria_recover_options, PLUGIN_VAR_OPCMDARG,
        "Specifies how corrupted tables should be automatically repaired."
        " Possible values are one or more of \"NORMAL\" (the default), "
@@ -256,8 +265,9 @@ static MYSQL_SYSVAR_SET(recover, maria_recover_options, PLUGIN_VAR_OPCMDARG,
        NULL, NULL, HA_RECOVER_DEFAULT, &maria_recover_typelib);
 
 static MYSQL_THDVAR_ULONG(repair_threads, PLUGIN_VAR_RQCMDARG,
-       "Number of threads to use when repairing Aria tables. The value of 1 "
-       "disables parallel repair.",
+       "Number of threads to use when repairing Aria tables: the keys are "
+       "collected with one thread per index, and the B-trees are built by at "
+       "most this many threads. The value of 1 disables parallel repair.",
        0, 0, 1, 1, 128, 1);
 
 static MYSQL_THDVAR_ULONG(sort_buffer_size, PLUGIN_VAR_RQCMDARG,
@@ -283,6 +293,17 @@ static MYSQL_SYSVAR_ENUM(sync_log_dir, sync_log_dir, PLUGIN_VAR_RQCMDARG,
 #endif
 my_bool use_maria_for_temp_tables= USE_ARIA_FOR_TMP_TABLES_VAL;
 
+static MYSQL_SYSVAR_ULONGLONG(tmp_table_pagecache_size,
+       maria_tmp_table_pagecache_size, PLUGIN_VAR_RQCMDARG,
+       "If not 0, every internal temporary table that is converted to Aria "
+       "caches its pages in a page cache of this size of its own, instead "
+       "of in the shared page cache. This avoids contention on the shared "
+       "page cache, and keeps temporary pages from evicting the pages of "
+       "other tables. Values smaller than 128K mean the shared page cache "
+       "is used. The memory of the cache is taken as pages are used, so a "
+       "small table only uses a small part of it.", 0, 0,
+       0, 0, 256*1024*1024ULL, 1);
+
 static MYSQL_SYSVAR_BOOL(used_for_temp_tables, 
        use_maria_for_temp_tables, PLUGIN_VAR_READONLY | PLUGIN_VAR_NOCMDOPT,
        "Whether temporary tables should be MyISAM or Aria", 0, 0,
@@ -336,7 +357,8 @@ static PSI_thread_info all_aria_threads[]=
 {
   { &key_thread_checkpoint, "checkpoint_background", PSI_FLAG_GLOBAL},
   { &key_thread_soft_sync, "soft_sync_background", PSI_FLAG_GLOBAL},
-  { &key_thread_find_all_keys, "thr_find_all_keys", 0}
+  { &key_thread_find_all_keys, "thr_find_all_keys", 0},
+  { &key_thread_write_index, "thr_write_index", 0}
 };
 
 static PSI_file_info all_aria_files[]=
@@ -1619,9 +1641,9 @@ int ha_maria::repair(THD *thd, HA_CHECK *param, bool do_optimize)
           share->data_file_type != BLOCK_RECORD)
       {
         char buf[40];
-        /* TODO: respect maria_repair_threads variable */
         my_snprintf(buf, 40, "Repair with %d threads", my_count_bits(key_map));
         thd_proc_info(thd, buf);
+        param->repair_threads= (uint) THDVAR(thd, repair_threads);
         param->testflag|= T_REP_PARALLEL;
         error= maria_repair_parallel(param, file, fixed_name,
                                      test(param->testflag & T_QUICK));
@@ -3486,6 +3508,7 @@ static int ha_maria_init(void *p)
   maria_hton->flags= HTON_CAN_RECREATE | HTON_SUPPORT_LOG_TABLES;
   bzero(maria_log_pagecache, sizeof(*maria_log_pagecache));
   maria_tmpdir= &mysql_tmpdir_list;             /* For REDO */
+  maria_pagecache->param_partitions= pagecache_segments;
   res= maria_upgrade() || maria_init() || ma_control_file_open(TRUE, TRUE) ||
     ((force_start_after_recovery_failures != 0) &&
      mark_recovery_start(log_dir)) ||
@@ -3610,11 +3633,13 @@ struct st_mysql_sys_var* system_variables[]= {
   MYSQL_SYSVAR(pagecache_age_threshold),
   MYSQL_SYSVAR(pagecache_buffer_size),
   MYSQL_SYSVAR(pagecache_division_limit),
+  MYSQL_SYSVAR(pagecache_segments),
   MYSQL_SYSVAR(recover),
   MYSQL_SYSVAR(repair_threads),
   MYSQL_SYSVAR(sort_buffer_size),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(sync_log_dir),
+  MYSQL_SYSVAR(tmp_table_pagecache_size),
   MYSQL_SYSVAR(used_for_temp_tables),
   NULL
 };
@@ -3745,8 +3770,17 @@ SHOW_VAR status_variables[]= {
   {NullS, NullS, SHOW_LONG}
 };
 
+static int show_aria_vars(THD *thd, SHOW_VAR *var, char *buff)
+{
+  /* The statistics of a segmented page cache are those of its segments */
+  pagecache_sum_partition_statistics(maria_pagecache);
+  var->type= SHOW_ARRAY;
+  var->value= (char*) &status_variables;
+  return 0;
+}
+
 static struct st_mysql_show_var aria_status_variables[]= {
-  {"Aria", (char*) &status_variables, SHOW_ARRAY},
+  {"Aria", (char*) &show_aria_vars, SHOW_FUNC},
   {NullS, NullS, SHOW_LONG}
 };
 
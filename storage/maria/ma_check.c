@@ -4147,10 +4147,12 @@ err:
 
   DESCRIPTION
     Same as maria_repair_by_sort but do it multithreaded
-    Each key is handled by a separate thread.
-    TODO: make a number of threads a parameter
+    The keys of each index are collected and sorted by a separate thread.
+    Then up to param->repair_threads threads (one per index if it is 0)
+    merge the sorted keys and build the B-trees of the indexes at the
+    same time, see _ma_thr_write_keys().
 
-    In parallel repair we use one thread per index. There are two modes:
+    To collect the keys we use one thread per index. There are two modes:
 
     Quick
 
@@ -4254,8 +4256,10 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
   mysql_mutex_init(key_SORT_INFO_mutex, &sort_info.mutex, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_SORT_INFO_cond, &sort_info.cond, 0);
 
+  /* Every thread of _ma_thr_write_keys() needs its own sort-key-blocks */
   if (!(sort_info.key_block=
-	alloc_key_blocks(param, (uint) param->sort_key_blocks,
+	alloc_key_blocks(param, (uint) param->sort_key_blocks *
+                         _ma_write_keys_threads(param, share->base.keys),
 			 share->base.max_key_block_length)) ||
       init_io_cache(&param->read_cache, info->dfile.file,
                     (uint) param->read_buffer_length,
@@ -5507,6 +5511,9 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
   }
   if ((sort_param->keyinfo->flag & HA_NOSAME) && cmp == 0)
   {
+    int error;
+    if (sort_info->write_lock)
+      mysql_mutex_lock(sort_info->write_lock);
     sort_info->dupp++;
     sort_info->info->cur_row.lastpos= get_record_for_key(sort_param->keyinfo,
                                                          a);
@@ -5522,7 +5529,10 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
     param->testflag|=T_RETRY_WITHOUT_QUICK;
     if (sort_info->param->testflag & T_VERBOSE)
       _ma_print_keydata(stdout,sort_param->seg, a, USE_WHOLE_KEY);
-    return (sort_delete_record(sort_param));
+    error= sort_delete_record(sort_param);
+    if (sort_info->write_lock)
+      mysql_mutex_unlock(sort_info->write_lock);
+    return error;
   }
 #ifndef DBUG_OFF
   if (cmp > 0)
@@ -5687,6 +5697,53 @@ static my_off_t get_record_for_key(MARIA_KEYDEF *keyinfo,
 } /* get_record_for_key */
 
 
+/*
+  Allocate a page in the index file and write a filled sort-key-block to it
+
+  RETURN
+    position of the page, or HA_OFFSET_ERROR on error
+*/
+
+static my_off_t sort_write_key_block(MARIA_SORT_PARAM *sort_param,
+                                     uchar *buff)
+{
+  my_off_t filepos;
+  MARIA_KEYDEF *keyinfo= sort_param->keyinfo;
+  MARIA_SORT_INFO *sort_info= sort_param->sort_info;
+  MARIA_HA *info= sort_info->info;
+  MARIA_SHARE *share= info->s;
+  MARIA_PINNED_PAGE tmp_page_link, *page_link= &tmp_page_link;
+  my_bool from_page_cache;
+
+  if (sort_info->write_lock)
+    mysql_mutex_lock(sort_info->write_lock);
+  filepos= _ma_new(info, DFLT_INIT_HITS, &page_link);
+  _ma_fast_unlock_key_del(info);
+  from_page_cache= filepos != HA_OFFSET_ERROR && page_link->changed;
+
+  /* If we read the page from the page cache, we have to write it back */
+  if (from_page_cache)
+  {
+    MARIA_PAGE page;
+    pop_dynamic(&info->pinned_pages);
+    _ma_page_setup(&page, info, keyinfo, filepos, buff);
+    if (_ma_write_keypage(&page, PAGECACHE_LOCK_WRITE_UNLOCK, DFLT_INIT_HITS))
+      filepos= HA_OFFSET_ERROR;
+  }
+  if (sort_info->write_lock)
+    mysql_mutex_unlock(sort_info->write_lock);
+
+  if (filepos != HA_OFFSET_ERROR && !from_page_cache)
+  {
+    put_crc(buff, filepos, share);
+    if (my_pwrite(share->kfile.file, buff, (uint) keyinfo->block_length,
+                  filepos, sort_info->param->myf_rw))
+      filepos= HA_OFFSET_ERROR;
+  }
+  return filepos;
+}
+
+
 /* Insert a key in sort-key-blocks */
 
 static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
@@ -5701,7 +5758,6 @@ static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
   MARIA_KEYDEF *keyinfo=sort_param->keyinfo;
   MARIA_SORT_INFO *sort_info= sort_param->sort_info;
   HA_CHECK *param=sort_info->param;
-  MARIA_PINNED_PAGE tmp_page_link, *page_link= &tmp_page_link;
   MARIA_KEY tmp_key;
   MARIA_HA *info= sort_info->info;
   MARIA_SHARE *share= info->s;
@@ -5763,26 +5819,9 @@ static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
   _ma_store_page_used(share, anc_buff, key_block->last_length);
   bzero(anc_buff+key_block->last_length,
 	keyinfo->block_length- key_block->last_length);
-  if ((filepos= _ma_new(info, DFLT_INIT_HITS, &page_link)) == HA_OFFSET_ERROR)
+  if ((filepos= sort_write_key_block(sort_param, anc_buff)) ==
+      HA_OFFSET_ERROR)
     DBUG_RETURN(1);
-  _ma_fast_unlock_key_del(info);
-
-  /* If we read the page from the key cache, we have to write it back to it */
-  if (page_link->changed)
-  {
-    MARIA_PAGE page;
-    pop_dynamic(&info->pinned_pages);
-    _ma_page_setup(&page, info, keyinfo, filepos, anc_buff);
-    if (_ma_write_keypage(&page, PAGECACHE_LOCK_WRITE_UNLOCK, DFLT_INIT_HITS))
-      DBUG_RETURN(1);
-  }
-  else
-  {
-    put_crc(anc_buff, filepos, share);
-    if (my_pwrite(share->kfile.file, anc_buff,
-                  (uint) keyinfo->block_length, filepos, param->myf_rw))
-      DBUG_RETURN(1);
-  }
   DBUG_DUMP("buff", anc_buff, _ma_get_page_used(share, anc_buff));
 
 	/* Write separator-key to block in next level */
@@ -5876,10 +5915,8 @@ int _ma_flush_pending_blocks(MARIA_SORT_PARAM *sort_param)
   my_off_t filepos;
   SORT_KEY_BLOCKS *key_block;
   MARIA_SORT_INFO *sort_info= sort_param->sort_info;
-  myf myf_rw=sort_info->param->myf_rw;
   MARIA_HA *info=sort_info->info;
   MARIA_KEYDEF *keyinfo=sort_param->keyinfo;
-  MARIA_PINNED_PAGE tmp_page_link, *page_link= &tmp_page_link;
   DBUG_ENTER("_ma_flush_pending_blocks");
 
   filepos= HA_OFFSET_ERROR;			/* if empty file */
@@ -5891,38 +5928,14 @@ int _ma_flush_pending_blocks(MARIA_SORT_PARAM *sort_param)
     if (nod_flag)
       _ma_kpointer(info,key_block->end_pos,filepos);
     bzero(key_block->buff+length, keyinfo->block_length-length);
-    if ((filepos= _ma_new(info, DFLT_INIT_HITS, &page_link)) ==
+    if ((filepos= sort_write_key_block(sort_param, key_block->buff)) ==
         HA_OFFSET_ERROR)
-      goto err;
-
-    /* If we read the page from the key cache, we have to write it back */
-    if (page_link->changed)
-    {
-      MARIA_PAGE page;
-      pop_dynamic(&info->pinned_pages);
-
-      _ma_page_setup(&page, info, keyinfo, filepos, key_block->buff);
-      if (_ma_write_keypage(&page, PAGECACHE_LOCK_WRITE_UNLOCK,
-                            DFLT_INIT_HITS))
-	goto err;
-    }
-    else
-    {
-      put_crc(key_block->buff, filepos, info->s);
-      if (my_pwrite(info->s->kfile.file, key_block->buff,
-                    (uint) keyinfo->block_length,filepos, myf_rw))
-        goto err;
-    }
+      DBUG_RETURN(1);
     DBUG_DUMP("buff",key_block->buff,length);
     nod_flag=1;
   }
   info->s->state.key_root[sort_param->key]=filepos; /* Last is root for tree */
-  _ma_fast_unlock_key_del(info);
   DBUG_RETURN(0);
-
-err:
-  _ma_fast_unlock_key_del(info);
-  DBUG_RETURN(1);
 } /* _ma_flush_pending_blocks */
 
 	/* alloc space and pointers for key_blocks */
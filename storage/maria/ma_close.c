@@ -174,6 +174,8 @@ int maria_close(register MARIA_HA *info)
       have concurrent checkpoint if no then we do not need it here also)
     */
     share->kfile.file= -1;
+    /* All pages are flushed and the data file is closed */
+    _ma_end_private_pagecache(share);
 
     /*
       Remember share->history for future opens
@@ -839,6 +839,8 @@ MARIA_HA *maria_open(const char *name, int mode, uint open_flags)
       share->write_flag=MYF(MY_NABP);
       share->w_locks++;			/* We don't have to update status */
       share->tot_locks++;
+      if (open_flags & HA_OPEN_INTERNAL_TABLE)
+        _ma_init_private_pagecache(share);
     }
 
     _ma_set_index_pagecache_callbacks(&share->kfile, share);
@@ -1025,6 +1027,7 @@ err:
     (*share->once_end)(share);
     /* fall through */
   case 4:
+    _ma_end_private_pagecache(share);
     my_free(share);
     /* fall through */
   case 3:
@@ -500,8 +500,9 @@ static void test_key_cache(PAGECACHE *pagecache,
                            const char *where, my_bool lock);
 #endif
 
-#define PAGECACHE_HASH(p, f, pos) (((ulong) (pos) +                          \
-                                    (ulong) (f).file) & (p->hash_entries-1))
+#define PAGECACHE_HASH(p, f, pos) ((((ulong) (pos) +                         \
+                                     (ulong) (f).file) / (p)->hash_factor) & \
+                                   ((p)->hash_entries-1))
 #define FILE_HASH(f) ((uint) (f).file & (PAGECACHE_CHANGED_BLOCKS_HASH - 1))
 
 #define DEFAULT_PAGECACHE_DEBUG_LOG  "pagecache_debug.log"
@@ -713,6 +714,116 @@ static inline uint next_power(uint value)
 }
 
 
+/*
+  Get the partition of a page cache that caches a page
+
+  SYNOPSIS
+    pagecache_partition()
+    pagecache                   pointer to a page cache data structure
+    file                        handler for the file of the page
+    pageno                      number of the page in the file
+
+  RETURN VALUE
+    The partition of a partitioned page cache, the page cache itself
+    otherwise.
+
+  NOTES
+    The pages of a file are spread over all partitions, in the same way as
+    the partitioned key cache does it. Every partition divides the hash
+    value by the number of partitions (hash_factor), so that its pages
+    use all of its hash table.
+*/
+
+static inline PAGECACHE *pagecache_partition(PAGECACHE *pagecache,
+                                             PAGECACHE_FILE *file,
+                                             pgcache_page_no_t pageno)
+{
+  if (!pagecache->partitions)
+    return pagecache;
+  return (pagecache->partition_array +
+          (uint) (((ulong) pageno + (ulong) file->file) %
+                  pagecache->partitions));
+}
+
+/* The partition that caches a block with a hash link, that is in use */
+#define pagecache_block_partition(P, B) \
+  pagecache_partition((P), &(B)->hash_link->file, (B)->hash_link->pageno)
+
+
+/*
+  Initialize a partitioned page cache
+
+  SYNOPSIS
+    init_partitioned_pagecache()
+    pagecache			pointer to a page cache data structure;
+                                param_partitions is the number of partitions
+    (the other parameters are the same as for init_pagecache())
+
+  RETURN VALUE
+    total number of blocks in the partitions, if successful,
+    0 - otherwise.
+
+  NOTES
+    Every partition is an independent page cache that gets an equal share
+    of the memory. The partitioned page cache itself has no blocks and no
+    cache_lock: all requests are dispatched to the partition of the page.
+*/
+
+static ulong init_partitioned_pagecache(PAGECACHE *pagecache, size_t use_mem,
+                                        uint division_limit,
+                                        uint age_threshold,
+                                        uint block_size,
+                                        myf my_readwrite_flags)
+{
+  uint i, partitions= (uint) pagecache->param_partitions;
+  ulong blocks= 0, partition_blocks;
+  DBUG_ENTER("init_partitioned_pagecache");
+
+  if (!(pagecache->partition_array= (PAGECACHE*)
+        my_malloc(sizeof(PAGECACHE) * partitions,
+                  MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(0);
+  for (i= 0; i < partitions; i++)
+  {
+    PAGECACHE *partition= pagecache->partition_array + i;
+    if (!(partition_blocks= init_pagecache(partition, use_mem / partitions,
+                                           division_limit, age_threshold,
+                                           block_size, my_readwrite_flags)))
+    {
+      do
+        end_pagecache(pagecache->partition_array + i, 1);
+      while (i--);
+      my_free(pagecache->partition_array);
+      pagecache->partition_array= NULL;
+      pagecache->can_be_used= 0;
+      DBUG_RETURN(0);
+    }
+    partition->owner= pagecache;
+    partition->hash_factor= partitions;
+    blocks+= partition_blocks;
+  }
+
+  pagecache->partitions= partitions;
+  pagecache->owner= pagecache;
+  pagecache->hash_factor= 1;
+  pagecache->mem_size= use_mem;
+  pagecache->block_size= block_size;
+  pagecache->shift= my_bit_log2(block_size);
+  pagecache->readwrite_flags= my_readwrite_flags | MY_NABP | MY_WAIT_IF_FULL;
+  pagecache->org_readwrite_flags= pagecache->readwrite_flags;
+  pagecache->disk_blocks= pagecache->blocks= (long) blocks;
+  pagecache->blocks_unused= blocks;
+  pagecache->blocks_used= pagecache->blocks_changed= 0;
+  pagecache->global_blocks_changed= 0;
+  pagecache->global_cache_w_requests= pagecache->global_cache_r_requests= 0;
+  pagecache->global_cache_read= pagecache->global_cache_write= 0;
+  pagecache->in_init= 0;
+  pagecache->inited= pagecache->can_be_used= 1;
+  DBUG_PRINT("exit", ("partitions: %u  blocks: %lu", partitions, blocks));
+  DBUG_RETURN(blocks);
+}
+
+
 /*
   Initialize a page cache
 
@@ -727,6 +838,9 @@ static inline uint next_power(uint value)
     my_read_flags		Flags used for all pread/pwrite calls
 			        Usually MY_WME in case of recovery
 
+    If pagecache->param_partitions is bigger than 1, a partitioned page
+    cache is created, see init_partitioned_pagecache().
+
   RETURN VALUE
     number of blocks in the key cache, if successful,
     0 - otherwise.
@@ -750,12 +864,16 @@ ulong init_pagecache(PAGECACHE *pagecache, size_t use_mem,
   DBUG_ENTER("init_pagecache");
   DBUG_ASSERT(block_size >= 512);
 
-  PAGECACHE_DEBUG_OPEN;
   if (pagecache->inited && pagecache->disk_blocks > 0)
   {
     DBUG_PRINT("warning",("key cache already in use"));
     DBUG_RETURN(0);
   }
+  if (pagecache->param_partitions > 1)
+    DBUG_RETURN(init_partitioned_pagecache(pagecache, use_mem,
+                                           division_limit, age_threshold,
+                                           block_size, my_readwrite_flags));
+  PAGECACHE_DEBUG_OPEN;
 
   pagecache->global_cache_w_requests= pagecache->global_cache_r_requests= 0;
   pagecache->global_cache_read= pagecache->global_cache_write= 0;
@@ -779,6 +897,8 @@ ulong init_pagecache(PAGECACHE *pagecache, size_t use_mem,
   pagecache->shift= my_bit_log2(block_size);
   pagecache->readwrite_flags= my_readwrite_flags | MY_NABP | MY_WAIT_IF_FULL;
   pagecache->org_readwrite_flags= pagecache->readwrite_flags;
+  pagecache->owner= pagecache;
+  pagecache->hash_factor= 1;
   DBUG_PRINT("info", ("block_size: %u", block_size));
   DBUG_ASSERT(((uint)(1 << pagecache->shift)) == block_size);
 
@@ -841,12 +961,13 @@ ulong init_pagecache(PAGECACHE *pagecache, size_t use_mem,
     (PAGECACHE_HASH_LINK*) ((char*) pagecache->hash_root +
                             ALIGN_SIZE((sizeof(PAGECACHE_HASH_LINK*) *
                                         pagecache->hash_entries)));
-  bzero((uchar*) pagecache->block_root,
-        pagecache->disk_blocks * sizeof(PAGECACHE_BLOCK_LINK));
+  /*
+    The blocks and hash links are taken from their arrays in order, and
+    each one is cleared when it's taken for the first time. So memory is
+    only touched for the blocks in use.
+  */
   bzero((uchar*) pagecache->hash_root,
         pagecache->hash_entries * sizeof(PAGECACHE_HASH_LINK*));
-  bzero((uchar*) pagecache->hash_link_root,
-        pagecache->hash_links * sizeof(PAGECACHE_HASH_LINK));
   pagecache->hash_links_used= 0;
   pagecache->free_hash_list= NULL;
   pagecache->blocks_used= pagecache->blocks_changed= 0;
@@ -1099,6 +1220,15 @@ void change_pagecache_param(PAGECACHE *pagecache, uint division_limit,
 {
   DBUG_ENTER("change_pagecache_param");
 
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      change_pagecache_param(pagecache->partition_array + i,
+                             division_limit, age_threshold);
+    DBUG_VOID_RETURN;
+  }
+
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   if (division_limit)
     pagecache->min_warm_blocks= (pagecache->disk_blocks *
@@ -1162,6 +1292,22 @@ void end_pagecache(PAGECACHE *pagecache, my_bool cleanup)
   if (!pagecache->inited)
     DBUG_VOID_RETURN;
 
+  if (pagecache->partitions)
+  {
+    /* The partitions are always freed completely */
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      end_pagecache(pagecache->partition_array + i, 1);
+    my_free(pagecache->partition_array);
+    pagecache->partition_array= NULL;
+    pagecache->partitions= 0;
+    pagecache->disk_blocks= -1;
+    pagecache->blocks_changed= 0;
+    if (cleanup)
+      pagecache->inited= pagecache->can_be_used= 0;
+    DBUG_VOID_RETURN;
+  }
+
   if (pagecache->disk_blocks > 0)
   {
 #ifndef DBUG_OFF
@@ -1794,6 +1940,7 @@ restart:
     else if (pagecache->hash_links_used < pagecache->hash_links)
     {
       hash_link= &pagecache->hash_link_root[pagecache->hash_links_used++];
+      bzero((uchar*) hash_link, sizeof(*hash_link));
     }
     else
     {
@@ -2017,6 +2164,7 @@ restart:
         {
           /* There are some never used blocks, take first of them */
           block= &pagecache->block_root[pagecache->blocks_used];
+          bzero((uchar*) block, sizeof(*block));
           block->buffer= ADD_TO_PTR(pagecache->block_mem,
                                     ((ulong) pagecache->blocks_used*
                                      pagecache->block_size),
@@ -2139,7 +2287,7 @@ restart:
                                     block->buffer,
                                     block->hash_link->pageno,
                                     block->type,
-                                    pagecache->readwrite_flags);
+                                    pagecache->owner->readwrite_flags);
             pagecache_pthread_mutex_lock(&pagecache->cache_lock);
 	    pagecache->global_cache_write++;
           }
@@ -2708,7 +2856,7 @@ static void read_block(PAGECACHE *pagecache,
     error= pagecache_fread(pagecache, &block->hash_link->file,
                            block->buffer,
                            block->hash_link->pageno,
-                           pagecache->readwrite_flags);
+                           pagecache->owner->readwrite_flags);
     pagecache_pthread_mutex_lock(&pagecache->cache_lock);
     if (error)
     {
@@ -2844,6 +2992,7 @@ void pagecache_unlock(PAGECACHE *pagecache,
   DBUG_ASSERT(pin != PAGECACHE_PIN);
   DBUG_ASSERT(lock != PAGECACHE_LOCK_READ && lock != PAGECACHE_LOCK_WRITE);
 
+  pagecache= pagecache_partition(pagecache, file, pageno);
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   /*
     As soon as we keep lock cache can be used, and we have lock because want
@@ -2933,6 +3082,7 @@ void pagecache_unpin(PAGECACHE *pagecache,
   DBUG_ENTER("pagecache_unpin");
   DBUG_PRINT("enter", ("fd: %u  page: %lu",
                        (uint) file->file, (ulong) pageno));
+  pagecache= pagecache_partition(pagecache, file, pageno);
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   /*
     As soon as we keep lock cache can be used, and we have lock bacause want
@@ -3022,6 +3172,7 @@ void pagecache_unlock_by_link(PAGECACHE *pagecache,
   DBUG_ASSERT(pin != PAGECACHE_PIN_LEFT_UNPINNED);
   DBUG_ASSERT(lock != PAGECACHE_LOCK_READ);
   DBUG_ASSERT(lock != PAGECACHE_LOCK_WRITE);
+  pagecache= pagecache_block_partition(pagecache, block);
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   if (pin == PAGECACHE_PIN_LEFT_UNPINNED &&
       lock == PAGECACHE_LOCK_READ_UNLOCK)
@@ -3126,6 +3277,8 @@ void pagecache_unpin_by_link(PAGECACHE *pagecache,
                        (uint) block->hash_link->file.file,
                        (ulong) block->hash_link->pageno));
 
+  pagecache= pagecache_block_partition(pagecache, block);
+
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   /*
     As soon as we keep lock cache can be used, and we have lock because want
@@ -3360,6 +3513,8 @@ uchar *pagecache_read(PAGECACHE *pagecache,
   DBUG_ASSERT(pageno < ((ULL(1)) << 40));
 #endif
 
+  pagecache= pagecache_partition(pagecache, file, pageno);
+
   if (!page_link)
     page_link= &fake_link;
   *page_link= 0;                                 /* Catch errors */
@@ -3509,7 +3664,7 @@ no_key_cache:					/* Key cache is not used */
   pagecache->global_cache_r_requests++;
   pagecache->global_cache_read++;
   if (pagecache_fread(pagecache, file, buff, pageno,
-                      pagecache->readwrite_flags))
+                      pagecache->owner->readwrite_flags))
     error= 1;
   DBUG_RETURN(error ? (uchar*) 0 : buff);
 }
@@ -3587,7 +3742,7 @@ static my_bool pagecache_delete_internal(PAGECACHE *pagecache,
                               block->buffer,
                               block->hash_link->pageno,
                               block->type,
-                              pagecache->readwrite_flags);
+                              pagecache->owner->readwrite_flags);
       pagecache_pthread_mutex_lock(&pagecache->cache_lock);
       pagecache->global_cache_write++;
 
@@ -3683,6 +3838,8 @@ my_bool pagecache_delete_by_link(PAGECACHE *pagecache,
               lock == PAGECACHE_LOCK_LEFT_WRITELOCKED);
   DBUG_ASSERT(block->pins != 0); /* should be pinned */
 
+  pagecache= pagecache_block_partition(pagecache, block);
+
   if (pagecache->can_be_used)
   {
     pagecache_pthread_mutex_lock(&pagecache->cache_lock);
@@ -3795,6 +3952,8 @@ my_bool pagecache_delete(PAGECACHE *pagecache,
               lock == PAGECACHE_LOCK_LEFT_WRITELOCKED);
   DBUG_ASSERT(pin == PAGECACHE_PIN ||
               pin == PAGECACHE_PIN_LEFT_PINNED);
+  pagecache= pagecache_partition(pagecache, file, pageno);
+
 restart:
 
   DBUG_ASSERT(pageno < ((ULL(1)) << 40));
@@ -3980,6 +4139,8 @@ my_bool pagecache_write_part(PAGECACHE *pagecache,
   DBUG_ASSERT(pageno < ((ULL(1)) << 40));
 #endif
 
+  pagecache= pagecache_partition(pagecache, file, pageno);
+
   if (!page_link)
     page_link= &fake_link;
   *page_link= 0;
@@ -4190,7 +4351,7 @@ no_key_cache:
       if ((error= (pagecache_fread(pagecache, file,
                                    page_buffer,
                                    pageno,
-                                   pagecache->readwrite_flags) != 0)))
+                                   pagecache->owner->readwrite_flags) != 0)))
         goto end;
       if ((file->read_callback)(page_buffer, pageno, file->callback_data))
       {
@@ -4202,7 +4363,7 @@ no_key_cache:
       buff= page_buffer;
     }
     if (pagecache_fwrite(pagecache, file, buff, pageno, type,
-                         pagecache->readwrite_flags))
+                         pagecache->owner->readwrite_flags))
       error= 1;
   }
 
@@ -4401,7 +4562,7 @@ static int flush_cached_blocks(PAGECACHE *pagecache,
                             block->buffer,
                             block->hash_link->pageno,
                             block->type,
-                            pagecache->readwrite_flags);
+                            pagecache->owner->readwrite_flags);
     pagecache_pthread_mutex_lock(&pagecache->cache_lock);
 
     if (make_lock_and_pin(pagecache, block,
@@ -4800,6 +4961,16 @@ int flush_pagecache_blocks_with_filter(PAGECACHE *pagecache,
 
   if (pagecache->disk_blocks <= 0)
     DBUG_RETURN(0);
+  if (pagecache->partitions)
+  {
+    /* Only one partition at a time is locked */
+    uint i;
+    for (i= 0, res= 0; i < pagecache->partitions; i++)
+      res|= flush_pagecache_blocks_with_filter(pagecache->partition_array + i,
+                                               file, type, filter,
+                                               filter_arg);
+    DBUG_RETURN(res);
+  }
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   inc_counter_for_resize_op(pagecache);
   res= flush_pagecache_blocks_int(pagecache, file, type, filter, filter_arg);
@@ -4836,6 +5007,12 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
   }
   DBUG_PRINT("info", ("Resetting counters for key cache %s.", name));
 
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      reset_pagecache_counters(name, pagecache->partition_array + i);
+  }
   pagecache->global_blocks_changed= 0;   /* Key_blocks_not_flushed */
   pagecache->global_cache_r_requests= 0; /* Key_read_requests */
   pagecache->global_cache_read= 0;       /* Key_reads */
@@ -4845,6 +5022,54 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
 }
 
 
+/*
+  Sum the statistics of the partitions of a page cache
+
+  SYNOPSIS
+    pagecache_sum_partition_statistics()
+    pagecache  pointer to the page cache
+
+  DESCRIPTION
+    The statistics variables of a partitioned page cache are not updated
+    by the page cache operations, which only update those of the
+    partitions. This sets them to the sums of the statistics of the
+    partitions. The sums are taken without locking the partitions, so they
+    may be slightly out of date, just like the statistics themselves.
+    Does nothing for a page cache that is not partitioned.
+*/
+
+void pagecache_sum_partition_statistics(PAGECACHE *pagecache)
+{
+  ulong blocks_used= 0, blocks_unused= 0, blocks_changed= 0;
+  ulong global_blocks_changed= 0;
+  ulonglong w_requests= 0, writes= 0, r_requests= 0, reads= 0;
+  uint i;
+
+  if (!pagecache->partitions)
+    return;
+  for (i= 0; i < pagecache->partitions; i++)
+  {
+    PAGECACHE *partition= pagecache->partition_array + i;
+    blocks_used+= partition->blocks_used;
+    blocks_unused+= partition->blocks_unused;
+    blocks_changed+= partition->blocks_changed;
+    global_blocks_changed+= partition->global_blocks_changed;
+    w_requests+= partition->global_cache_w_requests;
+    writes+= partition->global_cache_write;
+    r_requests+= partition->global_cache_r_requests;
+    reads+= partition->global_cache_read;
+  }
+  pagecache->blocks_used= blocks_used;
+  pagecache->blocks_unused= blocks_unused;
+  pagecache->blocks_changed= blocks_changed;
+  pagecache->global_blocks_changed= global_blocks_changed;
+  pagecache->global_cache_w_requests= w_requests;
+  pagecache->global_cache_write= writes;
+  pagecache->global_cache_r_requests= r_requests;
+  pagecache->global_cache_read= reads;
+}
+
+
 /**
    @brief Allocates a buffer and stores in it some info about all dirty pages
 
@@ -4865,6 +5090,60 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
      @retval 1      Error
 */
 
+/*
+  Collect the dirty pages of a partitioned page cache: the dirty pages of
+  every partition are collected under the lock of the partition only, and
+  the lists are concatenated.
+*/
+
+static my_bool
+collect_partitions_changed_blocks_with_lsn(PAGECACHE *pagecache,
+                                           LEX_STRING *str,
+                                           LSN *min_rec_lsn)
+{
+  my_bool error= 1;
+  ulonglong stored_list_size= 0;
+  LEX_STRING *part_str;
+  LSN part_min_rec_lsn;
+  uint i;
+  char *ptr;
+  DBUG_ENTER("collect_partitions_changed_blocks_with_lsn");
+
+  if (!(part_str= (LEX_STRING*) my_malloc(sizeof(LEX_STRING) *
+                                          pagecache->partitions,
+                                          MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  *min_rec_lsn= LSN_MAX;
+  str->length= 8;                               /* number of dirty pages */
+  for (i= 0; i < pagecache->partitions; i++)
+  {
+    if (pagecache_collect_changed_blocks_with_lsn(pagecache->partition_array +
+                                                  i, part_str + i,
+                                                  &part_min_rec_lsn))
+      goto err;
+    stored_list_size+= uint8korr(part_str[i].str);
+    str->length+= part_str[i].length - 8;
+    if (cmp_translog_addr(part_min_rec_lsn, *min_rec_lsn) < 0)
+      *min_rec_lsn= part_min_rec_lsn;
+  }
+  if (NULL == (str->str= my_malloc(str->length, MYF(MY_WME))))
+    goto err;
+  int8store(str->str, stored_list_size);
+  for (i= 0, ptr= str->str + 8; i < pagecache->partitions; i++)
+  {
+    memcpy(ptr, part_str[i].str + 8, part_str[i].length - 8);
+    ptr+= part_str[i].length - 8;
+  }
+  error= 0;
+
+err:
+  for (i= 0; i < pagecache->partitions; i++)
+    my_free(part_str[i].str);
+  my_free(part_str);
+  DBUG_RETURN(error);
+}
+
+
 my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
                                                   LEX_STRING *str,
                                                   LSN *min_rec_lsn)
@@ -4877,6 +5156,9 @@ my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
   DBUG_ENTER("pagecache_collect_changed_blocks_with_LSN");
 
   DBUG_ASSERT(NULL == str->str);
+  if (pagecache->partitions)
+    DBUG_RETURN(collect_partitions_changed_blocks_with_lsn(pagecache, str,
+                                                           min_rec_lsn));
   /*
     We lock the entire cache but will be quick, just reading/writing a few MBs
     of memory at most.
@@ -5008,6 +5290,13 @@ void pagecache_file_no_dirty_page(PAGECACHE *pagecache, PAGECACHE_FILE *file)
 {
   File fd= file->file;
   PAGECACHE_BLOCK_LINK *block;
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      pagecache_file_no_dirty_page(pagecache->partition_array + i, file);
+    return;
+  }
   for (block= pagecache->changed_blocks[FILE_HASH(*file)];
        block != NULL;
        block= block->next_changed)
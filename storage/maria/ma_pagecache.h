@@ -108,10 +108,16 @@ typedef struct st_pagecache_hash_link PAGECACHE_HASH_LINK;
 #define PAGECACHE_PRIORITY_LOW 0
 #define PAGECACHE_PRIORITY_DEFAULT 3
 #define PAGECACHE_PRIORITY_HIGH 6
+#define MAX_PAGECACHE_PARTITIONS 64        /* max number of partitions */
 
 /*
   The page cache structure
   It also contains read-only statistics parameters.
+
+  A partitioned page cache only dispatches the requests to its partitions,
+  which are independent page caches with their own cache_lock. The pages
+  are distributed over the partitions by the hash of the file and the page
+  number.
 */
 
 typedef struct st_pagecache
@@ -121,6 +127,7 @@ typedef struct st_pagecache
   ulong age_threshold;           /* age threshold for hot blocks             */
   ulonglong time;                /* total number of block link operations    */
   ulong hash_entries;            /* max number of entries in the hash table  */
+  uint hash_factor;              /* factor used to calculate hash function   */
   long hash_links;               /* max number of hash links                 */
   long hash_links_used;   /* number of hash links taken from free links pool */
   long disk_blocks;              /* max number of blocks in the cache        */
@@ -158,6 +165,11 @@ typedef struct st_pagecache
   ulong param_block_size;       /* size of the blocks in the key cache      */
   ulong param_division_limit;   /* min. percentage of warm blocks           */
   ulong param_age_threshold;    /* determines when hot block is downgraded  */
+  ulong param_partitions;       /* number of partitions, 0 = not partitioned */
+
+  struct st_pagecache *partition_array; /* the partitions, or NULL          */
+  struct st_pagecache *owner;   /* partitioned cache of a partition, or self */
+  uint partitions;              /* number of partitions, 0 = not partitioned */
 
   /* Statistics variables. These are reset in reset_pagecache_counters().    */
   ulong global_blocks_changed;	/* number of currently dirty blocks          */
@@ -300,6 +312,7 @@ extern my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
                                                          LEX_STRING *str,
                                                          LSN *min_lsn);
 extern int reset_pagecache_counters(const char *name, PAGECACHE *pagecache);
+extern void pagecache_sum_partition_statistics(PAGECACHE *pagecache);
 extern uchar *pagecache_block_link_to_buffer(PAGECACHE_BLOCK_LINK *block);
 
 extern uint pagecache_pagelevel(PAGECACHE_BLOCK_LINK *block);
@@ -102,3 +102,67 @@ void multi_pagecache_change(PAGECACHE *old_data,
 {
   safe_hash_change(&pagecache_hash, (uchar*) old_data, (uchar*) new_data);
 }
+
+
+/*
+  Give an internal temporary table a page cache of its own
+
+  SYNOPSIS
+    _ma_init_private_pagecache()
+    share			Share of the table, not yet used
+
+  NOTES
+    An internal temporary table is only used by the thread that created
+    it, and thrown away at the end of the statement. Its pages are cached
+    in a page cache of maria_tmp_table_pagecache_size bytes that is used
+    by nothing else, so that the thread never waits for the cache_lock of
+    the shared page cache, and the temporary pages do not evict pages of
+    real tables from it. When the private cache is full, its pages are
+    written directly to the file.
+    If the private cache cannot be created, or would be smaller than
+    MARIA_MIN_PAGE_CACHE_SIZE, the table keeps using the shared page cache.
+*/
+
+void _ma_init_private_pagecache(MARIA_SHARE *share)
+{
+  PAGECACHE *pagecache;
+  DBUG_ENTER("_ma_init_private_pagecache");
+
+  if (maria_tmp_table_pagecache_size < MARIA_MIN_PAGE_CACHE_SIZE ||
+      !(pagecache= (PAGECACHE*) my_malloc(sizeof(*pagecache),
+                                          MYF(MY_ZEROFILL))))
+    DBUG_VOID_RETURN;
+  if (!init_pagecache(pagecache, (size_t) maria_tmp_table_pagecache_size,
+                      0, 0, share->block_size, MY_WME))
+  {
+    end_pagecache(pagecache, 1);
+    my_free(pagecache);
+    DBUG_VOID_RETURN;
+  }
+  share->pagecache= pagecache;
+  share->private_pagecache= 1;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Free the private page cache of a table
+
+  SYNOPSIS
+    _ma_end_private_pagecache()
+    share			Share of the table; all its files are closed
+
+  NOTES
+    Pages still in the cache are thrown away.
+*/
+
+void _ma_end_private_pagecache(MARIA_SHARE *share)
+{
+  if (share->private_pagecache)
+  {
+    end_pagecache(share->pagecache, 1);
+    my_free(share->pagecache);
+    share->pagecache= maria_pagecache;
+    share->private_pagecache= 0;
+  }
+}
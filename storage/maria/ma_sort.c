@@ -502,56 +502,255 @@ ok:
 }
 
 
+/*
+  The threads that build the indexes in _ma_thr_write_keys(). Each thread
+  takes the next index that is not built yet, merges its keys and builds
+  its B-tree, until all indexes are built.
+*/
+
+typedef struct st_maria_write_keys
+{
+  MARIA_SORT_PARAM *sort_param;         /* Indexes to build */
+  MARIA_SORT_INFO *sort_info;           /* Shared sort info */
+  uint next_key;                        /* Protected by sort_info->mutex */
+  ulong mergebuf_length;                /* Merge buffer size of a thread */
+} MARIA_WRITE_KEYS;
+
+typedef struct st_maria_write_keys_thread
+{
+  MARIA_WRITE_KEYS *write_keys;
+  /*
+    Private copy of the shared sort info, with own sort-key-blocks and
+    fulltext buffer
+  */
+  MARIA_SORT_INFO sort_info;
+  pthread_t thr;
+} MARIA_WRITE_KEYS_THREAD;
+
+
+/*
+  Number of threads that build the indexes in _ma_thr_write_keys(). The
+  caller must allocate param->sort_key_blocks sort-key-blocks for each
+  of them.
+*/
+
+uint _ma_write_keys_threads(HA_CHECK *param, uint keys)
+{
+  if (param->repair_threads && keys > param->repair_threads)
+    return param->repair_threads;
+  return max(keys, 1);
+}
+
+
+/* Merge the keys of an index and build its B-tree */
+
+static int write_keys_of_index(MARIA_SORT_PARAM *sinfo, uchar **mergebuf,
+                               ulong *length)
+{
+  HA_CHECK *param= sinfo->sort_info->param;
+  ulong keys;
+  uint maxbuffer;
+
+  if (!sinfo->buffpek.elements)
+  {
+    int error;
+    if (param->testflag & T_VERBOSE)
+    {
+      printf("Key %d  - Dumping %u keys\n",sinfo->key+1, sinfo->keys);
+      fflush(stdout);
+    }
+    error= (write_index(sinfo, sinfo->sort_keys, sinfo->keys) ||
+            flush_maria_ft_buf(sinfo) || _ma_flush_pending_blocks(sinfo));
+    my_free(sinfo->sort_keys);
+    sinfo->sort_keys= 0;
+    return error;
+  }
+  my_free(sinfo->sort_keys);
+  sinfo->sort_keys= 0;
+
+  if (sinfo->keyinfo->flag & HA_VAR_LENGTH_KEY)
+  {
+    sinfo->write_keys=write_keys_varlen;
+    sinfo->read_to_buffer=read_to_buffer_varlen;
+    sinfo->write_key=write_merge_key_varlen;
+  }
+  else
+  {
+    sinfo->write_keys=write_keys;
+    sinfo->read_to_buffer=read_to_buffer;
+    sinfo->write_key=write_merge_key;
+  }
+  maxbuffer=sinfo->buffpek.elements-1;
+  if (!*mergebuf)
+  {
+    while (*length >= MIN_SORT_MEMORY)
+    {
+      if ((*mergebuf= my_malloc(*length, MYF(0))))
+        break;
+      *length= *length*3/4;
+    }
+    if (!*mergebuf)
+      return 1;
+  }
+  keys= *length/sinfo->key_length;
+  if (maxbuffer >= MERGEBUFF2)
+  {
+    if (param->testflag & T_VERBOSE)
+      printf("Key %d  - Merging %u keys\n",sinfo->key+1, sinfo->keys);
+    if (merge_many_buff(sinfo, keys, (uchar **) *mergebuf,
+                        dynamic_element(&sinfo->buffpek, 0, BUFFPEK *),
+                        (int*) &maxbuffer, &sinfo->tempfile))
+      return 1;
+  }
+  if (flush_io_cache(&sinfo->tempfile) ||
+      reinit_io_cache(&sinfo->tempfile,READ_CACHE,0L,0,0))
+    return 1;
+  if (param->testflag & T_VERBOSE)
+    printf("Key %d  - Last merge and dumping keys\n", sinfo->key+1);
+  return (merge_index(sinfo, keys, (uchar**) *mergebuf,
+                      dynamic_element(&sinfo->buffpek,0,BUFFPEK *),
+                      maxbuffer,&sinfo->tempfile) ||
+          flush_maria_ft_buf(sinfo) ||
+          _ma_flush_pending_blocks(sinfo));
+}
+
+
+static pthread_handler_t thr_write_index(void *arg)
+{
+  MARIA_WRITE_KEYS_THREAD *thread= (MARIA_WRITE_KEYS_THREAD*) arg;
+  MARIA_WRITE_KEYS *write_keys= thread->write_keys;
+  MARIA_SORT_INFO *sort_info= write_keys->sort_info;
+  MARIA_SORT_PARAM *sinfo;
+  uchar *mergebuf= 0;
+  ulong length= write_keys->mergebuf_length;
+  uint i;
+
+  if (my_thread_init())
+  {
+    sort_info->got_error= 1;
+    goto end;
+  }
+
+  for (;;)
+  {
+    mysql_mutex_lock(&sort_info->mutex);
+    i= write_keys->next_key++;
+    mysql_mutex_unlock(&sort_info->mutex);
+    if (i >= sort_info->total_keys || sort_info->got_error)
+      break;
+
+    sinfo= write_keys->sort_param + i;
+    sinfo->sort_info= &thread->sort_info;
+    if (write_keys_of_index(sinfo, &mergebuf, &length))
+      sort_info->got_error= 1; /* no need to protect with a mutex */
+    sinfo->sort_info= sort_info;
+  }
+  my_free(mergebuf);
+  my_thread_end();
+
+end:
+  mysql_mutex_lock(&sort_info->mutex);
+  if (!--sort_info->threads_running)
+    mysql_cond_signal(&sort_info->cond);
+  mysql_mutex_unlock(&sort_info->mutex);
+  return NULL;
+}
+
+
+/*
+  Build the indexes from the keys that _ma_thr_find_all_keys() has
+  collected
+
+  DESCRIPTION
+    The indexes are built by _ma_write_keys_threads() threads at the same
+    time. Every thread merges the keys of one index and builds its B-tree
+    at a time. The threads allocate the index pages and remove records
+    with duplicate keys under sort_info->mutex. Keys that were too long
+    for the sort are inserted afterwards, one index after the other.
+*/
+
 int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
 {
   MARIA_SORT_INFO *sort_info=sort_param->sort_info;
   HA_CHECK *param=sort_info->param;
-  ulong UNINIT_VAR(length), keys;
   double *rec_per_key_part= param->new_rec_per_key_part;
   int got_error=sort_info->got_error;
-  uint i;
+  uint i, threads;
   MARIA_HA *info=sort_info->info;
   MARIA_SHARE *share= info->s;
   MARIA_SORT_PARAM *sinfo;
-  uchar *mergebuf=0;
+  MARIA_WRITE_KEYS write_keys;
+  MARIA_WRITE_KEYS_THREAD *thread= 0;
+  pthread_attr_t thr_attr;
   DBUG_ENTER("_ma_thr_write_keys");
 
   for (i= 0, sinfo= sort_param ;
        i < sort_info->total_keys ;
-       i++, rec_per_key_part+=sinfo->keyinfo->keysegs, sinfo++)
+       i++, sinfo++)
   {
     if (!sinfo->sort_keys)
-    {
       got_error=1;
-      my_free(sinfo->rec_buff);
-      continue;
-    }
-    if (!got_error)
-    {
+    else if (!got_error)
       maria_set_key_active(share->state.key_map, sinfo->key);
+  }
+
+  threads= _ma_write_keys_threads(param, sort_info->total_keys);
+  if (!got_error &&
+      !(thread= (MARIA_WRITE_KEYS_THREAD*)
+        my_malloc(threads * sizeof(*thread), MYF(MY_WME))))
+    got_error=1;
 
-      if (!sinfo->buffpek.elements)
+  if (!got_error)
+  {
+    write_keys.sort_param= sort_param;
+    write_keys.sort_info= sort_info;
+    write_keys.next_key= 0;
+    write_keys.mergebuf_length= max((ulong) (param->sort_buffer_length /
+                                             threads),
+                                    MIN_SORT_MEMORY);
+    sort_info->got_error= 0;
+    sort_info->threads_running= threads;
+    (void) pthread_attr_init(&thr_attr);
+    (void) pthread_attr_setdetachstate(&thr_attr,PTHREAD_CREATE_DETACHED);
+
+    for (i= 0 ; i < threads ; i++)
+    {
+      thread[i].write_keys= &write_keys;
+      thread[i].sort_info= *sort_info;
+      thread[i].sort_info.write_lock= &sort_info->mutex;
+      thread[i].sort_info.ft_buf= 0;
+      thread[i].sort_info.dupp= 0;
+      thread[i].sort_info.key_block= (sort_info->key_block +
+                                      i * param->sort_key_blocks);
+      thread[i].sort_info.key_block_end= (thread[i].sort_info.key_block +
+                                          param->sort_key_blocks);
+      if (mysql_thread_create(key_thread_write_index,
+                              &thread[i].thr, &thr_attr,
+                              thr_write_index, (void *) (thread+i)))
       {
-        if (param->testflag & T_VERBOSE)
-        {
-          printf("Key %d  - Dumping %u keys\n",sinfo->key+1, sinfo->keys);
-          fflush(stdout);
-        }
-        if (write_index(sinfo, sinfo->sort_keys, sinfo->keys) ||
-            flush_maria_ft_buf(sinfo) || _ma_flush_pending_blocks(sinfo))
-          got_error=1;
+        _ma_check_print_error(param,"Cannot start a repair thread");
+        sort_info->got_error=1;
+        mysql_mutex_lock(&sort_info->mutex);
+        sort_info->threads_running--;
+        mysql_mutex_unlock(&sort_info->mutex);
       }
-      if (!got_error && param->testflag & T_STATISTICS)
-        maria_update_key_parts(sinfo->keyinfo, rec_per_key_part, sinfo->unique,
-                               param->stats_method ==
-                               MI_STATS_METHOD_IGNORE_NULLS ?
-                               sinfo->notnull : NULL,
-                               (ulonglong) share->state.state.records);
     }
-    my_free(sinfo->sort_keys);
-    my_free(sinfo->rec_buff);
-    sinfo->sort_keys=0;
+    (void) pthread_attr_destroy(&thr_attr);
+
+    mysql_mutex_lock(&sort_info->mutex);
+    while (sort_info->threads_running)
+      mysql_cond_wait(&sort_info->cond, &sort_info->mutex);
+    mysql_mutex_unlock(&sort_info->mutex);
+
+    for (i= 0 ; i < threads ; i++)
+    {
+      sort_info->dupp+= thread[i].sort_info.dupp;
+      /* An error skips flush_maria_ft_buf(), which frees ft_buf */
+      my_free(thread[i].sort_info.ft_buf);
+    }
+    got_error= sort_info->got_error;
   }
+  my_free(thread);
 
   for (i= 0, sinfo= sort_param ;
        i < sort_info->total_keys ;
@@ -559,71 +758,13 @@ int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
 	 delete_dynamic(&sinfo->buffpek),
 	 close_cached_file(&sinfo->tempfile),
 	 close_cached_file(&sinfo->tempfile_for_exceptions),
-	 sinfo++)
+         rec_per_key_part+= sinfo->keyinfo->keysegs, sinfo++)
   {
+    my_free(sinfo->sort_keys);
+    my_free(sinfo->rec_buff);
+    sinfo->sort_keys=0;
     if (got_error)
       continue;
-    if (sinfo->keyinfo->flag & HA_VAR_LENGTH_KEY)
-    {
-      sinfo->write_keys=write_keys_varlen;
-      sinfo->read_to_buffer=read_to_buffer_varlen;
-      sinfo->write_key=write_merge_key_varlen;
-    }
-    else
-    {
-      sinfo->write_keys=write_keys;
-      sinfo->read_to_buffer=read_to_buffer;
-      sinfo->write_key=write_merge_key;
-    }
-    if (sinfo->buffpek.elements)
-    {
-      uint maxbuffer=sinfo->buffpek.elements-1;
-      if (!mergebuf)
-      {
-        length=param->sort_buffer_length;
-        while (length >= MIN_SORT_MEMORY)
-        {
-          if ((mergebuf= my_malloc(length, MYF(0))))
-              break;
-          length=length*3/4;
-        }
-        if (!mergebuf)
-        {
-          got_error=1;
-          continue;
-        }
-      }
-      keys=length/sinfo->key_length;
-      if (maxbuffer >= MERGEBUFF2)
-      {
-        if (param->testflag & T_VERBOSE)
-          printf("Key %d  - Merging %u keys\n",sinfo->key+1, sinfo->keys);
-        if (merge_many_buff(sinfo, keys, (uchar **) mergebuf,
-			    dynamic_element(&sinfo->buffpek, 0, BUFFPEK *),
-			    (int*) &maxbuffer, &sinfo->tempfile))
-        {
-          got_error=1;
-          continue;
-        }
-      }
-      if (flush_io_cache(&sinfo->tempfile) ||
-          reinit_io_cache(&sinfo->tempfile,READ_CACHE,0L,0,0))
-      {
-        got_error=1;
-        continue;
-      }
-      if (param->testflag & T_VERBOSE)
-        printf("Key %d  - Last merge and dumping keys\n", sinfo->key+1);
-      if (merge_index(sinfo, keys, (uchar**) mergebuf,
-                      dynamic_element(&sinfo->buffpek,0,BUFFPEK *),
-                      maxbuffer,&sinfo->tempfile) ||
-          flush_maria_ft_buf(sinfo) ||
-	  _ma_flush_pending_blocks(sinfo))
-      {
-        got_error=1;
-        continue;
-      }
-    }
     if (my_b_inited(&sinfo->tempfile_for_exceptions))
     {
       uint16 key_length;
@@ -660,8 +801,13 @@ int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
         }
       }
     }
+    if (!got_error && param->testflag & T_STATISTICS)
+      maria_update_key_parts(sinfo->keyinfo, rec_per_key_part, sinfo->unique,
+                             param->stats_method ==
+                             MI_STATS_METHOD_IGNORE_NULLS ?
+                             sinfo->notnull : NULL,
+                             (ulonglong) share->state.state.records);
   }
-  my_free(mergebuf);
   DBUG_RETURN(got_error);
 }
 
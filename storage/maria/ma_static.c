@@ -50,6 +50,7 @@ ulong maria_concurrent_insert= 2;
 #endif
 
 my_off_t maria_max_temp_length= MAX_FILE_SIZE;
+ulonglong maria_tmp_table_pagecache_size= 0;
 ulong    maria_bulk_insert_tree_size=8192*1024;
 ulong    maria_data_pointer_size= 4;
 
@@ -141,7 +142,7 @@ PSI_rwlock_key key_KEYINFO_root_lock, key_SHARE_mmap_lock,
                key_TRANSLOG_DESCRIPTOR_open_files_lock;
 
 PSI_thread_key key_thread_checkpoint, key_thread_find_all_keys,
-               key_thread_soft_sync;
+               key_thread_soft_sync, key_thread_write_index;
 
 PSI_file_key key_file_translog, key_file_kfile, key_file_dfile,
              key_file_control, key_file_tmp;
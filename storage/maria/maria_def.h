@@ -62,6 +62,12 @@ typedef struct st_maria_sort_info
   char *buff;
   SORT_KEY_BLOCKS *key_block, *key_block_end;
   SORT_FT_BUF *ft_buf;
+  /*
+    Set when several threads build indexes of the table at the same time:
+    serializes the allocation of index pages and the removal of records
+    with duplicate keys
+  */
+  mysql_mutex_t *write_lock;
   my_off_t filelength, dupp, buff_length;
   pgcache_page_no_t page;
   ha_rows max_records;
@@ -449,6 +455,7 @@ typedef struct st_maria_share
   */
   uint8 in_checkpoint;
   my_bool temporary;
+  my_bool private_pagecache;            /* pagecache is only for this table */
   /* Below flag is needed to make log tables work with concurrent insert */
   my_bool is_log_table;
   my_bool has_null_fields;
@@ -920,7 +927,7 @@ extern PSI_rwlock_key key_KEYINFO_root_lock, key_SHARE_mmap_lock,
                       key_TRANSLOG_DESCRIPTOR_open_files_lock;
 
 extern PSI_thread_key key_thread_checkpoint, key_thread_find_all_keys,
-                      key_thread_soft_sync;
+                      key_thread_soft_sync, key_thread_write_index;
 
 extern PSI_file_key key_file_translog, key_file_kfile, key_file_dfile,
                     key_file_control, key_file_tmp;
@@ -1335,6 +1342,7 @@ C_MODE_END
 int _ma_flush_pending_blocks(MARIA_SORT_PARAM *param);
 int _ma_sort_ft_buf_flush(MARIA_SORT_PARAM *sort_param);
 int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param);
+uint _ma_write_keys_threads(HA_CHECK *param, uint keys);
 pthread_handler_t _ma_thr_find_all_keys(void *arg);
 
 int _ma_sort_write_record(MARIA_SORT_PARAM *sort_param);
@@ -1350,6 +1358,8 @@ int _ma_update_state_lsns_sub(MARIA_SHARE *share, LSN lsn,
                               my_bool update_create_rename_lsn);
 void _ma_set_data_pagecache_callbacks(PAGECACHE_FILE *file,
                                       MARIA_SHARE *share);
+void _ma_init_private_pagecache(MARIA_SHARE *share);
+void _ma_end_private_pagecache(MARIA_SHARE *share);
 void _ma_set_index_pagecache_callbacks(PAGECACHE_FILE *file,
                                        MARIA_SHARE *share);
 void _ma_tmp_disable_logging_for_table(MARIA_HA *info,
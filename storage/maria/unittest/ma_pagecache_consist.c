@@ -430,6 +430,9 @@ int main(int argc __attribute__((unused)),
   thr_setconcurrency(2);
 #endif
 
+#ifdef TEST_PAGECACHE_PARTITIONS
+  pagecache.param_partitions= TEST_PAGECACHE_PARTITIONS;
+#endif
   if ((pagen= init_pagecache(&pagecache, PCACHE_SIZE, 0, 0,
                              TEST_PAGE_SIZE, 0)) == 0)
   {
@@ -227,12 +227,14 @@ int simple_read_change_write_read_test()
                  0);
   ok((res= test(memcmp(buffr, buffw, TEST_PAGE_SIZE) == 0)),
      "Simple read-change-write-read page ");
+  pagecache_sum_partition_statistics(&pagecache);
   DBUG_ASSERT(pagecache.blocks_changed == 1);
   if (flush_pagecache_blocks(&pagecache, &file1, FLUSH_FORCE_WRITE))
   {
     diag("Got error during flushing pagecache\n");
     exit(1);
   }
+  pagecache_sum_partition_statistics(&pagecache);
   DBUG_ASSERT(pagecache.blocks_changed == 0);
   ok((res2= test(test_file(file1, file1_name, TEST_PAGE_SIZE, TEST_PAGE_SIZE,
                            simple_read_change_write_read_test_file))),
@@ -827,6 +829,9 @@ int main(int argc __attribute__((unused)),
   thr_setconcurrency(2);
 #endif
 
+#ifdef TEST_PAGECACHE_PARTITIONS
+  pagecache.param_partitions= TEST_PAGECACHE_PARTITIONS;
+#endif
   if ((pagen= init_pagecache(&pagecache, PCACHE_SIZE, 0, 0,
                              TEST_PAGE_SIZE, MYF(MY_WME))) == 0)
   {
@@ -71,7 +71,8 @@ static MYSQL_SYSVAR_SET(recover_options, myisam_recover_options,
 
 static MYSQL_THDVAR_ULONG(repair_threads, PLUGIN_VAR_RQCMDARG,
   "If larger than 1, when repairing a MyISAM table all indexes will be "
-  "created in parallel, with one thread per index. The value of 1 "
+  "created in parallel: the keys are collected with one thread per index, "
+  "and the B-trees are built by at most this many threads. The value of 1 "
   "disables parallel repair", NULL, NULL,
   1, 1, ULONG_MAX, 1);
 
@@ -1119,9 +1120,10 @@ int ha_myisam::repair(THD *thd, HA_CHECK &param, bool do_optimize)
       if (THDVAR(thd, repair_threads)>1)
       {
         char buf[40];
-        /* TODO: respect myisam_repair_threads variable */
         my_snprintf(buf, 40, "Repair with %d threads", my_count_bits(key_map));
         thd_proc_info(thd, buf);
+        param.repair_threads= (uint) min(THDVAR(thd, repair_threads),
+                                         UINT_MAX32);
         error = mi_repair_parallel(&param, file, fixed_name,
                                    test(param.testflag & T_QUICK));
         thd_proc_info(thd, "Repair done"); // to reset proc_info, as
@@ -2579,10 +2579,12 @@ err:
 
   DESCRIPTION
     Same as mi_repair_by_sort but do it multithreaded
-    Each key is handled by a separate thread.
-    TODO: make a number of threads a parameter
+    The keys of each index are collected and sorted by a separate thread.
+    Then up to param->repair_threads threads (one per index if it is 0)
+    merge the sorted keys and build the B-trees of the indexes at the
+    same time, see thr_write_keys().
 
-    In parallel repair we use one thread per index. There are two modes:
+    To collect the keys we use one thread per index. There are two modes:
 
     Quick
 
@@ -2687,8 +2689,10 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
                    &param->print_msg_mutex, MY_MUTEX_INIT_FAST);
   param->need_print_msg_lock= 1;
 
+  /* Every thread of thr_write_keys() needs its own sort-key-blocks */
   if (!(sort_info.key_block=
-	alloc_key_blocks(param, (uint) param->sort_key_blocks,
+	alloc_key_blocks(param, (uint) param->sort_key_blocks *
+                         mi_write_keys_threads(param, share->base.keys),
 			 share->base.max_key_block_length)) ||
       init_io_cache(&param->read_cache, info->dfile,
                     (uint) param->read_buffer_length,
@@ -3825,6 +3829,9 @@ static int sort_key_write(MI_SORT_PARAM *sort_param, const void *a)
   }
   if ((sort_param->keyinfo->flag & HA_NOSAME) && cmp == 0)
   {
+    int error;
+    if (sort_info->write_lock)
+      mysql_mutex_lock(sort_info->write_lock);
     sort_info->dupp++;
     sort_info->info->lastpos=get_record_for_key(sort_info->info,
 						sort_param->keyinfo,
@@ -3840,7 +3847,10 @@ static int sort_key_write(MI_SORT_PARAM *sort_param, const void *a)
     param->testflag|=T_RETRY_WITHOUT_QUICK;
     if (sort_info->param->testflag & T_VERBOSE)
       _mi_print_key(stdout,sort_param->seg,(uchar*) a, USE_WHOLE_KEY);
-    return (sort_delete_record(sort_param));
+    error= sort_delete_record(sort_param);
+    if (sort_info->write_lock)
+      mysql_mutex_unlock(sort_info->write_lock);
+    return error;
   }
 #ifndef DBUG_OFF
   if (cmp > 0)
@@ -3996,6 +4006,42 @@ static my_off_t get_record_for_key(MI_INFO *info, MI_KEYDEF *keyinfo,
 } /* get_record_for_key */
 
 
+/*
+  Allocate a page in the index file and write a filled sort-key-block to it
+
+  RETURN
+    position of the page, or HA_OFFSET_ERROR on error
+*/
+
+static my_off_t sort_write_key_block(MI_SORT_PARAM *sort_param, uchar *buff)
+{
+  my_off_t filepos, key_file_length;
+  MI_KEYDEF *keyinfo= sort_param->keyinfo;
+  MI_SORT_INFO *sort_info= sort_param->sort_info;
+  MI_INFO *info= sort_info->info;
+  my_bool from_key_cache;
+
+  if (sort_info->write_lock)
+    mysql_mutex_lock(sort_info->write_lock);
+  key_file_length=info->state->key_file_length;
+  filepos=_mi_new(info,keyinfo,DFLT_INIT_HITS);
+  from_key_cache= key_file_length == info->state->key_file_length;
+
+  /* If we read the page from the key cache, we have to write it back to it */
+  if (filepos != HA_OFFSET_ERROR && from_key_cache &&
+      _mi_write_keypage(info, keyinfo, filepos, DFLT_INIT_HITS, buff))
+    filepos= HA_OFFSET_ERROR;
+  if (sort_info->write_lock)
+    mysql_mutex_unlock(sort_info->write_lock);
+
+  if (filepos != HA_OFFSET_ERROR && !from_key_cache &&
+      mysql_file_pwrite(info->s->kfile, buff, (uint) keyinfo->block_length,
+                        filepos, sort_info->param->myf_rw))
+    filepos= HA_OFFSET_ERROR;
+  return filepos;
+}
+
+
 	/* Insert a key in sort-key-blocks */
 
 static int sort_insert_key(MI_SORT_PARAM *sort_param,
@@ -4003,7 +4049,7 @@ static int sort_insert_key(MI_SORT_PARAM *sort_param,
 			   my_off_t prev_block)
 {
   uint a_length,t_length,nod_flag;
-  my_off_t filepos,key_file_length;
+  my_off_t filepos;
   uchar *anc_buff,*lastkey;
   MI_KEY_PARAM s_temp;
   MI_INFO *info;
@@ -4055,19 +4101,8 @@ static int sort_insert_key(MI_SORT_PARAM *sort_param,
   mi_putint(anc_buff,key_block->last_length,nod_flag);
   bzero((uchar*) anc_buff+key_block->last_length,
 	keyinfo->block_length- key_block->last_length);
-  key_file_length=info->state->key_file_length;
-  if ((filepos=_mi_new(info,keyinfo,DFLT_INIT_HITS)) == HA_OFFSET_ERROR)
-    DBUG_RETURN(1);
-
-  /* If we read the page from the key cache, we have to write it back to it */
-  if (key_file_length == info->state->key_file_length)
-  {
-    if (_mi_write_keypage(info, keyinfo, filepos, DFLT_INIT_HITS, anc_buff))
-      DBUG_RETURN(1);
-  }
-  else if (mysql_file_pwrite(info->s->kfile, (uchar*) anc_buff,
-                             (uint) keyinfo->block_length, filepos,
-                             param->myf_rw))
+  if ((filepos= sort_write_key_block(sort_param, anc_buff)) ==
+      HA_OFFSET_ERROR)
     DBUG_RETURN(1);
   DBUG_DUMP("buff",(uchar*) anc_buff,mi_getint(anc_buff));
 
@@ -4144,10 +4179,9 @@ static int sort_delete_record(MI_SORT_PARAM *sort_param)
 int flush_pending_blocks(MI_SORT_PARAM *sort_param)
 {
   uint nod_flag,length;
-  my_off_t filepos,key_file_length;
+  my_off_t filepos;
   SORT_KEY_BLOCKS *key_block;
   MI_SORT_INFO *sort_info= sort_param->sort_info;
-  myf myf_rw=sort_info->param->myf_rw;
   MI_INFO *info=sort_info->info;
   MI_KEYDEF *keyinfo=sort_param->keyinfo;
   DBUG_ENTER("flush_pending_blocks");
@@ -4160,20 +4194,9 @@ int flush_pending_blocks(MI_SORT_PARAM *sort_param)
     length=mi_getint(key_block->buff);
     if (nod_flag)
       _mi_kpointer(info,(uchar*) key_block->end_pos,filepos);
-    key_file_length=info->state->key_file_length;
     bzero((uchar*) key_block->buff+length, keyinfo->block_length-length);
-    if ((filepos=_mi_new(info,keyinfo,DFLT_INIT_HITS)) == HA_OFFSET_ERROR)
-      DBUG_RETURN(1);
-
-    /* If we read the page from the key cache, we have to write it back */
-    if (key_file_length == info->state->key_file_length)
-    {
-      if (_mi_write_keypage(info, keyinfo, filepos,
-                            DFLT_INIT_HITS, (uchar*) key_block->buff))
-	DBUG_RETURN(1);
-    }
-    else if (mysql_file_pwrite(info->s->kfile, (uchar*) key_block->buff,
-                               (uint) keyinfo->block_length, filepos, myf_rw))
+    if ((filepos= sort_write_key_block(sort_param, (uchar*) key_block->buff)) ==
+        HA_OFFSET_ERROR)
       DBUG_RETURN(1);
     DBUG_DUMP("buff",(uchar*) key_block->buff,length);
     nod_flag=1;
@@ -107,11 +107,12 @@ static PSI_file_info all_myisam_files[]=
   { & mi_key_file_log, "log", 0}
 };
 
-PSI_thread_key mi_key_thread_find_all_keys;
+PSI_thread_key mi_key_thread_find_all_keys, mi_key_thread_write_index;
 
 static PSI_thread_info all_myisam_threads[]=
 {
   { &mi_key_thread_find_all_keys, "find_all_keys", 0},
+  { &mi_key_thread_write_index, "write_index", 0},
 };
 
 void init_myisam_psi_keys()
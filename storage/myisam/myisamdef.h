@@ -742,7 +742,7 @@ extern PSI_cond_key mi_key_cond_MI_SORT_INFO_cond;
 extern PSI_file_key mi_key_file_datatmp, mi_key_file_dfile, mi_key_file_kfile,
   mi_key_file_log;
 
-extern PSI_thread_key mi_key_thread_find_all_keys;
+extern PSI_thread_key mi_key_thread_find_all_keys, mi_key_thread_write_index;
 
 void init_myisam_psi_keys();
 #endif /* HAVE_PSI_INTERFACE */
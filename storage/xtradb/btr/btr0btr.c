@@ -32,6 +32,7 @@ Created 6/2/1994 Heikki Tuuri
 #include "fsp0fsp.h"
 #include "page0page.h"
 #include "page0zip.h"
+#include "log0recv.h"
 
 #ifndef UNIV_HOTBACKUP
 #include "btr0cur.h"
@@ -1615,6 +1616,9 @@ btr_page_reorganize_low(
 				there cannot exist locks on the
 				page, and a hash index should not be
 				dropped: it cannot exist */
+	ulint		algorithm,/*!< in: enum page_zip_algo of a
+				compressed page, or ULINT_UNDEFINED
+				to use page_zip_get_algorithm() */
 	buf_block_t*	block,	/*!< in: page to be reorganized */
 	dict_index_t*	index,	/*!< in: record descriptor */
 	mtr_t*		mtr)	/*!< in: mtr */
@@ -1641,11 +1645,27 @@ btr_page_reorganize_low(
 	data_size1 = page_get_data_size(page);
 	max_ins_size1 = page_get_max_insert_size_after_reorganize(page, 1);
 
+	if (page_zip && algorithm == ULINT_UNDEFINED) {
+		/* Read innodb_compression_algorithm only once, so that
+		the page is compressed with the algorithm that we log. */
+		algorithm = page_zip_get_algorithm(index);
+	}
+
 #ifndef UNIV_HOTBACKUP
 	/* Write the log record */
-	mlog_open_and_write_index(mtr, page, index, page_is_comp(page)
-				  ? MLOG_COMP_PAGE_REORGANIZE
-				  : MLOG_PAGE_REORGANIZE, 0);
+	if (page_zip) {
+		byte*	log_ptr = mlog_open_and_write_index(
+			mtr, page, index, MLOG_ZIP_PAGE_REORGANIZE, 1);
+
+		if (log_ptr) {
+			mach_write_to_1(log_ptr, algorithm);
+			mlog_close(mtr, log_ptr + 1);
+		}
+	} else {
+		mlog_open_and_write_index(mtr, page, index, page_is_comp(page)
+					  ? MLOG_COMP_PAGE_REORGANIZE
+					  : MLOG_PAGE_REORGANIZE, 0);
+	}
 #endif /* !UNIV_HOTBACKUP */
 
 	/* Turn logging off */
@@ -1695,7 +1715,7 @@ btr_page_reorganize_low(
 
 	if (UNIV_LIKELY_NULL(page_zip)
 	    && UNIV_UNLIKELY
-	    (!page_zip_compress(page_zip, page, index, NULL))) {
+	    (!page_zip_compress_low(page_zip, page, index, algorithm, NULL))) {
 
 		/* Restore the old page and exit. */
 		btr_blob_dbg_restore(page, temp_page, index,
@@ -1783,7 +1803,8 @@ btr_page_reorganize(
 	dict_index_t*	index,	/*!< in: record descriptor */
 	mtr_t*		mtr)	/*!< in: mtr */
 {
-	return(btr_page_reorganize_low(FALSE, block, index, mtr));
+	return(btr_page_reorganize_low(FALSE, ULINT_UNDEFINED,
+				       block, index, mtr));
 }
 #endif /* !UNIV_HOTBACKUP */
 
@@ -1795,18 +1816,40 @@ byte*
 btr_parse_page_reorganize(
 /*======================*/
 	byte*		ptr,	/*!< in: buffer */
-	byte*		end_ptr __attribute__((unused)),
-				/*!< in: buffer end */
+	byte*		end_ptr,/*!< in: buffer end */
 	dict_index_t*	index,	/*!< in: record descriptor */
+	ibool		compressed,/*!< in: TRUE for
+				MLOG_ZIP_PAGE_REORGANIZE */
 	buf_block_t*	block,	/*!< in: page to be reorganized, or NULL */
 	mtr_t*		mtr)	/*!< in: mtr or NULL */
 {
+	/* Log records written before the page compression algorithm
+	could be chosen always refer to zlib compressed pages. */
+	ulint	algorithm = PAGE_ZIP_ALGORITHM_ZLIB;
+
 	ut_ad(ptr && end_ptr);
 
-	/* The record is empty, except for the record initial part */
+	/* MLOG_ZIP_PAGE_REORGANIZE carries the page compression
+	algorithm.  The other records are empty, except for the record
+	initial part. */
+
+	if (compressed) {
+		if (ptr == end_ptr) {
+			return(NULL);
+		}
+
+		algorithm = mach_read_from_1(ptr);
+		ptr++;
+
+		if (UNIV_UNLIKELY(algorithm > PAGE_ZIP_ALGORITHM_LZ)) {
+			recv_sys->found_corrupt_log = TRUE;
+
+			return(NULL);
+		}
+	}
 
 	if (UNIV_LIKELY(block != NULL)) {
-		btr_page_reorganize_low(TRUE, block, index, mtr);
+		btr_page_reorganize_low(TRUE, algorithm, block, index, mtr);
 	}
 
 	return(ptr);
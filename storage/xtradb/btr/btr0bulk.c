@@ -0,0 +1,700 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Monty Program Ab. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place, Suite 330, Boston, MA 02111-1307 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.c
+Bottom-up loading of an empty B-tree from sorted index entries
+
+Created 2013-06-12
+*******************************************************/
+
+#include "btr0bulk.h"
+
+#ifndef UNIV_HOTBACKUP
+#include "btr0btr.h"
+#include "btr0sea.h"
+#include "page0cur.h"
+#include "page0page.h"
+#include "page0zip.h"
+#include "fsp0fsp.h"
+#include "fil0fil.h"
+#include "ibuf0ibuf.h"
+#include "lock0lock.h"
+#include "log0log.h"
+#include "mtr0log.h"
+#include "dict0dict.h"
+#include "rem0cmp.h"
+#include "srv0srv.h"
+
+/** A level of the B-tree being built */
+typedef struct btr_bulk_level_struct btr_bulk_level_t;
+
+/** A level of the B-tree being built */
+struct btr_bulk_level_struct {
+	ulint		first_page_no;	/*!< leftmost page of the level */
+	ulint		page_no;	/*!< rightmost page of the level,
+					where the records are appended */
+	ulint		n_pages;	/*!< number of pages on the level */
+};
+
+/** Bottom-up builder of an empty B-tree */
+struct btr_bulk_struct {
+	dict_index_t*	index;		/*!< index being loaded */
+	trx_id_t	trx_id;		/*!< id of the loading transaction */
+	ulint		space;		/*!< tablespace of the index */
+	ulint		comp;		/*!< nonzero=compact format */
+	ulint		reserve;	/*!< bytes to leave free on a page
+					that holds at least 2 records */
+	ulint		n_levels;	/*!< number of levels built so far */
+	btr_bulk_level_t levels[BTR_MAX_LEVELS];/*!< levels, the leaf
+					level first */
+	mtr_t		mtr;		/*!< mini-transaction filling the
+					leaf page */
+	buf_block_t*	block;		/*!< leaf page being filled,
+					x-latched in mtr, or NULL */
+	page_cur_t	cur;		/*!< cursor on the last record
+					of block */
+	byte*		log_ptr;	/*!< where to write the log data
+					length of the records appended
+					to block, or NULL */
+	ulint		log_data_len;	/*!< length of the mtr log when the
+					appending to block started */
+	ulint		log_mode;	/*!< log mode of mtr before the
+					appending to block started */
+	mem_heap_t*	heap;		/*!< heap for node pointers */
+};
+
+/**************************************************************//**
+Checks if a record can be appended to a page without going over
+the fill factor. A page always gets at least 2 records if they fit.
+@return	TRUE if the record should be appended to the page */
+static
+ibool
+btr_bulk_page_has_room(
+/*===================*/
+	const btr_bulk_t*	bulk,	/*!< in: builder */
+	const page_t*		page,	/*!< in: page being filled */
+	ulint			rec_size)/*!< in: size of the record */
+{
+	ulint	max_size = page_get_max_insert_size(page, 1);
+
+	if (rec_size > max_size) {
+
+		return(FALSE);
+	}
+
+	return(page_get_n_recs(page) < 2
+	       || max_size - rec_size >= bulk->reserve);
+}
+
+/**************************************************************//**
+Allocates the next page of a level and links it to the previous page.
+@return	the new page, x-latched in mtr, or NULL if out of space */
+static
+buf_block_t*
+btr_bulk_page_create(
+/*=================*/
+	btr_bulk_t*	bulk,	/*!< in/out: builder */
+	ulint		level,	/*!< in: level of the page */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction */
+{
+	btr_bulk_level_t*	lvl	= &bulk->levels[level];
+	dict_index_t*		index	= bulk->index;
+	mtr_t			alloc_mtr;
+	buf_block_t*		block;
+	page_t*			page;
+	ulint			page_no;
+	ulint			n_reserved;
+
+	ut_ad(level <= bulk->n_levels);
+
+	/* Allocate the page in a mini-transaction of its own, so
+	that the file space latches are not held while the page is
+	filled. */
+
+	mtr_start(&alloc_mtr);
+
+	if (!fsp_reserve_free_extents(&n_reserved, bulk->space, 2,
+				      FSP_NORMAL, &alloc_mtr)) {
+		mtr_commit(&alloc_mtr);
+
+		return(NULL);
+	}
+
+	if (lvl->n_pages) {
+		block = btr_page_alloc(index, lvl->page_no + 1, FSP_UP,
+				       level, &alloc_mtr, mtr);
+	} else {
+		block = btr_page_alloc(index, 0, FSP_NO_DIR,
+				       level, &alloc_mtr, mtr);
+	}
+
+	fil_space_release_free_extents(bulk->space, n_reserved);
+	mtr_commit(&alloc_mtr);
+
+	if (UNIV_UNLIKELY(!block)) {
+
+		return(NULL);
+	}
+
+	page = buf_block_get_frame(block);
+	page_no = buf_block_get_page_no(block);
+
+	btr_page_create(block, NULL, index, level, mtr);
+	btr_page_set_next(page, NULL, FIL_NULL, mtr);
+
+	if (lvl->n_pages) {
+		buf_block_t*	prev_block;
+
+		prev_block = btr_block_get(bulk->space, 0, lvl->page_no,
+					   RW_X_LATCH, index, mtr);
+		btr_page_set_next(buf_block_get_frame(prev_block), NULL,
+				  page_no, mtr);
+		btr_page_set_prev(page, NULL, lvl->page_no, mtr);
+	} else {
+		btr_page_set_prev(page, NULL, FIL_NULL, mtr);
+		lvl->first_page_no = page_no;
+		bulk->n_levels = level + 1;
+	}
+
+	if (level == 0 && !dict_index_is_clust(index)) {
+		page_update_max_trx_id(block, NULL, bulk->trx_id, mtr);
+	}
+
+	lvl->page_no = page_no;
+	lvl->n_pages++;
+
+	return(block);
+}
+
+/**************************************************************//**
+Builds the node pointer of a page, copying it to the heap of the builder
+so that it stays valid after the page latch is released.
+@return	node pointer */
+static
+dtuple_t*
+btr_bulk_node_ptr(
+/*==============*/
+	btr_bulk_t*		bulk,	/*!< in/out: builder */
+	const buf_block_t*	block,	/*!< in: page, latched */
+	ulint			level)	/*!< in: level of the page */
+{
+	const page_t*	page	= buf_block_get_frame(block);
+	dtuple_t*	node_ptr;
+	ulint		i;
+
+	node_ptr = dict_index_build_node_ptr(
+		bulk->index, page_rec_get_next_const(
+			page_get_infimum_rec(page)),
+		buf_block_get_page_no(block), bulk->heap, level);
+
+	for (i = 0; i < dtuple_get_n_fields(node_ptr); i++) {
+		dfield_dup(dtuple_get_nth_field(node_ptr, i), bulk->heap);
+	}
+
+	return(node_ptr);
+}
+
+/**************************************************************//**
+Appends a node pointer to a level above the leaf level. Each node
+pointer is appended in a mini-transaction of its own, as there is only
+one for each page of the level below.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static
+ulint
+btr_bulk_insert_node_ptr(
+/*=====================*/
+	btr_bulk_t*	bulk,	/*!< in/out: builder */
+	ulint		level,	/*!< in: level where to append */
+	dtuple_t*	node_ptr)/*!< in: node pointer of the last page
+				of level - 1 */
+{
+	btr_bulk_level_t*	lvl	= &bulk->levels[level];
+	dict_index_t*		index	= bulk->index;
+	buf_block_t*		block	= NULL;
+	page_t*			page;
+	page_cur_t		cur;
+	rec_t*			rec;
+	ulint			rec_size;
+	mtr_t			mtr;
+
+	ut_ad(level > 0);
+	ut_ad(level <= bulk->n_levels);
+
+	if (UNIV_UNLIKELY(level >= BTR_MAX_NODE_LEVEL)) {
+
+		return(DB_CORRUPTION);
+	}
+
+	rec_size = rec_get_converted_size(index, node_ptr, 0);
+
+	log_free_check();
+	mtr_start(&mtr);
+
+	if (level < bulk->n_levels) {
+		block = btr_block_get(bulk->space, 0, lvl->page_no,
+				      RW_X_LATCH, index, &mtr);
+
+		if (!btr_bulk_page_has_room(
+			    bulk, buf_block_get_frame(block), rec_size)) {
+			ulint		err;
+			dtuple_t*	parent_ptr;
+
+			/* The page is full: append its node pointer
+			to the level above, and continue on a new page. */
+
+			parent_ptr = btr_bulk_node_ptr(bulk, block, level);
+			mtr_commit(&mtr);
+
+			err = btr_bulk_insert_node_ptr(bulk, level + 1,
+						       parent_ptr);
+			if (err != DB_SUCCESS) {
+
+				return(err);
+			}
+
+			block = NULL;
+			log_free_check();
+			mtr_start(&mtr);
+		}
+	}
+
+	if (!block) {
+		block = btr_bulk_page_create(bulk, level, &mtr);
+
+		if (UNIV_UNLIKELY(!block)) {
+			mtr_commit(&mtr);
+
+			return(DB_OUT_OF_FILE_SPACE);
+		}
+
+		if (lvl->n_pages == 1) {
+			/* The leftmost node pointer of each non-leaf
+			level must be the minimum record. */
+
+			dtuple_set_info_bits(node_ptr,
+					     dtuple_get_info_bits(node_ptr)
+					     | REC_INFO_MIN_REC_FLAG);
+		}
+	}
+
+	page = buf_block_get_frame(block);
+	page_cur_position(page_rec_get_prev(page_get_supremum_rec(page)),
+			  block, &cur);
+
+	rec = page_cur_tuple_insert(&cur, node_ptr, index, 0, &mtr);
+	ut_a(rec);
+
+	mtr_commit(&mtr);
+
+	return(DB_SUCCESS);
+}
+
+/**************************************************************//**
+Starts filling a new leaf page.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static
+ulint
+btr_bulk_leaf_open(
+/*===============*/
+	btr_bulk_t*	bulk)	/*!< in/out: builder */
+{
+	mtr_t*	mtr	= &bulk->mtr;
+
+	ut_ad(!bulk->block);
+
+	/* No page latches are held between the leaf pages. */
+	log_free_check();
+	mtr_start(mtr);
+
+	bulk->block = btr_bulk_page_create(bulk, 0, mtr);
+
+	if (UNIV_UNLIKELY(!bulk->block)) {
+		mtr_commit(mtr);
+
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	page_cur_set_before_first(bulk->block, &bulk->cur);
+
+	/* Log the records like page_copy_rec_list_end_to_created_page()
+	does: recovery appends them to the end of the page, and the
+	individual inserts are logged in the short form, without the
+	cursor position. */
+
+	bulk->log_ptr = page_copy_rec_list_to_created_page_write_log(
+		buf_block_get_frame(bulk->block), bulk->index, mtr);
+	bulk->log_data_len = dyn_array_get_data_size(&mtr->log);
+	bulk->log_mode = mtr_set_log_mode(mtr, MTR_LOG_SHORT_INSERTS);
+
+	return(DB_SUCCESS);
+}
+
+/**************************************************************//**
+Finishes the leaf page being filled and commits its mini-transaction.
+@return	DB_SUCCESS or error code */
+static
+ulint
+btr_bulk_leaf_close(
+/*================*/
+	btr_bulk_t*	bulk,	/*!< in/out: builder */
+	ibool		push)	/*!< in: TRUE if the node pointer of the
+				page should be appended to level 1 */
+{
+	mtr_t*		mtr	= &bulk->mtr;
+	buf_block_t*	block	= bulk->block;
+	page_t*		page	= buf_block_get_frame(block);
+	dtuple_t*	node_ptr = NULL;
+	ulint		log_data_len;
+
+	log_data_len = dyn_array_get_data_size(&mtr->log)
+		- bulk->log_data_len;
+
+	ut_a(log_data_len < 100 * UNIV_PAGE_SIZE);
+
+	if (UNIV_LIKELY(bulk->log_ptr != NULL)) {
+		mach_write_to_4(bulk->log_ptr, log_data_len);
+	}
+
+	/* Reset the insert direction, as the recovery of the log
+	record does. */
+
+	page_header_set_ptr(page, NULL, PAGE_LAST_INSERT, NULL);
+	page_header_set_field(page, NULL, PAGE_DIRECTION, PAGE_NO_DIRECTION);
+	page_header_set_field(page, NULL, PAGE_N_DIRECTION, 0);
+
+	mtr_set_log_mode(mtr, bulk->log_mode);
+
+	if (!dict_index_is_clust(bulk->index)) {
+		ibuf_reset_free_bits(block);
+	}
+
+	if (push) {
+		mem_heap_empty(bulk->heap);
+		node_ptr = btr_bulk_node_ptr(bulk, block, 0);
+	}
+
+	mtr_commit(mtr);
+	bulk->block = NULL;
+
+	if (push) {
+
+		return(btr_bulk_insert_node_ptr(bulk, 1, node_ptr));
+	}
+
+	return(DB_SUCCESS);
+}
+
+/**************************************************************//**
+Checks if an index can be loaded bottom-up: it must be an empty,
+uncompressed index tree.
+@return	TRUE if btr_bulk_create() can be used on the index */
+UNIV_INTERN
+ibool
+btr_bulk_is_possible(
+/*=================*/
+	dict_index_t*	index)	/*!< in: index */
+{
+	const page_t*	root;
+	ibool		empty;
+	mtr_t		mtr;
+
+	if (dict_index_is_ibuf(index)
+	    || dict_table_zip_size(index->table)
+	    || index->page == FIL_NULL) {
+
+		return(FALSE);
+	}
+
+	mtr_start(&mtr);
+	root = btr_page_get(dict_index_get_space(index), 0,
+			    dict_index_get_page(index), RW_S_LATCH,
+			    index, &mtr);
+	empty = page_is_leaf(root) && !page_get_n_recs(root);
+	mtr_commit(&mtr);
+
+	return(empty);
+}
+
+/**************************************************************//**
+Starts a bottom-up load of an index. The index must be empty and
+uncompressed, and the entries must be passed to btr_bulk_insert() in
+ascending order, without duplicates.
+@return	own: the builder, or NULL if the index cannot be bulk loaded */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: index to load */
+	trx_id_t	trx_id)	/*!< in: id of the loading transaction,
+				written to PAGE_MAX_TRX_ID of the
+				secondary index leaf pages */
+{
+	btr_bulk_t*	bulk;
+
+	if (!btr_bulk_is_possible(index)) {
+
+		return(NULL);
+	}
+
+	bulk = mem_zalloc(sizeof *bulk);
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->space = dict_index_get_space(index);
+	bulk->comp = dict_table_is_comp(index->table);
+
+	/* Like a page split, a full page leaves 1/16 of the page free
+	for updates that make the records longer. */
+
+	if (srv_fill_factor >= 100) {
+		bulk->reserve = UNIV_PAGE_SIZE / 16;
+	} else {
+		bulk->reserve = UNIV_PAGE_SIZE * (100 - srv_fill_factor)
+			/ 100;
+	}
+
+	bulk->heap = mem_heap_create(1024);
+
+	return(bulk);
+}
+
+/**************************************************************//**
+Appends an entry to the index being loaded. The entry must not have
+externally stored columns.
+@return	DB_SUCCESS, DB_TOO_BIG_RECORD if the record is too big to be
+appended (the caller may finish the load and insert the remaining
+entries one by one), or DB_OUT_OF_FILE_SPACE */
+UNIV_INTERN
+ulint
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: builder */
+	const dtuple_t*	entry)	/*!< in: index entry */
+{
+	rec_t*	rec;
+	ulint	rec_size;
+	ulint	err;
+
+	ut_ad(!dtuple_get_n_ext(entry));
+
+	rec_size = rec_get_converted_size(bulk->index, entry, 0);
+
+	/* Like btr_cur_optimistic_insert(), require room for 2 records
+	on a page. Bigger records would need externally stored columns. */
+
+	if (UNIV_UNLIKELY(page_zip_rec_needs_ext(
+				  rec_size, bulk->comp,
+				  dtuple_get_n_fields(entry), 0))) {
+
+		return(DB_TOO_BIG_RECORD);
+	}
+
+	if (bulk->block) {
+		ut_ad(!page_rec_is_infimum(page_cur_get_rec(&bulk->cur)));
+		ut_ad(cmp_dtuple_rec(entry, page_cur_get_rec(&bulk->cur),
+				     rec_get_offsets(
+					     page_cur_get_rec(&bulk->cur),
+					     bulk->index, NULL,
+					     ULINT_UNDEFINED, &bulk->heap))
+		      > 0);
+
+		if (!btr_bulk_page_has_room(
+			    bulk, buf_block_get_frame(bulk->block),
+			    rec_size)) {
+
+			err = btr_bulk_leaf_close(bulk, TRUE);
+
+			if (err != DB_SUCCESS) {
+
+				return(err);
+			}
+		}
+	}
+
+	if (!bulk->block) {
+		err = btr_bulk_leaf_open(bulk);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+	}
+
+	rec = page_cur_tuple_insert(&bulk->cur, entry, bulk->index, 0,
+				    &bulk->mtr);
+	ut_a(rec);
+
+	page_cur_move_to_next(&bulk->cur);
+	ut_ad(page_cur_get_rec(&bulk->cur) == rec);
+
+	return(DB_SUCCESS);
+}
+
+/**************************************************************//**
+Makes the tree that was built the tree of the index, by copying the only
+page of its top level to the empty root page. */
+static
+void
+btr_bulk_attach(
+/*============*/
+	btr_bulk_t*	bulk)	/*!< in: builder */
+{
+	dict_index_t*	index	= bulk->index;
+	ulint		top	= bulk->n_levels - 1;
+	buf_block_t*	root_block;
+	buf_block_t*	top_block;
+	page_t*		top_page;
+	mtr_t		mtr;
+
+	ut_a(bulk->levels[top].n_pages == 1);
+
+	log_free_check();
+	mtr_start(&mtr);
+
+	/* Readers may be looking at the empty root page. */
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	root_block = btr_block_get(bulk->space, 0, dict_index_get_page(index),
+				   RW_X_LATCH, index, &mtr);
+	top_block = btr_block_get(bulk->space, 0, bulk->levels[top].page_no,
+				  RW_X_LATCH, index, &mtr);
+	top_page = buf_block_get_frame(top_block);
+
+	ut_a(page_is_leaf(buf_block_get_frame(root_block)));
+	ut_a(!page_get_n_recs(buf_block_get_frame(root_block)));
+
+	if (top > 0) {
+		buf_block_t*	leaf_block;
+
+		/* Move the gap locks on the supremum of the empty root
+		to the supremum of the last leaf page. */
+
+		leaf_block = btr_block_get(bulk->space, 0,
+					   bulk->levels[0].page_no,
+					   RW_X_LATCH, index, &mtr);
+		lock_update_root_raise(leaf_block, root_block);
+	}
+
+	btr_page_empty(root_block, NULL, index, top, &mtr);
+
+	if (!page_copy_rec_list_end(root_block, top_block,
+				    page_get_infimum_rec(top_page),
+				    index, &mtr)) {
+		/* Copying to an uncompressed page cannot fail. */
+		ut_error;
+	}
+
+	btr_page_free(index, top_block, &mtr);
+
+	if (top == 0 && !dict_index_is_clust(index)) {
+		ibuf_reset_free_bits(root_block);
+	}
+
+	mtr_commit(&mtr);
+}
+
+/**************************************************************//**
+Frees the pages that were built, walking each level from left to right. */
+static
+void
+btr_bulk_free_pages(
+/*================*/
+	btr_bulk_t*	bulk)	/*!< in: builder */
+{
+	ulint	level;
+
+	for (level = 0; level < bulk->n_levels; level++) {
+		ulint	page_no = bulk->levels[level].first_page_no;
+
+		while (page_no != FIL_NULL) {
+			buf_block_t*	block;
+			mtr_t		mtr;
+
+			log_free_check();
+			mtr_start(&mtr);
+
+			block = btr_block_get(bulk->space, 0, page_no,
+					      RW_X_LATCH, bulk->index, &mtr);
+			page_no = btr_page_get_next(
+				buf_block_get_frame(block), &mtr);
+			btr_page_free(bulk->index, block, &mtr);
+
+			mtr_commit(&mtr);
+		}
+	}
+}
+
+/**************************************************************//**
+Finishes a bottom-up load and frees the builder. If the load succeeded,
+the tree that was built replaces the empty root page of the index.
+Otherwise the pages that were built are freed and the index stays empty.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in,own: builder */
+	ulint		err)	/*!< in: DB_SUCCESS, or the error that
+				aborted the load */
+{
+	ulint	level;
+
+	if (bulk->block) {
+		ulint	close_err;
+
+		close_err = btr_bulk_leaf_close(
+			bulk, err == DB_SUCCESS && bulk->levels[0].n_pages > 1);
+
+		if (err == DB_SUCCESS) {
+			err = close_err;
+		}
+	}
+
+	/* Append the node pointers of the last pages. A level has
+	a parent level as soon as it has more than one page. */
+
+	for (level = 1; err == DB_SUCCESS && level + 1 < bulk->n_levels;
+	     level++) {
+		buf_block_t*	block;
+		dtuple_t*	node_ptr;
+		mtr_t		mtr;
+
+		mem_heap_empty(bulk->heap);
+
+		mtr_start(&mtr);
+		block = btr_block_get(bulk->space, 0,
+				      bulk->levels[level].page_no,
+				      RW_X_LATCH, bulk->index, &mtr);
+		node_ptr = btr_bulk_node_ptr(bulk, block, level);
+		mtr_commit(&mtr);
+
+		err = btr_bulk_insert_node_ptr(bulk, level + 1, node_ptr);
+	}
+
+	if (err != DB_SUCCESS) {
+		btr_bulk_free_pages(bulk);
+	} else if (bulk->n_levels) {
+		btr_bulk_attach(bulk);
+	}
+
+	mem_heap_free(bulk->heap);
+	mem_free(bulk);
+
+	return(err);
+}
+#endif /* !UNIV_HOTBACKUP */
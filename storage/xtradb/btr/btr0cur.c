@@ -84,10 +84,10 @@ UNIV_INTERN ibool	btr_cur_print_record_ops = FALSE;
 #endif /* UNIV_DEBUG */
 
 /** Number of searches down the B-tree in btr_cur_search_to_nth_level(). */
-UNIV_INTERN ulint	btr_cur_n_non_sea	= 0;
+UNIV_INTERN ut_counter_t	btr_cur_n_non_sea;
 /** Number of successful adaptive hash index lookups in
 btr_cur_search_to_nth_level(). */
-UNIV_INTERN ulint	btr_cur_n_sea		= 0;
+UNIV_INTERN ut_counter_t	btr_cur_n_sea;
 /** Old value of btr_cur_n_non_sea.  Copied by
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
@@ -543,13 +543,13 @@ btr_cur_search_to_nth_level(
 		      || mode != PAGE_CUR_LE);
 		ut_ad(cursor->low_match != ULINT_UNDEFINED
 		      || mode != PAGE_CUR_LE);
-		btr_cur_n_sea++;
+		ut_counter_inc(&btr_cur_n_sea);
 
 		return;
 	}
 #endif /* BTR_CUR_HASH_ADAPT */
 #endif /* BTR_CUR_ADAPT */
-	btr_cur_n_non_sea++;
+	ut_counter_inc(&btr_cur_n_non_sea);
 
 	/* If the hash search did not succeed, do binary search down the
 	tree */
@@ -400,7 +400,11 @@ btr_search_info_update_hash(
 
 	if (info->n_fields >= n_unique && cursor->up_match >= n_unique) {
 increment_potential:
-		info->n_hash_potential++;
+		/* Saturate, so that the search info is not written on
+		every search of a hot index */
+		if (info->n_hash_potential < BTR_SEARCH_BUILD_LIMIT + 5) {
+			info->n_hash_potential++;
+		}
 
 		return;
 	}
@@ -501,11 +505,12 @@ btr_search_update_block_hash_info(
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(cursor);
 
-	info->last_hash_succ = FALSE;
-
 	ut_a(buf_block_state_valid(block));
 	ut_ad(info->magic_n == BTR_SEARCH_MAGIC_N);
 
+	/* Only write last_hash_succ when it changes, to avoid dirtying
+	the cache line of the shared search info */
+
 	if ((block->n_hash_helps > 0)
 	    && (info->n_hash_potential > 0)
 	    && (block->n_fields == info->n_fields)
@@ -520,11 +525,19 @@ btr_search_update_block_hash_info(
 			/* The search would presumably have succeeded using
 			the hash index */
 
-			info->last_hash_succ = TRUE;
+			if (!info->last_hash_succ) {
+				info->last_hash_succ = TRUE;
+			}
+		} else if (info->last_hash_succ) {
+			info->last_hash_succ = FALSE;
 		}
 
 		block->n_hash_helps++;
 	} else {
+		if (info->last_hash_succ) {
+			info->last_hash_succ = FALSE;
+		}
+
 		block->n_hash_helps = 1;
 		block->n_fields = info->n_fields;
 		block->n_bytes = info->n_bytes;
@@ -1039,7 +1052,7 @@ btr_search_guess_on_hash(
 	/* Increment the page get statistics though we did not really
 	fix the page: for user info only */
 	buf_pool = buf_pool_from_bpage(&block->page);
-	buf_pool->stat.n_page_gets++;
+	buf_pool_inc_page_gets(buf_pool);
 
 	return(TRUE);
 
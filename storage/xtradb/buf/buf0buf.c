@@ -48,11 +48,14 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0log.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
+#include "m_string.h" /* for my_sys.h */
+#include "my_sys.h" /* my_crc32c() */
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "page0zip.h"
 #include "trx0trx.h"
 #include "srv0start.h"
+#include "sync0prof.h"
 
 /* prototypes for new functions added to ha_innodb.cc */
 trx_t* innobase_get_trx();
@@ -456,6 +459,8 @@ buf_get_total_stat(
 
 		buf_stat = &buf_pool->stat;
 		tot_stat->n_page_gets += buf_stat->n_page_gets;
+		tot_stat->n_page_gets_numa_local
+			+= buf_stat->n_page_gets_numa_local;
 		tot_stat->n_pages_read += buf_stat->n_pages_read;
 		tot_stat->n_pages_written += buf_stat->n_pages_written;
 		tot_stat->n_pages_created += buf_stat->n_pages_created;
@@ -551,6 +556,28 @@ buf_calc_page_new_checksum_32(
 	return(checksum);
 }
 
+/********************************************************************//**
+Calculates a CRC-32C page checksum which is stored to the page when it is
+written to a file with innodb_checksum_algorithm=crc32. It covers the same
+bytes as buf_calc_page_new_checksum().
+@return	checksum */
+UNIV_INTERN
+ulint
+buf_calc_page_crc32(
+/*================*/
+	const byte*	page)	/*!< in: buffer page */
+{
+	ulint checksum;
+
+	checksum = my_crc32c(0, page + FIL_PAGE_OFFSET,
+			     FIL_PAGE_FILE_FLUSH_LSN - FIL_PAGE_OFFSET);
+	checksum = my_crc32c(checksum, page + FIL_PAGE_DATA,
+			     UNIV_PAGE_SIZE - FIL_PAGE_DATA
+			     - FIL_PAGE_END_LSN_OLD_CHKSUM);
+
+	return(checksum & 0xFFFFFFFFUL);
+}
+
 /********************************************************************//**
 In versions < 4.0.14 and < 4.1.1 there was a bug that the checksum only
 looked at the first few bytes of the page. This calculates that old
@@ -647,6 +674,17 @@ buf_page_is_corrupted(
 			read_buf + UNIV_PAGE_SIZE
 			- FIL_PAGE_END_LSN_OLD_CHKSUM);
 
+		/* With innodb_checksum_algorithm=crc32 the same CRC-32C
+		value is stored to both fields. Pages written with
+		any algorithm remain readable. */
+
+		if (checksum_field == old_checksum_field
+		    && checksum_field != BUF_NO_CHECKSUM_MAGIC
+		    && checksum_field == buf_calc_page_crc32(read_buf)) {
+
+			return(FALSE);
+		}
+
 		/* There are 2 valid formulas for old_checksum_field:
 
 		1. Very old versions of InnoDB only stored 8 byte lsn to the
@@ -710,6 +748,7 @@ buf_page_print(
 #endif /* !UNIV_HOTBACKUP */
 	ulint		checksum;
 	ulint		checksum_32;
+	ulint		checksum_crc32;
 	ulint		old_checksum;
 	ulint		size	= zip_size;
 
@@ -801,13 +840,15 @@ buf_page_print(
 		? buf_calc_page_new_checksum(read_buf) : BUF_NO_CHECKSUM_MAGIC;
 	checksum_32 = srv_use_checksums
 		? buf_calc_page_new_checksum_32(read_buf) : BUF_NO_CHECKSUM_MAGIC;
+	checksum_crc32 = srv_use_checksums
+		? buf_calc_page_crc32(read_buf) : BUF_NO_CHECKSUM_MAGIC;
 	old_checksum = srv_use_checksums
 		? buf_calc_page_old_checksum(read_buf) : BUF_NO_CHECKSUM_MAGIC;
 
 	ut_print_timestamp(stderr);
 	fprintf(stderr,
-		"  InnoDB: Page checksum %lu (32bit_calc: %lu), prior-to-4.0.14-form"
-		" checksum %lu\n"
+		"  InnoDB: Page checksum %lu (32bit_calc: %lu, crc32: %lu),"
+		" prior-to-4.0.14-form checksum %lu\n"
 		"InnoDB: stored checksum %lu, prior-to-4.0.14-form"
 		" stored checksum %lu\n"
 		"InnoDB: Page lsn %lu %lu, low 4 bytes of lsn"
@@ -815,7 +856,8 @@ buf_page_print(
 		"InnoDB: Page number (if stored to page already) %lu,\n"
 		"InnoDB: space id (if created with >= MySQL-4.1.1"
 		" and stored already) %lu\n",
-		(ulong) checksum, (ulong) checksum_32, (ulong) old_checksum,
+		(ulong) checksum, (ulong) checksum_32,
+		(ulong) checksum_crc32, (ulong) old_checksum,
 		(ulong) mach_read_from_4(read_buf + FIL_PAGE_SPACE_OR_CHKSUM),
 		(ulong) mach_read_from_4(read_buf + UNIV_PAGE_SIZE
 					 - FIL_PAGE_END_LSN_OLD_CHKSUM),
@@ -1068,6 +1110,13 @@ buf_chunk_init(
 		return(NULL);
 	}
 
+	if (buf_pool->numa_node != ULINT_UNDEFINED) {
+		/* Bind the memory before the block descriptors
+		and the frames are initialized below. */
+		os_mem_bind_to_numa_node(chunk->mem, chunk->mem_size,
+					 buf_pool->numa_node);
+	}
+
 	/* Allocate the block descriptors from
 	the start of the memory block. */
 	chunk->blocks = chunk->mem;
@@ -1272,6 +1321,8 @@ buf_pool_init_instance(
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	ulint		buf_pool_size,	/*!< in: size in bytes */
 	ibool		populate,	/*!< in: virtual page preallocation */
+	ulint		numa_node,	/*!< in: NUMA node of the instance,
+					or ULINT_UNDEFINED */
 	ulint		instance_no)	/*!< in: id of the instance */
 {
 	ulint		i;
@@ -1298,6 +1349,8 @@ buf_pool_init_instance(
 	rw_lock_x_lock(&buf_pool->page_hash_latch);
 	buf_pool_mutex_enter(buf_pool);
 
+	buf_pool->numa_node = numa_node;
+
 	if (buf_pool_size > 0) {
 		buf_pool->n_chunks = 1;
 		buf_pool->chunks = chunk = mem_zalloc(sizeof *chunk);
@@ -1400,6 +1453,8 @@ buf_pool_init(
 /*==========*/
 	ulint	total_size,	/*!< in: size of the total pool in bytes */
 	ibool	populate,	/*!< in: virtual page preallocation */
+	ibool	numa,		/*!< in: place the instances on the
+				NUMA nodes, round robin */
 	ulint	n_instances)	/*!< in: number of instances */
 {
 	ulint		i;
@@ -1417,7 +1472,11 @@ buf_pool_init(
 	for (i = 0; i < n_instances; i++) {
 		buf_pool_t*	ptr	= &buf_pool_ptr[i];
 
-		if (buf_pool_init_instance(ptr, size, populate, i) != DB_SUCCESS) {
+		ulint		numa_node = numa && os_numa_n_nodes
+			? i % os_numa_n_nodes : ULINT_UNDEFINED;
+
+		if (buf_pool_init_instance(ptr, size, populate, numa_node, i)
+		    != DB_SUCCESS) {
 
 			/* Free all the instances created so far. */
 			buf_pool_free(i);
@@ -1978,7 +2037,7 @@ buf_page_get_zip(
 	if (UNIV_UNLIKELY(innobase_get_slow_log())) {
 		trx = innobase_get_trx();
 	}
-	buf_pool->stat.n_page_gets++;
+	buf_pool_inc_page_gets(buf_pool);
 
 	for (;;) {
 		//buf_pool_mutex_enter(buf_pool);
@@ -2414,6 +2473,31 @@ buf_block_is_uncompressed(
 	return(buf_pointer_is_block_field_instance(buf_pool, (void *)block));
 }
 
+/********************************************************************//**
+Records a sampled latch acquisition of a page in the latch profiler. */
+static
+void
+buf_page_prof_access(
+/*=================*/
+	const buf_block_t*	block,	/*!< in: latched page */
+	ullint			wait_us)/*!< in: microseconds spent
+					acquiring the latch */
+{
+	const page_t*	frame		= buf_block_get_frame(block);
+	ulint		page_type	= fil_page_get_type(frame);
+	index_id_t	index_id	= 0;
+	ulint		level		= 0;
+
+	if (page_type == FIL_PAGE_INDEX) {
+		index_id = btr_page_get_index_id(frame);
+		level = btr_page_get_level_low(frame);
+	}
+
+	sync_prof_page_access(buf_block_get_space(block),
+			      buf_block_get_page_no(block),
+			      page_type, index_id, level, wait_us);
+}
+
 /********************************************************************//**
 This is the general function used to get access to a database page.
 @return	pointer to the block or NULL */
@@ -2446,6 +2530,7 @@ buf_page_get_gen(
 	ulint		ms;
 	ib_uint64_t	start_time;
 	ib_uint64_t	finish_time;
+	ullint		prof_start_us = 0;
 	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
 
 	ut_ad(mtr);
@@ -2478,7 +2563,7 @@ buf_page_get_gen(
 	if (UNIV_UNLIKELY(innobase_get_slow_log())) {
 		trx = innobase_get_trx();
 	}
-	buf_pool->stat.n_page_gets++;
+	buf_pool_inc_page_gets(buf_pool);
 	fold = buf_page_address_fold(space, offset);
 loop:
 	block = guess;
@@ -2893,6 +2978,11 @@ wait_until_unfixed:
 	ut_a(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
 #endif /* UNIV_DEBUG || UNIV_BUF_DEBUG */
 
+	if (UNIV_UNLIKELY(srv_latch_profile)
+	    && rw_latch != RW_NO_LATCH && sync_prof_sample()) {
+		prof_start_us = ut_time_us(NULL);
+	}
+
 	switch (rw_latch) {
 	case RW_NO_LATCH:
 		if (must_read) {
@@ -2948,6 +3038,10 @@ wait_until_unfixed:
 
 	mtr_memo_push(mtr, block, fix_type);
 
+	if (UNIV_UNLIKELY(prof_start_us != 0)) {
+		buf_page_prof_access(block, ut_time_us(NULL) - prof_start_us);
+	}
+
 	if (mode != BUF_PEEK_IF_IN_POOL && !access_time) {
 		/* In the case of a first access, try to apply linear
 		read-ahead */
@@ -3082,7 +3176,7 @@ buf_page_optimistic_get(
 			    buf_block_get_page_no(block)) == 0);
 #endif
 	buf_pool = buf_pool_from_block(block);
-	buf_pool->stat.n_page_gets++;
+	buf_pool_inc_page_gets(buf_pool);
 
 	if (UNIV_UNLIKELY(trx && trx->take_stats)) {
 		_increment_page_get_statistics(block, trx);
@@ -3180,7 +3274,7 @@ buf_page_get_known_nowait(
 	     || (ibuf_count_get(buf_block_get_space(block),
 				buf_block_get_page_no(block)) == 0));
 #endif
-	buf_pool->stat.n_page_gets++;
+	buf_pool_inc_page_gets(buf_pool);
 
 	if (UNIV_UNLIKELY(innobase_get_slow_log())) {
 
@@ -3274,7 +3368,7 @@ buf_page_try_get_func(
 #endif /* UNIV_DEBUG_FILE_ACCESSES || UNIV_DEBUG */
 	buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
 
-	buf_pool->stat.n_page_gets++;
+	buf_pool_inc_page_gets(buf_pool);
 
 #ifdef UNIV_IBUF_COUNT_DEBUG
 	ut_a(ibuf_count_get(buf_block_get_space(block),
@@ -4896,6 +4990,9 @@ buf_stats_aggregate_pool_info(
 	total_info->n_pages_created += pool_info->n_pages_created;
 	total_info->n_pages_written += pool_info->n_pages_written;
 	total_info->n_page_gets += pool_info->n_page_gets;
+	total_info->n_page_gets_numa_local += pool_info->n_page_gets_numa_local;
+	/* The instances may be on different NUMA nodes */
+	total_info->numa_node = ULINT_UNDEFINED;
 	total_info->n_ra_pages_read_rnd += pool_info->n_ra_pages_read_rnd;
 	total_info->n_ra_pages_read += pool_info->n_ra_pages_read;
 	total_info->n_ra_pages_evicted += pool_info->n_ra_pages_evicted;
@@ -4991,6 +5088,11 @@ buf_stats_get_pool_info(
 
 	pool_info->n_page_gets = buf_pool->stat.n_page_gets;
 
+	pool_info->n_page_gets_numa_local =
+		buf_pool->stat.n_page_gets_numa_local;
+
+	pool_info->numa_node = buf_pool->numa_node;
+
 	pool_info->n_ra_pages_read_rnd = buf_pool->stat.n_ra_pages_read_rnd;
 	pool_info->n_ra_pages_read = buf_pool->stat.n_ra_pages_read;
 
@@ -5122,6 +5224,14 @@ buf_print_io_instance(
 		      file);
 	}
 
+	if (pool_info->numa_node != ULINT_UNDEFINED) {
+		fprintf(file,
+			"NUMA node %lu, page gets from the node %lu / %lu\n",
+			pool_info->numa_node,
+			pool_info->n_page_gets_numa_local,
+			pool_info->n_page_gets);
+	}
+
 	/* Statistics about read ahead algorithm */
 	fprintf(file, "Pages read ahead %.2f/s,"
 		" evicted without access %.2f/s,"
@@ -718,45 +718,106 @@ buf_flush_sync_datafiles(void)
 }
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+Writes a run of slots of the doublewrite memory buffer to the doublewrite
+blocks in the data file. We use synchronous aio and thus know that the file
+write has been completed when the control returns. */
 static
 void
-buf_flush_buffered_writes(void)
-/*===========================*/
+buf_flush_write_doublewrite_slots(
+/*==============================*/
+	ulint	first_slot,	/*!< in: first slot to write */
+	ulint	n_slots)	/*!< in: number of slots to write */
 {
-	byte*		write_buf;
-	ulint		len;
-	ulint		len2;
-	ulint		i;
+	ulint	space;
+	ulint	page_no;
+	ulint	n;
+	ulint	i;
 
-	if (!srv_use_doublewrite_buf || trx_doublewrite == NULL) {
-		/* Sync the writes to the disk. */
-		buf_flush_sync_datafiles();
-		return;
+	ut_ad(first_slot + n_slots <= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
+
+	space = srv_doublewrite_file ? TRX_DOUBLEWRITE_SPACE : TRX_SYS_SPACE;
+
+	while (n_slots > 0) {
+		const byte*	write_buf = trx_doublewrite->write_buf
+			+ first_slot * UNIV_PAGE_SIZE;
+
+		/* A run of slots may straddle the two blocks, which
+		need not be adjacent in the data file. */
+
+		if (first_slot < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+			page_no = trx_doublewrite->block1 + first_slot;
+			n = ut_min(n_slots,
+				   TRX_SYS_DOUBLEWRITE_BLOCK_SIZE - first_slot);
+		} else {
+			page_no = trx_doublewrite->block2 + first_slot
+				- TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+			n = n_slots;
+		}
+
+		fil_io(OS_FILE_WRITE, TRUE, space, 0, page_no, 0,
+		       n * UNIV_PAGE_SIZE, (void*) write_buf, NULL);
+
+		for (i = 0; i < n; i++) {
+			const buf_block_t* block = (buf_block_t*)
+				trx_doublewrite->buf_block_arr[first_slot + i];
+			const byte*	page = write_buf + i * UNIV_PAGE_SIZE;
+
+			if (UNIV_LIKELY(!block->page.zip.data)
+			    && UNIV_LIKELY(buf_block_get_state(block)
+					   == BUF_BLOCK_FILE_PAGE)
+			    && UNIV_UNLIKELY
+			    (memcmp(page + (FIL_PAGE_LSN + 4),
+				    page + (UNIV_PAGE_SIZE
+					    - FIL_PAGE_END_LSN_OLD_CHKSUM + 4),
+				    4))) {
+				ut_print_timestamp(stderr);
+				fprintf(stderr,
+					"  InnoDB: ERROR: The page to be"
+					" written seems corrupt!\n"
+					"InnoDB: The lsn fields do not match!"
+					" Noticed in the doublewrite"
+					" block%lu.\n",
+					first_slot
+					< TRX_SYS_DOUBLEWRITE_BLOCK_SIZE
+					? 1UL : 2UL);
+			}
+		}
+
+		first_slot += n;
+		n_slots -= n;
 	}
+}
+
+/********************************************************************//**
+Flushes possible buffered writes from a shard of the doublewrite memory
+buffer to disk. */
+static
+void
+buf_flush_buffered_writes_shard(
+/*============================*/
+	trx_doublewrite_shard_t*	shard)	/*!< in/out: doublewrite
+						shard */
+{
+	ulint		i;
 
-	mutex_enter(&(trx_doublewrite->mutex));
+	mutex_enter(&(shard->mutex));
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (trx_doublewrite->first_free == 0) {
+	if (shard->first_free == 0) {
 
-		mutex_exit(&(trx_doublewrite->mutex));
+		mutex_exit(&(shard->mutex));
 
 		return;
 	}
 
-	for (i = 0; i < trx_doublewrite->first_free; i++) {
+	for (i = 0; i < shard->first_free; i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) trx_doublewrite->buf_block_arr[i];
+		block = (buf_block_t*) shard->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -809,82 +870,12 @@ corrupted_page:
 	}
 
 	/* increment the doublewrite flushed pages counter */
-	srv_dblwr_pages_written+= trx_doublewrite->first_free;
+	srv_dblwr_pages_written+= shard->first_free;
 	srv_dblwr_writes++;
 
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     trx_doublewrite->first_free) * UNIV_PAGE_SIZE;
-
-	write_buf = trx_doublewrite->write_buf;
-	i = 0;
-
-	fil_io(OS_FILE_WRITE, TRUE,
-	       (srv_doublewrite_file ? TRX_DOUBLEWRITE_SPACE : TRX_SYS_SPACE), 0,
-	       trx_doublewrite->block1, 0, len,
-	       (void*) write_buf, NULL);
-
-	for (len2 = 0; len2 + UNIV_PAGE_SIZE <= len;
-	     len2 += UNIV_PAGE_SIZE, i++) {
-		const buf_block_t* block = (buf_block_t*)
-			trx_doublewrite->buf_block_arr[i];
-
-		if (UNIV_LIKELY(!block->page.zip.data)
-		    && UNIV_LIKELY(buf_block_get_state(block)
-				   == BUF_BLOCK_FILE_PAGE)
-		    && UNIV_UNLIKELY
-		    (memcmp(write_buf + len2 + (FIL_PAGE_LSN + 4),
-			    write_buf + len2
-			    + (UNIV_PAGE_SIZE
-			       - FIL_PAGE_END_LSN_OLD_CHKSUM + 4), 4))) {
-			ut_print_timestamp(stderr);
-			fprintf(stderr,
-				"  InnoDB: ERROR: The page to be written"
-				" seems corrupt!\n"
-				"InnoDB: The lsn fields do not match!"
-				" Noticed in the doublewrite block1.\n");
-		}
-	}
-
-	if (trx_doublewrite->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		goto flush;
-	}
-
-	len = (trx_doublewrite->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-		* UNIV_PAGE_SIZE;
-
-	write_buf = trx_doublewrite->write_buf
-		+ TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-	ut_ad(i == TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
-
-	fil_io(OS_FILE_WRITE, TRUE,
-	       (srv_doublewrite_file ? TRX_DOUBLEWRITE_SPACE : TRX_SYS_SPACE), 0,
-	       trx_doublewrite->block2, 0, len,
-	       (void*) write_buf, NULL);
-
-	for (len2 = 0; len2 + UNIV_PAGE_SIZE <= len;
-	     len2 += UNIV_PAGE_SIZE, i++) {
-		const buf_block_t* block = (buf_block_t*)
-			trx_doublewrite->buf_block_arr[i];
-
-		if (UNIV_LIKELY(!block->page.zip.data)
-		    && UNIV_LIKELY(buf_block_get_state(block)
-				   == BUF_BLOCK_FILE_PAGE)
-		    && UNIV_UNLIKELY
-		    (memcmp(write_buf + len2 + (FIL_PAGE_LSN + 4),
-			    write_buf + len2
-			    + (UNIV_PAGE_SIZE
-			       - FIL_PAGE_END_LSN_OLD_CHKSUM + 4), 4))) {
-			ut_print_timestamp(stderr);
-			fprintf(stderr,
-				"  InnoDB: ERROR: The page to be"
-				" written seems corrupt!\n"
-				"InnoDB: The lsn fields do not match!"
-				" Noticed in"
-				" the doublewrite block2.\n");
-		}
-	}
+	buf_flush_write_doublewrite_slots(shard->first_slot,
+					  shard->first_free);
 
-flush:
 	/* Now flush the doublewrite buffer data to disk */
 
 	fil_flush(srv_doublewrite_file ? TRX_DOUBLEWRITE_SPACE : TRX_SYS_SPACE, FALSE);
@@ -893,9 +884,9 @@ flush:
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	for (i = 0; i < trx_doublewrite->first_free; i++) {
+	for (i = 0; i < shard->first_free; i++) {
 		const buf_block_t* block = (buf_block_t*)
-			trx_doublewrite->buf_block_arr[i];
+			shard->buf_block_arr[i];
 
 		ut_a(buf_page_in_file(&block->page));
 		if (UNIV_LIKELY_NULL(block->page.zip.data)) {
@@ -950,9 +941,42 @@ flush:
 	buf_flush_sync_datafiles();
 
 	/* We can now reuse the doublewrite memory buffer: */
-	trx_doublewrite->first_free = 0;
+	shard->first_free = 0;
+
+	mutex_exit(&(shard->mutex));
+}
+
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+static
+void
+buf_flush_buffered_writes(
+/*======================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance whose
+					doublewrite shard to flush, or NULL
+					to flush all the shards */
+{
+	ulint		i;
+
+	if (!srv_use_doublewrite_buf || trx_doublewrite == NULL) {
+		/* Sync the writes to the disk. */
+		buf_flush_sync_datafiles();
+		return;
+	}
+
+	if (buf_pool != NULL) {
+		buf_flush_buffered_writes_shard(
+			trx_doublewrite_get_shard(buf_pool_index(buf_pool)));
+		return;
+	}
 
-	mutex_exit(&(trx_doublewrite->mutex));
+	for (i = 0; i < trx_doublewrite->n_shards; i++) {
+		buf_flush_buffered_writes_shard(&trx_doublewrite->shards[i]);
+	}
 }
 
 /********************************************************************//**
@@ -965,56 +989,54 @@ buf_flush_post_to_doublewrite_buf(
 /*==============================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
-	ulint	zip_size;
+	ulint				zip_size;
+	trx_doublewrite_shard_t*	shard;
+	byte*				write_buf;
+
+	shard = trx_doublewrite_get_shard(bpage->buf_pool_index);
 try_again:
-	mutex_enter(&(trx_doublewrite->mutex));
+	mutex_enter(&(shard->mutex));
 
 	ut_a(buf_page_in_file(bpage));
 
-	if (trx_doublewrite->first_free
-	    >= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		mutex_exit(&(trx_doublewrite->mutex));
+	if (shard->first_free >= shard->n_slots) {
+		mutex_exit(&(shard->mutex));
 
-		buf_flush_buffered_writes();
+		buf_flush_buffered_writes_shard(shard);
 
 		goto try_again;
 	}
 
 	zip_size = buf_page_get_zip_size(bpage);
+	write_buf = shard->write_buf + UNIV_PAGE_SIZE * shard->first_free;
 
 	if (UNIV_UNLIKELY(zip_size)) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
 		/* Copy the compressed page and clear the rest. */
-		memcpy(trx_doublewrite->write_buf
-		       + UNIV_PAGE_SIZE * trx_doublewrite->first_free,
-		       bpage->zip.data, zip_size);
-		memset(trx_doublewrite->write_buf
-		       + UNIV_PAGE_SIZE * trx_doublewrite->first_free
-		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
+		memcpy(write_buf, bpage->zip.data, zip_size);
+		memset(write_buf + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 	} else {
 		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
 		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
 				   UNIV_PAGE_SIZE);
 
-		memcpy(trx_doublewrite->write_buf
-		       + UNIV_PAGE_SIZE * trx_doublewrite->first_free,
-		       ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
+		memcpy(write_buf, ((buf_block_t*) bpage)->frame,
+		       UNIV_PAGE_SIZE);
 	}
 
-	trx_doublewrite->buf_block_arr[trx_doublewrite->first_free] = bpage;
+	shard->buf_block_arr[shard->first_free] = bpage;
 
-	trx_doublewrite->first_free++;
+	shard->first_free++;
 
-	if (trx_doublewrite->first_free
-	    >= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		mutex_exit(&(trx_doublewrite->mutex));
+	if (shard->first_free >= shard->n_slots) {
+		mutex_exit(&(shard->mutex));
 
-		buf_flush_buffered_writes();
+		buf_flush_buffered_writes_shard(shard);
 
 		return;
 	}
 
-	mutex_exit(&(trx_doublewrite->mutex));
+	mutex_exit(&(shard->mutex));
 }
 #endif /* !UNIV_HOTBACKUP */
 
@@ -1078,6 +1100,17 @@ buf_flush_init_for_writing(
 	mach_write_to_8(page + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN_OLD_CHKSUM,
 			newest_lsn);
 
+	if (srv_use_checksums
+	    && srv_checksum_algorithm == SRV_CHECKSUM_ALGORITHM_CRC32) {
+		/* Store the CRC-32C checksum to both checksum fields */
+		ulint	checksum = buf_calc_page_crc32(page);
+
+		mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM, checksum);
+		mach_write_to_4(page + UNIV_PAGE_SIZE
+				- FIL_PAGE_END_LSN_OLD_CHKSUM, checksum);
+		return;
+	}
+
 	/* Store the new formula checksum */
 
 	mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM,
@@ -1269,7 +1302,7 @@ buf_flush_page_try(
 	}
 
 	buf_pool_mutex_exit(buf_pool);
-	buf_flush_buffered_writes();
+	buf_flush_buffered_writes(buf_pool);
 
 	return(TRUE);
 }
@@ -1346,7 +1379,7 @@ buf_flush_page(
 		flush_list or LRU_list. */
 
 		if (!is_s_latched) {
-			buf_flush_buffered_writes();
+			buf_flush_buffered_writes(NULL);
 
 			if (is_uncompressed) {
 				rw_lock_s_lock_gen(&((buf_block_t*) bpage)
@@ -1850,7 +1883,7 @@ buf_flush_batch(
 
 	//buf_pool_mutex_exit(buf_pool);
 
-	buf_flush_buffered_writes();
+	buf_flush_buffered_writes(buf_pool);
 
 #ifdef UNIV_DEBUG
 	if (buf_debug_prints && count > 0) {
@@ -1873,7 +1906,7 @@ buf_flush_common(
 	enum buf_flush	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_flush_buffered_writes();
+	buf_flush_buffered_writes(NULL);
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
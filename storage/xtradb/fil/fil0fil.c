@@ -3182,6 +3182,12 @@ fil_page_buf_page_is_corrupted_offline(
 		page + UNIV_PAGE_SIZE
 		- FIL_PAGE_END_LSN_OLD_CHKSUM);
 
+	if (checksum_field == old_checksum_field
+	    && checksum_field != BUF_NO_CHECKSUM_MAGIC
+	    && checksum_field == buf_calc_page_crc32(page)) {
+		return(FALSE);
+	}
+
 	if (old_checksum_field != mach_read_from_4(page
 						   + FIL_PAGE_LSN)
 	    && old_checksum_field != BUF_NO_CHECKSUM_MAGIC
@@ -3220,7 +3226,14 @@ fil_page_buf_page_store_checksum(
 	byte*	page,
 	ulint	zip_size)
 {
-	if (!zip_size) {
+	if (!zip_size && srv_use_checksums
+	    && srv_checksum_algorithm == SRV_CHECKSUM_ALGORITHM_CRC32) {
+		ulint	checksum = buf_calc_page_crc32(page);
+
+		mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM, checksum);
+		mach_write_to_4(page + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN_OLD_CHKSUM,
+				checksum);
+	} else if (!zip_size) {
 		mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM,
 				srv_use_checksums
 				? (!srv_fast_checksum
@@ -5578,7 +5591,7 @@ fil_aio_wait(
 #ifdef WIN_ASYNC_IO
 		ret = os_aio_windows_handle(segment, 0, &fil_node,
 					    &message, &type, &space_id);
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(UNIV_LINUX_AIO)
 		ret = os_aio_linux_handle(segment, &fil_node,
 					  &message, &type, &space_id);
 #else
@@ -230,6 +230,24 @@ static TYPELIB innodb_stats_method_typelib = {
 	NULL
 };
 
+/** Engine-defined table options, CREATE TABLE ... *here* */
+struct ha_table_option_struct
+{
+	uint	page_compression_algorithm;
+				/*!< PAGE_COMPRESSION_ALGORITHM:
+				0=DEFAULT, else enum page_zip_algo + 1 */
+};
+
+/** Engine-defined table options of InnoDB tables */
+static ha_create_table_option innodb_table_option_list[]=
+{
+	/* The page compression algorithm of a ROW_FORMAT=COMPRESSED
+	table; DEFAULT follows innodb_compression_algorithm. */
+	HA_TOPTION_ENUM("PAGE_COMPRESSION_ALGORITHM",
+			page_compression_algorithm, "DEFAULT,ZLIB,LZ", 0),
+	HA_TOPTION_END
+};
+
 /* The following counter is used to convey information to InnoDB
 about server activity: in selects it is not sensible to call
 srv_active_wake_master_thread after each fetch or search, we only do
@@ -525,6 +543,26 @@ static MYSQL_THDVAR_ULONG(merge_sort_block_size, PLUGIN_VAR_RQCMDARG,
   "The block size used doing external merge-sort for secondary index creation.",
   NULL, NULL, 1UL << 20, 1UL << 20, 1UL << 30, 0);
 
+static MYSQL_SYSVAR_ULONG(merge_sort_threads, srv_merge_sort_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads merge sorting the secondary indexes in parallel when several indexes are created by one ALTER TABLE.",
+  NULL, NULL, 1, 1, 64, 0);
+
+static MYSQL_THDVAR_BOOL(bulk_load, PLUGIN_VAR_OPCMDARG,
+  "Load LOAD DATA, multi-row INSERT and INSERT ... SELECT into an empty table by sorting the rows and building the indexes bottom-up. "
+  "The table is locked in exclusive mode until the transaction ends, and duplicate keys are only reported at the end of the statement.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONG(fill_factor, srv_fill_factor,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of each index page that is filled by a bulk load; 100 leaves 1/16 of the page free for later updates.",
+  NULL, NULL, 100, 10, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(latch_profile, srv_latch_profile,
+  PLUGIN_VAR_RQCMDARG,
+  "Sample one of this many page latch acquisitions and record all rw-lock waits, shown in INFORMATION_SCHEMA.XTRADB_HOT_PAGES and XTRADB_RWLOCK_WAITS (0 disables the profiler).",
+  NULL, NULL, 0, 0, 1000000, 0);
+
 static handler *innobase_create_handler(handlerton *hton,
                                         TABLE_SHARE *table,
                                         MEM_ROOT *mem_root)
@@ -734,6 +772,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_read_ahead_evicted, SHOW_LONG},
   {"buffer_pool_read_requests",
   (char*) &export_vars.innodb_buffer_pool_read_requests,  SHOW_LONG},
+  {"buffer_pool_read_requests_numa_local",
+  (char*) &export_vars.innodb_buffer_pool_read_requests_numa_local, SHOW_LONG},
   {"buffer_pool_reads",
   (char*) &export_vars.innodb_buffer_pool_reads,	  SHOW_LONG},
   {"buffer_pool_wait_free",
@@ -852,6 +892,10 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_purge_trx_id,		  SHOW_LONGLONG},
   {"purge_undo_no",
   (char*) &export_vars.innodb_purge_undo_no,		  SHOW_LONGLONG},
+  {"purge_lag",
+  (char*) &export_vars.innodb_purge_lag,		  SHOW_LONGLONG},
+  {"purge_dml_delay",
+  (char*) &export_vars.innodb_purge_dml_delay,		  SHOW_LONG},
   {"row_lock_current_waits",
   (char*) &export_vars.innodb_row_lock_current_waits,	  SHOW_LONG},
   {"current_row_locks",
@@ -1934,7 +1978,9 @@ ha_innobase::ha_innobase(handlerton *hton, TABLE_SHARE *table_arg)
 		  HA_CAN_GEOMETRY | HA_PARTIAL_COLUMN_READ |
 		  HA_TABLE_SCAN_ON_INDEX),
   start_of_scan(0),
-  num_write_row(0)
+  num_write_row(0),
+  bulk_load_requested(false),
+  ignore_dup_key(false)
 {}
 
 /*********************************************************************//**
@@ -2628,6 +2674,7 @@ innobase_init(
         innobase_hton->flags=HTON_NO_FLAGS;
         innobase_hton->release_temporary_latches=innobase_release_temporary_latches;
 	innobase_hton->alter_table_flags = innobase_alter_table_flags;
+	innobase_hton->table_options = innodb_table_option_list;
         innobase_hton->kill_query = innobase_kill_query;
 
 	ut_a(DATA_MYSQL_TRUE_VARCHAR == (ulint)MYSQL_TYPE_VARCHAR);
@@ -3057,6 +3104,13 @@ innobase_change_buffering_inited_ok:
 			"help in upgrading.\n");
 	}
 
+	if (srv_checksum_algorithm == SRV_CHECKSUM_ALGORITHM_CRC32) {
+		fprintf(stderr,
+			"InnoDB: Using %s crc32 page checksums\n",
+			my_crc32c_is_hw_accelerated()
+			? "SSE4.2" : "software");
+	}
+
 	srv_blocking_lru_restore = (ibool) innobase_blocking_lru_restore;
 
 #ifdef HAVE_LARGE_PAGES
@@ -4751,6 +4805,17 @@ table_opened:
 		DBUG_RETURN(HA_ERR_NO_SUCH_TABLE);
 	}
 
+	/* Select the page compression algorithm.  The data dictionary
+does not store it; pages record the algorithm they were compressed
+with, so a table can hold pages of both algorithms. */
+	if (table->s->option_struct
+	    && table->s->option_struct->page_compression_algorithm) {
+		ib_table->zip_algorithm = table->s->option_struct
+			->page_compression_algorithm - 1;
+	} else {
+		ib_table->zip_algorithm = ULINT_UNDEFINED;
+	}
+
 	prebuilt = row_create_prebuilt(ib_table, table->s->stored_rec_length);
 
 	prebuilt->default_rec = table->s->default_values;
@@ -6103,7 +6168,8 @@ ha_innobase::write_row(
 	     || sql_command == SQLCOM_OPTIMIZE
 	     || sql_command == SQLCOM_CREATE_INDEX
 	     || sql_command == SQLCOM_DROP_INDEX)
-	    && num_write_row >= 10000) {
+	    && num_write_row >= 10000
+	    && !prebuilt->bulk) {
 		/* ALTER TABLE is COMMITted at every 10000 copied rows.
 		The IX table lock for the original table has to be re-issued.
 		As this method will be called on a temporary table where the
@@ -6213,7 +6279,24 @@ no_commit:
 
 	innodb_srv_conc_enter_innodb(prebuilt->trx);
 
-	error = row_insert_for_mysql((byte*) record, prebuilt);
+	if (bulk_load_requested) {
+		bulk_load_requested = false;
+
+		if (!ignore_dup_key && !trx->duplicates) {
+			error = row_bulk_start_for_mysql(prebuilt, table);
+
+			if (error != DB_SUCCESS) {
+				innodb_srv_conc_exit_innodb(prebuilt->trx);
+				goto report_error;
+			}
+		}
+	}
+
+	if (prebuilt->bulk) {
+		error = row_bulk_insert_for_mysql((byte*) record, prebuilt);
+	} else {
+		error = row_insert_for_mysql((byte*) record, prebuilt);
+	}
 
 #ifdef EXTENDED_FOR_USERSTAT
 	if (UNIV_LIKELY(error == DB_SUCCESS && !trx->fake_changes)) {
@@ -6323,6 +6406,62 @@ func_exit:
 	DBUG_RETURN(error_result);
 }
 
+/**********************************************************************//**
+Prepares for inserting many rows into the table. If innodb_bulk_load is
+set, the next write_row() starts a bulk load when the table is empty,
+see row_bulk_start_for_mysql(). */
+UNIV_INTERN
+void
+ha_innobase::start_bulk_insert(
+/*===========================*/
+	ha_rows	rows)	/*!< in: number of rows to insert, or 0 if not
+			known */
+{
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+
+	/* Triggers could read the table between the rows, and
+	BLOBs are stored externally row by row. */
+
+	bulk_load_requested = rows != 1
+		&& THDVAR(ha_thd(), bulk_load)
+		&& !table->triggers
+		&& !table->s->blob_fields;
+
+	DBUG_VOID_RETURN;
+}
+
+/**********************************************************************//**
+Ends the inserts started by start_bulk_insert(). If a bulk load was
+started, loads the rows into the indexes.
+@return	0 or error number */
+UNIV_INTERN
+int
+ha_innobase::end_bulk_insert(void)
+/*==============================*/
+{
+	int	error;
+
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	bulk_load_requested = false;
+
+	if (!prebuilt->bulk) {
+		DBUG_RETURN(0);
+	}
+
+	innodb_srv_conc_enter_innodb(prebuilt->trx);
+
+	error = row_bulk_end_for_mysql(prebuilt, TRUE);
+
+	innodb_srv_conc_exit_innodb(prebuilt->trx);
+
+	/* The caller reports the error through my_errno. */
+	my_errno = convert_error_code_to_mysql(error, prebuilt->table->flags,
+					       user_thd);
+
+	DBUG_RETURN(my_errno);
+}
+
 /**********************************************************************//**
 Checks which fields have changed in a row and stores information
 of them to an update vector.
@@ -8262,6 +8401,20 @@ ha_innobase::create(
 		break;
 	}
 
+	/* Only compressed pages have a compression algorithm.  Reject
+	the option rather than ignore it, so that it cannot silently take
+	effect after a later ALTER TABLE ROW_FORMAT=COMPRESSED. */
+	if (form->s->option_struct
+	    && form->s->option_struct->page_compression_algorithm
+	    && !(flags & DICT_TF_ZSSIZE_MASK)) {
+		push_warning(
+			thd, MYSQL_ERROR::WARN_LEVEL_WARN,
+			ER_ILLEGAL_HA_CREATE_OPTION,
+			"InnoDB: PAGE_COMPRESSION_ALGORITHM requires"
+			" ROW_FORMAT=COMPRESSED.");
+		DBUG_RETURN(ER_ILLEGAL_HA_CREATE_OPTION);
+	}
+
 	/* Look for a primary key */
 
 	primary_key_no= (form->s->primary_key != MAX_KEY ?
@@ -10306,8 +10459,12 @@ ha_innobase::extra(
 		case HA_EXTRA_INSERT_WITH_UPDATE:
 			thd_to_trx(ha_thd())->duplicates |= TRX_DUP_IGNORE;
 			break;
+		case HA_EXTRA_IGNORE_DUP_KEY:
+			ignore_dup_key = true;
+			break;
 		case HA_EXTRA_NO_IGNORE_DUP_KEY:
 			thd_to_trx(ha_thd())->duplicates &= ~TRX_DUP_IGNORE;
+			ignore_dup_key = false;
 			break;
 		case HA_EXTRA_WRITE_CAN_REPLACE:
 			thd_to_trx(ha_thd())->duplicates |= TRX_DUP_REPLACE;
@@ -10333,6 +10490,10 @@ ha_innobase::reset()
 	reset_template();
 	ds_mrr.dsmrr_close();
 
+	/* Discard a bulk load that end_bulk_insert() did not finish. */
+	bulk_load_requested = false;
+	row_bulk_end_for_mysql(prebuilt, FALSE);
+
 	/* TODO: This should really be reset in reset_template() but for now
 	it's safer to do it explicitly here. */
 
@@ -12710,6 +12871,56 @@ static MYSQL_SYSVAR_BOOL(checksums, innobase_use_checksums,
   "Disable with --skip-innodb-checksums.",
   NULL, NULL, TRUE);
 
+static const char* innodb_checksum_algorithm_names[]=
+{
+  "innodb",
+  "crc32",
+  NullS
+};
+
+static TYPELIB innodb_checksum_algorithm_typelib=
+{
+  array_elements(innodb_checksum_algorithm_names) - 1,
+  "innodb_checksum_algorithm_typelib",
+  innodb_checksum_algorithm_names,
+  NULL
+};
+
+static MYSQL_SYSVAR_ENUM(checksum_algorithm, srv_checksum_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "The algorithm of the checksum stored to pages when they are written. "
+  "innodb: the fold based InnoDB checksum; "
+  "crc32: CRC-32C, computed with the SSE4.2 instruction when available. "
+  "Pages are verified against all algorithms, so existing data files "
+  "stay readable after a change.",
+  NULL, NULL, SRV_CHECKSUM_ALGORITHM_INNODB,
+  &innodb_checksum_algorithm_typelib);
+
+static const char* innodb_compression_algorithm_names[]=
+{
+  "zlib",
+  "lz",
+  NullS
+};
+
+static TYPELIB innodb_compression_algorithm_typelib=
+{
+  array_elements(innodb_compression_algorithm_names) - 1,
+  "innodb_compression_algorithm_typelib",
+  innodb_compression_algorithm_names,
+  NULL
+};
+
+static MYSQL_SYSVAR_ENUM(compression_algorithm, page_zip_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "The algorithm used to compress the pages of ROW_FORMAT=COMPRESSED "
+  "tables that do not specify PAGE_COMPRESSION_ALGORITHM. "
+  "zlib: deflate; "
+  "lz: a faster LZ77 codec with a lower compression ratio. "
+  "Each page records its algorithm, so tables stay readable after a change.",
+  NULL, NULL, PAGE_ZIP_ALGORITHM_ZLIB,
+  &innodb_compression_algorithm_typelib);
+
 static MYSQL_SYSVAR_BOOL(fast_checksum, innobase_fast_checksum,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "DEPRECATED. #### WARNING #### : This feature is DEPRECATED and WILL "
@@ -12791,11 +13002,13 @@ static MYSQL_SYSVAR_ULONG(rollback_segments, srv_rollback_segments,
 
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
-  "Purge threads can be either 0 or 1.",
+  "Number of purge threads. 0 purges in the master thread, 1 in a separate "
+  "purge thread, and larger values add purge worker threads that purge "
+  "the undo log records of different tables in parallel.",
   NULL, NULL,
   1,			/* Default setting */
   0,			/* Minimum value */
-  1, 0);		/* Maximum value */
+  32, 0);		/* Maximum value */
 
 static MYSQL_SYSVAR_ULONG(fast_shutdown, innobase_fast_shutdown,
   PLUGIN_VAR_OPCMDARG,
@@ -12998,6 +13211,13 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_populate, srv_buf_pool_populate,
   "established by the buffer pool memory region. Disabled by default.",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_BOOL(buffer_pool_numa, srv_buf_pool_numa,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Place the memory of each buffer pool instance on one NUMA node, "
+  "round robin, and spread the I/O threads over the nodes. "
+  "Disabled by default.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_LONG(buffer_pool_instances, innobase_buffer_pool_instances,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Number of buffer pool instances, set to higher value on high-end machines to increase scalability",
@@ -13124,6 +13344,11 @@ static MYSQL_SYSVAR_STR(doublewrite_file, innobase_doublewrite_file,
   "Path to special datafile for doublewrite buffer. (default is "": not used) ### ONLY FOR EXPERTS!!! ###",
   NULL, NULL, NULL);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_shards, srv_doublewrite_shards,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of shards the doublewrite buffer is split into. Each buffer pool instance posts its pages to one shard, and the shards are written and flushed in parallel.",
+  NULL, NULL, 1, 1, MAX_BUFFER_POOLS, 0);
+
 static MYSQL_SYSVAR_LONG(autoinc_lock_mode, innobase_autoinc_lock_mode,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "The AUTOINC lock modes supported by InnoDB:               "
@@ -13150,6 +13375,11 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of io_submit() for Linux native AIO, if supported by the kernel.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
   PLUGIN_VAR_RQCMDARG,
   "Buffer changes to reduce random access: "
@@ -13233,6 +13463,11 @@ static MYSQL_SYSVAR_ULONG(ibuf_accel_rate, srv_ibuf_accel_rate,
   "Tunes amount of insert buffer processing of background, in addition to innodb_io_capacity. (in percentage)",
   NULL, NULL, 100, 100, 999999999, 0);
 
+static MYSQL_SYSVAR_ULONG(ibuf_sequential_merge, srv_ibuf_sequential_merge,
+  PLUGIN_VAR_RQCMDARG,
+  "Enable/Disable in-order background merge of insert buffer, reading the pages of large batches asynchronously in ascending order and raising the merge rate as insert buffer grows. 0:disable 1:enable",
+  NULL, NULL, 0, 0, 1, 0);
+
 static MYSQL_SYSVAR_ULINT(checkpoint_age_target, srv_checkpoint_age_target,
   PLUGIN_VAR_RQCMDARG,
   "Control soft limit of checkpoint age. (0 : not control)",
@@ -13409,16 +13644,20 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* !DBUG_OFF */
   MYSQL_SYSVAR(buffer_pool_size),
   MYSQL_SYSVAR(buffer_pool_populate),
+  MYSQL_SYSVAR(buffer_pool_numa),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(buffer_pool_shm_key),
   MYSQL_SYSVAR(buffer_pool_shm_checksum),
   MYSQL_SYSVAR(checksums),
   MYSQL_SYSVAR(fast_checksum),
+  MYSQL_SYSVAR(checksum_algorithm),
+  MYSQL_SYSVAR(compression_algorithm),
   MYSQL_SYSVAR(commit_concurrency),
   MYSQL_SYSVAR(concurrency_tickets),
   MYSQL_SYSVAR(kill_idle_transaction),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(doublewrite_file),
+  MYSQL_SYSVAR(doublewrite_shards),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
   MYSQL_SYSVAR(use_atomic_writes),
@@ -13485,6 +13724,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(ibuf_max_size),
   MYSQL_SYSVAR(ibuf_active_contract),
   MYSQL_SYSVAR(ibuf_accel_rate),
+  MYSQL_SYSVAR(ibuf_sequential_merge),
   MYSQL_SYSVAR(checkpoint_age_target),
   MYSQL_SYSVAR(flush_neighbor_pages),
   MYSQL_SYSVAR(read_ahead),
@@ -13493,6 +13733,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(dict_size_limit),
   MYSQL_SYSVAR(use_sys_malloc),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(track_changed_pages),
   MYSQL_SYSVAR(max_bitmap_file_size),
@@ -13518,6 +13759,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(fake_changes),
   MYSQL_SYSVAR(locking_fake_changes),
   MYSQL_SYSVAR(merge_sort_block_size),
+  MYSQL_SYSVAR(merge_sort_threads),
+  MYSQL_SYSVAR(bulk_load),
+  MYSQL_SYSVAR(fill_factor),
+  MYSQL_SYSVAR(latch_profile),
   MYSQL_SYSVAR(print_all_deadlocks),
   NULL
 };
@@ -13564,7 +13809,9 @@ i_s_innodb_admin_command,
 i_s_innodb_changed_pages,
 i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
-i_s_innodb_buffer_stats
+i_s_innodb_buffer_stats,
+i_s_xtradb_hot_pages,
+i_s_xtradb_rwlock_waits
 maria_declare_plugin_end;
 
 /** @brief Initialize the default value of innodb_commit_concurrency.
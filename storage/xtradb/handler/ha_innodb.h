@@ -97,6 +97,12 @@ class ha_innobase: public handler
 					ROW_SEL_EXACT, ROW_SEL_EXACT_PREFIX,
 					or undefined */
 	uint		num_write_row;	/*!< number of write_row() calls */
+	bool		bulk_load_requested;
+					/*!< true if start_bulk_insert()
+					asked for a bulk load, which is
+					started by the next write_row() */
+	bool		ignore_dup_key;	/*!< true if duplicate keys are
+					ignored or replaced, see extra() */
 
 	uint store_key_val_for_row(uint keynr, char* buff, uint buff_len,
                                    const uchar* record);
@@ -142,6 +148,8 @@ class ha_innobase: public handler
 	my_bool is_fake_change_enabled(THD *thd);
 	bool is_corrupt() const;
 
+	void start_bulk_insert(ha_rows rows);
+	int end_bulk_insert();
 	int write_row(uchar * buf);
 	int update_row(const uchar * old_data, uchar * new_data);
 	int delete_row(const uchar * buf);
@@ -67,6 +67,7 @@ extern "C" {
 #include "btr0btr.h"
 #include "page0zip.h"
 #include "log0log.h"
+#include "sync0prof.h" /* for XTRADB_HOT_PAGES */
 }
 
 /** structure associates a name string with a file page type and/or buffer
@@ -6124,6 +6125,14 @@ nomatch:
 
 		goto end_func;
 	}
+	else if (!strncasecmp("XTRA_LATCH_PROFILE_RESET", ptr, 24)) {
+		sync_prof_reset();
+
+		field_store_string(i_s_table->field[0],
+			"XTRA_LATCH_PROFILE_RESET was succeeded.");
+
+		goto end_func;
+	}
 	else if (!strncasecmp("XTRA_LRU_RESTORE", ptr, 16)) {
 		ut_print_timestamp(stderr);
 		fprintf(stderr, " InnoDB: Administrative command 'XTRA_LRU_RESTORE'"
@@ -6183,6 +6192,407 @@ UNIV_INTERN struct st_maria_plugin	i_s_innodb_admin_command =
         INNODB_VERSION_STR, MariaDB_PLUGIN_MATURITY_STABLE
 };
 
+/***********************************************************************
+*/
+static ST_FIELD_INFO	i_s_xtradb_hot_pages_info[] =
+{
+#define IDX_HOT_PAGES_SPACE		0
+	{STRUCT_FLD(field_name,		"space"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_PAGE_NUMBER	1
+	{STRUCT_FLD(field_name,		"page_number"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_PAGE_TYPE		2
+	{STRUCT_FLD(field_name,		"page_type"),
+	 STRUCT_FLD(field_length,	64),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_INDEX_ID		3
+	{STRUCT_FLD(field_name,		"index_id"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_TABLE_NAME	4
+	{STRUCT_FLD(field_name,		"table_name"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_INDEX_NAME	5
+	{STRUCT_FLD(field_name,		"index_name"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_LEVEL		6
+	{STRUCT_FLD(field_name,		"level"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_ACCESSES		7
+	{STRUCT_FLD(field_name,		"accesses"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_HOT_PAGES_WAIT_TIME		8
+	{STRUCT_FLD(field_name,		"wait_time_us"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill Information Schema table XTRADB_HOT_PAGES with the pages copied from
+the latch profiler
+@return	0 on success, 1 on failure */
+static
+int
+i_s_xtradb_hot_pages_fill_low(
+/*==========================*/
+	THD*			thd,	/*!< in: thread */
+	TABLE_LIST*		tables,	/*!< in/out: tables to fill */
+	const sync_prof_page_t*	pages,	/*!< in: sampled pages */
+	ulint			n_pages,/*!< in: number of pages */
+	mem_heap_t*		heap)	/*!< in: temp heap memory */
+{
+	TABLE*	table	= tables->table;
+	Field**	fields	= table->field;
+
+	DBUG_ENTER("i_s_xtradb_hot_pages_fill_low");
+
+	for (ulint i = 0; i < n_pages; i++) {
+		const sync_prof_page_t*	page		= &pages[i];
+		const char*		table_name	= NULL;
+		const char*		index_name	= NULL;
+		ulint			type		= page->page_type;
+
+		if (type == FIL_PAGE_INDEX) {
+			const dict_index_t*	index;
+
+			type = I_S_PAGE_TYPE_INDEX;
+
+			/* Copy the index/table name under mutex, as in
+			i_s_innodb_buffer_page_fill() */
+			mutex_enter(&dict_sys->mutex);
+			index = dict_index_get_if_in_cache_low(
+				page->index_id);
+
+			if (index) {
+				const char*	name_ptr = index->name;
+
+				if (name_ptr[0] == TEMP_INDEX_PREFIX) {
+					name_ptr++;
+				}
+
+				index_name = mem_heap_strdup(heap, name_ptr);
+				table_name = mem_heap_strdup(
+					heap, index->table_name);
+			}
+
+			mutex_exit(&dict_sys->mutex);
+		} else if (type >= I_S_PAGE_TYPE_UNKNOWN) {
+			type = I_S_PAGE_TYPE_UNKNOWN;
+		}
+
+		OK(fields[IDX_HOT_PAGES_SPACE]->store(page->space));
+		OK(fields[IDX_HOT_PAGES_PAGE_NUMBER]->store(page->page_no));
+		OK(field_store_string(fields[IDX_HOT_PAGES_PAGE_TYPE],
+				      i_s_page_type[type].type_str));
+		OK(fields[IDX_HOT_PAGES_INDEX_ID]->store(
+			(longlong) page->index_id, true));
+		OK(field_store_string(fields[IDX_HOT_PAGES_TABLE_NAME],
+				      table_name));
+		OK(field_store_string(fields[IDX_HOT_PAGES_INDEX_NAME],
+				      index_name));
+		OK(fields[IDX_HOT_PAGES_LEVEL]->store(page->level));
+		OK(fields[IDX_HOT_PAGES_ACCESSES]->store(
+			(longlong) page->n_accesses, true));
+		OK(fields[IDX_HOT_PAGES_WAIT_TIME]->store(
+			(longlong) page->wait_us, true));
+		OK(schema_table_store_record(thd, table));
+
+		mem_heap_empty(heap);
+	}
+
+	DBUG_RETURN(0);
+}
+
+/*******************************************************************//**
+Fill the dynamic table information_schema.XTRADB_HOT_PAGES
+@return	0 on success, 1 on failure */
+static
+int
+i_s_xtradb_hot_pages_fill(
+/*======================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	COND*		cond)	/*!< in: condition (ignored) */
+{
+	sync_prof_page_t*	pages;
+	mem_heap_t*		heap;
+	int			status;
+
+	DBUG_ENTER("i_s_xtradb_hot_pages_fill");
+
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
+
+	/* deny access to non-superusers */
+	if (check_global_access(thd, PROCESS_ACL, true)) {
+		DBUG_RETURN(0);
+	}
+
+	pages = (sync_prof_page_t*) mem_alloc(
+		SYNC_PROF_N_PAGES * sizeof *pages);
+	heap = mem_heap_create(1000);
+
+	status = i_s_xtradb_hot_pages_fill_low(
+		thd, tables, pages, sync_prof_get_pages(pages), heap);
+
+	mem_heap_free(heap);
+	mem_free(pages);
+
+	DBUG_RETURN(status);
+}
+
+/*******************************************************************//**
+Bind the dynamic table information_schema.XTRADB_HOT_PAGES.
+@return 0 on success */
+static
+int
+i_s_xtradb_hot_pages_init(
+/*======================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	DBUG_ENTER("i_s_xtradb_hot_pages_init");
+	ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = i_s_xtradb_hot_pages_info;
+	schema->fill_table = i_s_xtradb_hot_pages_fill;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_maria_plugin	i_s_xtradb_hot_pages =
+{
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+	STRUCT_FLD(info, &i_s_info),
+	STRUCT_FLD(name, "XTRADB_HOT_PAGES"),
+	STRUCT_FLD(author, plugin_author),
+	STRUCT_FLD(descr, "Pages most often latched, sampled by innodb_latch_profile"),
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+	STRUCT_FLD(init, i_s_xtradb_hot_pages_init),
+	STRUCT_FLD(deinit, i_s_common_deinit),
+	STRUCT_FLD(version, 0x0100 /* 1.0 */),
+	STRUCT_FLD(status_vars, NULL),
+	STRUCT_FLD(system_vars, NULL),
+        INNODB_VERSION_STR, MariaDB_PLUGIN_MATURITY_STABLE
+};
+
+/***********************************************************************
+*/
+static ST_FIELD_INFO	i_s_xtradb_rwlock_waits_info[] =
+{
+#define IDX_RWLOCK_WAITS_LOCK_NAME	0
+	{STRUCT_FLD(field_name,		"lock_name"),
+	 STRUCT_FLD(field_length,	OS_FILE_MAX_PATH),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_RWLOCK_WAITS_FILE		1
+	{STRUCT_FLD(field_name,		"file"),
+	 STRUCT_FLD(field_length,	OS_FILE_MAX_PATH),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_RWLOCK_WAITS_LINE		2
+	{STRUCT_FLD(field_name,		"line"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_RWLOCK_WAITS_S_WAITS	3
+	{STRUCT_FLD(field_name,		"s_waits"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_RWLOCK_WAITS_X_WAITS	4
+	{STRUCT_FLD(field_name,		"x_waits"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_RWLOCK_WAITS_WAIT_TIME	5
+	{STRUCT_FLD(field_name,		"wait_time_us"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill Information Schema table XTRADB_RWLOCK_WAITS with the wait sites
+copied from the latch profiler
+@return	0 on success, 1 on failure */
+static
+int
+i_s_xtradb_rwlock_waits_fill_low(
+/*=============================*/
+	THD*			thd,	/*!< in: thread */
+	TABLE_LIST*		tables,	/*!< in/out: tables to fill */
+	const sync_prof_rw_t*	waits,	/*!< in: wait sites */
+	ulint			n_waits)/*!< in: number of wait sites */
+{
+	TABLE*	table	= tables->table;
+	Field**	fields	= table->field;
+
+	DBUG_ENTER("i_s_xtradb_rwlock_waits_fill_low");
+
+	for (ulint i = 0; i < n_waits; i++) {
+		const sync_prof_rw_t*	wait = &waits[i];
+
+		OK(field_store_string(fields[IDX_RWLOCK_WAITS_LOCK_NAME],
+				      wait->lock_name));
+		OK(field_store_string(fields[IDX_RWLOCK_WAITS_FILE],
+				      innobase_basename(wait->file_name)));
+		OK(fields[IDX_RWLOCK_WAITS_LINE]->store(wait->line));
+		OK(fields[IDX_RWLOCK_WAITS_S_WAITS]->store(
+			(longlong) wait->n_s_waits, true));
+		OK(fields[IDX_RWLOCK_WAITS_X_WAITS]->store(
+			(longlong) wait->n_x_waits, true));
+		OK(fields[IDX_RWLOCK_WAITS_WAIT_TIME]->store(
+			(longlong) wait->wait_us, true));
+		OK(schema_table_store_record(thd, table));
+	}
+
+	DBUG_RETURN(0);
+}
+
+/*******************************************************************//**
+Fill the dynamic table information_schema.XTRADB_RWLOCK_WAITS
+@return	0 on success, 1 on failure */
+static
+int
+i_s_xtradb_rwlock_waits_fill(
+/*=========================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	COND*		cond)	/*!< in: condition (ignored) */
+{
+	sync_prof_rw_t*	waits;
+	int		status;
+
+	DBUG_ENTER("i_s_xtradb_rwlock_waits_fill");
+
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
+
+	/* deny access to non-superusers */
+	if (check_global_access(thd, PROCESS_ACL, true)) {
+		DBUG_RETURN(0);
+	}
+
+	waits = (sync_prof_rw_t*) mem_alloc(SYNC_PROF_N_RW * sizeof *waits);
+
+	status = i_s_xtradb_rwlock_waits_fill_low(
+		thd, tables, waits, sync_prof_get_rw_waits(waits));
+
+	mem_free(waits);
+
+	DBUG_RETURN(status);
+}
+
+/*******************************************************************//**
+Bind the dynamic table information_schema.XTRADB_RWLOCK_WAITS.
+@return 0 on success */
+static
+int
+i_s_xtradb_rwlock_waits_init(
+/*=========================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	DBUG_ENTER("i_s_xtradb_rwlock_waits_init");
+	ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = i_s_xtradb_rwlock_waits_info;
+	schema->fill_table = i_s_xtradb_rwlock_waits_fill;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_maria_plugin	i_s_xtradb_rwlock_waits =
+{
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+	STRUCT_FLD(info, &i_s_info),
+	STRUCT_FLD(name, "XTRADB_RWLOCK_WAITS"),
+	STRUCT_FLD(author, plugin_author),
+	STRUCT_FLD(descr, "rw-lock waits recorded by innodb_latch_profile"),
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+	STRUCT_FLD(init, i_s_xtradb_rwlock_waits_init),
+	STRUCT_FLD(deinit, i_s_common_deinit),
+	STRUCT_FLD(version, 0x0100 /* 1.0 */),
+	STRUCT_FLD(status_vars, NULL),
+	STRUCT_FLD(system_vars, NULL),
+        INNODB_VERSION_STR, MariaDB_PLUGIN_MATURITY_STABLE
+};
+
 /***********************************************************************
 */
 static ST_FIELD_INFO	i_s_innodb_buffer_pool_pages_fields_info[] =
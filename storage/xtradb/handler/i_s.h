@@ -55,5 +55,7 @@ extern struct st_maria_plugin	i_s_innodb_changed_pages;
 extern struct st_maria_plugin	i_s_innodb_buffer_page;
 extern struct st_maria_plugin	i_s_innodb_buffer_page_lru;
 extern struct st_maria_plugin	i_s_innodb_buffer_stats;
+extern struct st_maria_plugin	i_s_xtradb_hot_pages;
+extern struct st_maria_plugin	i_s_xtradb_rwlock_waits;
 
 #endif /* i_s_h */
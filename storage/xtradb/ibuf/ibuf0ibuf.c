@@ -310,6 +310,10 @@ page are merged along with the page whose buffer became full */
 batch, in order to merge the entries for them in the insert buffer */
 #define	IBUF_MAX_N_PAGES_MERGED		IBUF_MERGE_AREA
 
+/** In the in-order background merge at most this number of pages is read
+to memory in one batch of asynchronous reads */
+#define IBUF_SEQ_MAX_N_PAGES_MERGED	64
+
 /** If the combined size of the ibuf trees exceeds ibuf->max_size by this
 many pages, we start to contract it in connection to inserts there, using
 non-synchronous contract */
@@ -2732,6 +2736,139 @@ ibuf_contract_ext(
 	return(sum_sizes + 1);
 }
 
+/** Position of the in-order background merge: the next batch starts
+from the first entry buffered for a page >= (space, page_no). Only
+accessed by the master thread. */
+static ulint	ibuf_seq_merge_space	= 0;
+static ulint	ibuf_seq_merge_page_no	= 0;
+
+/*********************************************************************//**
+Contracts insert buffer trees by reading pages to the buffer pool, walking
+the insert buffer tree in key order from where the previous call left off.
+The pages of a batch are thus in ascending order within a tablespace, and
+they are read by a large batch of asynchronous reads. When the end of the
+tree is reached, the merge starts over from its beginning.
+@return a lower limit for the combined size in bytes of entries which
+will be merged from ibuf trees to the pages read, 0 if ibuf is
+empty */
+static
+ulint
+ibuf_contract_in_order(
+/*===================*/
+	ulint*	n_pages,/*!< out: number of pages to which merged */
+	ibool	sync)	/*!< in: TRUE if the caller wants to wait for the
+			issued read with the highest tablespace address
+			to complete */
+{
+	btr_pcur_t	pcur;
+	ulint		page_nos[IBUF_SEQ_MAX_N_PAGES_MERGED];
+	ulint		space_ids[IBUF_SEQ_MAX_N_PAGES_MERGED];
+	ib_int64_t	space_versions[IBUF_SEQ_MAX_N_PAGES_MERGED];
+	ulint		sum_sizes;
+	ulint		limit;
+	ibool		wrapped	= FALSE;
+	mem_heap_t*	heap;
+	mtr_t		mtr;
+
+	*n_pages = 0;
+
+	/* See the comment in ibuf_contract_ext() */
+
+	if (UNIV_UNLIKELY(ibuf->empty)
+	    && UNIV_LIKELY(!srv_shutdown_state)) {
+		return(0);
+	}
+
+	if (UNIV_UNLIKELY(!trx_sys_multiple_tablespace_format)) {
+		return(ibuf_contract_ext(n_pages, sync));
+	}
+
+	limit = ut_min(IBUF_SEQ_MAX_N_PAGES_MERGED,
+		       buf_pool_get_curr_size() / 4);
+
+	heap = mem_heap_create(512);
+
+	for (;;) {
+		dtuple_t*	search_tuple;
+		ulint		prev_space_id	= 0;
+		ulint		prev_page_no	= 0;
+
+		sum_sizes = 0;
+
+		search_tuple = ibuf_new_search_tuple_build(
+			ibuf_seq_merge_space, ibuf_seq_merge_page_no, heap);
+
+		ibuf_mtr_start(&mtr);
+
+		btr_pcur_open_on_user_rec(
+			ibuf->index, search_tuple, PAGE_CUR_GE,
+			BTR_SEARCH_LEAF, &pcur, &mtr);
+
+		/* The merge restarts from the beginning of the tree
+		unless the batch fills up before its end */
+
+		ibuf_seq_merge_space = 0;
+		ibuf_seq_merge_page_no = 0;
+
+		while (btr_pcur_is_on_user_rec(&pcur)) {
+			const rec_t*	rec = btr_pcur_get_rec(&pcur);
+			ulint		space_id;
+			ulint		page_no;
+
+			space_id = ibuf_rec_get_space(&mtr, rec);
+			page_no = ibuf_rec_get_page_no(&mtr, rec);
+
+			if (space_id != prev_space_id
+			    || page_no != prev_page_no) {
+
+				if (*n_pages == limit) {
+					ibuf_seq_merge_space = space_id;
+					ibuf_seq_merge_page_no = page_no;
+					break;
+				}
+
+				space_ids[*n_pages] = space_id;
+				space_versions[*n_pages]
+					= fil_space_get_version(space_id);
+				page_nos[*n_pages] = page_no;
+
+				(*n_pages)++;
+
+				prev_space_id = space_id;
+				prev_page_no = page_no;
+			}
+
+			sum_sizes += ibuf_rec_get_volume(&mtr, rec);
+
+			btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+		}
+
+		ibuf_mtr_commit(&mtr);
+		btr_pcur_close(&pcur);
+
+		if (*n_pages > 0 || wrapped) {
+			break;
+		}
+
+		/* Nothing was left after the previous position:
+		start over from the beginning of the tree */
+
+		wrapped = TRUE;
+		mem_heap_empty(heap);
+	}
+
+	mem_heap_free(heap);
+
+	if (*n_pages == 0) {
+		return(0);
+	}
+
+	buf_read_ibuf_merge_pages(sync, space_ids, space_versions, page_nos,
+				  *n_pages);
+
+	return(sum_sizes + 1);
+}
+
 /*********************************************************************//**
 Contracts insert buffer trees by reading pages to the buffer pool.
 @return a lower limit for the combined size in bytes of entries which
@@ -2771,8 +2908,19 @@ ibuf_contract_for_n_pages(
 	ulint	n_bytes;
 	ulint	n_pag2;
 
+	if (srv_ibuf_sequential_merge && ibuf->max_size > 0) {
+		/* Raise the merge rate with the size of the insert
+		buffer, up to 4 times n_pages when it is full, so that
+		the background merge keeps ahead of the merges done
+		when pages are read */
+		n_pages += 3 * n_pages * ut_min(ibuf->size, ibuf->max_size)
+			/ ibuf->max_size;
+	}
+
 	while (sum_pages < n_pages) {
-		n_bytes = ibuf_contract_ext(&n_pag2, sync);
+		n_bytes = srv_ibuf_sequential_merge
+			? ibuf_contract_in_order(&n_pag2, sync)
+			: ibuf_contract_ext(&n_pag2, sync);
 
 		if (n_bytes == 0) {
 			return(sum_bytes);
@@ -0,0 +1,92 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Monty Program Ab. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place, Suite 330, Boston, MA 02111-1307 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+Bottom-up loading of an empty B-tree from sorted index entries
+
+The entries are appended to freshly allocated leaf pages, which are filled
+up to innodb_fill_factor percent. When a page is full, its node pointer is
+appended to the level above, so that the upper levels are built bottom-up
+too. Each leaf page is filled in one mini-transaction, which logs the page
+as a compact list of appended records instead of one positioned insert per
+record. The new tree is attached to the index root only when the load is
+finished, so readers see the index empty until then.
+
+Created 2013-06-12
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+#include "btr0types.h"
+#include "data0types.h"
+#include "dict0types.h"
+#include "trx0types.h"
+
+#ifndef UNIV_HOTBACKUP
+/**************************************************************//**
+Checks if an index can be loaded bottom-up: it must be an empty,
+uncompressed index tree.
+@return	TRUE if btr_bulk_create() can be used on the index */
+UNIV_INTERN
+ibool
+btr_bulk_is_possible(
+/*=================*/
+	dict_index_t*	index);	/*!< in: index */
+/**************************************************************//**
+Starts a bottom-up load of an index. The index must be empty and
+uncompressed, and the entries must be passed to btr_bulk_insert() in
+ascending order, without duplicates.
+@return	own: the builder, or NULL if the index cannot be bulk loaded */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: index to load */
+	trx_id_t	trx_id);/*!< in: id of the loading transaction,
+				written to PAGE_MAX_TRX_ID of the
+				secondary index leaf pages */
+/**************************************************************//**
+Appends an entry to the index being loaded. The entry must not have
+externally stored columns.
+@return	DB_SUCCESS, DB_TOO_BIG_RECORD if the record is too big to be
+appended (the caller may finish the load and insert the remaining
+entries one by one), or DB_OUT_OF_FILE_SPACE */
+UNIV_INTERN
+ulint
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: builder */
+	const dtuple_t*	entry);	/*!< in: index entry */
+/**************************************************************//**
+Finishes a bottom-up load and frees the builder. If the load succeeded,
+the tree that was built replaces the empty root page of the index.
+Otherwise the pages that were built are freed and the index stays empty.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in,own: builder */
+	ulint		err);	/*!< in: DB_SUCCESS, or the error that
+				aborted the load */
+#endif /* !UNIV_HOTBACKUP */
+
+#endif
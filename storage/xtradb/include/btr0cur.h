@@ -30,6 +30,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "dict0dict.h"
 #include "page0cur.h"
 #include "btr0types.h"
+#include "ut0counter.h"
 
 /* Mode flags for btr_cur operations; these can be ORed */
 #define BTR_NO_UNDO_LOG_FLAG	1	/* do no undo logging */
@@ -792,10 +793,10 @@ inherited external field. */
 #define BTR_EXTERN_INHERITED_FLAG	64
 
 /** Number of searches down the B-tree in btr_cur_search_to_nth_level(). */
-extern ulint	btr_cur_n_non_sea;
+extern ut_counter_t	btr_cur_n_non_sea;
 /** Number of successful adaptive hash index lookups in
 btr_cur_search_to_nth_level(). */
-extern ulint	btr_cur_n_sea;
+extern ut_counter_t	btr_cur_n_sea;
 /** Old value of btr_cur_n_non_sea.  Copied by
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
@@ -38,6 +38,8 @@ typedef struct btr_pcur_struct		btr_pcur_t;
 typedef struct btr_cur_struct		btr_cur_t;
 /** B-tree search information for the adaptive hash index */
 typedef struct btr_search_struct	btr_search_t;
+/** Bottom-up builder of an empty B-tree */
+typedef struct btr_bulk_struct		btr_bulk_t;
 
 #ifndef UNIV_HOTBACKUP
 
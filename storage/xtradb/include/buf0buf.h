@@ -151,6 +151,8 @@ struct buf_pool_info_struct{
 	ulint	n_pages_created;	/*!< buf_pool->n_pages_created */
 	ulint	n_pages_written;	/*!< buf_pool->n_pages_written */
 	ulint	n_page_gets;		/*!< buf_pool->n_page_gets */
+	ulint	n_page_gets_numa_local;	/*!< buf_pool->n_page_gets_numa_local */
+	ulint	numa_node;		/*!< buf_pool->numa_node */
 	ulint	n_ra_pages_read_rnd;	/*!< buf_pool->n_ra_pages_read_rnd,
 					number of pages readahead */
 	ulint	n_ra_pages_read;	/*!< buf_pool->n_ra_pages_read, number
@@ -246,6 +248,8 @@ buf_pool_init(
 /*=========*/
 	ulint	size,		/*!< in: Size of the total pool in bytes */
 	ibool	populate,	/*!< in: Force virtual page preallocation */
+	ibool	numa,		/*!< in: Place the instances on the
+				NUMA nodes, round robin */
 	ulint	n_instances);	/*!< in: Number of instances */
 /********************************************************************//**
 Frees the buffer pool at shutdown.  This must not be invoked before
@@ -665,6 +669,16 @@ buf_calc_page_new_checksum_32(
 /*==========================*/
 	const byte*	page);	/*!< in: buffer page */
 /********************************************************************//**
+Calculates a CRC-32C page checksum which is stored to the page when it is
+written to a file with innodb_checksum_algorithm=crc32. It covers the same
+bytes as buf_calc_page_new_checksum().
+@return	checksum */
+UNIV_INTERN
+ulint
+buf_calc_page_crc32(
+/*================*/
+	const byte*	page);	/*!< in: buffer page */
+/********************************************************************//**
 In versions < 4.0.14 and < 4.1.1 there was a bug that the checksum only
 looked at the first few bytes of the page. This calculates that old
 checksum.
@@ -1307,6 +1321,13 @@ buf_pool_from_array(
 	ulint	index);		/*!< in: array index to get
 				buffer pool instance from */
 /******************************************************************//**
+Counts a page get in the statistics of a buffer pool instance. */
+UNIV_INLINE
+void
+buf_pool_inc_page_gets(
+/*===================*/
+	buf_pool_t*	buf_pool);	/*!< in/out: buffer pool instance */
+/******************************************************************//**
 Returns the control block of a file page, NULL if not found.
 @return	block, NULL if not found */
 UNIV_INLINE
@@ -1760,6 +1781,12 @@ struct buf_pool_stat_struct{
 				counted as page gets; this field
 				is NOT protected by the buffer
 				pool mutex */
+	ulint	n_page_gets_numa_local;
+				/*!< number of page gets performed
+				by a thread running on the NUMA node
+				of the buffer pool instance; this
+				field is NOT protected by the buffer
+				pool mutex */
 	ulint	n_pages_read;	/*!< number read operations */
 	ulint	n_pages_written;/*!< number write operations */
 	ulint	n_pages_created;/*!< number of pages created
@@ -1813,6 +1840,9 @@ struct buf_pool_struct{
 	mutex_t		zip_hash_mutex;
 	ulint		instance_no;	/*!< Array index of this buffer
 					pool instance */
+	ulint		numa_node;	/*!< NUMA node of the memory of this
+					buffer pool instance, or
+					ULINT_UNDEFINED */
 	ulint		old_pool_size;  /*!< Old pool size in bytes */
 	ulint		curr_pool_size;	/*!< Current pool size in bytes */
 	ulint		LRU_old_ratio;  /*!< Reserve this much of the buffer
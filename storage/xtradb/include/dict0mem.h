@@ -539,6 +539,12 @@ struct dict_table_struct{
 	unsigned	n_cols:10;/*!< number of columns */
 	unsigned	corrupted:1;
 				/*!< TRUE if table is corrupted */
+	ulint		zip_algorithm;
+				/*!< page compression algorithm of a
+				ROW_FORMAT=COMPRESSED table, or
+				ULINT_UNDEFINED to use the
+				innodb_compression_algorithm default;
+				see enum page_zip_algo */
 	dict_col_t*	cols;	/*!< array of column descriptions */
 	const char*	col_names;
 				/*!< Column names packed in a character string
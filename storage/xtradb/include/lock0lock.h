@@ -471,6 +471,26 @@ lock_table(
 	dict_table_t*	table,	/*!< in: database table in dictionary cache */
 	enum lock_mode	mode,	/*!< in: lock mode */
 	que_thr_t*	thr);	/*!< in: query thread */
+/*********************************************************************//**
+Checks if a transaction holds an exclusive lock on a table.
+@return	TRUE if trx holds LOCK_X on the table */
+UNIV_INTERN
+ibool
+lock_table_has_x(
+/*=============*/
+	trx_t*		trx,	/*!< in: transaction */
+	dict_table_t*	table);	/*!< in: table */
+/*********************************************************************//**
+Releases a granted exclusive table lock of a transaction, and grants
+the locks of other transactions waiting in the queue if they now are
+entitled to a lock. The transaction must not have modified the table
+after acquiring the lock. */
+UNIV_INTERN
+void
+lock_table_x_unlock(
+/*================*/
+	trx_t*		trx,	/*!< in: transaction */
+	dict_table_t*	table);	/*!< in: table locked with LOCK_X */
 /*************************************************************//**
 Removes a granted record lock of a transaction from the queue and grants
 locks to other transactions waiting in the queue if they now are entitled
@@ -44,6 +44,12 @@ Created 12/9/1995 Heikki Tuuri
 /* Type used for all log sequence number storage and arithmetics */
 typedef	ib_uint64_t		lsn_t;
 
+#if defined HAVE_ATOMIC_BUILTINS && !defined UNIV_LOG_DEBUG
+/** Mini-transactions reserve space in the log buffer while holding the
+log mutex, and copy their log records there after releasing it */
+# define LOG_COPY_WITHOUT_MUTEX
+#endif
+
 /** Redo log buffer */
 typedef struct log_struct	log_t;
 /** Redo log group */
@@ -148,6 +154,38 @@ log_write_low(
 /*==========*/
 	byte*	str,		/*!< in: string */
 	ulint	str_len);	/*!< in: string length */
+#ifdef LOG_COPY_WITHOUT_MUTEX
+/************************************************************//**
+Reserves space at the end of the log buffer for a string, like
+log_write_low() does but without copying the string. The string must
+then be copied with log_write_reserved() and the copy ended with
+log_write_reserved_complete(), which do not need the log mutex. It is
+assumed that the caller holds the log mutex.
+@return	offset of the reserved space in the log buffer */
+UNIV_INTERN
+ulint
+log_reserve_low(
+/*============*/
+	ulint	str_len);	/*!< in: string length */
+/************************************************************//**
+Copies a string to space reserved with log_reserve_low(). The log mutex
+need not be held. */
+UNIV_INTERN
+void
+log_write_reserved(
+/*===============*/
+	ulint*		offset,		/*!< in/out: offset in the log
+					buffer where to copy the string */
+	const byte*	str,		/*!< in: string */
+	ulint		str_len);	/*!< in: string length */
+/************************************************************//**
+Tells that the strings have been copied to the space reserved with
+log_reserve_low(), so that the log buffer can be written up to it. */
+UNIV_INLINE
+void
+log_write_reserved_complete(void);
+/*=============================*/
+#endif /* LOG_COPY_WITHOUT_MUTEX */
 /************************************************************//**
 Closes the log.
 @return	lsn */
@@ -873,6 +911,15 @@ struct log_struct{
 					AND flushed to disk */
 	ulint		n_pending_writes;/*!< number of currently
 					pending flushes or writes */
+#ifdef LOG_COPY_WITHOUT_MUTEX
+	lint		n_pending_copies;/*!< number of mini-transactions
+					that have reserved space in the log
+					buffer with log_reserve_low() but
+					not yet copied their log records
+					there; the log buffer must not be
+					written or moved before this drops
+					to 0 */
+#endif /* LOG_COPY_WITHOUT_MUTEX */
 	/* NOTE on the 'flush' in names of the fields below: starting from
 	4.0.14, we separate the write of the log file and the actual fsync()
 	or other method to flush it to disk. The names below shhould really
@@ -75,6 +75,12 @@ extern ulint	os_n_pending_writes;
 
 #endif
 
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+/** Linux native aio is compiled in: the requests are submitted either
+with io_submit() of libaio or through io_uring, chosen at startup */
+#define UNIV_LINUX_AIO
+#endif
+
 #ifdef __WIN__
 #define SRV_PATH_SEPARATOR	'\\'
 /** File handle */
@@ -1219,7 +1225,7 @@ innobase_mysql_tmpfile(void);
 #endif /* !UNIV_HOTBACKUP */
 
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(UNIV_LINUX_AIO)
 /**************************************************************************
 This function is only used in Linux native asynchronous i/o.
 Waits for an aio operation to complete. This function is used to wait the
@@ -1245,7 +1251,7 @@ os_aio_linux_handle(
 				restart the operation. */
 	ulint*	type,		/*!< out: OS_FILE_WRITE or ..._READ */
 	ulint*	space_id);
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 
 #ifndef UNIV_NONINL
 #include "os0file.ic"
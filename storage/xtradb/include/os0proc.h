@@ -41,6 +41,15 @@ extern ibool os_use_large_pages;
 /* Large page size. This may be a boot-time option on some platforms */
 extern ulint os_large_page_size;
 
+/** Number of NUMA nodes, or 0 if NUMA support is not available */
+extern ulint os_numa_n_nodes;
+#ifdef HAVE_LIBNUMA
+/** Number of entries in os_numa_cpu_node[] */
+extern ulint os_numa_n_cpus;
+/** NUMA node of each CPU */
+extern byte* os_numa_cpu_node;
+#endif /* HAVE_LIBNUMA */
+
 /****************************************************************//**
 Converts the current process id to a number. It is not guaranteed that the
 number is unique. In Linux returns the 'process number' of the current
@@ -70,6 +79,40 @@ os_mem_free_large(
 					os_mem_alloc_large() */
 	ulint	size);			/*!< in: size returned by
 					os_mem_alloc_large() */
+/****************************************************************//**
+Initializes NUMA support: determines the number of NUMA nodes and
+the node of each CPU.  Sets os_numa_n_nodes to 0 if NUMA is not
+available. */
+UNIV_INTERN
+void
+os_numa_init(void);
+/*==============*/
+/****************************************************************//**
+Sets the memory policy of a memory region so that its pages are
+allocated on the given NUMA node, and moves the pages that are
+already allocated. */
+UNIV_INTERN
+void
+os_mem_bind_to_numa_node(
+/*=====================*/
+	void*	ptr,			/*!< in: pointer returned by
+					os_mem_alloc_large() */
+	ulint	size,			/*!< in: size of the region */
+	ulint	node);			/*!< in: NUMA node */
+/****************************************************************//**
+Restricts the calling thread to the CPUs of a NUMA node. */
+UNIV_INTERN
+void
+os_thread_bind_to_numa_node(
+/*========================*/
+	ulint	node);			/*!< in: NUMA node */
+/****************************************************************//**
+Returns the NUMA node of the CPU that the calling thread runs on.
+@return	NUMA node, or 0 if NUMA support is not available */
+UNIV_INLINE
+ulint
+os_numa_get_curr_node(void);
+/*=======================*/
 
 #ifndef UNIV_NONINL
 #include "os0proc.ic"
@@ -220,6 +220,20 @@ page_cur_insert_rec_zip(
 	const rec_t*	rec,	/*!< in: pointer to a physical record */
 	ulint*		offsets,/*!< in/out: rec_get_offsets(rec, index) */
 	mtr_t*		mtr);	/*!< in: mini-transaction handle, or NULL */
+/**********************************************************//**
+Writes a log record of copying a record list end to a new created page.
+The records must then be inserted at the end of the page in the
+MTR_LOG_SHORT_INSERTS log mode, and the total length of their log
+written to the returned field.
+@return 4-byte field where to write the log data length, or NULL if
+logging is disabled */
+UNIV_INTERN
+byte*
+page_copy_rec_list_to_created_page_write_log(
+/*=========================================*/
+	page_t*		page,	/*!< in: index page */
+	dict_index_t*	index,	/*!< in: record descriptor */
+	mtr_t*		mtr);	/*!< in: mtr */
 /*************************************************************//**
 Copies records from page to a newly created page, from a given record onward,
 including that record. Infimum and supremum records are not copied. */
@@ -81,6 +81,14 @@ struct page_zip_des_struct
 					PAGE_ZIP_MIN_SIZE << (ssize - 1). */
 };
 
+/** Page compression algorithms.  The algorithm is recorded
+in the first byte of the compressed page stream. */
+enum page_zip_algo {
+	PAGE_ZIP_ALGORITHM_ZLIB = 0,	/*!< zlib deflate() */
+	PAGE_ZIP_ALGORITHM_LZ = 1	/*!< my_lz_compress(), a fast
+					LZ77 codec without entropy coding */
+};
+
 /** Compression statistics for a given page size */
 struct page_zip_stat_struct {
 	/** Number of page compressions */
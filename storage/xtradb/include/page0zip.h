@@ -38,6 +38,10 @@ Created June 2005 by Marko Makela
 #include "trx0types.h"
 #include "mem0mem.h"
 
+/** Default page compression algorithm (innodb_compression_algorithm),
+used for tables that do not specify PAGE_COMPRESSION_ALGORITHM */
+extern ulong	page_zip_algorithm;
+
 /**********************************************************************//**
 Determine the size of a compressed page in bytes.
 @return	size in bytes */
@@ -102,7 +106,33 @@ page_zip_set_alloc(
 	mem_heap_t*	heap);		/*!< in: memory heap to use */
 
 /**********************************************************************//**
-Compress a page.
+Determine the page compression algorithm of an index.
+@return	PAGE_COMPRESSION_ALGORITHM of the table, or page_zip_algorithm */
+UNIV_INTERN
+ulint
+page_zip_get_algorithm(
+/*===================*/
+	const dict_index_t*	index)	/*!< in: index of the B-tree node */
+	__attribute__((nonnull, pure));
+
+/**********************************************************************//**
+Compress a page with the given algorithm.
+@return TRUE on success, FALSE on failure; page_zip will be left
+intact on failure. */
+UNIV_INTERN
+ibool
+page_zip_compress_low(
+/*==================*/
+	page_zip_des_t*	page_zip,/*!< in: size; out: data, n_blobs,
+				m_start, m_end, m_nonempty */
+	const page_t*	page,	/*!< in: uncompressed page */
+	dict_index_t*	index,	/*!< in: index of the B-tree node */
+	ulint		algorithm,/*!< in: enum page_zip_algo */
+	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
+	__attribute__((nonnull(1,3)));
+
+/**********************************************************************//**
+Compress a page with the algorithm of the index.
 @return TRUE on success, FALSE on failure; page_zip will be left
 intact on failure. */
 UNIV_INTERN
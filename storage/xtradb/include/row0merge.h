@@ -194,4 +194,48 @@ row_merge_build_indexes(
 	struct TABLE*	table);		/*!< in/out: MySQL table, for
 					reporting erroneous key value
 					if applicable */
+/*********************************************************************//**
+Starts a bulk load of an empty table. All indexes of the table must be
+empty and uncompressed. The caller must hold an exclusive lock on the
+table until the load is finished.
+@return	own: bulk load, or NULL if the table cannot be bulk loaded */
+UNIV_INTERN
+row_merge_bulk_t*
+row_merge_bulk_create(
+/*==================*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_table_t*	table,		/*!< in: table to load */
+	struct TABLE*	mysql_table);	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+/*********************************************************************//**
+Adds a row to a bulk load. The undo log record of the row must have been
+written, and the system columns of the row must be set.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_add(
+/*===============*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	trx_t*			trx,	/*!< in/out: transaction */
+	const dtuple_t*		row);	/*!< in: row, indexed by col_no */
+/*********************************************************************//**
+Finishes a bulk load: sorts the entries of all indexes, which finds
+any duplicate keys before anything is loaded, and then builds the
+indexes bottom-up. On error, trx->error_info is the index that failed.
+The bulk load must still be freed with row_merge_bulk_free().
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_finish(
+/*==================*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	trx_t*			trx);	/*!< in/out: transaction */
+/*********************************************************************//**
+Frees a bulk load. The rows that were not loaded by
+row_merge_bulk_finish() are discarded. */
+UNIV_INTERN
+void
+row_merge_bulk_free(
+/*================*/
+	row_merge_bulk_t*	bulk);	/*!< in,own: bulk load */
 #endif /* row0merge.h */
@@ -238,6 +238,44 @@ row_insert_for_mysql(
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct in MySQL
 					handle */
 /*********************************************************************//**
+Starts a bulk load of an empty table for MySQL. The table is locked
+in exclusive mode, and the rows passed to row_bulk_insert_for_mysql()
+are sorted and loaded into the indexes by row_bulk_end_for_mysql().
+If the table cannot be bulk loaded, prebuilt->bulk stays NULL and the
+rows must be inserted with row_insert_for_mysql(). A table that is not
+empty is not locked.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_start_for_mysql(
+/*=====================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	struct TABLE*	mysql_table);	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+/*********************************************************************//**
+Adds a row to the bulk load started by row_bulk_start_for_mysql().
+Duplicate keys are only detected by row_bulk_end_for_mysql().
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_insert_for_mysql(
+/*======================*/
+	byte*		mysql_rec,	/*!< in: row in the MySQL format */
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct in
+					MySQL handle */
+/*********************************************************************//**
+Ends the bulk load started by row_bulk_start_for_mysql().
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_end_for_mysql(
+/*===================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	ibool		load);		/*!< in: TRUE=load the rows into
+					the indexes, FALSE=discard them */
+/*********************************************************************//**
 Builds a dummy query graph used in selects. */
 UNIV_INTERN
 void
@@ -675,6 +713,10 @@ struct row_prebuilt_struct {
 	ins_node_t*	ins_node;	/*!< Innobase SQL insert node
 					used to perform inserts
 					to the table */
+	row_merge_bulk_t* bulk;		/*!< bulk load of the empty
+					table, started by
+					row_bulk_start_for_mysql(),
+					or NULL */
 	byte*		ins_upd_rec_buff;/*!< buffer for storing data converted
 					to the Innobase format from the MySQL
 					format */
@@ -109,6 +109,13 @@ struct purge_node_struct{
 	mem_heap_t*	heap;	/*!< memory heap used as auxiliary storage for
 				row; this must be emptied after a successful
 				purge of a row */
+	/*----------------------*/
+	ibool		batch;	/*!< TRUE if the undo log records to purge
+				are attached to recs by the purge
+				coordinator instead of being fetched by
+				this node */
+	trx_purge_rec_t* recs;	/*!< if batch, the undo log records left
+				to purge */
 };
 
 #ifndef UNIV_NONINL
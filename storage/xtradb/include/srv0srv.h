@@ -131,6 +131,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/* If this flag is TRUE, Linux native aio submits and reaps the
+requests through io_uring instead of io_submit() and io_getevents() */
+extern my_bool	srv_use_io_uring;
 #endif /* !UNIV_HOTBACKUP */
 #ifdef __WIN__
 extern ibool	srv_use_native_conditions;
@@ -141,6 +144,7 @@ extern ulint*	srv_data_file_sizes;
 extern ulint*	srv_data_file_is_raw_partition;
 
 extern char*	srv_doublewrite_file;
+extern ulong	srv_doublewrite_shards;
 
 extern ibool	srv_recovery_stats;
 
@@ -184,6 +188,8 @@ extern ibool	srv_use_sys_malloc;
 #endif /* UNIV_HOTBACKUP */
 extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
 extern my_bool	srv_buf_pool_populate;	/*!< virtual page preallocation */
+extern my_bool	srv_buf_pool_numa;	/*!< place the buffer pool
+					instances on NUMA nodes */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
 extern ulint	srv_buf_pool_old_size;	/*!< previously requested size */
 extern ulint	srv_buf_pool_curr_size;	/*!< current size in bytes */
@@ -257,6 +263,18 @@ extern ibool	srv_use_posix_fallocate;
 extern ibool	srv_use_checksums;
 extern ibool	srv_fast_checksum;
 
+/** Alternatives for the page checksum algorithm,
+innodb_checksum_algorithm */
+enum srv_checksum_algorithm {
+	SRV_CHECKSUM_ALGORITHM_INNODB,	/*!< fold based InnoDB checksum */
+	SRV_CHECKSUM_ALGORITHM_CRC32	/*!< CRC-32C, using the SSE4.2
+					instruction when available */
+};
+
+/** Page checksum algorithm used for writing pages, one of
+enum srv_checksum_algorithm. Pages are verified against all of them. */
+extern ulong	srv_checksum_algorithm;
+
 extern ulong	srv_max_buf_pool_modified_pct;
 extern ulong	srv_max_purge_lag;
 
@@ -265,6 +283,7 @@ extern ulong	srv_replication_delay;
 extern long long	srv_ibuf_max_size;
 extern ulong	srv_ibuf_active_contract;
 extern ulong	srv_ibuf_accel_rate;
+extern ulong	srv_ibuf_sequential_merge;
 extern ulint	srv_checkpoint_age_target;
 extern ulong	srv_flush_neighbor_pages;
 extern ulint	srv_deprecated_enable_unsafe_group_commit;
@@ -374,12 +393,25 @@ extern ulint srv_os_log_pending_writes;
 log buffer and have to flush it */
 extern ulint srv_log_waits;
 
-/* the number of purge threads to use from the worker pool (currently 0 or 1) */
+/* the number of purge threads to use: the purge thread and
+srv_n_purge_threads - 1 purge worker threads, or 0 to purge in
+the master thread */
 extern ulong srv_n_purge_threads;
 
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/* the number of threads sorting the indexes in fast index creation */
+extern ulong srv_merge_sort_threads;
+
+/* percentage of each B-tree page filled by a bulk load; 100 leaves
+1/16 of the page free */
+extern ulong srv_fill_factor;
+
+/* if nonzero, one of this many page latch acquisitions is sampled by
+the latch profiler, and all rw-lock OS waits are recorded */
+extern ulong srv_latch_profile;
+
 /* the number of rollback segments to use */
 extern ulong srv_rollback_segments;
 
@@ -784,6 +816,15 @@ srv_purge_thread(
 /*=============*/
 	void*	arg __attribute__((unused))); /*!< in: a dummy parameter
 					      required by os_thread_create */
+/*********************************************************************//**
+Purge worker thread, purging the undo log records attached to it by the
+purge thread.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+srv_purge_worker_thread(
+/*====================*/
+	void*	arg);	/*!< in: worker number, 0..srv_n_purge_threads - 2 */
 
 /**********************************************************************//**
 Enqueues a task to server task queue and releases a worker thread, if there
@@ -834,6 +875,9 @@ struct export_var_struct{
 	ulint innodb_buffer_pool_pages_made_young;
 	ulint innodb_buffer_pool_pages_old;
 	ulint innodb_buffer_pool_read_requests;	/*!< buf_pool->stat.n_page_gets */
+	ulint innodb_buffer_pool_read_requests_numa_local;
+						/*!< buf_pool->stat.
+						n_page_gets_numa_local */
 	ulint innodb_buffer_pool_reads;		/*!< srv_buf_pool_reads */
 	ulint innodb_buffer_pool_wait_free;	/*!< srv_buf_pool_wait_free */
 	ulint innodb_buffer_pool_pages_flushed;	/*!< srv_buf_pool_flushed */
@@ -889,6 +933,9 @@ struct export_var_struct{
 	ulint innodb_pages_written;		/*!< buf_pool->stat.n_pages_written */
 	ib_int64_t innodb_purge_trx_id;
 	ib_int64_t innodb_purge_undo_no;
+	ib_int64_t innodb_purge_lag;		/*!< trx_sys->max_trx_id
+						- purge_sys->purge_trx_no */
+	ulint innodb_purge_dml_delay;		/*!< srv_dml_needed_delay */
 	ulint innodb_row_lock_waits;		/*!< srv_n_lock_wait_count */
 	ulint innodb_row_lock_current_waits;	/*!< srv_n_lock_wait_current_count */
 	ib_int64_t innodb_row_lock_time;	/*!< srv_n_lock_wait_time
@@ -937,6 +984,7 @@ extern ulint	srv_n_threads_active[];
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_checksums			TRUE
 # define srv_use_native_aio			FALSE
+# define srv_use_io_uring			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
 # define srv_is_being_started			0
@@ -0,0 +1,156 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Monty Program Ab. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place, Suite 330, Boston, MA 02111-1307 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/sync0prof.h
+Sampling profiler of hot pages and rw-lock waits
+
+When innodb_latch_profile is N > 0, one of N page latch acquisitions in
+buf_page_get_gen() is timed and counted per page, and every OS wait for
+an rw-lock is timed and counted per lock name and requesting code line.
+Both are kept in small fixed-size tables in which a new key replaces the
+coldest entry of its hash neighbourhood, so that the hot entries stay.
+
+Created 2013-06-20
+*******************************************************/
+
+#ifndef sync0prof_h
+#define sync0prof_h
+
+#include "univ.i"
+#include "dict0types.h"
+#include "sync0rw.h"
+
+/** Number of pages tracked by the profiler */
+#define SYNC_PROF_N_PAGES	1024
+/** Number of rw-lock wait sites tracked by the profiler */
+#define SYNC_PROF_N_RW		256
+
+/** Sampled latch acquisitions of a page */
+typedef struct sync_prof_page_struct	sync_prof_page_t;
+/** OS waits for rw-locks of one name at one code line */
+typedef struct sync_prof_rw_struct	sync_prof_rw_t;
+
+/** Sampled latch acquisitions of a page */
+struct sync_prof_page_struct {
+	ulint		space;		/*!< tablespace id */
+	ulint		page_no;	/*!< page number */
+	ulint		page_type;	/*!< FIL_PAGE_TYPE of the page */
+	index_id_t	index_id;	/*!< PAGE_INDEX_ID of an index page,
+					or 0 */
+	ulint		level;		/*!< B-tree level of an index page */
+	ulint		n_accesses;	/*!< number of sampled latch
+					acquisitions, 0 if the entry
+					is unused */
+	ullint		wait_us;	/*!< microseconds spent acquiring
+					the latch in the sampled
+					acquisitions */
+};
+
+/** OS waits for rw-locks of one name at one code line */
+struct sync_prof_rw_struct {
+	const char*	lock_name;	/*!< rw_lock_t::lock_name, which
+					names the creation site, or NULL
+					if the entry is unused */
+	const char*	file_name;	/*!< file where the lock was
+					requested */
+	ulint		line;		/*!< line where the lock was
+					requested */
+	ulint		n_s_waits;	/*!< number of OS waits for
+					a shared lock */
+	ulint		n_x_waits;	/*!< number of OS waits for
+					an exclusive lock */
+	ullint		wait_us;	/*!< microseconds spent in the
+					OS waits */
+};
+
+/******************************************************************//**
+Initializes the profiler. */
+UNIV_INTERN
+void
+sync_prof_init(void);
+/*================*/
+/******************************************************************//**
+Frees the profiler. */
+UNIV_INTERN
+void
+sync_prof_free(void);
+/*================*/
+/******************************************************************//**
+Discards everything that the profiler has recorded. */
+UNIV_INTERN
+void
+sync_prof_reset(void);
+/*=================*/
+/******************************************************************//**
+Decides if the latch acquisition of the calling thread is sampled. Must
+only be called when srv_latch_profile is nonzero.
+@return	TRUE if the latch acquisition should be recorded */
+UNIV_INTERN
+ibool
+sync_prof_sample(void);
+/*==================*/
+/******************************************************************//**
+Records a sampled page latch acquisition. */
+UNIV_INTERN
+void
+sync_prof_page_access(
+/*==================*/
+	ulint		space,		/*!< in: tablespace id */
+	ulint		page_no,	/*!< in: page number */
+	ulint		page_type,	/*!< in: FIL_PAGE_TYPE */
+	index_id_t	index_id,	/*!< in: index id, or 0 */
+	ulint		level,		/*!< in: B-tree level, or 0 */
+	ullint		wait_us);	/*!< in: microseconds spent
+					acquiring the latch */
+/******************************************************************//**
+Records an OS wait for an rw-lock. */
+UNIV_INTERN
+void
+sync_prof_rw_wait(
+/*==============*/
+	const rw_lock_t*	lock,		/*!< in: rw-lock */
+	ulint			lock_type,	/*!< in: RW_LOCK_SHARED,
+						RW_LOCK_EX or
+						RW_LOCK_WAIT_EX */
+	const char*		file_name,	/*!< in: file where the
+						lock was requested */
+	ulint			line,		/*!< in: line where the
+						lock was requested */
+	ullint			wait_us);	/*!< in: microseconds
+						spent waiting */
+/******************************************************************//**
+Copies the pages tracked by the profiler.
+@return	number of pages copied */
+UNIV_INTERN
+ulint
+sync_prof_get_pages(
+/*================*/
+	sync_prof_page_t*	pages);	/*!< out: SYNC_PROF_N_PAGES
+					entries */
+/******************************************************************//**
+Copies the rw-lock wait sites tracked by the profiler.
+@return	number of wait sites copied */
+UNIV_INTERN
+ulint
+sync_prof_get_rw_waits(
+/*===================*/
+	sync_prof_rw_t*		waits);	/*!< out: SYNC_PROF_N_RW
+					entries */
+
+#endif
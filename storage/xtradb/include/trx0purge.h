@@ -117,6 +117,22 @@ trx_purge(
 /*======*/
 	ulint	limit);		/*!< in: the maximum number of records to
 				purge in one batch */
+/*******************************************************************//**
+Waits for the purge coordinator to attach undo log records to a purge
+worker and purges them.
+@return	FALSE if the worker thread should exit */
+UNIV_INTERN
+ibool
+trx_purge_worker_run(
+/*=================*/
+	ulint	id);		/*!< in: worker number,
+				0..purge_sys->n_workers - 1 */
+/*******************************************************************//**
+Wakes up the purge worker threads so that they exit at shutdown. */
+UNIV_INTERN
+void
+trx_purge_wake_workers(void);
+/*========================*/
 /******************************************************************//**
 Prints information of the purge system to stderr. */
 UNIV_INTERN
@@ -124,6 +140,35 @@ void
 trx_purge_sys_print(void);
 /*======================*/
 
+/** An undo log record attached to a purge query thread by
+trx_purge_attach_undo_recs() */
+struct trx_purge_rec_struct{
+	trx_undo_rec_t*	undo_rec;	/*!< copy of the undo log record,
+					or &trx_purge_dummy_rec */
+	roll_ptr_t	roll_ptr;	/*!< roll pointer to the record */
+	trx_undo_inf_t*	reservation;	/*!< reservation for the record in
+					the purge array, NULL if the batch
+					is held by an earlier record */
+	trx_purge_rec_t* next;		/*!< next record to purge by the
+					same query thread, or NULL */
+};
+
+/** The context of a purge worker thread. Each worker has its own session
+and transaction, because row purge freezes the data dictionary on
+behalf of the transaction of the query thread. */
+struct trx_purge_worker_struct{
+	sess_t*		sess;		/*!< session of the worker */
+	que_t*		query;		/*!< purge query graph run by the
+					worker */
+	os_event_t	event;		/*!< set when undo log records are
+					attached to the worker, or at
+					shutdown */
+	ibool		pending;	/*!< TRUE if the worker has been
+					handed a batch it has not purged
+					yet; protected by
+					purge_sys->workers_mutex */
+};
+
 /** The control structure used in the purge operation */
 struct trx_purge_struct{
 	ulint		state;		/*!< Purge system state */
@@ -190,6 +235,16 @@ struct trx_purge_struct{
 					rseg_queue_t::trx_no. It is protected
 					by the bh_mutex */
 	mutex_t		bh_mutex;	/*!< Mutex protecting ib_bh */
+	/*-----------------------------*/
+	ulint		n_workers;	/*!< number of purge worker threads
+					helping the purge coordinator,
+					srv_n_purge_threads - 1 or 0 */
+	trx_purge_worker_t* workers;	/*!< array of n_workers contexts */
+	os_fast_mutex_t	workers_mutex;	/*!< mutex protecting n_running and
+					the pending flags of workers */
+	ulint		n_running;	/*!< number of workers that have
+					not finished the current batch */
+	os_event_t	workers_done;	/*!< set when n_running drops to 0 */
 };
 
 #define TRX_PURGE_ON		1	/* purge operation is running */
@@ -108,6 +108,15 @@ void
 trx_sys_mark_upgraded_to_multiple_tablespaces(void);
 /*===============================================*/
 /****************************************************************//**
+Returns the doublewrite shard which pages of a buffer pool instance
+are posted to.
+@return	doublewrite shard */
+UNIV_INLINE
+trx_doublewrite_shard_t*
+trx_doublewrite_get_shard(
+/*======================*/
+	ulint	buf_pool_index);	/*!< in: buffer pool instance number */
+/****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
 doublewrite buffer */
@@ -647,15 +656,31 @@ identifier is added to this 64-bit constant. */
 #define TRX_DESCR_ARRAY_INITIAL_SIZE 	1000
 
 #ifndef UNIV_HOTBACKUP
-/** Doublewrite control struct */
-struct trx_doublewrite_struct{
+/** Doublewrite shard: a disjoint range of slots of the doublewrite
+buffer which is filled, written and flushed independently of the other
+shards. A page is always posted to the shard of its buffer pool
+instance. */
+struct trx_doublewrite_shard_struct{
 	mutex_t	mutex;		/*!< mutex protecting the first_free field and
+				the slots of write_buf owned by this shard */
+	ulint	first_slot;	/*!< first slot of the doublewrite buffer
+				owned by this shard, measured in units of
+				UNIV_PAGE_SIZE */
+	ulint	n_slots;	/*!< number of slots owned by this shard */
+	ulint	first_free;	/*!< first free position in write_buf measured
+				in units of UNIV_PAGE_SIZE */
+	byte*	write_buf;	/*!< slot first_slot of trx_doublewrite's
 				write_buf */
+	buf_page_t**
+		buf_block_arr;	/*!< array to store pointers to the buffer
+				blocks which have been cached to write_buf */
+};
+
+/** Doublewrite control struct */
+struct trx_doublewrite_struct{
 	ulint	block1;		/*!< the page number of the first
 				doublewrite block (64 pages) */
 	ulint	block2;		/*!< page number of the second block */
-	ulint	first_free;	/*!< first free position in write_buf measured
-				in units of UNIV_PAGE_SIZE */
 	byte*	write_buf;	/*!< write buffer used in writing to the
 				doublewrite buffer, aligned to an
 				address divisible by UNIV_PAGE_SIZE
@@ -665,6 +690,11 @@ struct trx_doublewrite_struct{
 	buf_page_t**
 		buf_block_arr;	/*!< array to store pointers to the buffer
 				blocks which have been cached to write_buf */
+	ulint	n_shards;	/*!< number of shards the
+				2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE slots
+				are split into */
+	trx_doublewrite_shard_t*
+		shards;		/*!< array of n_shards shards */
 };
 
 /** The transaction system central memory data structure; protected by the
@@ -0,0 +1,84 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Monty Program Ab. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place, Suite 330, Boston, MA 02111-1307 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/ut0counter.h
+Statistics counters split into cache line sized slots, so that threads
+incrementing a hot counter do not keep stealing the cache line from each
+other. A thread always increments the slot selected by its thread id; the
+value of the counter is the sum of all slots.
+
+Like the plain ulint counters they replace, the slots are not protected by
+any latch, and two threads mapped to the same slot may lose an increment.
+
+Created 2013-05-06
+*******************************************************/
+
+#ifndef ut0counter_h
+#define ut0counter_h
+
+#include "univ.i"
+#include "os0thread.h"
+
+/** Number of slots of a counter; must be a power of 2 */
+#define UT_COUNTER_N_SLOTS	64
+
+/** Size of a slot: a cache line */
+#define UT_COUNTER_SLOT_SIZE	64
+
+/** A slot of a counter */
+typedef union ut_counter_slot_union	ut_counter_slot_t;
+/** A counter */
+typedef struct ut_counter_struct	ut_counter_t;
+
+/** A slot of a counter, padded to its own cache line */
+union ut_counter_slot_union {
+	ulint	value;				/*!< part of the counter */
+	byte	pad[UT_COUNTER_SLOT_SIZE];	/*!< padding */
+};
+
+/** A counter split into slots */
+struct ut_counter_struct {
+	ut_counter_slot_t	slots[UT_COUNTER_N_SLOTS];
+};
+
+/*******************************************************************//**
+Adds to a counter. */
+UNIV_INLINE
+void
+ut_counter_add(
+/*===========*/
+	ut_counter_t*	counter,	/*!< in/out: counter */
+	ulint		n);		/*!< in: value to add */
+/*******************************************************************//**
+Increments a counter by one. */
+#define ut_counter_inc(counter)	ut_counter_add(counter, 1)
+/*******************************************************************//**
+Sums up the slots of a counter.
+@return	value of the counter */
+UNIV_INLINE
+ulint
+ut_counter_get(
+/*===========*/
+	const ut_counter_t*	counter);	/*!< in: counter */
+
+#ifndef UNIV_NONINL
+#include "ut0counter.ic"
+#endif
+
+#endif
@@ -4127,6 +4127,59 @@ lock_table_dequeue(
 	}
 }
 
+/*********************************************************************//**
+Checks if a transaction holds an exclusive lock on a table.
+@return	TRUE if trx holds LOCK_X on the table */
+UNIV_INTERN
+ibool
+lock_table_has_x(
+/*=============*/
+	trx_t*		trx,	/*!< in: transaction */
+	dict_table_t*	table)	/*!< in: table */
+{
+	ibool	has;
+
+	lock_mutex_enter_kernel();
+	has = lock_table_has(trx, table, LOCK_X) != NULL;
+	lock_mutex_exit_kernel();
+
+	return(has);
+}
+
+/*********************************************************************//**
+Releases a granted exclusive table lock of a transaction, and grants
+the locks of other transactions waiting in the queue if they now are
+entitled to a lock. The transaction must not have modified the table
+after acquiring the lock. */
+UNIV_INTERN
+void
+lock_table_x_unlock(
+/*================*/
+	trx_t*		trx,	/*!< in: transaction */
+	dict_table_t*	table)	/*!< in: table locked with LOCK_X */
+{
+	lock_t*	lock;
+
+	lock_mutex_enter_kernel();
+
+	for (lock = UT_LIST_GET_LAST(trx->trx_locks); lock;
+	     lock = UT_LIST_GET_PREV(trx_locks, lock)) {
+
+		if (lock_get_type_low(lock) == LOCK_TABLE
+		    && lock->un_member.tab_lock.table == table
+		    && lock_get_mode(lock) == LOCK_X) {
+
+			ut_a(!lock_get_wait(lock));
+			lock_table_dequeue(lock);
+			break;
+		}
+	}
+
+	ut_ad(lock);
+
+	lock_mutex_exit_kernel();
+}
+
 /*=========================== LOCK RELEASE ==============================*/
 
 /*************************************************************//**
@@ -355,14 +355,16 @@ loop:
 }
 
 /************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
+Appends a string to the log buffer, or only reserves the space for it,
+splitting it into log blocks. It is assumed that the caller holds the
 log mutex. */
-UNIV_INTERN
+static
 void
-log_write_low(
-/*==========*/
-	byte*	str,		/*!< in: string */
-	ulint	str_len)	/*!< in: string length */
+log_write_or_reserve_low(
+/*=====================*/
+	const byte*	str,		/*!< in: string, or NULL to only
+					reserve the space */
+	ulint		str_len)	/*!< in: string length */
 {
 	log_t*	log	= log_sys;
 	ulint	len;
@@ -389,10 +391,12 @@ part_loop:
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
+	if (str) {
+		ut_memcpy(log->buf + log->buf_free, str, len);
+		str = str + len;
+	}
 
 	str_len -= len;
-	str = str + len;
 
 	log_block = ut_align_down(log->buf + log->buf_free,
 				  OS_FILE_LOG_BLOCK_SIZE);
@@ -424,6 +428,108 @@ part_loop:
 	srv_log_write_requests++;
 }
 
+/************************************************************//**
+Writes to the log the string given. It is assumed that the caller holds the
+log mutex. */
+UNIV_INTERN
+void
+log_write_low(
+/*==========*/
+	byte*	str,		/*!< in: string */
+	ulint	str_len)	/*!< in: string length */
+{
+	log_write_or_reserve_low(str, str_len);
+}
+
+#ifdef LOG_COPY_WITHOUT_MUTEX
+/************************************************************//**
+Reserves space at the end of the log buffer for a string, like
+log_write_low() does but without copying the string. The string must
+then be copied with log_write_reserved() and the copy ended with
+log_write_reserved_complete(), which do not need the log mutex. It is
+assumed that the caller holds the log mutex.
+@return	offset of the reserved space in the log buffer */
+UNIV_INTERN
+ulint
+log_reserve_low(
+/*============*/
+	ulint	str_len)	/*!< in: string length */
+{
+	ulint	offset	= log_sys->buf_free;
+
+	/* The block headers in the reserved space are written here,
+	under the log mutex. The copies only write the record bytes
+	between them, so that concurrent copies never overlap. */
+
+	(void) os_atomic_increment_lint(&log_sys->n_pending_copies, 1);
+
+	log_write_or_reserve_low(NULL, str_len);
+
+	return(offset);
+}
+
+/************************************************************//**
+Copies a string to space reserved with log_reserve_low(). The log mutex
+need not be held. */
+UNIV_INTERN
+void
+log_write_reserved(
+/*===============*/
+	ulint*		offset,		/*!< in/out: offset in the log
+					buffer where to copy the string */
+	const byte*	str,		/*!< in: string */
+	ulint		str_len)	/*!< in: string length */
+{
+	while (str_len > 0) {
+		ulint	block_offset = *offset % OS_FILE_LOG_BLOCK_SIZE;
+		ulint	len;
+
+		if (block_offset
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the
+			header of the next block */
+
+			*offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+			block_offset = LOG_BLOCK_HDR_SIZE;
+		}
+
+		len = ut_min(str_len, OS_FILE_LOG_BLOCK_SIZE
+			     - LOG_BLOCK_TRL_SIZE - block_offset);
+
+		ut_memcpy(log_sys->buf + *offset, str, len);
+
+		*offset += len;
+		str += len;
+		str_len -= len;
+	}
+}
+
+/************************************************************//**
+Waits until the mini-transactions that reserved space in the log buffer
+have copied their log records there. It is assumed that the caller holds
+the log mutex, so that no more space can be reserved meanwhile. */
+static
+void
+log_wait_for_copies(void)
+/*=====================*/
+{
+	ulint	i = 0;
+
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	/* The copies are short memcpy() calls: spin before yielding. */
+
+	while (os_atomic_increment_lint(&log_sys->n_pending_copies, 0)) {
+		if (i < SYNC_SPIN_ROUNDS) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+			i++;
+		} else {
+			os_thread_yield();
+		}
+	}
+}
+#endif /* LOG_COPY_WITHOUT_MUTEX */
+
 /************************************************************//**
 */
 UNIV_INLINE
@@ -925,6 +1031,9 @@ log_init(void)
 	log_sys->written_to_all_lsn = log_sys->lsn;
 
 	log_sys->n_pending_writes = 0;
+#ifdef LOG_COPY_WITHOUT_MUTEX
+	log_sys->n_pending_copies = 0;
+#endif /* LOG_COPY_WITHOUT_MUTEX */
 
 	log_sys->no_flush_event = os_event_create(NULL);
 
@@ -1171,6 +1280,10 @@ log_sys_check_flush_completion(void)
 			/* Move the log buffer content to the start of the
 			buffer */
 
+#ifdef LOG_COPY_WITHOUT_MUTEX
+			log_wait_for_copies();
+#endif /* LOG_COPY_WITHOUT_MUTEX */
+
 			move_start = ut_calc_align_down(
 				log_sys->write_end_offset,
 				OS_FILE_LOG_BLOCK_SIZE);
@@ -1561,6 +1674,11 @@ loop:
 			log_sys->lsn);
 	}
 #endif /* UNIV_DEBUG */
+#ifdef LOG_COPY_WITHOUT_MUTEX
+	/* Write only complete log records */
+	log_wait_for_copies();
+#endif /* LOG_COPY_WITHOUT_MUTEX */
+
 	log_sys->n_pending_writes++;
 
 	group = UT_LIST_GET_FIRST(log_sys->log_groups);
@@ -206,6 +206,9 @@ mtr_log_reserve_and_write(
 	dyn_block_t*	block;
 	ulint		data_size;
 	byte*		first_data;
+#ifdef LOG_COPY_WITHOUT_MUTEX
+	ulint		offset		= ULINT_UNDEFINED;
+#endif /* LOG_COPY_WITHOUT_MUTEX */
 
 	ut_ad(mtr);
 
@@ -240,7 +243,11 @@ mtr_log_reserve_and_write(
 	mtr->start_lsn = log_open(data_size);
 
 	if (mtr->log_mode == MTR_LOG_ALL) {
-
+#ifdef LOG_COPY_WITHOUT_MUTEX
+		/* Only reserve the space here, and copy the log
+		records after releasing the log mutex below. */
+		offset = log_reserve_low(data_size);
+#else /* LOG_COPY_WITHOUT_MUTEX */
 		block = mlog;
 
 		while (block != NULL) {
@@ -248,6 +255,7 @@ mtr_log_reserve_and_write(
 				      dyn_block_get_used(block));
 			block = dyn_array_get_next_block(mlog, block);
 		}
+#endif /* LOG_COPY_WITHOUT_MUTEX */
 	} else {
 		ut_ad(mtr->log_mode == MTR_LOG_NONE);
 		/* Do nothing */
@@ -278,6 +286,23 @@ func_exit:
 	if (mtr->made_dirty) {
 		log_flush_order_mutex_exit();
 	}
+
+#ifdef LOG_COPY_WITHOUT_MUTEX
+	if (offset != ULINT_UNDEFINED) {
+		/* The page latches are still held, but the other
+		mini-transactions can reserve log space and copy
+		their records in parallel with this one. */
+
+		for (block = mlog; block != NULL;
+		     block = dyn_array_get_next_block(mlog, block)) {
+			log_write_reserved(&offset,
+					   dyn_block_get_data(block),
+					   dyn_block_get_used(block));
+		}
+
+		log_write_reserved_complete();
+	}
+#endif /* LOG_COPY_WITHOUT_MUTEX */
 }
 #endif /* !UNIV_HOTBACKUP */
 
@@ -62,6 +62,12 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif
 
+#if defined(LINUX_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef _WIN32
 #define IOCP_SHUTDOWN_KEY (ULONG_PTR)-1
 #endif
@@ -206,11 +212,47 @@ struct os_aio_slot_struct{
 					completed */
 #ifdef LINUX_NATIVE_AIO
 	struct iocb	control;	/* Linux control block for aio */
+#endif
+#ifdef UNIV_LINUX_AIO
 	int		n_bytes;	/* bytes written/read. */
 	int		ret;		/* AIO return code */
 #endif
 };
 
+#ifdef LINUX_IO_URING
+/** The io_uring of an aio segment */
+typedef struct os_aio_uring_struct	os_aio_uring_t;
+
+/** The io_uring of an aio segment. The requests are queued in the
+submission ring by the threads that post them, and reaped from the
+completion ring by the i/o handler thread of the segment. */
+struct os_aio_uring_struct{
+	int		fd;		/*!< io_uring file descriptor */
+	os_fast_mutex_t	sq_mutex;	/*!< mutex serializing the threads
+					which fill the submission ring */
+	void*		ring;		/*!< the mmap()ed submission and
+					completion rings */
+	size_t		ring_size;	/*!< size of ring in bytes */
+	unsigned*	sq_head;	/*!< submission ring head,
+					advanced by the kernel */
+	unsigned*	sq_tail;	/*!< submission ring tail, protected
+					by sq_mutex */
+	unsigned	sq_mask;	/*!< submission ring index mask */
+	unsigned	sq_entries;	/*!< submission ring size */
+	unsigned*	sq_array;	/*!< submission ring: indexes of
+					sqes */
+	struct io_uring_sqe* sqes;	/*!< the mmap()ed submission queue
+					entries */
+	size_t		sqes_size;	/*!< size of sqes in bytes */
+	unsigned*	cq_head;	/*!< completion ring head, advanced
+					by the i/o handler thread */
+	unsigned*	cq_tail;	/*!< completion ring tail, advanced
+					by the kernel */
+	unsigned	cq_mask;	/*!< completion ring index mask */
+	struct io_uring_cqe* cqes;	/*!< completion queue entries */
+};
+#endif /* LINUX_IO_URING */
+
 /** The asynchronous i/o array structure */
 typedef struct os_aio_array_struct	os_aio_array_t;
 
@@ -253,10 +295,28 @@ struct os_aio_array_struct{
 				possible pending IO. The size of the
 				array is equal to n_slots. */
 #endif
+#if defined(LINUX_IO_URING)
+	os_aio_uring_t*		uring;
+				/* io_uring per segment, or NULL if
+				the requests are submitted with
+				io_submit() */
+#endif
+#if defined(UNIV_LINUX_AIO)
+	os_aio_slot_t**		completed;
+				/* Completed requests reaped from the
+				kernel and not yet handled. Each
+				segment uses n_slots / n_segments
+				entries starting at the first slot of
+				the segment, and only the i/o handler
+				thread of the segment accesses them. */
+	ulint*			n_completed;
+				/* Number of requests in completed,
+				one counter per segment */
+#endif
 };
 
-#if defined(LINUX_NATIVE_AIO)
-/** timeout for each io_getevents() call = 500ms. */
+#if defined(UNIV_LINUX_AIO)
+/** timeout for each io_getevents() or io_uring_enter() wait = 500ms. */
 #define OS_AIO_REAP_TIMEOUT	(500000000UL)
 
 /** time to sleep, in microseconds if io_setup() returns EAGAIN. */
@@ -3513,6 +3573,334 @@ os_aio_native_aio_supported(void)
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+/******************************************************************//**
+Creates an io_uring for an aio segment.
+@return	TRUE on success. */
+static
+ibool
+os_aio_uring_create(
+/*================*/
+	ulint		max_events,	/*!< in: number of pending requests */
+	os_aio_uring_t*	uring)		/*!< out: io_uring to initialize */
+{
+	struct io_uring_params	params;
+	byte*			ring;
+	int			fd;
+
+	memset(uring, 0x0, sizeof(*uring));
+	memset(&params, 0x0, sizeof(params));
+
+	fd = (int) syscall(__NR_io_uring_setup, (unsigned) max_events,
+			   &params);
+
+	if (fd < 0) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: Warning: io_uring_setup() failed"
+			" with error[%d]\n", errno);
+		return(FALSE);
+	}
+
+	/* We map both rings with one mmap() call and wait for the
+	completions with a timeout: these need Linux 5.4 and 5.11. */
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)
+	    || !(params.features & IORING_FEAT_EXT_ARG)) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: Warning: io_uring is supported"
+			" on Linux 5.11 or later only\n");
+		close(fd);
+		return(FALSE);
+	}
+
+	uring->fd = fd;
+	uring->ring_size = ut_max(
+		params.sq_off.array + params.sq_entries * sizeof(unsigned),
+		params.cq_off.cqes
+		+ params.cq_entries * sizeof(struct io_uring_cqe));
+	uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	ring = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	uring->sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+			   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+	if (ring == MAP_FAILED || uring->sqes == MAP_FAILED) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: Warning: mmap() of io_uring failed"
+			" with error[%d]\n", errno);
+
+		if (ring != MAP_FAILED) {
+			munmap(ring, uring->ring_size);
+		}
+
+		if (uring->sqes != MAP_FAILED) {
+			munmap(uring->sqes, uring->sqes_size);
+		}
+
+		close(fd);
+		return(FALSE);
+	}
+
+	uring->ring = ring;
+	uring->sq_head = (unsigned*) (ring + params.sq_off.head);
+	uring->sq_tail = (unsigned*) (ring + params.sq_off.tail);
+	uring->sq_mask = *(unsigned*) (ring + params.sq_off.ring_mask);
+	uring->sq_entries = params.sq_entries;
+	uring->sq_array = (unsigned*) (ring + params.sq_off.array);
+	uring->cq_head = (unsigned*) (ring + params.cq_off.head);
+	uring->cq_tail = (unsigned*) (ring + params.cq_off.tail);
+	uring->cq_mask = *(unsigned*) (ring + params.cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe*) (ring + params.cq_off.cqes);
+
+	os_fast_mutex_init(&uring->sq_mutex);
+
+	return(TRUE);
+}
+
+/******************************************************************//**
+Frees an io_uring created with os_aio_uring_create(). */
+static
+void
+os_aio_uring_free(
+/*==============*/
+	os_aio_uring_t*	uring)	/*!< in, own: io_uring */
+{
+	os_fast_mutex_free(&uring->sq_mutex);
+	munmap(uring->sqes, uring->sqes_size);
+	munmap(uring->ring, uring->ring_size);
+	close(uring->fd);
+}
+
+/******************************************************************//**
+Fills the next submission queue entry of an io_uring and makes it
+visible to the kernel. The caller must hold sq_mutex, unless it is the
+only user of the io_uring. */
+static
+void
+os_aio_uring_prep(
+/*==============*/
+	os_aio_uring_t*	uring,	/*!< in/out: io_uring */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	os_file_t	file,	/*!< in: file handle */
+	void*		buf,	/*!< in: buffer to read to or write from */
+	ulint		len,	/*!< in: length of the block */
+	ib_uint64_t	offset,	/*!< in: file offset */
+	void*		data)	/*!< in: returned with the completion */
+{
+	unsigned		tail	= *uring->sq_tail;
+	unsigned		index	= tail & uring->sq_mask;
+	struct io_uring_sqe*	sqe	= &uring->sqes[index];
+
+	/* The ring is at least as big as the segment, and each
+	reserved slot of the segment queues one request. */
+	ut_a(tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE)
+	     < uring->sq_entries);
+
+	memset(sqe, 0x0, sizeof(*sqe));
+	sqe->opcode = (type == OS_FILE_READ)
+		? IORING_OP_READ : IORING_OP_WRITE;
+	sqe->fd = file;
+	sqe->off = offset;
+	sqe->addr = (ulint) buf;
+	sqe->len = (unsigned) len;
+	sqe->user_data = (ulint) data;
+
+	uring->sq_array[index] = index;
+
+	__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/******************************************************************//**
+Submits the requests queued in an io_uring, and optionally waits for
+completed requests.
+@return	number of submitted requests, or -errno */
+static
+int
+os_aio_uring_enter(
+/*===============*/
+	os_aio_uring_t*	uring,	/*!< in: io_uring */
+	ibool		wait)	/*!< in: TRUE=wait up to OS_AIO_REAP_TIMEOUT
+				for a completed request */
+{
+	struct io_uring_getevents_arg	arg;
+	struct __kernel_timespec	timeout;
+	unsigned			to_submit;
+	long				ret;
+
+	to_submit = __atomic_load_n(uring->sq_tail, __ATOMIC_ACQUIRE)
+		- __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+
+	if (!wait) {
+		if (to_submit == 0) {
+			return(0);
+		}
+
+		ret = syscall(__NR_io_uring_enter, uring->fd, to_submit,
+			      0, 0, NULL, 0);
+	} else {
+		memset(&arg, 0x0, sizeof(arg));
+		timeout.tv_sec = 0;
+		timeout.tv_nsec = OS_AIO_REAP_TIMEOUT;
+		arg.ts = (ulint) &timeout;
+
+		ret = syscall(__NR_io_uring_enter, uring->fd, to_submit, 1,
+			      IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+			      &arg, sizeof(arg));
+	}
+
+	return(ret < 0 ? -errno : (int) ret);
+}
+
+/******************************************************************//**
+Submits the requests queued in an io_uring. */
+static
+void
+os_aio_uring_submit(
+/*================*/
+	os_aio_uring_t*	uring)	/*!< in: io_uring */
+{
+	int	ret;
+
+	do {
+		ret = os_aio_uring_enter(uring, FALSE);
+	} while (ret == -EINTR);
+
+	switch (ret) {
+	case -EAGAIN:
+	case -EBUSY:
+		/* The requests stay in the submission ring. The i/o
+		handler thread submits them when it waits for the
+		completed requests. */
+		return;
+	}
+
+	if (UNIV_UNLIKELY(ret < 0)) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: unexpected ret_code[%d]"
+			" from io_uring_enter()!\n", ret);
+		ut_error;
+	}
+}
+
+/******************************************************************//**
+Checks if the kernel supports io_uring, and if it works on tmpdir.
+@return: TRUE if supported, FALSE otherwise. */
+static
+ibool
+os_aio_uring_supported(void)
+/*========================*/
+{
+	os_aio_uring_t	uring;
+	byte*		buf;
+	int		fd;
+	int		err;
+
+	if (!os_aio_uring_create(1, &uring)) {
+
+		return(FALSE);
+	}
+
+	fd = innobase_mysql_tmpfile();
+
+	if (fd < 0) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, " InnoDB: Error: unable to create "
+			"temp file to check io_uring support.\n");
+		os_aio_uring_free(&uring);
+
+		return(FALSE);
+	}
+
+	buf = (byte*) ut_malloc(UNIV_PAGE_SIZE * 2);
+
+	/* Suppress valgrind warning. */
+	memset(buf, 0x00, UNIV_PAGE_SIZE * 2);
+
+	os_aio_uring_prep(&uring, OS_FILE_WRITE, fd,
+			  ut_align(buf, UNIV_PAGE_SIZE), UNIV_PAGE_SIZE,
+			  0, NULL);
+
+	/* Wait until the write completes. */
+	do {
+		err = os_aio_uring_enter(&uring, TRUE);
+	} while ((err >= 0 || err == -EINTR || err == -ETIME)
+		 && *uring.cq_head
+		 == __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE));
+
+	if (err >= 0 || err == -EINTR || err == -ETIME) {
+		err = uring.cqes[*uring.cq_head & uring.cq_mask].res;
+	}
+
+	ut_free(buf);
+	close(fd);
+	os_aio_uring_free(&uring);
+
+	if (err == (int) UNIV_PAGE_SIZE) {
+
+		return(TRUE);
+	}
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr,
+		" InnoDB: Error: io_uring check"
+		" on tmpdir returned error[%d]\n", err < 0 ? -err : err);
+
+	return(FALSE);
+}
+
+/*******************************************************************//**
+Queues an aio request in the io_uring of its segment. */
+static
+void
+os_aio_uring_dispatch(
+/*==================*/
+	os_aio_array_t*	array,	/*!< in: io request array */
+	os_aio_slot_t*	slot,	/*!< in: an already reserved slot */
+	ibool		submit)	/*!< in: FALSE=leave the request in the
+				submission ring, to be submitted in a
+				batch by
+				os_aio_simulated_wake_handler_threads() */
+{
+	os_aio_uring_t*	uring;
+
+	ut_a(slot->reserved);
+
+	uring = &array->uring[(slot->pos * array->n_segments)
+			      / array->n_slots];
+
+	os_fast_mutex_lock(&uring->sq_mutex);
+	os_aio_uring_prep(uring, slot->type, slot->file, slot->buf,
+			  slot->len,
+			  ((ib_uint64_t) slot->offset_high << 32)
+			  | slot->offset,
+			  slot);
+	os_fast_mutex_unlock(&uring->sq_mutex);
+
+	if (submit) {
+		os_aio_uring_submit(uring);
+	}
+}
+
+/*******************************************************************//**
+Submits the requests queued in the io_urings of an aio array. */
+static
+void
+os_aio_uring_submit_array(
+/*======================*/
+	os_aio_array_t*	array)	/*!< in: aio array */
+{
+	ulint	i;
+
+	for (i = 0; i < array->n_segments; i++) {
+		os_aio_uring_submit(&array->uring[i]);
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /******************************************************************//**
 Creates an aio wait array. Note that we return NULL in case of failure.
 We don't care about freeing memory here because we assume that a
@@ -3550,9 +3938,16 @@ os_aio_array_create(
 	array->cur_seg		= 0;
 	array->slots		= ut_malloc(n * sizeof(os_aio_slot_t));
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(UNIV_LINUX_AIO)
+# if defined(LINUX_NATIVE_AIO)
 	array->aio_ctx = NULL;
 	array->aio_events = NULL;
+# endif /* LINUX_NATIVE_AIO */
+# if defined(LINUX_IO_URING)
+	array->uring = NULL;
+# endif /* LINUX_IO_URING */
+	array->completed = NULL;
+	array->n_completed = NULL;
 
 	/* If we are not using native aio interface then skip this
 	part of initialization. */
@@ -3560,6 +3955,29 @@ os_aio_array_create(
 		goto skip_native_aio;
 	}
 
+	array->completed = ut_malloc(n * sizeof(*array->completed));
+	array->n_completed = ut_malloc(n_segments
+				       * sizeof(*array->n_completed));
+	memset(array->n_completed, 0x0,
+	       n_segments * sizeof(*array->n_completed));
+
+# if defined(LINUX_IO_URING)
+	if (srv_use_io_uring) {
+		/* One io_uring per segment */
+		array->uring = ut_malloc(n_segments * sizeof(*array->uring));
+
+		for (i = 0; i < n_segments; ++i) {
+			if (!os_aio_uring_create(n / n_segments,
+						 &array->uring[i])) {
+				return(NULL);
+			}
+		}
+
+		goto skip_native_aio;
+	}
+# endif /* LINUX_IO_URING */
+
+# if defined(LINUX_NATIVE_AIO)
 	/* Initialize the io_context array. One io_context
 	per segment in the array. */
 
@@ -3593,9 +4011,10 @@ os_aio_array_create(
 	io_event = ut_malloc(n * sizeof(*io_event));
 	memset(io_event, 0x0, sizeof(*io_event) * n);
 	array->aio_events = io_event;
+# endif /* LINUX_NATIVE_AIO */
 
 skip_native_aio:
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 	for (i = 0; i < n; i++) {
 		slot = os_aio_array_get_nth_slot(array, i);
 		slot->pos = i;
@@ -3603,6 +4022,8 @@ skip_native_aio:
 #ifdef LINUX_NATIVE_AIO
 
 		memset(&slot->control, 0x0, sizeof(slot->control));
+#endif
+#ifdef UNIV_LINUX_AIO
 		slot->n_bytes = 0;
 		slot->ret = 0;
 #endif
@@ -3623,12 +4044,27 @@ os_aio_array_free(
 	os_event_free(array->not_full);
 	os_event_free(array->is_empty);
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(UNIV_LINUX_AIO)
 	if (srv_use_native_aio) {
+# if defined(LINUX_IO_URING)
+		if (array->uring) {
+			ulint	i;
+
+			for (i = 0; i < array->n_segments; i++) {
+				os_aio_uring_free(&array->uring[i]);
+			}
+
+			ut_free(array->uring);
+		}
+# endif /* LINUX_IO_URING */
+# if defined(LINUX_NATIVE_AIO)
 		ut_free(array->aio_events);
 		ut_free(array->aio_ctx);
+# endif /* LINUX_NATIVE_AIO */
+		ut_free(array->n_completed);
+		ut_free(array->completed);
 	}
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 
 	ut_free(array->slots);
 	ut_free(array);
@@ -3659,9 +4095,24 @@ os_aio_init(
 
 	os_io_init_simple();
 
+#if defined(LINUX_IO_URING)
+	/* Check if io_uring is supported by the kernel and on tmpfs */
+	if (srv_use_io_uring
+	    && !os_aio_uring_supported()) {
+
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			" InnoDB: Warning: io_uring disabled.\n");
+		srv_use_io_uring = FALSE;
+# if !defined(LINUX_NATIVE_AIO)
+		srv_use_native_aio = FALSE;
+# endif /* !LINUX_NATIVE_AIO */
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	/* Check if native aio is supported on this system and tmpfs */
-	if (srv_use_native_aio
+	if (srv_use_native_aio && !srv_use_io_uring
 	    && !os_aio_native_aio_supported()) {
 
 		ut_print_timestamp(stderr);
@@ -3810,10 +4261,11 @@ os_aio_wake_all_threads_at_shutdown(void)
 	os_aio_array_wake_win_aio_at_shutdown(os_aio_ibuf_array);
 	os_aio_array_wake_win_aio_at_shutdown(os_aio_log_array);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(UNIV_LINUX_AIO)
 
 	/* When using native AIO interface the io helper threads
-	wait on io_getevents with a timeout value of 500ms. At
+	wait on io_getevents or io_uring_enter with a timeout
+	value of 500ms. At
 	each wake up these threads check the server status.
 	No need to do anything to wake them up. */
 
@@ -3974,12 +4426,11 @@ loop:
 	if (array->n_reserved == array->n_slots) {
 		os_mutex_exit(array->mutex);
 
-		if (!srv_use_native_aio) {
-			/* If the handler threads are suspended, wake them
-			so that we get more slots */
+		/* If the handler threads are suspended, or the
+		requests of a batch wait in the io_uring submission
+		rings, wake them so that we get more slots */
 
-			os_aio_simulated_wake_handler_threads();
-		}
+		os_aio_simulated_wake_handler_threads();
 
 		os_event_wait(array->not_full);
 
@@ -4036,13 +4487,25 @@ found:
 	control->hEvent = 0;
 	slot->arr = array;
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(UNIV_LINUX_AIO)
 
 	/* If we are not using native AIO skip this part. */
 	if (!srv_use_native_aio) {
 		goto skip_native_aio;
 	}
 
+	slot->n_bytes = 0;
+	slot->ret = 0;
+
+# ifdef LINUX_IO_URING
+	if (array->uring) {
+		/* The submission queue entry is filled in
+		os_aio_uring_dispatch(). */
+		goto skip_native_aio;
+	}
+# endif /* LINUX_IO_URING */
+
+# ifdef LINUX_NATIVE_AIO
 	/* Check if we are dealing with 64 bit arch.
 	If not then make sure that offset fits in 32 bits. */
 	if (sizeof(aio_offset) == 8) {
@@ -4064,13 +4527,11 @@ found:
 	}
 
 	iocb->data = (void*)slot;
-	slot->n_bytes = 0;
-	slot->ret = 0;
 	/*fprintf(stderr, "Filled up Linux native iocb.\n");*/
-	
+# endif /* LINUX_NATIVE_AIO */
 
 skip_native_aio:
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 	os_mutex_exit(array->mutex);
 
 	return(slot);
@@ -4104,10 +4565,12 @@ os_aio_array_free_slot(
 		os_event_set(array->is_empty);
 	}
 
-#ifdef LINUX_NATIVE_AIO
+#ifdef UNIV_LINUX_AIO
 
 	if (srv_use_native_aio) {
+# ifdef LINUX_NATIVE_AIO
 		memset(&slot->control, 0x0, sizeof(slot->control));
+# endif /* LINUX_NATIVE_AIO */
 		slot->n_bytes = 0;
 		slot->ret = 0;
 		/*fprintf(stderr, "Freed up Linux native slot.\n");*/
@@ -4174,6 +4637,17 @@ os_aio_simulated_wake_handler_threads(void)
 	ulint	i;
 
 	if (srv_use_native_aio) {
+#ifdef LINUX_IO_URING
+		if (srv_use_io_uring) {
+			/* Submit the requests that were posted
+			with OS_AIO_SIMULATED_WAKE_LATER */
+
+			os_aio_uring_submit_array(os_aio_ibuf_array);
+			os_aio_uring_submit_array(os_aio_log_array);
+			os_aio_uring_submit_array(os_aio_read_array);
+			os_aio_uring_submit_array(os_aio_write_array);
+		}
+#endif /* LINUX_IO_URING */
 		/* We do not use simulated aio: do nothing */
 
 		return;
@@ -4224,7 +4698,7 @@ readahead requests. */
 #endif /* __WIN__ */
 }
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(UNIV_LINUX_AIO)
 /*******************************************************************//**
 Dispatch an AIO request to the kernel.
 @return	TRUE on success. */
@@ -4233,17 +4707,32 @@ ibool
 os_aio_linux_dispatch(
 /*==================*/
 	os_aio_array_t*	array,	/*!< in: io request array. */
-	os_aio_slot_t*	slot)	/*!< in: an already reserved slot. */
+	os_aio_slot_t*	slot,	/*!< in: an already reserved slot. */
+	ulint		wake_later)/*!< in: with io_uring, leave the
+				request to be submitted in a batch by
+				os_aio_simulated_wake_handler_threads() */
 {
+# if defined(LINUX_NATIVE_AIO)
 	int		ret;
 	ulint		io_ctx_index;
 	struct iocb*	iocb;
+# endif /* LINUX_NATIVE_AIO */
 
 	ut_ad(slot != NULL);
 	ut_ad(array);
 
 	ut_a(slot->reserved);
 
+# if defined(LINUX_IO_URING)
+	if (array->uring) {
+		os_aio_uring_dispatch(array, slot, !wake_later);
+
+		return(TRUE);
+	}
+# endif /* LINUX_IO_URING */
+
+# if defined(LINUX_NATIVE_AIO)
+
 	/* Find out what we are going to work with.
 	The iocb struct is directly in the slot.
 	The io_context is one per segment. */
@@ -4268,8 +4757,12 @@ os_aio_linux_dispatch(
 	}
 
 	return(TRUE);
+# else /* LINUX_NATIVE_AIO */
+	ut_error;
+	return(FALSE);
+# endif /* LINUX_NATIVE_AIO */
 }
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 
 
 /*******************************************************************//**
@@ -4378,10 +4871,10 @@ try_again:
 	case OS_AIO_SYNC:
 		array = os_aio_sync_array;
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(UNIV_LINUX_AIO)
 		/* In Linux native AIO we don't use sync IO array. */
 		ut_a(!srv_use_native_aio);
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 		break;
 	default:
 		ut_error;
@@ -4405,8 +4898,8 @@ try_again:
 			if(!ret && GetLastError() != ERROR_IO_PENDING)
 				goto err_exit;
 
-#elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+#elif defined(UNIV_LINUX_AIO)
+			if (!os_aio_linux_dispatch(array, slot, wake_later)) {
 				goto err_exit;
 			}
 #endif
@@ -4426,8 +4919,8 @@ try_again:
 
 			if(!ret && GetLastError() != ERROR_IO_PENDING)
 				goto err_exit;
-#elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+#elif defined(UNIV_LINUX_AIO)
+			if (!os_aio_linux_dispatch(array, slot, wake_later)) {
 				goto err_exit;
 			}
 #endif
@@ -4445,9 +4938,9 @@ try_again:
 	/* aio was queued successfully! */
 	return(TRUE);
 
-#if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
+#if defined UNIV_LINUX_AIO || defined WIN_ASYNC_IO
 err_exit:
-#endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
+#endif /* UNIV_LINUX_AIO || WIN_ASYNC_IO */
 	os_aio_array_free_slot(array, slot);
 
 	retry = os_file_handle_error(name,
@@ -4629,8 +5122,8 @@ os_aio_windows_handle(
 /******************************************************************//**
 This function is only used in Linux native asynchronous i/o. This is
 called from within the io-thread. If there are no completed IO requests
-in the slot array, the thread calls this function to collect more
-requests from the kernel.
+in the queue of its segment, the thread calls this function to collect
+more requests from the kernel.
 The io-thread waits on io_getevents(), which is a blocking call, with
 a timeout value. Unless the system is very heavy loaded, keeping the
 io-thread very busy, the io-thread will spend most of its time waiting
@@ -4652,6 +5145,7 @@ os_aio_linux_collect(
 	struct timespec		timeout;
 	struct io_event*	events;
 	struct io_context*	io_ctx;
+	os_aio_slot_t**		completed;
 
 	/* sanity checks. */
 	ut_ad(array != NULL);
@@ -4664,6 +5158,9 @@ os_aio_linux_collect(
 	/* Which io_context we are going to use. */
 	io_ctx = array->aio_ctx[segment];
 
+	/* The queue of completed requests of the segment. */
+	completed = &array->completed[segment * seg_size];
+
 	/* Starting point of the segment we will be working on. */
 	start_pos = segment * seg_size;
 
@@ -4708,14 +5205,17 @@ retry:
 			/* We have not overstepped to next segment. */
 			ut_a(slot->pos < end_pos);
 
-			/* Mark this request as completed. The error handling
-			will be done in the calling function. */
-			os_mutex_enter(array->mutex);
+			/* Queue this request as completed. Only this
+			thread accesses the slot until it is freed, so
+			no mutex is needed. The error handling will be
+			done in the calling function. */
 			slot->n_bytes = events[i].res;
 			slot->ret = events[i].res2;
 			slot->io_already_done = TRUE;
-			os_mutex_exit(array->mutex);
+			completed[i] = slot;
 		}
+
+		array->n_completed[segment] = ret;
 		return;
 	}
 
@@ -4747,7 +5247,122 @@ retry:
 		ret);
 	ut_error;
 }
+#endif /* LINUX_NATIVE_AIO */
+
+#if defined(LINUX_IO_URING)
+/******************************************************************//**
+Moves the completed requests of a segment from its io_uring completion
+ring to the queue of completed requests of the segment.
+@return	number of completed requests in the queue */
+static
+ulint
+os_aio_uring_reap(
+/*==============*/
+	os_aio_array_t* array,		/*!< in/out: slot array. */
+	ulint		segment,	/*!< in: local segment no. */
+	ulint		seg_size)	/*!< in: segment size. */
+{
+	os_aio_uring_t*	uring;
+	os_aio_slot_t**	completed;
+	ulint		n;
+	unsigned	head;
+	unsigned	tail;
+
+	uring = &array->uring[segment];
+	completed = &array->completed[segment * seg_size];
+	n = array->n_completed[segment];
+
+	head = *uring->cq_head;
+	tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; head++) {
+		struct io_uring_cqe*	cqe;
+		os_aio_slot_t*		slot;
+
+		cqe = &uring->cqes[head & uring->cq_mask];
+		slot = (os_aio_slot_t*) (ulint) cqe->user_data;
+
+		/* Some sanity checks. */
+		ut_a(slot != NULL);
+		ut_a(slot->reserved);
+		ut_a(slot->pos >= segment * seg_size);
+		ut_a(slot->pos < (segment + 1) * seg_size);
+		ut_a(n < seg_size);
+
+		/* The error handling will be done in the calling
+		function. */
+		if (cqe->res < 0) {
+			slot->n_bytes = 0;
+			slot->ret = cqe->res;
+		} else {
+			slot->n_bytes = cqe->res;
+			slot->ret = 0;
+		}
+
+		slot->io_already_done = TRUE;
+		completed[n++] = slot;
+	}
+
+	/* Give the entries back to the kernel. */
+	__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+	array->n_completed[segment] = n;
+
+	return(n);
+}
+
+/******************************************************************//**
+This function is only used in Linux native asynchronous i/o with
+io_uring. It is the counterpart of os_aio_linux_collect(): the
+io-thread submits the requests left in the submission ring of its
+segment and waits on io_uring_enter(), with a timeout value, until the
+kernel posts a completion. */
+static
+void
+os_aio_uring_collect(
+/*=================*/
+	os_aio_array_t* array,		/*!< in/out: slot array. */
+	ulint		segment,	/*!< in: local segment no. */
+	ulint		seg_size)	/*!< in: segment size. */
+{
+	int	ret;
+
+	while (!os_aio_uring_reap(array, segment, seg_size)) {
 
+		ret = os_aio_uring_enter(&array->uring[segment], TRUE);
+
+		if (UNIV_UNLIKELY(srv_shutdown_state
+				  == SRV_SHUTDOWN_EXIT_THREADS)) {
+			os_aio_uring_reap(array, segment, seg_size);
+			return;
+		}
+
+		if (ret >= 0) {
+			continue;
+		}
+
+		switch (ret) {
+		case -ETIME:
+			/* No completed request! Go back and check
+			again. */
+		case -EAGAIN:
+		case -EBUSY:
+			/* Not enough resources! Try again. */
+		case -EINTR:
+			continue;
+		}
+
+		/* All other errors should cause a trap for now. */
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: unexpected ret_code[%d]"
+			" from io_uring_enter()!\n", ret);
+		ut_error;
+	}
+}
+#endif /* LINUX_IO_URING */
+
+#if defined(UNIV_LINUX_AIO)
 /**********************************************************************//**
 This function is only used in Linux native asynchronous i/o.
 Waits for an aio operation to complete. This function is used to wait for
@@ -4788,34 +5403,33 @@ os_aio_linux_handle(
 	segment = os_aio_get_array_and_local_segment(&array, global_seg);
 	n = array->n_slots / array->n_segments;
 
-	/* Loop until we have found a completed request. */
-	for (;;) {
-		ibool	any_reserved = FALSE;
-		os_mutex_enter(array->mutex);
-		for (i = 0; i < n; ++i) {
-			slot = os_aio_array_get_nth_slot(
-				array, i + segment * n);
-			if (!slot->reserved) {
-				continue;
-			} else if (slot->io_already_done) {
-				/* Something for us to work on. */
-				goto found;
-			} else {
-				any_reserved = TRUE;
-			}
-		}
+	/* Loop until we have found a completed request. The
+	completed requests are queued by the collect functions,
+	so that we need not scan the slots of the segment. */
+	while (array->n_completed[segment] == 0) {
 
-		os_mutex_exit(array->mutex);
-
-		/* There is no completed request.
-		If there is no pending request at all,
-		and the system is being shut down, exit. */
 		if (UNIV_UNLIKELY
-		    (!any_reserved
-		     && srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS)) {
-			*message1 = NULL;
-			*message2 = NULL;
-			return(TRUE);
+		    (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS)) {
+			/* If there is no pending request at all,
+			and the system is being shut down, exit. */
+			ibool	any_reserved = FALSE;
+
+			os_mutex_enter(array->mutex);
+			for (i = 0; i < n; ++i) {
+				slot = os_aio_array_get_nth_slot(
+					array, i + segment * n);
+				if (slot->reserved) {
+					any_reserved = TRUE;
+					break;
+				}
+			}
+			os_mutex_exit(array->mutex);
+
+			if (!any_reserved) {
+				*message1 = NULL;
+				*message2 = NULL;
+				return(TRUE);
+			}
 		}
 
 		/* Wait for some request. Note that we return
@@ -4823,19 +5437,31 @@ os_aio_linux_handle(
 
 		srv_set_io_thread_op_info(global_seg,
 			"waiting for completed aio requests");
+# if defined(LINUX_IO_URING)
+		if (array->uring) {
+			os_aio_uring_collect(array, segment, n);
+			continue;
+		}
+# endif /* LINUX_IO_URING */
+# if defined(LINUX_NATIVE_AIO)
 		os_aio_linux_collect(array, segment, n);
+# else /* LINUX_NATIVE_AIO */
+		ut_error;
+# endif /* LINUX_NATIVE_AIO */
 	}
 
-found:
 	/* Note that it may be that there are more then one completed
-	IO requests. We process them one at a time. We may have a case
-	here to improve the performance slightly by dealing with all
-	requests in one sweep. */
+	IO requests. We process them one at a time, the rest stay
+	in the queue for the next calls. */
 	srv_set_io_thread_op_info(global_seg,
 				"processing completed aio requests");
 
+	slot = array->completed[segment * n
+				+ --array->n_completed[segment]];
+
 	/* Ensure that we are scribbling only our segment. */
-	ut_a(i < n);
+	ut_a(slot->pos >= segment * n);
+	ut_a(slot->pos < (segment + 1) * n);
 
 	ut_ad(slot != NULL);
 	ut_ad(slot->reserved);
@@ -4872,13 +5498,11 @@ found:
 		ret = FALSE;
 	}
 
-	os_mutex_exit(array->mutex);
-
 	os_aio_array_free_slot(array, slot);
 
 	return(ret);
 }
-#endif /* LINUX_NATIVE_AIO */
+#endif /* UNIV_LINUX_AIO */
 
 /**********************************************************************//**
 Does simulated aio. This function should be called by an i/o-handler
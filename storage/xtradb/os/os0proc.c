@@ -46,6 +46,11 @@ MAP_ANON but MAP_ANON is marked as deprecated */
 #define OS_MAP_ANON	MAP_ANON
 #endif
 
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#include <numaif.h>
+#endif
+
 /* Linux's MAP_POPULATE */
 #if defined(MAP_POPULATE)
 #define OS_MAP_POPULATE	MAP_POPULATE
@@ -57,6 +62,15 @@ UNIV_INTERN ibool os_use_large_pages;
 /* Large page size. This may be a boot-time option on some platforms */
 UNIV_INTERN ulint os_large_page_size;
 
+/** Number of NUMA nodes, or 0 if NUMA support is not available */
+UNIV_INTERN ulint os_numa_n_nodes;
+#ifdef HAVE_LIBNUMA
+/** Number of entries in os_numa_cpu_node[] */
+UNIV_INTERN ulint os_numa_n_cpus;
+/** NUMA node of each CPU */
+UNIV_INTERN byte* os_numa_cpu_node;
+#endif /* HAVE_LIBNUMA */
+
 /****************************************************************//**
 Converts the current process id to a number. It is not guaranteed that the
 number is unique. In Linux returns the 'process number' of the current
@@ -278,3 +292,100 @@ os_mem_free_large(
 	}
 #endif
 }
+
+/****************************************************************//**
+Initializes NUMA support: determines the number of NUMA nodes and
+the node of each CPU.  Sets os_numa_n_nodes to 0 if NUMA is not
+available. */
+UNIV_INTERN
+void
+os_numa_init(void)
+/*==============*/
+{
+#ifdef HAVE_LIBNUMA
+	ulint	cpu;
+
+	os_numa_n_nodes = 0;
+
+	if (numa_available() < 0) {
+		fprintf(stderr, "InnoDB: Warning: NUMA is not available"
+			" on this system\n");
+		return;
+	}
+
+	os_numa_n_cpus = (ulint) numa_num_configured_cpus();
+	os_numa_cpu_node = ut_malloc(os_numa_n_cpus);
+
+	for (cpu = 0; cpu < os_numa_n_cpus; cpu++) {
+		int	node = numa_node_of_cpu((int) cpu);
+
+		os_numa_cpu_node[cpu] = (byte) (node < 0 ? 0 : node);
+	}
+
+	os_numa_n_nodes = (ulint) numa_max_node() + 1;
+
+	fprintf(stderr, "InnoDB: Using %lu NUMA nodes\n",
+		(ulong) os_numa_n_nodes);
+#else /* HAVE_LIBNUMA */
+	os_numa_n_nodes = 0;
+
+	fprintf(stderr, "InnoDB: Warning: NUMA support"
+		" was not compiled in\n");
+#endif /* HAVE_LIBNUMA */
+}
+
+/****************************************************************//**
+Sets the memory policy of a memory region so that its pages are
+allocated on the given NUMA node, and moves the pages that are
+already allocated. */
+UNIV_INTERN
+void
+os_mem_bind_to_numa_node(
+/*=====================*/
+	void*	ptr __attribute__((unused)),
+					/*!< in: pointer returned by
+					os_mem_alloc_large() */
+	ulint	size __attribute__((unused)),
+					/*!< in: size of the region */
+	ulint	node __attribute__((unused)))
+					/*!< in: NUMA node */
+{
+#ifdef HAVE_LIBNUMA
+	struct bitmask*	nodes;
+
+	ut_ad(node < os_numa_n_nodes);
+
+	nodes = numa_allocate_nodemask();
+	numa_bitmask_setbit(nodes, (unsigned int) node);
+
+	/* Prefer the node rather than bind to it, so that an
+	exhausted node does not make the allocation fail. */
+	if (mbind(ptr, size, MPOL_PREFERRED, nodes->maskp,
+		  nodes->size + 1, MPOL_MF_MOVE)) {
+		fprintf(stderr, "InnoDB: Warning: mbind(%p, %lu, node %lu)"
+			" failed; errno %lu\n",
+			ptr, (ulong) size, (ulong) node, (ulong) errno);
+	}
+
+	numa_bitmask_free(nodes);
+#endif /* HAVE_LIBNUMA */
+}
+
+/****************************************************************//**
+Restricts the calling thread to the CPUs of a NUMA node. */
+UNIV_INTERN
+void
+os_thread_bind_to_numa_node(
+/*========================*/
+	ulint	node __attribute__((unused)))	/*!< in: NUMA node */
+{
+#ifdef HAVE_LIBNUMA
+	ut_ad(node < os_numa_n_nodes);
+
+	if (numa_run_on_node((int) node)) {
+		fprintf(stderr, "InnoDB: Warning: numa_run_on_node(%lu)"
+			" failed; errno %lu\n",
+			(ulong) node, (ulong) errno);
+	}
+#endif /* HAVE_LIBNUMA */
+}
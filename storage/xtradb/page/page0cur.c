@@ -1517,7 +1517,7 @@ use_heap:
 Writes a log record of copying a record list end to a new created page.
 @return 4-byte field where to write the log data length, or NULL if
 logging is disabled */
-UNIV_INLINE
+UNIV_INTERN
 byte*
 page_copy_rec_list_to_created_page_write_log(
 /*=========================================*/
@@ -37,6 +37,8 @@ Created June 2005 by Marko Makela
 #include "page0types.h"
 #include "log0recv.h"
 #include "zlib.h"
+#include "m_string.h" /* for my_sys.h */
+#include "my_sys.h" /* my_lz_compress() */
 #ifndef UNIV_HOTBACKUP
 # include "buf0lru.h"
 # include "btr0sea.h"
@@ -47,6 +49,9 @@ Created June 2005 by Marko Makela
 # define buf_LRU_stat_inc_unzip()			((void) 0)
 #endif /* !UNIV_HOTBACKUP */
 
+/** Default page compression algorithm (innodb_compression_algorithm) */
+UNIV_INTERN ulong	page_zip_algorithm = PAGE_ZIP_ALGORITHM_ZLIB;
+
 #ifndef UNIV_HOTBACKUP
 /** Statistics on compression, indexed by page_zip_des_t::ssize - 1 */
 UNIV_INTERN page_zip_stat_t page_zip_stat[PAGE_ZIP_NUM_SSIZE_MAX - 1];
@@ -731,6 +736,301 @@ page_zip_set_alloc(
 	strm->opaque = heap;
 }
 
+/** First byte of a page stream compressed with my_lz_compress().
+A zlib stream starts with a CMF byte whose low nibble is Z_DEFLATED. */
+#define PAGE_ZIP_LZ_MAGIC	0x4C
+/** Size of the header of an LZ page stream: the magic byte, and
+the lengths of the index information, of the uncompressed stream
+and of the compressed payload, 2 bytes each */
+#define PAGE_ZIP_LZ_HEADER	7
+
+/** Compressed page stream.  The record compression and decompression
+functions are passed &zs and expect the zlib semantics of deflate()
+and inflate() from it; for PAGE_ZIP_ALGORITHM_LZ those are emulated
+by buffering the whole stream in buf. */
+typedef struct page_zip_stream_struct {
+	z_stream	zs;		/*!< zlib stream; must be the first
+					member.  For PAGE_ZIP_ALGORITHM_LZ,
+					only the next_*, avail_*, total_*
+					and msg fields are used */
+	ulint		algorithm;	/*!< enum page_zip_algo */
+	byte*		buf;		/*!< PAGE_ZIP_ALGORITHM_LZ:
+					the uncompressed stream */
+	ulint		len;		/*!< length of buf */
+	ulint		pos;		/*!< number of bytes of buf
+					returned by page_zip_inflate() */
+	ulint		first_len;	/*!< length of the first block
+					of buf, the index information */
+	ulint		in_len;		/*!< length of the compressed
+					stream, to be consumed from
+					zs.next_in at the end of the stream */
+} page_zip_stream_t;
+
+/**********************************************************************//**
+Initialize a compressed page stream for compression. */
+static
+void
+page_zip_deflate_init(
+/*==================*/
+	page_zip_stream_t*	strm,	/*!< out: compressed page stream,
+					after page_zip_set_alloc() */
+	ulint			algorithm,/*!< in: enum page_zip_algo */
+	mem_heap_t*		heap)	/*!< in: memory heap for
+					PAGE_ZIP_ALGORITHM_LZ */
+{
+	strm->algorithm = algorithm;
+
+	if (algorithm == PAGE_ZIP_ALGORITHM_LZ) {
+		/* The index information and the page payload */
+		strm->buf = mem_heap_alloc(heap, 2 * UNIV_PAGE_SIZE);
+		strm->len = strm->pos = strm->first_len = 0;
+		strm->zs.total_in = strm->zs.total_out = 0;
+		strm->zs.msg = NULL;
+	} else {
+		int	err;
+
+		err = deflateInit2(&strm->zs, Z_DEFAULT_COMPRESSION,
+				   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
+				   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+		ut_a(err == Z_OK);
+	}
+}
+
+/**********************************************************************//**
+Compress data with the algorithm of a compressed page stream.
+For PAGE_ZIP_ALGORITHM_LZ, the input is only buffered until Z_FINISH.
+The first Z_FULL_FLUSH marks the end of the index information.
+If the LZ stream does not fit, the buffer is compressed with zlib.
+@return	deflate() status: Z_OK, Z_STREAM_END, Z_BUF_ERROR, ... */
+static
+int
+page_zip_deflate(
+/*=============*/
+	z_streamp	zs,	/*!< in/out: page_zip_stream_t::zs */
+	int		flush)	/*!< in: deflate() flushing method */
+{
+	page_zip_stream_t*	strm = (page_zip_stream_t*) zs;
+	ulint			comp_len;
+
+	if (strm->algorithm != PAGE_ZIP_ALGORITHM_LZ) {
+		return(deflate(zs, flush));
+	}
+
+	if (UNIV_UNLIKELY(zs->avail_in > 2 * UNIV_PAGE_SIZE - strm->len)) {
+		return(Z_STREAM_ERROR);
+	}
+
+	memcpy(strm->buf + strm->len, zs->next_in, zs->avail_in);
+	strm->len += zs->avail_in;
+	zs->next_in += zs->avail_in;
+	zs->total_in += zs->avail_in;
+	zs->avail_in = 0;
+
+	if (flush == Z_FULL_FLUSH && !strm->first_len) {
+		strm->first_len = strm->len;
+	}
+
+	if (flush != Z_FINISH) {
+		return(Z_OK);
+	}
+
+	if (UNIV_UNLIKELY(zs->avail_out <= PAGE_ZIP_LZ_HEADER
+			  || strm->len > 0xFFFF)) {
+		comp_len = 0;
+	} else {
+		comp_len = my_lz_compress(strm->buf, strm->len,
+					  zs->next_out + PAGE_ZIP_LZ_HEADER,
+					  zs->avail_out - PAGE_ZIP_LZ_HEADER);
+	}
+
+	if (UNIV_UNLIKELY(!comp_len)) {
+		/* The LZ stream does not fit.  Fall back to zlib, so that
+		no page that zlib can compress will fail to compress. */
+		int	err;
+
+		page_zip_deflate_init(strm, PAGE_ZIP_ALGORITHM_ZLIB, NULL);
+
+		zs->next_in = strm->buf;
+		zs->avail_in = strm->first_len;
+		err = deflate(zs, Z_FULL_FLUSH);
+
+		if (err == Z_OK) {
+			zs->avail_in = strm->len - strm->first_len;
+			err = deflate(zs, Z_FINISH);
+		}
+
+		return(err);
+	}
+
+	zs->next_out[0] = PAGE_ZIP_LZ_MAGIC;
+	mach_write_to_2(zs->next_out + 1, strm->first_len);
+	mach_write_to_2(zs->next_out + 3, strm->len);
+	mach_write_to_2(zs->next_out + 5, comp_len);
+
+	comp_len += PAGE_ZIP_LZ_HEADER;
+	zs->next_out += comp_len;
+	zs->avail_out -= comp_len;
+	zs->total_out += comp_len;
+
+	return(Z_STREAM_END);
+}
+
+/**********************************************************************//**
+Free a compressed page stream that was used for compression.
+@return	deflateEnd() status */
+static
+int
+page_zip_deflate_end(
+/*=================*/
+	z_streamp	zs)	/*!< in/out: page_zip_stream_t::zs */
+{
+	page_zip_stream_t*	strm = (page_zip_stream_t*) zs;
+
+	if (strm->algorithm == PAGE_ZIP_ALGORITHM_LZ) {
+		return(Z_OK);
+	}
+
+	return(deflateEnd(zs));
+}
+
+/**********************************************************************//**
+Initialize a compressed page stream for decompression.  The algorithm
+is determined from the first byte of the stream.  An LZ stream is
+decompressed here as a whole.
+@return	Z_OK, or Z_DATA_ERROR if the stream is corrupted */
+static
+int
+page_zip_inflate_init(
+/*==================*/
+	page_zip_stream_t*	strm,	/*!< in/out: compressed page stream,
+					after page_zip_set_alloc() */
+	mem_heap_t*		heap)	/*!< in: memory heap */
+{
+	z_streamp	zs = &strm->zs;
+	ulint		first_len;
+	ulint		len;
+	ulint		comp_len;
+	size_t		dst_len;
+
+	if (!zs->avail_in || zs->next_in[0] != PAGE_ZIP_LZ_MAGIC) {
+		strm->algorithm = PAGE_ZIP_ALGORITHM_ZLIB;
+
+		if (UNIV_UNLIKELY(inflateInit2(zs, UNIV_PAGE_SIZE_SHIFT)
+				  != Z_OK)) {
+			ut_error;
+		}
+
+		return(Z_OK);
+	}
+
+	strm->algorithm = PAGE_ZIP_ALGORITHM_LZ;
+	zs->total_in = zs->total_out = 0;
+	zs->msg = (char*) "corrupted LZ page stream";
+
+	if (UNIV_UNLIKELY(zs->avail_in < PAGE_ZIP_LZ_HEADER)) {
+		return(Z_DATA_ERROR);
+	}
+
+	first_len = mach_read_from_2(zs->next_in + 1);
+	len = mach_read_from_2(zs->next_in + 3);
+	comp_len = mach_read_from_2(zs->next_in + 5);
+
+	if (UNIV_UNLIKELY(first_len > len
+			  || comp_len > zs->avail_in - PAGE_ZIP_LZ_HEADER)) {
+		return(Z_DATA_ERROR);
+	}
+
+	strm->buf = mem_heap_alloc(heap, len + 1);
+	dst_len = len;
+
+	if (UNIV_UNLIKELY(my_lz_decompress(zs->next_in + PAGE_ZIP_LZ_HEADER,
+					   comp_len, strm->buf, &dst_len)
+			  || dst_len != len)) {
+		return(Z_DATA_ERROR);
+	}
+
+	strm->len = len;
+	strm->pos = 0;
+	strm->first_len = first_len;
+	strm->in_len = PAGE_ZIP_LZ_HEADER + comp_len;
+	zs->msg = NULL;
+
+	return(Z_OK);
+}
+
+/**********************************************************************//**
+Decompress data with the algorithm of a compressed page stream.
+For PAGE_ZIP_ALGORITHM_LZ, Z_BLOCK returns the index information,
+and the compressed stream is consumed from next_in when
+Z_STREAM_END is returned, as zlib would have done by then.
+@return	inflate() status: Z_OK, Z_STREAM_END, Z_BUF_ERROR, ... */
+static
+int
+page_zip_inflate(
+/*=============*/
+	z_streamp	zs,	/*!< in/out: page_zip_stream_t::zs */
+	int		flush)	/*!< in: inflate() flushing method */
+{
+	page_zip_stream_t*	strm = (page_zip_stream_t*) zs;
+	ulint			n;
+
+	if (strm->algorithm != PAGE_ZIP_ALGORITHM_LZ) {
+		return(inflate(zs, flush));
+	}
+
+	if (flush == Z_BLOCK) {
+		n = strm->pos < strm->first_len
+			? strm->first_len - strm->pos : 0;
+	} else {
+		n = strm->len - strm->pos;
+	}
+
+	n = ut_min(n, zs->avail_out);
+	memcpy(zs->next_out, strm->buf + strm->pos, n);
+	strm->pos += n;
+	zs->next_out += n;
+	zs->avail_out -= n;
+	zs->total_out += n;
+
+	if (flush == Z_BLOCK) {
+		return(Z_OK);
+	} else if (strm->pos < strm->len) {
+		return(n && flush != Z_FINISH ? Z_OK : Z_BUF_ERROR);
+	} else if (flush != Z_FINISH && !zs->avail_out) {
+		return(Z_OK);
+	}
+
+	if (UNIV_UNLIKELY(zs->avail_in < strm->in_len)) {
+		zs->msg = (char*) "LZ page stream overlaps the page directory";
+		return(Z_DATA_ERROR);
+	}
+
+	zs->next_in += strm->in_len;
+	zs->avail_in -= strm->in_len;
+	zs->total_in += strm->in_len;
+	strm->in_len = 0;
+
+	return(Z_STREAM_END);
+}
+
+/**********************************************************************//**
+Free a compressed page stream that was used for decompression.
+@return	inflateEnd() status */
+static
+int
+page_zip_inflate_end(
+/*=================*/
+	z_streamp	zs)	/*!< in/out: page_zip_stream_t::zs */
+{
+	page_zip_stream_t*	strm = (page_zip_stream_t*) zs;
+
+	if (strm->algorithm == PAGE_ZIP_ALGORITHM_LZ) {
+		return(Z_OK);
+	}
+
+	return(inflateEnd(zs));
+}
+
 #if 0 || defined UNIV_DEBUG || defined UNIV_ZIP_DEBUG
 /** Symbol for enabling compression and decompression diagnostics */
 # define PAGE_ZIP_COMPRESS_DBG
@@ -747,7 +1047,8 @@ as a log file name generator. */
 UNIV_INTERN unsigned	page_zip_compress_log;
 
 /**********************************************************************//**
-Wrapper for deflate().  Log the operation if page_zip_compress_dbg is set.
+Wrapper for page_zip_deflate().
+Log the operation if page_zip_compress_dbg is set.
 @return	deflate() status: Z_OK, Z_BUF_ERROR, ... */
 static
 int
@@ -764,21 +1065,21 @@ page_zip_compress_deflate(
 	if (UNIV_LIKELY_NULL(logfile)) {
 		fwrite(strm->next_in, 1, strm->avail_in, logfile);
 	}
-	status = deflate(strm, flush);
+	status = page_zip_deflate(strm, flush);
 	if (UNIV_UNLIKELY(page_zip_compress_dbg)) {
 		fprintf(stderr, " -> %d\n", status);
 	}
 	return(status);
 }
 
-/* Redefine deflate(). */
-# undef deflate
-/** Debug wrapper for the zlib compression routine deflate().
+/* Redefine page_zip_deflate(). */
+/** Debug wrapper for the compression routine page_zip_deflate().
 Log the operation if page_zip_compress_dbg is set.
 @param strm	in/out: compressed stream
 @param flush	in: flushing method
 @return		deflate() status: Z_OK, Z_BUF_ERROR, ... */
-# define deflate(strm, flush) page_zip_compress_deflate(logfile, strm, flush)
+# define page_zip_deflate(strm, flush)				\
+	page_zip_compress_deflate(logfile, strm, flush)
 /** Declaration of the logfile parameter */
 # define FILE_LOGFILE FILE* logfile,
 /** The logfile parameter */
@@ -826,7 +1127,7 @@ page_zip_compress_node_ptrs(
 			- c_stream->next_in;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -839,7 +1140,7 @@ page_zip_compress_node_ptrs(
 			- REC_NODE_PTR_SIZE;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -883,7 +1184,7 @@ page_zip_compress_sec(
 		if (UNIV_LIKELY(c_stream->avail_in)) {
 			UNIV_MEM_ASSERT_RW(c_stream->next_in,
 					   c_stream->avail_in);
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -947,7 +1248,7 @@ page_zip_compress_clust_ext(
 				= src - c_stream->next_in;
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -976,7 +1277,7 @@ page_zip_compress_clust_ext(
 			c_stream->avail_in = src
 				- c_stream->next_in;
 			if (UNIV_LIKELY(c_stream->avail_in)) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1073,7 +1374,7 @@ page_zip_compress_clust(
 			- c_stream->next_in;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1120,7 +1421,7 @@ page_zip_compress_clust(
 			c_stream->avail_in = src - c_stream->next_in;
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1148,7 +1449,7 @@ page_zip_compress_clust(
 			- c_stream->next_in;
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1162,7 +1463,21 @@ func_exit:
 }
 
 /**********************************************************************//**
-Compress a page.
+Determine the page compression algorithm of an index.
+@return	PAGE_COMPRESSION_ALGORITHM of the table, or page_zip_algorithm */
+UNIV_INTERN
+ulint
+page_zip_get_algorithm(
+/*===================*/
+	const dict_index_t*	index)	/*!< in: index of the B-tree node */
+{
+	return(index->table->zip_algorithm != ULINT_UNDEFINED
+	       ? index->table->zip_algorithm
+	       : page_zip_algorithm);
+}
+
+/**********************************************************************//**
+Compress a page with the algorithm of the index.
 @return TRUE on success, FALSE on failure; page_zip will be left
 intact on failure. */
 UNIV_INTERN
@@ -1175,7 +1490,26 @@ page_zip_compress(
 	dict_index_t*	index,	/*!< in: index of the B-tree node */
 	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
 {
-	z_stream	c_stream;
+	return(page_zip_compress_low(page_zip, page, index,
+				     page_zip_get_algorithm(index), mtr));
+}
+
+/**********************************************************************//**
+Compress a page with the given algorithm.
+@return TRUE on success, FALSE on failure; page_zip will be left
+intact on failure. */
+UNIV_INTERN
+ibool
+page_zip_compress_low(
+/*==================*/
+	page_zip_des_t*	page_zip,/*!< in: size; out: data, n_blobs,
+				m_start, m_end, m_nonempty */
+	const page_t*	page,	/*!< in: uncompressed page */
+	dict_index_t*	index,	/*!< in: index of the B-tree node */
+	ulint		algorithm,/*!< in: enum page_zip_algo */
+	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
+{
+	page_zip_stream_t c_stream;
 	int		err;
 	ulint		n_fields;/* number of index fields needed */
 	byte*		fields;	/*!< index field information */
@@ -1286,15 +1620,12 @@ page_zip_compress(
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, Z_DEFAULT_COMPRESSION,
-			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
-			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
-	ut_a(err == Z_OK);
+	page_zip_deflate_init(&c_stream, algorithm, heap);
 
-	c_stream.next_out = buf;
+	c_stream.zs.next_out = buf;
 	/* Subtract the space reserved for uncompressed data. */
 	/* Page header and the end marker of the modification log */
-	c_stream.avail_out = buf_end - buf - 1;
+	c_stream.zs.avail_out = buf_end - buf - 1;
 	/* Dense page directory and uncompressed columns, if any */
 	if (page_is_leaf(page)) {
 		if (dict_index_is_clust(index)) {
@@ -1318,30 +1649,30 @@ page_zip_compress(
 		trx_id_col = ULINT_UNDEFINED;
 	}
 
-	if (UNIV_UNLIKELY(c_stream.avail_out <= n_dense * slot_size
+	if (UNIV_UNLIKELY(c_stream.zs.avail_out <= n_dense * slot_size
 			  + 6/* sizeof(zlib header and footer) */)) {
 		goto zlib_error;
 	}
 
-	c_stream.avail_out -= n_dense * slot_size;
-	c_stream.avail_in = page_zip_fields_encode(n_fields, index,
-						   trx_id_col, fields);
-	c_stream.next_in = fields;
+	c_stream.zs.avail_out -= n_dense * slot_size;
+	c_stream.zs.avail_in = page_zip_fields_encode(n_fields, index,
+						      trx_id_col, fields);
+	c_stream.zs.next_in = fields;
 	if (UNIV_LIKELY(!trx_id_col)) {
 		trx_id_col = ULINT_UNDEFINED;
 	}
 
-	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FULL_FLUSH);
+	UNIV_MEM_ASSERT_RW(c_stream.zs.next_in, c_stream.zs.avail_in);
+	err = page_zip_deflate(&c_stream.zs, Z_FULL_FLUSH);
 	if (err != Z_OK) {
 		goto zlib_error;
 	}
 
-	ut_ad(!c_stream.avail_in);
+	ut_ad(!c_stream.zs.avail_in);
 
 	page_zip_dir_encode(page, buf_end, recs);
 
-	c_stream.next_in = (byte*) page + PAGE_ZIP_START;
+	c_stream.zs.next_in = (byte*) page + PAGE_ZIP_START;
 
 	storage = buf_end - n_dense * PAGE_ZIP_DIR_SLOT_SIZE;
 
@@ -1350,7 +1681,7 @@ page_zip_compress(
 	} else if (!page_is_leaf(page)) {
 		/* This is a node pointer page. */
 		err = page_zip_compress_node_ptrs(LOGFILE
-						  &c_stream, recs, n_dense,
+						  &c_stream.zs, recs, n_dense,
 						  index, storage, heap);
 		if (UNIV_UNLIKELY(err != Z_OK)) {
 			goto zlib_error;
@@ -1358,14 +1689,14 @@ page_zip_compress(
 	} else if (UNIV_LIKELY(trx_id_col == ULINT_UNDEFINED)) {
 		/* This is a leaf page in a secondary index. */
 		err = page_zip_compress_sec(LOGFILE
-					    &c_stream, recs, n_dense);
+					    &c_stream.zs, recs, n_dense);
 		if (UNIV_UNLIKELY(err != Z_OK)) {
 			goto zlib_error;
 		}
 	} else {
 		/* This is a leaf page in a clustered index. */
 		err = page_zip_compress_clust(LOGFILE
-					      &c_stream, recs, n_dense,
+					      &c_stream.zs, recs, n_dense,
 					      index, &n_blobs, trx_id_col,
 					      buf_end - PAGE_ZIP_DIR_SLOT_SIZE
 					      * page_get_n_recs(page),
@@ -1376,21 +1707,21 @@ page_zip_compress(
 	}
 
 	/* Finish the compression. */
-	ut_ad(!c_stream.avail_in);
+	ut_ad(!c_stream.zs.avail_in);
 	/* Compress any trailing garbage, in case the last record was
 	allocated from an originally longer space on the free list,
 	or the data of the last record from page_zip_compress_sec(). */
-	c_stream.avail_in
+	c_stream.zs.avail_in
 		= page_header_get_field(page, PAGE_HEAP_TOP)
-		- (c_stream.next_in - page);
-	ut_a(c_stream.avail_in <= UNIV_PAGE_SIZE - PAGE_ZIP_START - PAGE_DIR);
+		- (c_stream.zs.next_in - page);
+	ut_a(c_stream.zs.avail_in <= UNIV_PAGE_SIZE - PAGE_ZIP_START - PAGE_DIR);
 
-	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FINISH);
+	UNIV_MEM_ASSERT_RW(c_stream.zs.next_in, c_stream.zs.avail_in);
+	err = page_zip_deflate(&c_stream.zs, Z_FINISH);
 
 	if (UNIV_UNLIKELY(err != Z_STREAM_END)) {
 zlib_error:
-		deflateEnd(&c_stream);
+		page_zip_deflate_end(&c_stream.zs);
 		mem_heap_free(heap);
 err_exit:
 #ifdef PAGE_ZIP_COMPRESS_DBG
@@ -1405,25 +1736,26 @@ err_exit:
 		return(FALSE);
 	}
 
-	err = deflateEnd(&c_stream);
+	err = page_zip_deflate_end(&c_stream.zs);
 	ut_a(err == Z_OK);
 
-	ut_ad(buf + c_stream.total_out == c_stream.next_out);
-	ut_ad((ulint) (storage - c_stream.next_out) >= c_stream.avail_out);
+	ut_ad(buf + c_stream.zs.total_out == c_stream.zs.next_out);
+	ut_ad((ulint) (storage - c_stream.zs.next_out) >= c_stream.zs.avail_out);
 
 	/* Valgrind believes that zlib does not initialize some bits
 	in the last 7 or 8 bytes of the stream.  Make Valgrind happy. */
-	UNIV_MEM_VALID(buf, c_stream.total_out);
+	UNIV_MEM_VALID(buf, c_stream.zs.total_out);
 
 	/* Zero out the area reserved for the modification log.
 	Space for the end marker of the modification log is not
 	included in avail_out. */
-	memset(c_stream.next_out, 0, c_stream.avail_out + 1/* end marker */);
+	memset(c_stream.zs.next_out, 0,
+	       c_stream.zs.avail_out + 1/* end marker */);
 
 #ifdef UNIV_DEBUG
 	page_zip->m_start =
 #endif /* UNIV_DEBUG */
-		page_zip->m_end = PAGE_DATA + c_stream.total_out;
+		page_zip->m_end = PAGE_DATA + c_stream.zs.total_out;
 	page_zip->m_nonempty = FALSE;
 	page_zip->n_blobs = n_blobs;
 	/* Copy those header fields that will not be written
@@ -1453,7 +1785,7 @@ err_exit:
 	if (logfile) {
 		/* Record the compressed size of the block. */
 		byte sz[4];
-		mach_write_to_4(sz, c_stream.total_out);
+		mach_write_to_4(sz, c_stream.zs.total_out);
 		fseek(logfile, UNIV_PAGE_SIZE, SEEK_SET);
 		fwrite(sz, 1, sizeof sz, logfile);
 		fclose(logfile);
@@ -2150,7 +2482,7 @@ page_zip_decompress_node_ptrs(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			/* Apparently, n_dense has grown
 			since the time the page was last compressed. */
@@ -2187,7 +2519,7 @@ page_zip_decompress_node_ptrs(
 		d_stream->avail_out = rec_offs_data_size(offsets)
 			- REC_NODE_PTR_SIZE;
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			goto zlib_done;
 		case Z_OK:
@@ -2226,12 +2558,13 @@ page_zip_decompress_node_ptrs(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH)
+			  != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_node_ptrs:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2239,7 +2572,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2339,7 +2672,7 @@ page_zip_decompress_sec(
 			- d_stream->next_out;
 
 		if (UNIV_LIKELY(d_stream->avail_out)) {
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 				/* Apparently, n_dense has grown
 				since the time the page was last compressed. */
@@ -2384,12 +2717,13 @@ page_zip_decompress_sec(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH)
+			  != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_sec:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2397,7 +2731,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2489,7 +2823,7 @@ page_zip_decompress_clust_ext(
 
 			d_stream->avail_out = dst - d_stream->next_out;
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2519,7 +2853,7 @@ page_zip_decompress_clust_ext(
 			dst += len - BTR_EXTERN_FIELD_REF_SIZE;
 
 			d_stream->avail_out = dst - d_stream->next_out;
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2597,7 +2931,7 @@ page_zip_decompress_clust(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		err = inflate(d_stream, Z_SYNC_FLUSH);
+		err = page_zip_inflate(d_stream, Z_SYNC_FLUSH);
 		switch (err) {
 		case Z_STREAM_END:
 			/* Apparently, n_dense has grown
@@ -2655,7 +2989,7 @@ page_zip_decompress_clust(
 
 			d_stream->avail_out = dst - d_stream->next_out;
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2685,7 +3019,7 @@ page_zip_decompress_clust(
 		d_stream->avail_out = rec_get_end(rec, offsets)
 			- d_stream->next_out;
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 		case Z_OK:
 		case Z_BUF_ERROR:
@@ -2715,12 +3049,13 @@ page_zip_decompress_clust(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH)
+			  != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_clust:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2728,7 +3063,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2872,7 +3207,7 @@ page_zip_decompress(
 				page header fields that should not change
 				after page creation */
 {
-	z_stream	d_stream;
+	page_zip_stream_t d_stream;
 	dict_index_t*	index	= NULL;
 	rec_t**		recs;	/*!< dense page directory, sorted by address */
 	ulint		n_dense;/* number of user records on the page */
@@ -2956,35 +3291,38 @@ zlib_error:
 
 	page_zip_set_alloc(&d_stream, heap);
 
-	d_stream.next_in = page_zip->data + PAGE_DATA;
+	d_stream.zs.next_in = page_zip->data + PAGE_DATA;
 	/* Subtract the space reserved for
 	the page header and the end marker of the modification log. */
-	d_stream.avail_in = page_zip_get_size(page_zip) - (PAGE_DATA + 1);
-	d_stream.next_out = page + PAGE_ZIP_START;
-	d_stream.avail_out = UNIV_PAGE_SIZE - PAGE_ZIP_START;
+	d_stream.zs.avail_in = page_zip_get_size(page_zip) - (PAGE_DATA + 1);
+	d_stream.zs.next_out = page + PAGE_ZIP_START;
+	d_stream.zs.avail_out = UNIV_PAGE_SIZE - PAGE_ZIP_START;
 
-	if (UNIV_UNLIKELY(inflateInit2(&d_stream, UNIV_PAGE_SIZE_SHIFT)
-			  != Z_OK)) {
-		ut_error;
+	if (UNIV_UNLIKELY(page_zip_inflate_init(&d_stream, heap) != Z_OK)) {
+
+		page_zip_fail(("page_zip_decompress:"
+			       " page_zip_inflate_init()=%s\n",
+			       d_stream.zs.msg));
+		goto zlib_error;
 	}
 
 	/* Decode the zlib header and the index information. */
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream.zs, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
-			       " 1 inflate(Z_BLOCK)=%s\n", d_stream.msg));
+			       " 1 inflate(Z_BLOCK)=%s\n", d_stream.zs.msg));
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream.zs, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
-			       " 2 inflate(Z_BLOCK)=%s\n", d_stream.msg));
+			       " 2 inflate(Z_BLOCK)=%s\n", d_stream.zs.msg));
 		goto zlib_error;
 	}
 
 	index = page_zip_fields_decode(
-		page + PAGE_ZIP_START, d_stream.next_out,
+		page + PAGE_ZIP_START, d_stream.zs.next_out,
 		page_is_leaf(page) ? &trx_id_col : NULL);
 
 	if (UNIV_UNLIKELY(!index)) {
@@ -2994,7 +3332,7 @@ zlib_error:
 
 	/* Decompress the user records. */
 	page_zip->n_blobs = 0;
-	d_stream.next_out = page + PAGE_ZIP_START;
+	d_stream.zs.next_out = page + PAGE_ZIP_START;
 
 	{
 		/* Pre-allocate the offsets for rec_get_offsets_reverse(). */
@@ -3010,7 +3348,7 @@ zlib_error:
 		ulint	info_bits;
 
 		if (UNIV_UNLIKELY
-		    (!page_zip_decompress_node_ptrs(page_zip, &d_stream,
+		    (!page_zip_decompress_node_ptrs(page_zip, &d_stream.zs,
 						    recs, n_dense, index,
 						    offsets, heap))) {
 			goto err_exit;
@@ -3025,7 +3363,8 @@ zlib_error:
 		}
 	} else if (UNIV_LIKELY(trx_id_col == ULINT_UNDEFINED)) {
 		/* This is a leaf page in a secondary index. */
-		if (UNIV_UNLIKELY(!page_zip_decompress_sec(page_zip, &d_stream,
+		if (UNIV_UNLIKELY(!page_zip_decompress_sec(page_zip,
+							   &d_stream.zs,
 							   recs, n_dense,
 							   index, offsets))) {
 			goto err_exit;
@@ -3041,7 +3380,7 @@ err_exit:
 	} else {
 		/* This is a leaf page in a clustered index. */
 		if (UNIV_UNLIKELY(!page_zip_decompress_clust(page_zip,
-							     &d_stream, recs,
+							     &d_stream.zs, recs,
 							     n_dense, index,
 							     trx_id_col,
 							     offsets, heap))) {
@@ -36,6 +36,7 @@ Completed by Sunny Bains and Marko Makela
 #include "dict0crea.h"
 #include "dict0load.h"
 #include "btr0btr.h"
+#include "btr0bulk.h"
 #include "mach0data.h"
 #include "trx0rseg.h"
 #include "trx0trx.h"
@@ -55,6 +56,7 @@ Completed by Sunny Bains and Marko Makela
 #include "mem0mem.h"
 #include "log0log.h"
 #include "ut0sort.h"
+#include "srv0srv.h"
 #include "handler0alter.h"
 #include "ha_prototypes.h"
 
@@ -445,6 +447,22 @@ struct row_merge_dup_struct {
 /** Structure for reporting duplicate records. */
 typedef struct row_merge_dup_struct row_merge_dup_t;
 
+/** Structure for reporting the duplicate key found while merging the
+sorted runs of a unique index. It is shared by all threads sorting the
+indexes of a table, so that only the first duplicate is copied to the
+MySQL record. */
+struct row_merge_keydup_struct {
+	struct TABLE*		table;	/*!< MySQL table object */
+	os_fast_mutex_t		mutex;	/*!< protects index and
+					table->record[0] */
+	const dict_index_t*	index;	/*!< index whose duplicate key
+					was copied to table->record[0],
+					or NULL */
+};
+
+/** Structure for reporting duplicate keys found by a merge sort. */
+typedef struct row_merge_keydup_struct row_merge_keydup_t;
+
 /*************************************************************//**
 Report a duplicate key. */
 static
@@ -1480,8 +1498,8 @@ row_merge_blocks(
 	ulint*			foffs1,	/*!< in/out: offset of second
 					source list in the file */
 	merge_file_t*		of,	/*!< in/out: output file */
-	struct TABLE*		table,	/*!< in/out: MySQL table, for
-					reporting erroneous key value
+	row_merge_keydup_t*	keydup,	/*!< in/out: for reporting
+					erroneous key value
 					if applicable */
 	ulint			block_size)
 					/*!< in: merge block buffer size */
@@ -1545,8 +1563,14 @@ corrupt:
 		case 0:
 			if (UNIV_UNLIKELY
 			    (dict_index_is_unique(index) && !null_eq)) {
-				innobase_rec_to_mysql(table, mrec0,
-						      index, offsets0);
+				os_fast_mutex_lock(&keydup->mutex);
+				if (!keydup->index) {
+					keydup->index = index;
+					innobase_rec_to_mysql(keydup->table,
+							      mrec0, index,
+							      offsets0);
+				}
+				os_fast_mutex_unlock(&keydup->mutex);
 				mem_heap_free(heap);
 				return(DB_DUPLICATE_KEY);
 			}
@@ -1671,8 +1695,8 @@ row_merge(
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
 	int*			tmpfd,	/*!< in/out: temporary file handle */
-	struct TABLE*		table,	/*!< in/out: MySQL table, for
-					reporting erroneous key value
+	row_merge_keydup_t*	keydup,	/*!< in/out: for reporting
+					erroneous key value
 					if applicable */
 	ulint*			num_run,/*!< in/out: Number of runs remain
 					to be merged */
@@ -1722,7 +1746,7 @@ row_merge(
 		run_offset[n_run++] = of.offset;
 
 		error = row_merge_blocks(index, file, block,
-					 &foffs0, &foffs1, &of, table,
+					 &foffs0, &foffs1, &of, keydup,
 					 block_size);
 
 		if (error != DB_SUCCESS) {
@@ -1805,8 +1829,8 @@ row_merge_sort(
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
 	int*			tmpfd,	/*!< in/out: temporary file handle */
-	struct TABLE*		table,	/*!< in/out: MySQL table, for
-					reporting erroneous key value
+	row_merge_keydup_t*	keydup,	/*!< in/out: for reporting
+					erroneous key value
 					if applicable */
 	ulint			block_size)
 					/*!< in: merge block buffer size */
@@ -1838,7 +1862,7 @@ row_merge_sort(
 	/* Merge the runs until we have one big run */
 	do {
 		error = row_merge(trx, index, file, block, tmpfd,
-				  table, &num_runs, run_offset, block_size);
+				  keydup, &num_runs, run_offset, block_size);
 
 		UNIV_MEM_ASSERT_RW(run_offset, num_runs * sizeof *run_offset);
 
@@ -1897,7 +1921,9 @@ row_merge_copy_blobs(
 
 /********************************************************************//**
 Read sorted file containing index data tuples and insert these data
-tuples to the index
+tuples to the index. A secondary index, or a clustered index whose
+entries are prepared, is built bottom-up while the entries fit on
+the B-tree pages; the rest of the entries are inserted one by one.
 @return	DB_SUCCESS or error number */
 static
 ulint
@@ -1910,14 +1936,20 @@ row_merge_insert_index_tuples(
 					 the old table, or 0 if uncompressed */
 	int			fd,	/*!< in: file descriptor */
 	row_merge_block_t*	block,	/*!< in/out: file buffer */
-	ulint			block_size)
+	ulint			block_size,
 					/*! in: merge block buffer size */
+	ibool			prepared)
+					/*!< in: TRUE if the clustered index
+					entries already have their undo log
+					records and system columns, and fit
+					on the B-tree pages */
 {
 	const byte*		b;
 	que_thr_t*		thr;
 	ins_node_t*		node;
 	mem_heap_t*		tuple_heap;
 	mem_heap_t*		graph_heap;
+	btr_bulk_t*		bulk	= NULL;
 	ulint			error = DB_SUCCESS;
 	ulint			foffs = 0;
 	ulint*			offsets;
@@ -1926,6 +1958,15 @@ row_merge_insert_index_tuples(
 	ut_ad(index);
 	ut_ad(table);
 
+	if (prepared || !dict_index_is_clust(index)) {
+		bulk = btr_bulk_create(index, trx->id);
+
+		if (UNIV_UNLIKELY(!bulk) && prepared) {
+
+			return(DB_ERROR);
+		}
+	}
+
 	/* We use the insert query graph as the dummy graph
 	needed in the row module call */
 
@@ -1979,12 +2020,42 @@ row_merge_insert_index_tuples(
 						     dtuple, tuple_heap);
 			}
 
+			ut_ad(dtuple_validate(dtuple));
+
+			if (bulk) {
+				if (UNIV_LIKELY(!n_ext)) {
+					error = btr_bulk_insert(bulk, dtuple);
+
+					if (UNIV_LIKELY(error == DB_SUCCESS)) {
+
+						goto next_rec;
+					} else if (error != DB_TOO_BIG_RECORD) {
+
+						break;
+					}
+				}
+
+				/* Attach the tree built so far, and insert
+				the rest of the entries one by one. */
+
+				error = btr_bulk_finish(bulk, DB_SUCCESS);
+				bulk = NULL;
+
+				if (error != DB_SUCCESS) {
+
+					break;
+				} else if (prepared) {
+					/* The clustered index entries
+					must not be inserted again. */
+					error = DB_TOO_BIG_RECORD;
+					break;
+				}
+			}
+
 			node->row = dtuple;
 			node->table = table;
 			node->trx_id = trx->id;
 
-			ut_ad(dtuple_validate(dtuple));
-
 			do {
 				thr->run_node = thr;
 				thr->prev_node = thr->common.parent;
@@ -2010,6 +2081,11 @@ next_rec:
 		}
 	}
 
+	if (bulk) {
+		error = btr_bulk_finish(bulk, error);
+		bulk = NULL;
+	}
+
 	que_thr_stop_for_mysql_no_error(thr, trx);
 err_exit:
 	que_graph_free(thr->graph);
@@ -2735,6 +2811,194 @@ row_merge_drop_table(
 	return(row_drop_table_for_mysql(table->name, trx, FALSE));
 }
 
+/** Work shared by the threads merge sorting the indexes being created
+in row_merge_build_indexes(). Each thread repeatedly takes the next
+index and sorts it with its own buffers and temporary file. */
+struct row_merge_sort_work_struct {
+	trx_t*			trx;		/*!< transaction */
+	dict_index_t**		indexes;	/*!< indexes being created */
+	merge_file_t*		merge_files;	/*!< files containing the
+						index entries of indexes[] */
+	ulint*			errors;		/*!< error code of sorting
+						each of indexes[] */
+	ulint			n_indexes;	/*!< size of indexes[] */
+	ulint			block_size;	/*!< merge block buffer size */
+	row_merge_keydup_t*	keydup;		/*!< for reporting
+						erroneous key value */
+	os_fast_mutex_t		mutex;		/*!< protects next and
+						n_running */
+	ulint			next;		/*!< next index to sort */
+	ulint			n_running;	/*!< number of running
+						helper threads */
+	os_event_t		done;		/*!< set when n_running
+						drops to 0 */
+};
+
+/** Work shared by the threads merge sorting indexes. */
+typedef struct row_merge_sort_work_struct row_merge_sort_work_t;
+
+/*************************************************************//**
+Merge sorts indexes until none are left to sort. */
+static
+void
+row_merge_sort_indexes(
+/*===================*/
+	row_merge_sort_work_t*	work,	/*!< in/out: shared work */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd)	/*!< in/out: temporary file handle */
+{
+	for (;;) {
+		ulint	i;
+
+		os_fast_mutex_lock(&work->mutex);
+		i = work->next++;
+		os_fast_mutex_unlock(&work->mutex);
+
+		if (i >= work->n_indexes) {
+			return;
+		}
+
+		work->errors[i] = row_merge_sort(
+			work->trx, work->indexes[i], &work->merge_files[i],
+			block, tmpfd, work->keydup, work->block_size);
+	}
+}
+
+/*************************************************************//**
+Thread helping row_merge_build_indexes() to merge sort the indexes.
+@return	a dummy parameter */
+static
+os_thread_ret_t
+row_merge_sort_thread(
+/*==================*/
+	void*	arg)	/*!< in/out: row_merge_sort_work_t */
+{
+	row_merge_sort_work_t*	work = arg;
+	row_merge_block_t	block[4];
+	ulint			block_size = 3 * work->block_size;
+	void*			block_mem;
+	int			tmpfd;
+	ulint			i;
+
+	block_mem = os_mem_alloc_large(&block_size, FALSE);
+	tmpfd = row_merge_file_create_low();
+
+	/* If we are short of resources, leave the indexes to the
+	other threads. */
+
+	if (block_mem && tmpfd >= 0) {
+		for (i = 0; i < UT_ARR_SIZE(block); i++) {
+			block[i] = (row_merge_block_t) ((byte*) block_mem
+				+ i * work->block_size);
+		}
+
+		row_merge_sort_indexes(work, block, &tmpfd);
+	}
+
+	if (tmpfd >= 0) {
+		row_merge_file_destroy_low(tmpfd);
+	}
+
+	if (block_mem) {
+		os_mem_free_large(block_mem, block_size);
+	}
+
+	os_fast_mutex_lock(&work->mutex);
+	if (--work->n_running == 0) {
+		os_event_set(work->done);
+	}
+	os_fast_mutex_unlock(&work->mutex);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*************************************************************//**
+Merge sorts the files of index entries of several indexes in parallel,
+with up to innodb_merge_sort_threads threads. The calling thread takes
+part in the work.
+@return	DB_SUCCESS or error code; on error, trx->error_key_num is the
+position in indexes[] of the index that failed */
+static
+ulint
+row_merge_sort_all(
+/*===============*/
+	trx_t*			trx,	/*!< in: transaction */
+	dict_index_t**		indexes,/*!< in: indexes being built */
+	merge_file_t*		merge_files,/*!< in/out: files containing
+					the entries of indexes[] */
+	ulint			n_indexes,/*!< in: size of indexes[] */
+	row_merge_keydup_t*	keydup,	/*!< in/out: for reporting
+					erroneous key value */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd,	/*!< in/out: temporary file handle */
+	ulint			block_size)/*!< in: merge block buffer size */
+{
+	row_merge_sort_work_t	work;
+	ulint*			errors;
+	ulint			n_threads;
+	ulint			error = DB_SUCCESS;
+	ulint			i;
+
+	errors = mem_alloc(n_indexes * sizeof *errors);
+	n_threads = ut_min(srv_merge_sort_threads, n_indexes);
+
+	work.trx = trx;
+	work.indexes = indexes;
+	work.merge_files = merge_files;
+	work.errors = errors;
+	work.n_indexes = n_indexes;
+	work.block_size = block_size;
+	work.keydup = keydup;
+	work.next = 0;
+	work.n_running = n_threads - 1;
+	work.done = os_event_create(NULL);
+	os_fast_mutex_init(&work.mutex);
+
+	for (i = 0; i < n_indexes; i++) {
+		errors[i] = DB_SUCCESS;
+	}
+
+	for (i = 1; i < n_threads; i++) {
+		os_thread_create(row_merge_sort_thread, &work, NULL);
+	}
+
+	row_merge_sort_indexes(&work, block, tmpfd);
+
+	if (n_threads > 1) {
+		os_event_wait(work.done);
+	}
+
+	os_event_free(work.done);
+	os_fast_mutex_free(&work.mutex);
+
+	for (i = 0; i < n_indexes; i++) {
+		if (errors[i] != DB_SUCCESS) {
+			error = errors[i];
+
+			/* Report the index whose duplicate key value
+			was copied to the MySQL record */
+			if (keydup->index) {
+				error = DB_DUPLICATE_KEY;
+				while (indexes[i] != keydup->index) {
+					i = (i + 1) % n_indexes;
+				}
+			}
+
+			trx->error_key_num = i;
+			break;
+		}
+	}
+
+	mem_free(errors);
+
+	return(error);
+}
+
 /*********************************************************************//**
 Build indexes on a table by reading a clustered index,
 creating a temporary file containing index entries, merge sorting
@@ -2757,6 +3021,7 @@ row_merge_build_indexes(
 					if applicable */
 {
 	merge_file_t*		merge_files;
+	row_merge_keydup_t	keydup;
 	/* Some code uses block[1] as the synonym for block + block_size.  So
 	we initialize block[3] to the address boundary of block[2], even
 	though space for 3 only buffers is allocated. */
@@ -2819,6 +3084,10 @@ row_merge_build_indexes(
 	duplicate keys. */
 	innobase_rec_reset(table);
 
+	keydup.table = table;
+	keydup.index = NULL;
+	os_fast_mutex_init(&keydup.mutex);
+
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
 
@@ -2828,34 +3097,40 @@ row_merge_build_indexes(
 
 	if (error != DB_SUCCESS) {
 
-		goto func_exit;
+		goto keydup_exit;
 	}
 
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	error = row_merge_sort_all(trx, indexes, merge_files, n_indexes,
+				   &keydup, block, &tmpfd,
+				   merge_sort_block_size);
+
+	if (error != DB_SUCCESS) {
+
+		goto keydup_exit;
+	}
+
 	for (i = 0; i < n_indexes; i++) {
-		error = row_merge_sort(trx, indexes[i], &merge_files[i],
-				       block, &tmpfd, table,
-				       merge_sort_block_size);
-
-		if (error == DB_SUCCESS) {
-			error = row_merge_insert_index_tuples(
-				trx, indexes[i], new_table,
-				dict_table_zip_size(old_table),
-				merge_files[i].fd, block,
-				merge_sort_block_size);
-		}
+		error = row_merge_insert_index_tuples(
+			trx, indexes[i], new_table,
+			dict_table_zip_size(old_table),
+			merge_files[i].fd, block,
+			merge_sort_block_size, FALSE);
 
 		/* Close the temporary file to free up space. */
 		row_merge_file_destroy(&merge_files[i]);
 
 		if (error != DB_SUCCESS) {
 			trx->error_key_num = i;
-			goto func_exit;
+			goto keydup_exit;
 		}
 	}
 
+keydup_exit:
+	os_fast_mutex_free(&keydup.mutex);
+
 func_exit:
 	row_merge_file_destroy_low(tmpfd);
 
@@ -2868,3 +3143,299 @@ func_exit:
 
 	return(error);
 }
+
+/** Bulk load of an empty table. The index entries of the inserted rows
+are sorted like in row_merge_build_indexes(), and the indexes are built
+bottom-up when the load is finished. */
+struct row_merge_bulk_struct {
+	dict_table_t*		table;		/*!< table being loaded */
+	dict_index_t**		indexes;	/*!< indexes of the table */
+	ulint			n_indexes;	/*!< size of indexes[] */
+	row_merge_buf_t**	bufs;		/*!< sort buffer of each index */
+	merge_file_t*		files;		/*!< temporary file of each
+						index */
+	ulint			block_size;	/*!< merge block buffer size */
+	row_merge_block_t	block[4];	/*!< file buffers, see
+						row_merge_build_indexes() */
+	void*			block_mem;	/*!< memory of block[] */
+	ulint			block_mem_size;	/*!< size of block_mem */
+	int			tmpfd;		/*!< temporary file for
+						merging */
+	row_merge_keydup_t	keydup;		/*!< for reporting duplicate
+						keys */
+};
+
+/*********************************************************************//**
+Starts a bulk load of an empty table. All indexes of the table must be
+empty and uncompressed. The caller must hold an exclusive lock on the
+table until the load is finished.
+@return	own: bulk load, or NULL if the table cannot be bulk loaded */
+UNIV_INTERN
+row_merge_bulk_t*
+row_merge_bulk_create(
+/*==================*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_table_t*	table,		/*!< in: table to load */
+	struct TABLE*	mysql_table)	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+{
+	row_merge_bulk_t*	bulk;
+	dict_index_t*		index;
+	ulint			n_indexes = 0;
+	ulint			i;
+
+	for (index = dict_table_get_first_index(table); index;
+	     index = dict_table_get_next_index(index)) {
+
+		if (dict_index_is_corrupted(index)
+		    || index->to_be_dropped
+		    || *index->name == TEMP_INDEX_PREFIX
+		    || !btr_bulk_is_possible(index)) {
+
+			return(NULL);
+		}
+
+		n_indexes++;
+	}
+
+	bulk = mem_zalloc(sizeof *bulk);
+	bulk->table = table;
+	bulk->n_indexes = n_indexes;
+	bulk->indexes = mem_alloc(n_indexes * sizeof *bulk->indexes);
+	bulk->bufs = mem_zalloc(n_indexes * sizeof *bulk->bufs);
+	bulk->files = mem_alloc(n_indexes * sizeof *bulk->files);
+	bulk->block_size = thd_merge_sort_block_size(trx->mysql_thd);
+	bulk->block_mem_size = 3 * bulk->block_size;
+	bulk->block_mem = os_mem_alloc_large(&bulk->block_mem_size, FALSE);
+	bulk->tmpfd = -1;
+
+	bulk->keydup.table = mysql_table;
+	bulk->keydup.index = NULL;
+	os_fast_mutex_init(&bulk->keydup.mutex);
+
+	for (i = 0, index = dict_table_get_first_index(table);
+	     i < n_indexes; i++, index = dict_table_get_next_index(index)) {
+		bulk->indexes[i] = index;
+		bulk->files[i].fd = -1;
+	}
+
+	if (UNIV_UNLIKELY(!bulk->block_mem)) {
+
+		goto err_exit;
+	}
+
+	for (i = 0; i < UT_ARR_SIZE(bulk->block); i++) {
+		bulk->block[i] = (row_merge_block_t) ((byte*) bulk->block_mem
+			+ i * bulk->block_size);
+	}
+
+	for (i = 0; i < n_indexes; i++) {
+		if (row_merge_file_create(&bulk->files[i]) < 0) {
+
+			goto err_exit;
+		}
+
+		bulk->bufs[i] = row_merge_buf_create(bulk->indexes[i],
+						     bulk->block_size);
+	}
+
+	bulk->tmpfd = row_merge_file_create_low();
+
+	if (bulk->tmpfd < 0) {
+err_exit:
+		row_merge_bulk_free(bulk);
+
+		return(NULL);
+	}
+
+	return(bulk);
+}
+
+/*********************************************************************//**
+Sorts the sort buffer of an index and writes it to the temporary file
+of the index.
+@return	DB_SUCCESS or error code */
+static
+ulint
+row_merge_bulk_write(
+/*=================*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	trx_t*			trx,	/*!< in/out: transaction */
+	ulint			i)	/*!< in: position of the index
+					in bulk->indexes[] */
+{
+	row_merge_buf_t*	buf	= bulk->bufs[i];
+	merge_file_t*		file	= &bulk->files[i];
+
+	if (dict_index_is_unique(buf->index)) {
+		row_merge_dup_t	dup;
+
+		dup.index = buf->index;
+		dup.table = bulk->keydup.table;
+		dup.n_dup = 0;
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			trx->error_info = bulk->indexes[i];
+
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, file, bulk->block);
+
+	if (!row_merge_write(file->fd, file->offset++,
+			     bulk->block[0], bulk->block_size)) {
+
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	UNIV_MEM_INVALID(bulk->block[0], bulk->block_size);
+	bulk->bufs[i] = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Adds a row to a bulk load. The undo log record of the row must have been
+written, and the system columns of the row must be set.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_add(
+/*===============*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	trx_t*			trx,	/*!< in/out: transaction */
+	const dtuple_t*		row)	/*!< in: row, indexed by col_no */
+{
+	ulint	i;
+
+	for (i = 0; i < bulk->n_indexes; i++) {
+		ulint	error;
+
+		if (UNIV_LIKELY(row_merge_buf_add(bulk->bufs[i], row, NULL,
+						  bulk->block_size))) {
+			bulk->files[i].n_rec++;
+			continue;
+		}
+
+		error = row_merge_bulk_write(bulk, trx, i);
+
+		if (error != DB_SUCCESS) {
+
+			return(error);
+		}
+
+		if (UNIV_UNLIKELY(!row_merge_buf_add(bulk->bufs[i], row, NULL,
+						     bulk->block_size))) {
+			/* An empty buffer should have enough
+			room for at least one record. */
+			ut_error;
+		}
+
+		bulk->files[i].n_rec++;
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Finishes a bulk load: sorts the entries of all indexes, which finds
+any duplicate keys before anything is loaded, and then builds the
+indexes bottom-up. On error, trx->error_info is the index that failed.
+The bulk load must still be freed with row_merge_bulk_free().
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+row_merge_bulk_finish(
+/*==================*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	trx_t*			trx)	/*!< in/out: transaction */
+{
+	ulint	error;
+	ulint	i;
+
+	trx->op_info = "sorting index entries";
+
+	for (i = 0; i < bulk->n_indexes; i++) {
+		error = row_merge_bulk_write(bulk, trx, i);
+
+		if (error != DB_SUCCESS) {
+
+			goto func_exit;
+		}
+	}
+
+	error = row_merge_sort_all(trx, bulk->indexes, bulk->files,
+				   bulk->n_indexes, &bulk->keydup,
+				   bulk->block, &bulk->tmpfd,
+				   bulk->block_size);
+
+	if (error != DB_SUCCESS) {
+		trx->error_info = bulk->indexes[trx->error_key_num];
+
+		goto func_exit;
+	}
+
+	/* Build the clustered index first, so that the undo log
+	records of the rows find the rows if the load fails later. */
+
+	for (i = 0; i < bulk->n_indexes; i++) {
+		error = row_merge_insert_index_tuples(
+			trx, bulk->indexes[i], bulk->table, 0,
+			bulk->files[i].fd, bulk->block,
+			bulk->block_size, TRUE);
+
+		/* Close the temporary file to free up space. */
+		row_merge_file_destroy(&bulk->files[i]);
+
+		if (error != DB_SUCCESS) {
+			trx->error_info = bulk->indexes[i];
+
+			goto func_exit;
+		}
+	}
+
+func_exit:
+	trx->op_info = "";
+
+	return(error);
+}
+
+/*********************************************************************//**
+Frees a bulk load. The rows that were not loaded by
+row_merge_bulk_finish() are discarded. */
+UNIV_INTERN
+void
+row_merge_bulk_free(
+/*================*/
+	row_merge_bulk_t*	bulk)	/*!< in,own: bulk load */
+{
+	ulint	i;
+
+	for (i = 0; i < bulk->n_indexes; i++) {
+		if (bulk->bufs[i]) {
+			row_merge_buf_free(bulk->bufs[i]);
+		}
+
+		row_merge_file_destroy(&bulk->files[i]);
+	}
+
+	if (bulk->tmpfd >= 0) {
+		row_merge_file_destroy_low(bulk->tmpfd);
+	}
+
+	if (bulk->block_mem) {
+		os_mem_free_large(bulk->block_mem, bulk->block_mem_size);
+	}
+
+	os_fast_mutex_free(&bulk->keydup.mutex);
+
+	mem_free(bulk->files);
+	mem_free(bulk->bufs);
+	mem_free(bulk->indexes);
+	mem_free(bulk);
+}
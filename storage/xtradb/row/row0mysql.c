@@ -34,6 +34,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0sel.h"
+#include "btr0bulk.h"
 #include "row0upd.h"
 #include "row0row.h"
 #include "que0que.h"
@@ -52,6 +53,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "btr0sea.h"
 #include "fil0fil.h"
 #include "ibuf0ibuf.h"
+#include "page0zip.h"
 #include "ha_prototypes.h"
 #include "m_string.h"
 #include "my_sys.h"
@@ -804,6 +806,10 @@ row_prebuilt_free(
 		mem_free(prebuilt->mysql_template);
 	}
 
+	if (prebuilt->bulk) {
+		row_merge_bulk_free(prebuilt->bulk);
+	}
+
 	if (prebuilt->ins_graph) {
 		que_graph_free_recursive(prebuilt->ins_graph);
 	}
@@ -1292,6 +1298,208 @@ run_again:
 	return((int) err);
 }
 
+/*********************************************************************//**
+Starts a bulk load of an empty table for MySQL. The table is locked
+in exclusive mode, and the rows passed to row_bulk_insert_for_mysql()
+are sorted and loaded into the indexes by row_bulk_end_for_mysql().
+If the table cannot be bulk loaded, prebuilt->bulk stays NULL and the
+rows must be inserted with row_insert_for_mysql(). A table that is not
+empty is not locked.
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_start_for_mysql(
+/*=====================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	struct TABLE*	mysql_table)	/*!< in/out: MySQL table, for
+					reporting duplicate key values */
+{
+	dict_table_t*	table	= prebuilt->table;
+	trx_t*		trx	= prebuilt->trx;
+	ibool		had_lock;
+	int		err;
+
+	ut_ad(!prebuilt->bulk);
+
+	/* The rows of a compressed table could be moved to
+	externally stored columns on the fly, and a foreign key
+	must be checked row by row. */
+
+	if (trx->fake_changes
+	    || table->ibd_file_missing
+	    || dict_table_zip_size(table)
+	    || UT_LIST_GET_LEN(table->foreign_list)
+	    || UT_LIST_GET_LEN(table->referenced_list)
+	    || srv_created_new_raw || srv_force_recovery) {
+
+		return(DB_SUCCESS);
+	}
+
+	/* Do not lock a table that already has rows. Without the lock
+	the check can be outdated, so it is repeated below. */
+
+	if (!btr_bulk_is_possible(dict_table_get_first_index(table))) {
+
+		return(DB_SUCCESS);
+	}
+
+	/* Keep other transactions away from the table until commit,
+	so that the indexes stay empty until the rows are loaded. */
+
+	had_lock = lock_table_has_x(trx, table);
+
+	err = row_lock_table_for_mysql(prebuilt, table, LOCK_X);
+
+	if (err != DB_SUCCESS) {
+
+		return(err);
+	}
+
+	prebuilt->bulk = row_merge_bulk_create(trx, table, mysql_table);
+
+	if (!prebuilt->bulk && !had_lock) {
+		/* Rows were inserted before we got the lock, or the
+		load could not be started. Inserting the rows one by
+		one does not need the exclusive lock. */
+
+		lock_table_x_unlock(trx, table);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Adds a row to the bulk load started by row_bulk_start_for_mysql().
+Duplicate keys are only detected by row_bulk_end_for_mysql().
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_insert_for_mysql(
+/*======================*/
+	byte*		mysql_rec,	/*!< in: row in the MySQL format */
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct in
+					MySQL handle */
+{
+	trx_t*		trx		= prebuilt->trx;
+	dict_table_t*	table		= prebuilt->table;
+	dict_index_t*	clust_index	= dict_table_get_first_index(table);
+	ins_node_t*	node;
+	dtuple_t*	entry;
+	mem_heap_t*	heap;
+	roll_ptr_t	roll_ptr;
+	ulint		err;
+
+	ut_ad(prebuilt->bulk);
+
+	trx->op_info = "inserting";
+
+	if (prebuilt->ins_node == NULL) {
+		row_get_prebuilt_insert_row(prebuilt);
+	}
+
+	node = prebuilt->ins_node;
+
+	row_mysql_convert_row_to_innobase(node->row, prebuilt, mysql_rec);
+
+	heap = mem_heap_create(1024);
+
+	entry = row_build_index_entry(node->row, NULL, clust_index, heap);
+
+	if (page_zip_rec_needs_ext(rec_get_converted_size(clust_index,
+							  entry, 0),
+				   dict_table_is_comp(table),
+				   dtuple_get_n_fields(entry), 0)) {
+		/* Columns would have to be stored externally.
+		Load the rows so far, and insert the rest one by one. */
+
+		mem_heap_free(heap);
+
+		err = row_bulk_end_for_mysql(prebuilt, TRUE);
+
+		if (err != DB_SUCCESS) {
+
+			return((int) err);
+		}
+
+		return(row_insert_for_mysql(mysql_rec, prebuilt));
+	}
+
+	if (!dict_index_is_unique(clust_index)) {
+		dict_sys_write_row_id(node->row_id_buf,
+				      dict_sys_get_new_row_id());
+	}
+
+	trx_write_trx_id(node->trx_id_buf, trx->id);
+
+	/* The undo log record allows the rollback to remove the row,
+	if it was loaded, and the purge to ignore it otherwise. */
+
+	err = trx_undo_report_row_operation(
+		0, TRX_UNDO_INSERT_OP,
+		que_fork_get_first_thr(prebuilt->ins_graph),
+		clust_index, entry, NULL, 0, NULL, &roll_ptr);
+
+	mem_heap_free(heap);
+
+	if (err == DB_SUCCESS) {
+		trx_write_roll_ptr(dfield_get_data(
+					   dtuple_get_nth_field(
+						   node->row,
+						   dict_table_get_sys_col_no(
+							   table,
+							   DATA_ROLL_PTR))),
+				   roll_ptr);
+
+		err = row_merge_bulk_add(prebuilt->bulk, trx, node->row);
+	}
+
+	if (err == DB_SUCCESS) {
+		table->stat_n_rows++;
+
+		if (table->stat_n_rows == 0) {
+			/* Avoid wrap-over */
+			table->stat_n_rows--;
+		}
+
+		srv_n_rows_inserted++;
+		row_update_statistics_if_needed(table);
+	}
+
+	trx->op_info = "";
+
+	return((int) err);
+}
+
+/*********************************************************************//**
+Ends the bulk load started by row_bulk_start_for_mysql().
+@return	error code or DB_SUCCESS */
+UNIV_INTERN
+int
+row_bulk_end_for_mysql(
+/*===================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	ibool		load)		/*!< in: TRUE=load the rows into
+					the indexes, FALSE=discard them */
+{
+	ulint	err	= DB_SUCCESS;
+
+	if (!prebuilt->bulk) {
+
+		return((int) err);
+	}
+
+	if (load) {
+		err = row_merge_bulk_finish(prebuilt->bulk, prebuilt->trx);
+	}
+
+	row_merge_bulk_free(prebuilt->bulk);
+	prebuilt->bulk = NULL;
+
+	return((int) err);
+}
+
 /*********************************************************************//**
 Builds a dummy query graph used in selects. */
 UNIV_INTERN
@@ -75,6 +75,9 @@ row_purge_node_create(
 
 	node->heap = mem_heap_create(256);
 
+	node->batch = FALSE;
+	node->recs = NULL;
+
 	return(node);
 }
 
@@ -743,9 +746,25 @@ row_purge(
 	ut_ad(node);
 	ut_ad(thr);
 
-	node->undo_rec = trx_purge_fetch_next_rec(&node->roll_ptr,
-						  &node->reservation,
-						  node->heap);
+	if (node->batch) {
+		/* The records were fetched by the purge coordinator,
+		which also releases their reservations */
+		trx_purge_rec_t*	rec = node->recs;
+
+		if (rec) {
+			node->recs = rec->next;
+			node->undo_rec = rec->undo_rec;
+			node->roll_ptr = rec->roll_ptr;
+			node->reservation = rec->reservation;
+		} else {
+			node->undo_rec = NULL;
+		}
+	} else {
+		node->undo_rec = trx_purge_fetch_next_rec(&node->roll_ptr,
+							  &node->reservation,
+							  node->heap);
+	}
+
 	if (!node->undo_rec) {
 		/* Purge completed for this query thread */
 
@@ -778,7 +797,10 @@ row_purge(
 	}
 
 	/* Do some cleanup */
-	trx_purge_rec_release(node->reservation);
+	if (!node->batch) {
+		trx_purge_rec_release(node->reservation);
+	}
+
 	mem_heap_empty(node->heap);
 
 	thr->run_node = node;
@@ -155,6 +155,13 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 UNIV_INTERN my_bool	srv_use_native_aio = TRUE;
 
+/* If this flag is TRUE, Linux native aio uses io_uring (provided we
+compiled Innobase with it in and the kernel supports it): the requests
+are queued in a submission ring per aio segment, and the i/o handler
+threads reap the completions from the completion ring of their
+segment. */
+UNIV_INTERN my_bool	srv_use_io_uring = FALSE;
+
 #ifdef __WIN__
 /* Windows native condition variables. We use runtime loading / function
 pointers, because they are not available on Windows Server 2003 and
@@ -176,6 +183,8 @@ UNIV_INTERN char**	srv_data_file_names = NULL;
 UNIV_INTERN ulint*	srv_data_file_sizes = NULL;
 
 UNIV_INTERN char*	srv_doublewrite_file = NULL;
+/* number of independently flushed shards of the doublewrite buffer */
+UNIV_INTERN ulong	srv_doublewrite_shards = 1;
 
 UNIV_INTERN ibool	srv_recovery_stats = FALSE;
 
@@ -242,6 +251,8 @@ UNIV_INTERN my_bool	srv_use_sys_malloc	= TRUE;
 UNIV_INTERN ulint	srv_buf_pool_size	= ULINT_MAX;
 /* force virtual page preallocation (prefault) */
 UNIV_INTERN my_bool	srv_buf_pool_populate	= FALSE;
+/* place the buffer pool instances and the i/o threads on NUMA nodes */
+UNIV_INTERN my_bool	srv_buf_pool_numa	= FALSE;
 /* requested number of buffer pool instances */
 UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
 /* previously requested size */
@@ -305,12 +316,25 @@ that during a time of heavy update/insert activity. */
 
 UNIV_INTERN ulong	srv_max_buf_pool_modified_pct	= 75;
 
-/* the number of purge threads to use from the worker pool (currently 0 or 1).*/
+/* the number of purge threads to use: the purge thread and
+srv_n_purge_threads - 1 purge worker threads, or 0 to purge in
+the master thread */
 UNIV_INTERN ulong srv_n_purge_threads = 0;
 
 /* the number of pages to purge in one batch */
 UNIV_INTERN ulong srv_purge_batch_size = 20;
 
+/* the number of threads sorting the indexes in fast index creation */
+UNIV_INTERN ulong srv_merge_sort_threads = 1;
+
+/* percentage of each B-tree page filled by a bulk load; 100 leaves
+1/16 of the page free */
+UNIV_INTERN ulong srv_fill_factor = 100;
+
+/* if nonzero, one of this many page latch acquisitions is sampled by
+the latch profiler, and all rw-lock OS waits are recorded */
+UNIV_INTERN ulong srv_latch_profile = 0;
+
 /* the number of rollback segments to use */
 UNIV_INTERN ulong srv_rollback_segments = TRX_SYS_N_RSEGS;
 
@@ -416,12 +440,14 @@ UNIV_INTERN ibool       srv_use_posix_fallocate = FALSE;
 
 UNIV_INTERN ibool	srv_use_checksums = TRUE;
 UNIV_INTERN ibool	srv_fast_checksum = FALSE;
+UNIV_INTERN ulong	srv_checksum_algorithm = SRV_CHECKSUM_ALGORITHM_INNODB;
 
 UNIV_INTERN ulong	srv_replication_delay		= 0;
 
 UNIV_INTERN long long	srv_ibuf_max_size = 0;
 UNIV_INTERN ulong	srv_ibuf_active_contract = 0; /* 0:disable 1:enable */
 UNIV_INTERN ulong	srv_ibuf_accel_rate = 100;
+UNIV_INTERN ulong	srv_ibuf_sequential_merge = 0; /* 0:disable 1:enable */
 #define PCT_IBUF_IO(pct) ((ulint) (srv_io_capacity * srv_ibuf_accel_rate * ((double) pct / 10000.0)))
 
 UNIV_INTERN ulint	srv_checkpoint_age_target = 0;
@@ -2015,8 +2041,8 @@ srv_refresh_innodb_monitor_stats(void)
 
 	os_aio_refresh_stats();
 
-	btr_cur_n_sea_old = btr_cur_n_sea;
-	btr_cur_n_non_sea_old = btr_cur_n_non_sea;
+	btr_cur_n_sea_old = ut_counter_get(&btr_cur_n_sea);
+	btr_cur_n_non_sea_old = ut_counter_get(&btr_cur_n_non_sea);
 
 	log_refresh_stats();
 
@@ -2121,12 +2147,12 @@ srv_printf_innodb_monitor(
 
 	fprintf(file,
 		"%.2f hash searches/s, %.2f non-hash searches/s\n",
-		(btr_cur_n_sea - btr_cur_n_sea_old)
+		(ut_counter_get(&btr_cur_n_sea) - btr_cur_n_sea_old)
 		/ time_elapsed,
-		(btr_cur_n_non_sea - btr_cur_n_non_sea_old)
+		(ut_counter_get(&btr_cur_n_non_sea) - btr_cur_n_non_sea_old)
 		/ time_elapsed);
-	btr_cur_n_sea_old = btr_cur_n_sea;
-	btr_cur_n_non_sea_old = btr_cur_n_non_sea;
+	btr_cur_n_sea_old = ut_counter_get(&btr_cur_n_sea);
+	btr_cur_n_non_sea_old = ut_counter_get(&btr_cur_n_non_sea);
 
 	fputs("---\n"
 	      "LOG\n"
@@ -2376,9 +2402,9 @@ srv_export_innodb_status(void)
 			+= (UT_LIST_GET_LEN(table->heap->base) - 1);
 	}
 	export_vars.innodb_adaptive_hash_hash_searches
-		= btr_cur_n_sea;
+		= ut_counter_get(&btr_cur_n_sea);
 	export_vars.innodb_adaptive_hash_non_hash_searches
-		= btr_cur_n_non_sea;
+		= ut_counter_get(&btr_cur_n_non_sea);
 	export_vars.innodb_background_log_sync
 		= srv_log_writes_and_flush;
 	export_vars.innodb_data_pending_reads
@@ -2395,6 +2421,8 @@ srv_export_innodb_status(void)
 	export_vars.innodb_data_written = srv_data_written;
 	export_vars.innodb_dict_tables= (dict_sys ? UT_LIST_GET_LEN(dict_sys->table_LRU) : 0);
 	export_vars.innodb_buffer_pool_read_requests = stat.n_page_gets;
+	export_vars.innodb_buffer_pool_read_requests_numa_local
+		= stat.n_page_gets_numa_local;
 	export_vars.innodb_buffer_pool_write_requests
 		= srv_buf_pool_write_requests;
 	export_vars.innodb_buffer_pool_wait_free = srv_buf_pool_wait_free;
@@ -2507,6 +2535,10 @@ srv_export_innodb_status(void)
 		= purge_sys->purge_trx_no;
 	export_vars.innodb_purge_undo_no
 		= purge_sys->purge_undo_no;
+	export_vars.innodb_purge_lag
+		= trx_sys->max_trx_id > purge_sys->purge_trx_no
+		? trx_sys->max_trx_id - purge_sys->purge_trx_no : 0;
+	export_vars.innodb_purge_dml_delay = srv_dml_needed_delay;
 	export_vars.innodb_current_row_locks
 		= lock_sys->rec_num;
 
@@ -4077,7 +4109,7 @@ srv_purge_thread(
 	ulint		next_itr_time;
 	ib_int64_t	sig_count;
 
-	ut_a(srv_n_purge_threads == 1);
+	ut_a(srv_n_purge_threads >= 1);
 
 #ifdef UNIV_PFS_THREAD
 	pfs_register_thread(srv_purge_thread_key);
@@ -4184,6 +4216,45 @@ srv_purge_thread(
 	OS_THREAD_DUMMY_RETURN;	/* Not reached, avoid compiler warning */
 }
 
+/*********************************************************************//**
+Purge worker thread, purging the undo log records attached to it by the
+purge thread.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+srv_purge_worker_thread(
+/*====================*/
+	void*	arg)	/*!< in: worker number, 0..srv_n_purge_threads - 2 */
+{
+	ulint	id = (ulint) arg;
+
+	ut_a(id < purge_sys->n_workers);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(srv_purge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: Purge worker thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	while (trx_purge_worker_run(id)) {
+		/* Purge the batches handed out by the purge thread */
+	}
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: Purge worker thread exiting, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;	/* Not reached, avoid compiler warning */
+}
+
 /**********************************************************************//**
 Enqueues a task to server task queue and releases a worker thread, if there
 is a suspended one. */
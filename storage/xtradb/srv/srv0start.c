@@ -481,6 +481,11 @@ io_handler_thread(
 	pfs_register_thread(io_handler_thread_key);
 #endif /* UNIV_PFS_THREAD */
 
+	if (srv_buf_pool_numa && os_numa_n_nodes) {
+		/* Spread the i/o threads over the NUMA nodes */
+		os_thread_bind_to_numa_node(segment % os_numa_n_nodes);
+	}
+
 	while (srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
 		fil_aio_wait(segment);
 	}
@@ -1342,6 +1347,10 @@ innobase_start_or_create_for_mysql(void)
 	srv_is_being_started = TRUE;
 	srv_startup_is_before_trx_rollback_phase = TRUE;
 
+#ifndef LINUX_IO_URING
+	srv_use_io_uring = FALSE;
+#endif /* !LINUX_IO_URING */
+
 #ifdef __WIN__
 	switch (os_get_os_version()) {
 	case OS_WIN95:
@@ -1370,12 +1379,20 @@ innobase_start_or_create_for_mysql(void)
 		break;
 	}
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(UNIV_LINUX_AIO)
+
+# ifndef LINUX_NATIVE_AIO
+	/* Without libaio, io_uring is the only native aio interface */
+	if (!srv_use_io_uring) {
+		srv_use_native_aio = FALSE;
+	}
+# endif /* !LINUX_NATIVE_AIO */
 
 	if (srv_use_native_aio) {
 		ut_print_timestamp(stderr);
 		fprintf(stderr,
-			" InnoDB: Using Linux native AIO\n");
+			" InnoDB: Using Linux native AIO%s\n",
+			srv_use_io_uring ? " with io_uring" : "");
 	}
 #else
 	/* Currently native AIO is supported only on windows and linux
@@ -1385,6 +1402,10 @@ innobase_start_or_create_for_mysql(void)
 
 #endif
 
+	if (!srv_use_native_aio) {
+		srv_use_io_uring = FALSE;
+	}
+
 	if (srv_file_flush_method_str == NULL) {
 		/* These are the default options */
 
@@ -1540,6 +1561,11 @@ innobase_start_or_create_for_mysql(void)
 			" sub-system\n");
 #if defined(LINUX_NATIVE_AIO)
                 fprintf(stderr, "You can try increasing system fs.aio-max-nr to 1048576 or larger or setting innodb_use_native_aio = 0 in my.cnf\n");
+#endif
+#if defined(LINUX_IO_URING)
+		if (srv_use_io_uring) {
+			fprintf(stderr, "You can try setting innodb_use_io_uring = 0 in my.cnf\n");
+		}
 #endif
                 return(DB_ERROR);
         }
@@ -1562,8 +1588,12 @@ innobase_start_or_create_for_mysql(void)
 			((double) srv_buf_pool_size) / (1024 * 1024));
 	}
 
+	if (srv_buf_pool_numa) {
+		os_numa_init();
+	}
+
 	err = buf_pool_init(srv_buf_pool_size, (ibool) srv_buf_pool_populate,
-			    srv_buf_pool_instances);
+			    (ibool) srv_buf_pool_numa, srv_buf_pool_instances);
 
 	ut_print_timestamp(stderr);
 	fprintf(stderr,
@@ -2077,20 +2107,22 @@ innobase_start_or_create_for_mysql(void)
 	os_thread_create(&srv_master_thread, NULL, thread_ids
 			 + (1 + SRV_MAX_N_IO_THREADS));
 
-	/* Currently we allow only a single purge thread. */
-	ut_a(srv_n_purge_threads == 0 || srv_n_purge_threads == 1);
-
 	/* If the user has requested a separate purge thread then
-	start the purge thread. */
-	if (srv_n_purge_threads == 1) {
+	start the purge thread, and the worker threads helping it. */
+	if (srv_n_purge_threads >= 1) {
 		os_thread_create(&srv_purge_thread, NULL, NULL);
+
+		for (i = 0; i + 1 < srv_n_purge_threads; i++) {
+			os_thread_create(&srv_purge_worker_thread,
+					 (void*) i, NULL);
+		}
 	}
 
 	/* Wait for the purge and master thread to startup. */
 
 	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 		if (srv_thread_has_reserved_slot(SRV_MASTER) == ULINT_UNDEFINED
-		    || (srv_n_purge_threads == 1
+		    || (srv_n_purge_threads >= 1
 			&& srv_thread_has_reserved_slot(SRV_WORKER)
 			== ULINT_UNDEFINED)) {
 
@@ -2380,8 +2412,10 @@ innobase_shutdown_for_mysql(void)
 		/* c. We wake the master thread so that it exits */
 		srv_wake_master_thread();
 
-		/* d. We wake the purge thread so that it exits */
+		/* d. We wake the purge thread and the purge worker
+		threads so that they exit */
 		srv_wake_purge_thread();
+		trx_purge_wake_workers();
 
 		/* e. Exit the i/o threads */
 
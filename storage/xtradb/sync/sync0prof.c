@@ -0,0 +1,292 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Monty Program Ab. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+Place, Suite 330, Boston, MA 02111-1307 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file sync/sync0prof.c
+Sampling profiler of hot pages and rw-lock waits
+
+Created 2013-06-20
+*******************************************************/
+
+#include "sync0prof.h"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "srv0srv.h"
+#include "ut0rnd.h"
+
+/** Number of slots probed for a key in the profiler tables */
+#define SYNC_PROF_PROBES	8
+
+/** Number of sampling counters; the counter of a thread is chosen by
+hashing its id */
+#define SYNC_PROF_N_COUNTERS	64
+
+/** Number of ulint in a sampling counter, so that each counter has
+a cache line of its own */
+#define SYNC_PROF_COUNTER_PAD	(64 / sizeof(ulint))
+
+/** Sampling counters of the page latch acquisitions. They are updated
+without synchronization: a lost update only shifts the sampling. */
+static ulint		sync_prof_counters[SYNC_PROF_N_COUNTERS
+					   * SYNC_PROF_COUNTER_PAD];
+
+/** Mutex protecting sync_prof_pages[] and sync_prof_rw_waits[] */
+static os_fast_mutex_t	sync_prof_mutex;
+
+/** Pages tracked by the profiler */
+static sync_prof_page_t	sync_prof_pages[SYNC_PROF_N_PAGES];
+
+/** rw-lock wait sites tracked by the profiler */
+static sync_prof_rw_t	sync_prof_rw_waits[SYNC_PROF_N_RW];
+
+/******************************************************************//**
+Initializes the profiler. */
+UNIV_INTERN
+void
+sync_prof_init(void)
+/*================*/
+{
+	os_fast_mutex_init(&sync_prof_mutex);
+
+	sync_prof_reset();
+}
+
+/******************************************************************//**
+Frees the profiler. */
+UNIV_INTERN
+void
+sync_prof_free(void)
+/*================*/
+{
+	os_fast_mutex_free(&sync_prof_mutex);
+}
+
+/******************************************************************//**
+Discards everything that the profiler has recorded. */
+UNIV_INTERN
+void
+sync_prof_reset(void)
+/*=================*/
+{
+	os_fast_mutex_lock(&sync_prof_mutex);
+
+	memset(sync_prof_pages, 0, sizeof sync_prof_pages);
+	memset(sync_prof_rw_waits, 0, sizeof sync_prof_rw_waits);
+
+	os_fast_mutex_unlock(&sync_prof_mutex);
+}
+
+/******************************************************************//**
+Decides if the latch acquisition of the calling thread is sampled. Must
+only be called when srv_latch_profile is nonzero.
+@return	TRUE if the latch acquisition should be recorded */
+UNIV_INTERN
+ibool
+sync_prof_sample(void)
+/*==================*/
+{
+	ulint	interval	= srv_latch_profile;
+	ulint*	counter;
+
+	counter = &sync_prof_counters[
+		ut_hash_ulint(os_thread_pf(os_thread_get_curr_id()),
+			      SYNC_PROF_N_COUNTERS)
+		* SYNC_PROF_COUNTER_PAD];
+
+	return(interval && ++*counter % interval == 0);
+}
+
+/******************************************************************//**
+Records a sampled page latch acquisition. */
+UNIV_INTERN
+void
+sync_prof_page_access(
+/*==================*/
+	ulint		space,		/*!< in: tablespace id */
+	ulint		page_no,	/*!< in: page number */
+	ulint		page_type,	/*!< in: FIL_PAGE_TYPE */
+	index_id_t	index_id,	/*!< in: index id, or 0 */
+	ulint		level,		/*!< in: B-tree level, or 0 */
+	ullint		wait_us)	/*!< in: microseconds spent
+					acquiring the latch */
+{
+	ulint			slot;
+	ulint			i;
+	sync_prof_page_t*	entry;
+	sync_prof_page_t*	coldest	= NULL;
+
+	slot = ut_hash_ulint(ut_fold_ulint_pair(space, page_no),
+			     SYNC_PROF_N_PAGES);
+
+	os_fast_mutex_lock(&sync_prof_mutex);
+
+	for (i = 0; i < SYNC_PROF_PROBES; i++) {
+		entry = &sync_prof_pages[(slot + i) % SYNC_PROF_N_PAGES];
+
+		if (entry->n_accesses
+		    && entry->space == space && entry->page_no == page_no) {
+
+			goto found;
+		}
+
+		if (!coldest || entry->n_accesses < coldest->n_accesses) {
+			coldest = entry;
+		}
+	}
+
+	/* Replace an unused or the least accessed entry. */
+
+	entry = coldest;
+	entry->space = space;
+	entry->page_no = page_no;
+	entry->n_accesses = 0;
+	entry->wait_us = 0;
+found:
+	/* An index page may have been freed and reused meanwhile. */
+	entry->page_type = page_type;
+	entry->index_id = index_id;
+	entry->level = level;
+	entry->n_accesses++;
+	entry->wait_us += wait_us;
+
+	os_fast_mutex_unlock(&sync_prof_mutex);
+}
+
+/******************************************************************//**
+Records an OS wait for an rw-lock. */
+UNIV_INTERN
+void
+sync_prof_rw_wait(
+/*==============*/
+	const rw_lock_t*	lock,		/*!< in: rw-lock */
+	ulint			lock_type,	/*!< in: RW_LOCK_SHARED,
+						RW_LOCK_EX or
+						RW_LOCK_WAIT_EX */
+	const char*		file_name,	/*!< in: file where the
+						lock was requested */
+	ulint			line,		/*!< in: line where the
+						lock was requested */
+	ullint			wait_us)	/*!< in: microseconds
+						spent waiting */
+{
+	const char*	lock_name	= lock->lock_name;
+	ulint		slot;
+	ulint		i;
+	sync_prof_rw_t*	entry;
+	sync_prof_rw_t*	coldest		= NULL;
+
+	/* The names are string literals, which can be compared
+	by address. */
+
+	slot = ut_hash_ulint(ut_fold_ulint_pair((ulint) lock_name,
+						ut_fold_ulint_pair(
+							(ulint) file_name,
+							line)),
+			     SYNC_PROF_N_RW);
+
+	os_fast_mutex_lock(&sync_prof_mutex);
+
+	for (i = 0; i < SYNC_PROF_PROBES; i++) {
+		entry = &sync_prof_rw_waits[(slot + i) % SYNC_PROF_N_RW];
+
+		if (entry->lock_name == lock_name
+		    && entry->file_name == file_name
+		    && entry->line == line) {
+
+			goto found;
+		}
+
+		if (!coldest
+		    || (entry->n_s_waits + entry->n_x_waits
+			< coldest->n_s_waits + coldest->n_x_waits)) {
+			coldest = entry;
+		}
+	}
+
+	/* Replace an unused or the least waited for entry. */
+
+	entry = coldest;
+	entry->lock_name = lock_name;
+	entry->file_name = file_name;
+	entry->line = line;
+	entry->n_s_waits = 0;
+	entry->n_x_waits = 0;
+	entry->wait_us = 0;
+found:
+	if (lock_type == RW_LOCK_SHARED) {
+		entry->n_s_waits++;
+	} else {
+		entry->n_x_waits++;
+	}
+
+	entry->wait_us += wait_us;
+
+	os_fast_mutex_unlock(&sync_prof_mutex);
+}
+
+/******************************************************************//**
+Copies the pages tracked by the profiler.
+@return	number of pages copied */
+UNIV_INTERN
+ulint
+sync_prof_get_pages(
+/*================*/
+	sync_prof_page_t*	pages)	/*!< out: SYNC_PROF_N_PAGES
+					entries */
+{
+	ulint	n	= 0;
+	ulint	i;
+
+	os_fast_mutex_lock(&sync_prof_mutex);
+
+	for (i = 0; i < SYNC_PROF_N_PAGES; i++) {
+		if (sync_prof_pages[i].n_accesses) {
+			pages[n++] = sync_prof_pages[i];
+		}
+	}
+
+	os_fast_mutex_unlock(&sync_prof_mutex);
+
+	return(n);
+}
+
+/******************************************************************//**
+Copies the rw-lock wait sites tracked by the profiler.
+@return	number of wait sites copied */
+UNIV_INTERN
+ulint
+sync_prof_get_rw_waits(
+/*===================*/
+	sync_prof_rw_t*		waits)	/*!< out: SYNC_PROF_N_RW
+					entries */
+{
+	ulint	n	= 0;
+	ulint	i;
+
+	os_fast_mutex_lock(&sync_prof_mutex);
+
+	for (i = 0; i < SYNC_PROF_N_RW; i++) {
+		if (sync_prof_rw_waits[i].lock_name) {
+			waits[n++] = sync_prof_rw_waits[i];
+		}
+	}
+
+	os_fast_mutex_unlock(&sync_prof_mutex);
+
+	return(n);
+}
@@ -40,6 +40,7 @@ Created 9/11/1995 Heikki Tuuri
 #include "srv0srv.h"
 #include "os0sync.h" /* for INNODB_RW_LOCKS_USE_ATOMICS */
 #include "ha_prototypes.h"
+#include "sync0prof.h"
 
 /*
 	IMPLEMENTATION OF THE RW_LOCK
@@ -366,6 +367,36 @@ rw_lock_validate(
 }
 #endif /* UNIV_DEBUG */
 
+/******************************************************************//**
+Suspends the thread in the wait array cell reserved for an rw-lock, and
+records the wait in the latch profiler if it is enabled. */
+static
+void
+rw_lock_wait_event(
+/*===============*/
+	rw_lock_t*	lock,	/*!< in: rw-lock */
+	ulint		lock_type,/*!< in: RW_LOCK_SHARED, RW_LOCK_EX
+				or RW_LOCK_WAIT_EX */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line,	/*!< in: line where requested */
+	ulint		index)	/*!< in: reserved wait array cell */
+{
+	ullint	start_us;
+
+	if (UNIV_LIKELY(!srv_latch_profile)) {
+		sync_array_wait_event(sync_primary_wait_array, index);
+
+		return;
+	}
+
+	start_us = ut_time_us(NULL);
+
+	sync_array_wait_event(sync_primary_wait_array, index);
+
+	sync_prof_rw_wait(lock, lock_type, file_name, line,
+			  ut_time_us(NULL) - start_us);
+}
+
 /******************************************************************//**
 Lock an rw-lock in shared mode for the current thread. If the rw-lock is
 locked in exclusive mode, or there is an exclusive lock request waiting,
@@ -450,7 +481,8 @@ lock_loop:
 		lock->count_os_wait++;
 		rw_s_os_wait_count++;
 
-		sync_array_wait_event(sync_primary_wait_array, index);
+		rw_lock_wait_event(lock, RW_LOCK_SHARED, file_name, line,
+				   index);
 
 		i = 0;
 		goto lock_loop;
@@ -529,8 +561,8 @@ rw_lock_x_lock_wait(
 					       file_name, line);
 #endif
 
-			sync_array_wait_event(sync_primary_wait_array,
-					      index);
+			rw_lock_wait_event(lock, RW_LOCK_WAIT_EX,
+					   file_name, line, index);
 #ifdef UNIV_SYNC_DEBUG
 			rw_lock_remove_debug_info(lock, pass,
 					       RW_LOCK_WAIT_EX);
@@ -697,7 +729,7 @@ lock_loop:
 	lock->count_os_wait++;
 	rw_x_os_wait_count++;
 
-	sync_array_wait_event(sync_primary_wait_array, index);
+	rw_lock_wait_event(lock, RW_LOCK_EX, file_name, line, index);
 
 	i = 0;
 	goto lock_loop;
@@ -36,6 +36,7 @@ Created 9/5/1995 Heikki Tuuri
 #endif
 
 #include "sync0rw.h"
+#include "sync0prof.h"
 #include "buf0buf.h"
 #include "srv0srv.h"
 #include "buf0types.h"
@@ -1515,6 +1516,8 @@ sync_init(void)
 	rw_lock_debug_event = os_event_create(NULL);
 	rw_lock_debug_waiters = FALSE;
 #endif /* UNIV_SYNC_DEBUG */
+
+	sync_prof_init();
 }
 
 #ifdef UNIV_SYNC_DEBUG
@@ -1557,6 +1560,8 @@ sync_close(void)
 
 	sync_array_free(sync_primary_wait_array);
 
+	sync_prof_free();
+
 	for (mutex = UT_LIST_GET_FIRST(mutex_list);
 	     mutex != NULL;
 	     /* No op */) {
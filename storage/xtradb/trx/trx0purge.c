@@ -43,6 +43,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0rec.h"
 #include "srv0srv.h"
 #include "os0thread.h"
+#include "srv0start.h"
 
 /** The global data structure coordinating a purge */
 UNIV_INTERN trx_purge_t*	purge_sys = NULL;
@@ -195,8 +196,9 @@ this query graph.
 @return	own: the query graph */
 static
 que_t*
-trx_purge_graph_build(void)
-/*=======================*/
+trx_purge_graph_build(
+/*==================*/
+	trx_t*	trx)	/*!< in: purge transaction running the graph */
 {
 	mem_heap_t*	heap;
 	que_fork_t*	fork;
@@ -205,7 +207,7 @@ trx_purge_graph_build(void)
 
 	heap = mem_heap_create(512);
 	fork = que_fork_create(NULL, NULL, QUE_FORK_PURGE, heap);
-	fork->trx = purge_sys->trx;
+	fork->trx = trx;
 
 	thr = que_thr_create(fork, heap);
 
@@ -218,6 +220,20 @@ trx_purge_graph_build(void)
 	return(fork);
 }
 
+/****************************************************************//**
+Gets the purge node of a purge query graph.
+@return	purge node */
+static
+purge_node_t*
+trx_purge_graph_get_node(
+/*=====================*/
+	que_t*	query)	/*!< in: purge query graph */
+{
+	que_thr_t*	thr = UT_LIST_GET_FIRST(query->thrs);
+
+	return((purge_node_t*) thr->child);
+}
+
 /********************************************************************//**
 Creates the global purge system control structure and inits the history
 mutex. */
@@ -261,7 +277,37 @@ trx_purge_sys_create(
 
 	ut_a(trx_start_low(purge_sys->trx, ULINT_UNDEFINED));
 
-	purge_sys->query = trx_purge_graph_build();
+	purge_sys->query = trx_purge_graph_build(purge_sys->trx);
+
+	/* The purge thread coordinates srv_n_purge_threads - 1 worker
+	threads, each running its own query graph. */
+	purge_sys->n_workers = srv_n_purge_threads > 1
+		? srv_n_purge_threads - 1 : 0;
+
+	if (purge_sys->n_workers > 0) {
+		ulint	i;
+
+		purge_sys->workers = mem_zalloc(
+			purge_sys->n_workers * sizeof *purge_sys->workers);
+
+		for (i = 0; i < purge_sys->n_workers; i++) {
+			trx_purge_worker_t*	worker
+				= &purge_sys->workers[i];
+
+			worker->sess = sess_open();
+			worker->sess->trx->is_purge = 1;
+
+			ut_a(trx_start_low(worker->sess->trx,
+					   ULINT_UNDEFINED));
+
+			worker->query = trx_purge_graph_build(
+				worker->sess->trx);
+			worker->event = os_event_create(NULL);
+		}
+
+		os_fast_mutex_init(&purge_sys->workers_mutex);
+		purge_sys->workers_done = os_event_create(NULL);
+	}
 
 	purge_sys->prebuilt_view =
 		read_view_oldest_copy_or_open_new(0, NULL);
@@ -289,6 +335,27 @@ trx_purge_sys_close(void)
 	sess_close(purge_sys->sess);
 	purge_sys->sess = NULL;
 
+	if (purge_sys->n_workers > 0) {
+		ulint	i;
+
+		for (i = 0; i < purge_sys->n_workers; i++) {
+			trx_purge_worker_t*	worker
+				= &purge_sys->workers[i];
+
+			que_graph_free(worker->query);
+
+			worker->sess->trx->state = TRX_NOT_STARTED;
+			sess_close(worker->sess);
+
+			os_event_free(worker->event);
+		}
+
+		os_fast_mutex_free(&purge_sys->workers_mutex);
+		os_event_free(purge_sys->workers_done);
+
+		mem_free(purge_sys->workers);
+	}
+
 	if (purge_sys->view != NULL) {
 		/* Because acquiring the kernel mutex is a pre-condition
 		of read_view_close(). We don't really need it here. */
@@ -1136,6 +1203,247 @@ trx_purge_rec_release(
 	trx_purge_arr_remove_info(cell);
 }
 
+/*******************************************************************//**
+Runs a purge query graph until its purge node has no more records. */
+static
+void
+trx_purge_run_graph(
+/*================*/
+	que_t*	query)	/*!< in: purge query graph */
+{
+	que_thr_t*	thr;
+
+	mutex_enter(&kernel_mutex);
+
+	thr = que_fork_start_command(query);
+
+	ut_ad(thr);
+
+	mutex_exit(&kernel_mutex);
+
+	que_run_threads(thr);
+}
+
+/*******************************************************************//**
+Fetches the undo log records of a purge batch and attaches them to the
+purge nodes of the coordinator and the workers. All records of a table
+go to the same node, so that the workers do not contend on the same
+index pages and do not process the history of one row out of order.
+
+The purge array has only UNIV_MAX_PARALLELISM cells, fewer than the
+records of a batch. Only the reservation of the first record is kept
+until the batch is done: it is enough to stop the history from being
+truncated, because the coordinator is the only thread that fetches
+records and truncates the history. */
+static
+void
+trx_purge_attach_undo_recs(
+/*=======================*/
+	purge_node_t**		nodes,	/*!< in/out: purge nodes */
+	trx_purge_rec_t**	heads,	/*!< out: first record attached
+					to each node */
+	ulint			n_nodes)/*!< in: number of nodes */
+{
+	trx_purge_rec_t***	tails;
+	trx_undo_inf_t*		batch_cell = NULL;
+	ulint			i;
+
+	tails = mem_heap_alloc(purge_sys->heap, n_nodes * sizeof *tails);
+
+	for (i = 0; i < n_nodes; i++) {
+		heads[i] = NULL;
+		tails[i] = &heads[i];
+	}
+
+	for (;;) {
+		trx_purge_rec_t*	rec;
+		trx_undo_rec_t*		undo_rec;
+		roll_ptr_t		roll_ptr;
+		trx_undo_inf_t*		cell;
+
+		undo_rec = trx_purge_fetch_next_rec(&roll_ptr, &cell,
+						    purge_sys->heap);
+
+		if (undo_rec == NULL) {
+			break;
+		}
+
+		if (batch_cell == NULL) {
+			batch_cell = cell;
+		} else {
+			trx_purge_rec_release(cell);
+			cell = NULL;
+		}
+
+		if (undo_rec == &trx_purge_dummy_rec) {
+			i = 0;
+		} else {
+			ulint		type;
+			ulint		cmpl_info;
+			ibool		updated_extern;
+			undo_no_t	undo_no;
+			table_id_t	table_id;
+
+			trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info,
+					      &updated_extern, &undo_no,
+					      &table_id);
+
+			i = (ulint) (table_id % n_nodes);
+		}
+
+		rec = mem_heap_alloc(purge_sys->heap, sizeof *rec);
+
+		rec->undo_rec = undo_rec;
+		rec->roll_ptr = roll_ptr;
+		rec->reservation = cell;
+		rec->next = NULL;
+
+		*tails[i] = rec;
+		tails[i] = &rec->next;
+	}
+
+	for (i = 0; i < n_nodes; i++) {
+		nodes[i]->batch = TRUE;
+		nodes[i]->recs = heads[i];
+	}
+}
+
+/*******************************************************************//**
+Runs a purge batch with the purge worker threads. The calling thread,
+the purge coordinator, fetches the undo log records and partitions them
+between itself and the workers by table. Once all of them are purged,
+the coordinator releases the records and truncates the history. */
+static
+void
+trx_purge_run_batch(void)
+/*=====================*/
+{
+	ulint			n_nodes = purge_sys->n_workers + 1;
+	purge_node_t**		nodes;
+	trx_purge_rec_t**	heads;
+	ulint			n_started = 0;
+	ulint			i;
+
+	nodes = mem_heap_alloc(purge_sys->heap, n_nodes * sizeof *nodes);
+	heads = mem_heap_alloc(purge_sys->heap, n_nodes * sizeof *heads);
+
+	nodes[0] = trx_purge_graph_get_node(purge_sys->query);
+
+	for (i = 1; i < n_nodes; i++) {
+		nodes[i] = trx_purge_graph_get_node(
+			purge_sys->workers[i - 1].query);
+	}
+
+	trx_purge_attach_undo_recs(nodes, heads, n_nodes);
+
+	if (srv_print_thread_releases) {
+
+		fputs("Starting purge\n", stderr);
+	}
+
+	/* Hand the non-empty batches to the workers */
+
+	os_fast_mutex_lock(&purge_sys->workers_mutex);
+
+	os_event_reset(purge_sys->workers_done);
+
+	for (i = 1; i < n_nodes; i++) {
+		if (heads[i] != NULL) {
+			purge_sys->workers[i - 1].pending = TRUE;
+			n_started++;
+		}
+	}
+
+	purge_sys->n_running = n_started;
+
+	os_fast_mutex_unlock(&purge_sys->workers_mutex);
+
+	for (i = 1; i < n_nodes; i++) {
+		if (heads[i] != NULL) {
+			os_event_set(purge_sys->workers[i - 1].event);
+		}
+	}
+
+	if (heads[0] != NULL) {
+		trx_purge_run_graph(purge_sys->query);
+	}
+
+	if (n_started > 0) {
+		os_event_wait(purge_sys->workers_done);
+	}
+
+	/* Release the reservation only now, so that the history is not
+	truncated past any record that is still being purged. */
+
+	for (i = 0; i < n_nodes; i++) {
+		trx_purge_rec_t*	rec;
+
+		for (rec = heads[i]; rec != NULL; rec = rec->next) {
+			if (rec->reservation != NULL) {
+				trx_purge_rec_release(rec->reservation);
+			}
+		}
+	}
+
+	trx_purge_truncate_if_arr_empty();
+}
+
+/*******************************************************************//**
+Waits for the purge coordinator to attach undo log records to a purge
+worker and purges them.
+@return	FALSE if the worker thread should exit */
+UNIV_INTERN
+ibool
+trx_purge_worker_run(
+/*=================*/
+	ulint	id)		/*!< in: worker number,
+				0..purge_sys->n_workers - 1 */
+{
+	trx_purge_worker_t*	worker = &purge_sys->workers[id];
+	ibool			pending;
+
+	os_event_wait(worker->event);
+	os_event_reset(worker->event);
+
+	os_fast_mutex_lock(&purge_sys->workers_mutex);
+	pending = worker->pending;
+	os_fast_mutex_unlock(&purge_sys->workers_mutex);
+
+	if (pending) {
+		trx_purge_run_graph(worker->query);
+
+		os_fast_mutex_lock(&purge_sys->workers_mutex);
+
+		worker->pending = FALSE;
+
+		if (--purge_sys->n_running == 0) {
+			os_event_set(purge_sys->workers_done);
+		}
+
+		os_fast_mutex_unlock(&purge_sys->workers_mutex);
+	}
+
+	return(srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS);
+}
+
+/*******************************************************************//**
+Wakes up the purge worker threads so that they exit at shutdown. */
+UNIV_INTERN
+void
+trx_purge_wake_workers(void)
+/*========================*/
+{
+	ulint	i;
+
+	if (purge_sys == NULL) {
+		return;
+	}
+
+	for (i = 0; i < purge_sys->n_workers; i++) {
+		os_event_set(purge_sys->workers[i].event);
+	}
+}
+
 /*******************************************************************//**
 This function runs a purge batch.
 @return	number of undo log pages handled in the batch */
@@ -1203,6 +1511,12 @@ trx_purge(
 
 	old_pages_handled = purge_sys->n_pages_handled;
 
+	if (purge_sys->n_workers > 0) {
+		trx_purge_run_batch();
+
+		return((ulint) (purge_sys->n_pages_handled
+				- old_pages_handled));
+	}
 
 	mutex_enter(&kernel_mutex);
 
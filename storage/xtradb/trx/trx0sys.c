@@ -187,6 +187,10 @@ trx_doublewrite_init(
 	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
 				header on trx sys page */
 {
+	ulint	n_shards;
+	ulint	n_slots;
+	ulint	i;
+
 	trx_doublewrite = mem_alloc(sizeof(trx_doublewrite_t));
 
 	/* Since we now start to use the doublewrite buffer, no need to call
@@ -195,11 +199,6 @@ trx_doublewrite_init(
 	os_do_not_call_flush_at_each_write = TRUE;
 #endif /* UNIV_DO_FLUSH */
 
-	mutex_create(trx_doublewrite_mutex_key,
-		     &trx_doublewrite->mutex, SYNC_DOUBLEWRITE);
-
-	trx_doublewrite->first_free = 0;
-
 	trx_doublewrite->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
 	trx_doublewrite->block2 = mach_read_from_4(
@@ -211,6 +210,35 @@ trx_doublewrite_init(
 		trx_doublewrite->write_buf_unaligned, UNIV_PAGE_SIZE);
 	trx_doublewrite->buf_block_arr = mem_alloc(
 		2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * sizeof(void*));
+
+	/* Split the slots into shards, so that the flushes of different
+	buffer pool instances do not serialize on a single batch. The
+	on-disk layout is unchanged: recovery scans all the slots. */
+
+	n_shards = ut_min(srv_doublewrite_shards,
+			  2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
+	n_shards = ut_max(n_shards, 1);
+	n_slots = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE / n_shards;
+
+	trx_doublewrite->n_shards = n_shards;
+	trx_doublewrite->shards = mem_alloc(
+		n_shards * sizeof(trx_doublewrite_shard_t));
+
+	for (i = 0; i < n_shards; i++) {
+		trx_doublewrite_shard_t*	shard
+			= &trx_doublewrite->shards[i];
+
+		mutex_create(trx_doublewrite_mutex_key,
+			     &shard->mutex, SYNC_DOUBLEWRITE);
+
+		shard->first_slot = i * n_slots;
+		shard->n_slots = n_slots;
+		shard->first_free = 0;
+		shard->write_buf = trx_doublewrite->write_buf
+			+ shard->first_slot * UNIV_PAGE_SIZE;
+		shard->buf_block_arr = trx_doublewrite->buf_block_arr
+			+ shard->first_slot;
+	}
 }
 
 /****************************************************************//**
@@ -1966,6 +1994,7 @@ trx_sys_close(void)
 	trx_t*		trx;
 	trx_rseg_t*	rseg;
 	read_view_t*	view;
+	ulint		i;
 
 	ut_ad(trx_sys != NULL);
 	ut_ad(srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS);
@@ -1996,7 +2025,12 @@ trx_sys_close(void)
 	mem_free(trx_doublewrite->buf_block_arr);
 	trx_doublewrite->buf_block_arr = NULL;
 
-	mutex_free(&trx_doublewrite->mutex);
+	for (i = 0; i < trx_doublewrite->n_shards; i++) {
+		mutex_free(&trx_doublewrite->shards[i].mutex);
+	}
+
+	mem_free(trx_doublewrite->shards);
+	trx_doublewrite->shards = NULL;
 	mem_free(trx_doublewrite);
 	trx_doublewrite = NULL;
 
@@ -19029,6 +19029,397 @@ static void test_mdev4326()
   myquery(rc);
 }
 
+/* Queries sent with mysql_send_queries() */
+
+static void test_send_queries()
+{
+  const char *queries[]= {
+    "INSERT INTO t1 VALUES (1), (2), (3)",
+    "SELECT COUNT(*) FROM t1",
+    "SELEC 1",
+    "UPDATE t1 SET a= a + 10 WHERE a > 1",
+    "SELECT a FROM t1 ORDER BY a"
+  };
+  unsigned long lengths[5];
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  int rc, i;
+  myheader("test_send_queries");
+
+  for (i= 0; i < 5; i++)
+    lengths[i]= strlen(queries[i]);
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT)");
+  myquery(rc);
+
+  rc= mysql_send_queries(mysql, queries, lengths, 5);
+  myquery(rc);
+
+  /* No other command until all results are read */
+  rc= mysql_query(mysql, "SELECT 1");
+  DIE_UNLESS(rc && mysql_errno(mysql) == CR_COMMANDS_OUT_OF_SYNC);
+
+  rc= mysql_read_query_result(mysql);
+  myquery(rc);
+  DIE_UNLESS(mysql_affected_rows(mysql) == 3);
+
+  rc= mysql_read_query_result(mysql);
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(row && !strcmp(row[0], "3"));
+  mysql_free_result(result);
+
+  /* An error does not stop the following queries */
+  rc= mysql_read_query_result(mysql);
+  DIE_UNLESS(rc && mysql_errno(mysql) == ER_PARSE_ERROR);
+
+  rc= mysql_read_query_result(mysql);
+  myquery(rc);
+  DIE_UNLESS(mysql_affected_rows(mysql) == 2);
+
+  rc= mysql_read_query_result(mysql);
+  myquery(rc);
+  result= mysql_use_result(mysql);
+  mytest(result);
+  rc= my_process_result_set(result);
+  DIE_UNLESS(rc == 3);
+  mysql_free_result(result);
+
+  /*
+    More query text than is sent ahead at once: the rest is sent while
+    the results are read
+  */
+  {
+    char long_query[1024];
+    const char *long_queries[20];
+    unsigned long long_lengths[20];
+    size_t length;
+
+    strmov(long_query, "INSERT INTO t1 SELECT a + 100 FROM t1 WHERE a < 0 -- ");
+    length= strlen(long_query);
+    memset(long_query + length, 'x', sizeof(long_query) - length - 1);
+    long_query[sizeof(long_query) - 1]= 0;
+    for (i= 0; i < 20; i++)
+    {
+      long_queries[i]= long_query;
+      long_lengths[i]= sizeof(long_query) - 1;
+    }
+    long_queries[19]= "SELECT COUNT(*) FROM t1";
+    long_lengths[19]= strlen(long_queries[19]);
+
+    rc= mysql_send_queries(mysql, long_queries, long_lengths, 20);
+    myquery(rc);
+    for (i= 0; i < 19; i++)
+    {
+      rc= mysql_read_query_result(mysql);
+      myquery(rc);
+      DIE_UNLESS(mysql_affected_rows(mysql) == 0);
+    }
+    rc= mysql_read_query_result(mysql);
+    myquery(rc);
+    result= mysql_store_result(mysql);
+    mytest(result);
+    row= mysql_fetch_row(result);
+    DIE_UNLESS(row && !strcmp(row[0], "3"));
+    mysql_free_result(result);
+  }
+
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
+
+
+static void test_stmt_array_binding()
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[2];
+  MYSQL_RES  *result;
+  MYSQL_ROW  row;
+  int32      ids[3]= { 1, 2, 3 };
+  char       names[3][10]= { "one", "", "three" };
+  ulong      lengths[3]= { 3, 0, 5 };
+  my_bool    is_null[3]= { 0, 1, 0 };
+  ulong      array_size= 3;
+  int        rc;
+  myheader("test_stmt_array_binding");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT, b VARCHAR(10))");
+  myquery(rc);
+
+  stmt= mysql_simple_prepare(mysql, "INSERT INTO t1 VALUES (?, ?)");
+  check_stmt(stmt);
+
+  bzero((char*) my_bind, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void *) ids;
+  my_bind[1].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[1].buffer= (void *) names;
+  my_bind[1].buffer_length= sizeof(names[0]);
+  my_bind[1].length= lengths;
+  my_bind[1].is_null= is_null;
+
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+
+  /* Three rows with one execute */
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 3);
+  mysql_stmt_close(stmt);
+
+  /* Statements other than INSERT are executed once per row */
+  stmt= mysql_simple_prepare(mysql, "UPDATE t1 SET a= a + 10 WHERE b <=> ?");
+  check_stmt(stmt);
+  rc= mysql_stmt_bind_param(stmt, my_bind + 1);
+  check_execute(stmt, rc);
+  array_size= 2;
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 2);
+  mysql_stmt_close(stmt);
+
+  /* Only one result set can be read */
+  stmt= mysql_simple_prepare(mysql, "SELECT a FROM t1 WHERE a = ?");
+  check_stmt(stmt);
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  DIE_UNLESS(rc && mysql_stmt_errno(stmt) == ER_UNSUPPORTED_PS);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "SELECT a, b FROM t1 ORDER BY a");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  DIE_UNLESS(mysql_num_rows(result) == 3);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(!strcmp(row[0], "3") && !strcmp(row[1], "three"));
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(!strcmp(row[0], "11") && !strcmp(row[1], "one"));
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(!strcmp(row[0], "12") && row[1] == NULL);
+  mysql_free_result(result);
+
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
+
+
+/*
+  Array binding with the general and slow logs off (and no binary log),
+  so that INSERT runs once for all parameter rows and reads them with
+  bulk_parameters_set(). Other statements still run once per row.
+*/
+
+static void test_stmt_array_binding_no_log()
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[2];
+  MYSQL_RES  *result;
+  MYSQL_ROW  row;
+  int32      ids[3]= { 1, 2, 3 };
+  char       names[3][10]= { "one", "", "three" };
+  ulong      lengths[3]= { 3, 0, 5 };
+  my_bool    is_null[3]= { 0, 1, 0 };
+  ulong      array_size= 3;
+  int        rc, i;
+  myheader("test_stmt_array_binding_no_log");
+
+  rc= mysql_query(mysql, "set @save_global_general_log=@@global.general_log");
+  myquery(rc);
+  rc= mysql_query(mysql, "set @save_global_slow_query_log=@@global.slow_query_log");
+  myquery(rc);
+  disable_query_logs();
+  rc= mysql_query(mysql, "set @save_sql_mode=@@sql_mode, sql_mode=''");
+  myquery(rc);
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT, b VARCHAR(3))");
+  myquery(rc);
+
+  /* Prepared after the logs are off, so the query is not expanded */
+  stmt= mysql_simple_prepare(mysql, "INSERT INTO t1 VALUES (?, ?)");
+  check_stmt(stmt);
+
+  bzero((char*) my_bind, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void *) ids;
+  my_bind[1].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[1].buffer= (void *) names;
+  my_bind[1].buffer_length= sizeof(names[0]);
+  my_bind[1].length= lengths;
+  my_bind[1].is_null= is_null;
+
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+
+  /*
+    'three' is truncated. The warnings of one execute don't carry over
+    to the next one.
+  */
+  for (i= 0; i < 2; i++)
+  {
+    rc= mysql_stmt_execute(stmt);
+    check_execute(stmt, rc);
+    DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 3);
+    DIE_UNLESS(mysql_warning_count(mysql) == 1);
+  }
+
+  /* The rows are counted as the rows of a multi-row INSERT */
+  rc= mysql_query(mysql, "SHOW WARNINGS");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  DIE_UNLESS(mysql_num_rows(result) == 1);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(!strcmp(row[1], "1265") &&
+             !strcmp(row[2], "Data truncated for column 'b' at row 3"));
+  mysql_free_result(result);
+  mysql_stmt_close(stmt);
+
+  /* UPDATE runs once per row; the warnings of all rows are counted */
+  stmt= mysql_simple_prepare(mysql, "UPDATE t1 SET b= ? WHERE a = ?");
+  check_stmt(stmt);
+  my_bind[0].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[0].buffer= (void *) names;
+  my_bind[0].buffer_length= sizeof(names[0]);
+  my_bind[0].length= lengths;
+  my_bind[0].is_null= 0;
+  my_bind[1].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[1].buffer= (void *) ids;
+  my_bind[1].buffer_length= 0;
+  my_bind[1].length= 0;
+  my_bind[1].is_null= 0;
+  strmov(names[0], "uno12");
+  lengths[0]= 5;
+  strmov(names[1], "dos12");
+  lengths[1]= 5;
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  array_size= 2;
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 4);
+  DIE_UNLESS(mysql_warning_count(mysql) == 4);
+  /* The values don't change any more */
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 0);
+  DIE_UNLESS(mysql_warning_count(mysql) == 4);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "SELECT a, b FROM t1 ORDER BY a");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  DIE_UNLESS(mysql_num_rows(result) == 6);
+  for (i= 0; i < 6; i++)
+  {
+    static const char *values[3]= { "uno", "dos", "thr" };
+    row= mysql_fetch_row(result);
+    DIE_UNLESS(atoi(row[0]) == i / 2 + 1 && !strcmp(row[1], values[i / 2]));
+  }
+  mysql_free_result(result);
+
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "set sql_mode=@save_sql_mode");
+  myquery(rc);
+  restore_query_logs();
+}
+
+
+/*
+  A bulk INSERT with an expression over a parameter that is converted to
+  another charset: the conversion is done again for each row
+*/
+
+static void test_stmt_array_binding_charset()
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[2];
+  MYSQL_RES  *result;
+  MYSQL_ROW  row;
+  int32      ids[3]= { 1, 2, 3 };
+  char       names[3][10]= { "one", "two", "three" };
+  ulong      lengths[3]= { 3, 3, 5 };
+  ulong      array_size= 3;
+  int        rc, i;
+  myheader("test_stmt_array_binding_charset");
+
+  rc= mysql_query(mysql, "set @save_global_general_log=@@global.general_log");
+  myquery(rc);
+  rc= mysql_query(mysql, "set @save_global_slow_query_log=@@global.slow_query_log");
+  myquery(rc);
+  disable_query_logs();
+  rc= mysql_query(mysql, "set names latin1");
+  myquery(rc);
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql,
+                  "CREATE TABLE t1 (a INT, b VARCHAR(10) CHARACTER SET utf8)");
+  myquery(rc);
+
+  stmt= mysql_simple_prepare(mysql,
+                             "INSERT INTO t1 VALUES (?, CONCAT(?, _utf8'x'))");
+  check_stmt(stmt);
+
+  bzero((char*) my_bind, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void *) ids;
+  my_bind[1].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[1].buffer= (void *) names;
+  my_bind[1].buffer_length= sizeof(names[0]);
+  my_bind[1].length= lengths;
+
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 3);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "SELECT a, b FROM t1 ORDER BY a");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  DIE_UNLESS(mysql_num_rows(result) == 3);
+  for (i= 0; i < 3; i++)
+  {
+    static const char *values[3]= { "onex", "twox", "threex" };
+    row= mysql_fetch_row(result);
+    DIE_UNLESS(atoi(row[0]) == i + 1 && !strcmp(row[1], values[i]));
+  }
+  mysql_free_result(result);
+
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "set names default");
+  myquery(rc);
+  restore_query_logs();
+}
+
+
 static struct my_tests_st my_tests[]= {
   { "disable_query_logs", disable_query_logs },
   { "test_view_sp_list_fields", test_view_sp_list_fields },
@@ -19295,6 +19686,10 @@ static struct my_tests_st my_tests[]= {
   { "test_bug13001491", test_bug13001491 },
   { "test_mdev4326", test_mdev4326 },
   { "test_ps_sp_out_params", test_ps_sp_out_params },
+  { "test_send_queries", test_send_queries },
+  { "test_stmt_array_binding", test_stmt_array_binding },
+  { "test_stmt_array_binding_no_log", test_stmt_array_binding_no_log },
+  { "test_stmt_array_binding_charset", test_stmt_array_binding_charset },
   { 0, 0 }
 };
 
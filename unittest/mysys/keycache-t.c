@@ -0,0 +1,159 @@
+/* Copyright (c) 2013, Monty Program Ab
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the key cache with CLOCK replacement
+*/
+
+#include "thr_template.c"
+
+#include <keycache.h>
+
+#define BLOCK_SIZE 1024
+#define N_PAGES    64
+#define PAGE_INTS  (BLOCK_SIZE / sizeof(uint32))
+
+KEY_CACHE kc;
+File file;
+
+/* The content of a word of a page; 'gen' is changed by the writes */
+static uint32 page_word(uint page, uint i, uint gen)
+{
+  return (uint32) ((gen * N_PAGES + page) * PAGE_INTS + i);
+}
+
+static void fill_page(uint32 *buf, uint page, uint gen)
+{
+  uint i;
+  for (i= 0; i < PAGE_INTS; i++)
+    buf[i]= page_word(page, i, gen);
+}
+
+/* Check that a page read through the key cache has the given content */
+static int check_page(uint page, uint gen)
+{
+  uint32 buf[PAGE_INTS];
+  uint i;
+  if (!key_cache_read(&kc, file, (my_off_t) page * BLOCK_SIZE, 0,
+                      (uchar*) buf, BLOCK_SIZE, BLOCK_SIZE, 0))
+    return 0;
+  for (i= 0; i < PAGE_INTS; i++)
+    if (buf[i] != page_word(page, i, gen))
+      return 0;
+  return 1;
+}
+
+/* Check the content of a page in the file */
+static int check_file_page(uint page, uint gen)
+{
+  uint32 buf[PAGE_INTS];
+  uint i;
+  if (my_pread(file, (uchar*) buf, BLOCK_SIZE, (my_off_t) page * BLOCK_SIZE,
+               MYF(MY_NABP)))
+    return 0;
+  for (i= 0; i < PAGE_INTS; i++)
+    if (buf[i] != page_word(page, i, gen))
+      return 0;
+  return 1;
+}
+
+/*
+  reader - read random pages that do not fit all into the cache, and
+  check their content
+*/
+pthread_handler_t test_readers(void *arg)
+{
+  int m= *(int *)arg;
+  uint32 seed= (uint32) (size_t) &m;
+
+  my_thread_init();
+  for (; m ; m--)
+  {
+    seed= seed * 1103515245 + 12345;
+    if (!check_page((seed >> 16) % N_PAGES, 0))
+      my_atomic_add32((int32 volatile*) &bad, 1);
+  }
+  pthread_mutex_lock(&mutex);
+  if (!--running_threads) pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  my_thread_end();
+  return 0;
+}
+
+void do_tests()
+{
+  char path[FN_REFLEN];
+  uint32 buf[PAGE_INTS];
+  uint page, all_ok;
+  KEY_CACHE_STATISTICS stats;
+
+  plan(9);
+
+  file= create_temp_file(path, NULL, "kc", O_RDWR | O_BINARY,
+                         MYF(MY_WME));
+  if (file < 0)
+    BAIL_OUT("could not create a temporary file");
+  for (page= 0; page < N_PAGES; page++)
+  {
+    fill_page(buf, page, 0);
+    if (my_write(file, (uchar*) buf, BLOCK_SIZE, MYF(MY_NABP)))
+      BAIL_OUT("could not write to the temporary file");
+  }
+
+  /* A cache of 16 blocks */
+  kc.param_clock_replacement= 1;
+  ok(init_key_cache(&kc, BLOCK_SIZE, 16 * (BLOCK_SIZE + 200), 100, 300,
+                    2) > 0 && kc.key_cache_type == CLOCK_KEY_CACHE &&
+     kc.partitions == 0, "init");
+
+  for (all_ok= 1, page= 0; page < 2 * N_PAGES; page++)
+    all_ok&= check_page(page % N_PAGES, 0) & check_page(page % N_PAGES, 0);
+  ok(all_ok, "read with eviction");
+
+  fill_page(buf, 3, 1);
+  key_cache_write(&kc, file, NULL, 3 * BLOCK_SIZE, 0, (uchar*) buf,
+                  BLOCK_SIZE, BLOCK_SIZE, 1);
+  ok(check_page(3, 1) && check_file_page(3, 0), "delayed write");
+  ok(!flush_key_blocks(&kc, file, NULL, FLUSH_KEEP) && check_file_page(3, 1),
+     "flush");
+
+  /* A partial write of a page that is not cached */
+  flush_key_blocks(&kc, file, NULL, FLUSH_RELEASE);
+  fill_page(buf, 3, 0);
+  key_cache_write(&kc, file, NULL, 3 * BLOCK_SIZE + 100, 0,
+                  (uchar*) buf + 100, BLOCK_SIZE - 100, BLOCK_SIZE, 1);
+  ok(!check_page(3, 1) && !check_page(3, 0), "partial write");
+  key_cache_write(&kc, file, NULL, 3 * BLOCK_SIZE, 0, (uchar*) buf, 100,
+                  BLOCK_SIZE, 1);
+  ok(check_page(3, 0) &&
+     !flush_key_blocks(&kc, file, NULL, FLUSH_RELEASE) &&
+     check_file_page(3, 0), "partial write and flush");
+
+  test_concurrently("readers", test_readers, THREADS, CYCLES);
+
+  ok(resize_key_cache(&kc, BLOCK_SIZE, 32 * (BLOCK_SIZE + 200), 100,
+                      300) > 0, "resize");
+  for (all_ok= 1, page= 0; page < N_PAGES; page++)
+    all_ok&= check_page(page, 0);
+  get_key_cache_statistics(&kc, 0, &stats);
+  ok(all_ok && stats.read_requests >= N_PAGES, "read after resize");
+
+  flush_key_blocks(&kc, file, NULL, FLUSH_RELEASE);
+  end_key_cache(&kc, 1);
+  my_close(file, MYF(0));
+  my_delete(path, MYF(0));
+}
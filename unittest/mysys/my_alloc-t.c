@@ -0,0 +1,59 @@
+/* Copyright (c) 2013, Monty Program Ab
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include "tap.h"
+
+#define BLOCK_SIZE 1024
+
+/* Allocate enough to need several blocks and return the number of them */
+static uint fill_root(MEM_ROOT *root)
+{
+  uint i;
+  for (i= 0; i < 16; i++)
+    if (!alloc_root(root, BLOCK_SIZE / 2))
+      return 0;
+  return root->block_num - 4;
+}
+
+int main(int argc __attribute__((unused)),char *argv[])
+{
+  MEM_ROOT root;
+  uint blocks;
+  MY_INIT(argv[0]);
+
+  plan(4);
+
+  init_alloc_root(&root, BLOCK_SIZE, BLOCK_SIZE);
+  blocks= fill_root(&root);
+  ok(blocks > 1 && my_thread_var->alloc_cache_hits == 0, "fill");
+
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  ok(my_thread_var->alloc_cache && my_thread_var->alloc_cache_size > 0,
+     "blocks kept in the cache");
+
+  ok(fill_root(&root) == blocks &&
+     my_thread_var->alloc_cache_hits == blocks &&
+     !my_thread_var->alloc_cache, "blocks reused");
+
+  free_root(&root, MYF(0));
+  free_alloc_cache(my_thread_var);
+  ok(!my_thread_var->alloc_cache && !my_thread_var->alloc_cache_size,
+     "cache freed");
+
+  my_end(0);
+  return exit_status();
+}
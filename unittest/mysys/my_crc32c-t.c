@@ -0,0 +1,71 @@
+/* Copyright (c) 2013, Monty Program Ab
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <tap.h>
+
+#define BUF_SIZE 1000
+#define SPLIT_LOOP_COUNT 100
+
+int
+main(int argc __attribute__((unused)),char *argv[])
+{
+  uchar buf[BUF_SIZE + 8];
+  uint32 whole, parts;
+  size_t i, split, offset;
+  int ok_split= 1, ok_offset= 1;
+  MY_INIT(argv[0]);
+
+  plan(5);
+
+  diag("Using %s implementation",
+       my_crc32c_is_hw_accelerated() ? "SSE4.2" : "software");
+
+  /* Check values from RFC 3720, appendix B.4 */
+  ok(my_crc32c(0, (const uchar*) "123456789", 9) == 0xE3069283,
+     "crc32c of \"123456789\"");
+
+  memset(buf, 0, 32);
+  ok(my_crc32c(0, buf, 32) == 0x8A9136AA, "crc32c of 32 zero bytes");
+
+  memset(buf, 0xFF, 32);
+  ok(my_crc32c(0, buf, 32) == 0x62A8AB43, "crc32c of 32 0xFF bytes");
+
+  for (i= 0; i < sizeof(buf); i++)
+    buf[i]= (uchar) rand();
+
+  /* Checksumming in pieces must give the same result as in one go */
+  whole= my_crc32c(0, buf, BUF_SIZE);
+  for (i= 0; i < SPLIT_LOOP_COUNT; i++)
+  {
+    split= rand() % BUF_SIZE;
+    parts= my_crc32c(my_crc32c(0, buf, split), buf + split, BUF_SIZE - split);
+    if (parts != whole)
+      ok_split= 0;
+  }
+  ok(ok_split, "crc32c in two pieces");
+
+  /* The result must not depend on the alignment of the block */
+  for (offset= 1; offset < 8; offset++)
+  {
+    memmove(buf + offset, buf + offset - 1, BUF_SIZE);
+    if (my_crc32c(0, buf + offset, BUF_SIZE) != whole)
+      ok_offset= 0;
+  }
+  ok(ok_offset, "crc32c of unaligned blocks");
+
+  return exit_status();
+}
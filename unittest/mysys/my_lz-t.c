@@ -0,0 +1,161 @@
+/* Copyright (c) 2013, Monty Program Ab
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include <tap.h>
+
+#define BUF_SIZE 70000
+
+static uchar src[BUF_SIZE], comp[BUF_SIZE + BUF_SIZE / 255 + 16],
+             dst[BUF_SIZE];
+
+/* Compress and decompress len bytes of src, return 1 if they round trip */
+static int round_trip(size_t len, size_t *comp_len)
+{
+  size_t dst_len= sizeof(dst);
+  *comp_len= my_lz_compress(src, len, comp, sizeof(comp));
+  if (!*comp_len)
+    return 0;
+  if (my_lz_decompress(comp, *comp_len, dst, &dst_len))
+    return 0;
+  return dst_len == len && !memcmp(src, dst, len);
+}
+
+#define PIECE 100
+
+/*
+  Compress src in pieces of PIECE bytes as one stream, with the history
+  in src and dst shifted away when it grows over 1000 bytes.
+  Return 1 if the pieces round trip, and the total compressed length.
+*/
+static int stream_round_trip(size_t len, size_t *comp_len)
+{
+  MY_LZ_STREAM comp_stream, dec_stream;
+  uchar *comp_buf= src, *dec_buf= dst;
+  size_t pos, piece_len;
+  int res= 1;
+
+  if (my_lz_stream_init(&comp_stream))
+    return 0;
+  dec_stream.history= 0;
+  dec_stream.table= 0;
+  *comp_len= 0;
+  for (pos= 0; pos < len && res; pos+= PIECE)
+  {
+    size_t dst_len= PIECE;
+    if (comp_stream.history > 1000)
+    {
+      size_t shift= comp_stream.history - 500;
+      comp_buf+= shift;
+      dec_buf+= shift;
+      my_lz_stream_shift(&comp_stream, shift);
+      my_lz_stream_shift(&dec_stream, shift);
+    }
+    piece_len= my_lz_stream_compress(&comp_stream, comp_buf, PIECE,
+                                     comp, sizeof(comp));
+    *comp_len+= piece_len;
+    if (!piece_len ||
+        my_lz_stream_decompress(&dec_stream, comp, piece_len, dec_buf,
+                                &dst_len) ||
+        dst_len != PIECE)
+      res= 0;
+  }
+  my_lz_stream_end(&comp_stream);
+  return res && !memcmp(src, dst, len);
+}
+
+int
+main(int argc __attribute__((unused)),char *argv[])
+{
+  size_t i, comp_len, dst_len;
+  uint32 rnd= 1;
+  int ok_short= 1, res;
+  MY_INIT(argv[0]);
+
+  plan(10);
+
+  for (i= 0; i < 20; i++)
+  {
+    src[i]= (uchar) ('a' + i % 3);
+    if (!round_trip(i, &comp_len))
+      ok_short= 0;
+  }
+  ok(ok_short, "round trip of inputs shorter than 20 bytes");
+
+  for (i= 0; i < BUF_SIZE; i++)
+    src[i]= (uchar) "abcdefgh"[(i * 7 + i / 100) % 8];
+  res= round_trip(BUF_SIZE, &comp_len);
+  ok(res && comp_len < BUF_SIZE / 4,
+     "round trip of repetitive data, %lu to %lu bytes",
+     (ulong) BUF_SIZE, (ulong) comp_len);
+
+  bfill(src, BUF_SIZE, 'x');
+  res= round_trip(BUF_SIZE, &comp_len);
+  ok(res && comp_len < 400,
+     "round trip of a run of one byte, %lu to %lu bytes",
+     (ulong) BUF_SIZE, (ulong) comp_len);
+
+  for (i= 0; i < BUF_SIZE; i++)
+  {
+    rnd^= rnd << 13;
+    rnd^= rnd >> 17;
+    rnd^= rnd << 5;
+    src[i]= (uchar) rnd;
+  }
+  res= round_trip(BUF_SIZE, &comp_len);
+  ok(res,
+     "round trip of incompressible data, %lu to %lu bytes",
+     (ulong) BUF_SIZE, (ulong) comp_len);
+
+  ok(my_lz_compress(src, BUF_SIZE, comp, BUF_SIZE / 2) == 0,
+     "compress fails when the output does not fit");
+
+  bfill(src, BUF_SIZE, 'x');
+  comp_len= my_lz_compress(src, BUF_SIZE, comp, sizeof(comp));
+  dst_len= BUF_SIZE - 1;
+  ok(my_lz_decompress(comp, comp_len, dst, &dst_len),
+     "decompress fails when the output does not fit");
+
+  dst_len= sizeof(dst);
+  ok(my_lz_decompress(comp, comp_len - 1, dst, &dst_len),
+     "decompress fails on truncated input");
+
+  comp[2]= comp[3]= 0;
+  dst_len= sizeof(dst);
+  ok(my_lz_decompress(comp, comp_len, dst, &dst_len) ||
+     dst_len != BUF_SIZE,
+     "decompress detects a corrupted offset");
+
+  for (i= 0; i < 20 * PIECE; i++)
+    src[i]= (uchar) "abcdefghijklmnopq"[(i * 7 + i / PIECE) % 17];
+  bzero(dst, sizeof(dst));
+  res= stream_round_trip(20 * PIECE, &comp_len);
+  ok(res, "stream round trip, %lu to %lu bytes",
+     (ulong) 20 * PIECE, (ulong) comp_len);
+
+  for (i= 0, res= 0; i < 20; i++)
+  {
+    size_t piece_len= my_lz_compress(src + i * PIECE, PIECE, comp,
+                                     sizeof(comp));
+    res+= (int) (piece_len ? piece_len : PIECE);
+  }
+  ok((size_t) res > comp_len * 2,
+     "stream history helps, %lu bytes without it", (ulong) res);
+
+  my_end(0);
+  return exit_status();
+}
@@ -203,6 +203,28 @@ void vio_reset(Vio* vio, enum enum_vio_type type,
 }
 
 
+/*
+  Start reading a socket through a buffer, so that several small packets
+  sent by the peer are read with one system call. SSL must not be
+  started after this, as the buffer may already hold the start of the
+  SSL handshake.
+*/
+
+void vio_set_buffered_read(Vio *vio)
+{
+#ifdef HAVE_VIO_READ_BUFF
+  if ((vio->type == VIO_TYPE_TCPIP || vio->type == VIO_TYPE_SOCKET) &&
+      !vio->read_buffer &&
+      (vio->read_buffer= (char*) my_malloc(VIO_READ_BUFFER_SIZE, MYF(MY_WME))))
+  {
+    vio->read_pos= vio->read_end= vio->read_buffer;
+    vio->read= vio_read_buff;
+    vio->has_data= vio_buff_has_data;
+  }
+#endif
+}
+
+
 /* Open the socket or TCP/IP connection and read the fnctl() status */
 
 Vio *vio_new(my_socket sd, enum enum_vio_type type, uint flags)
@@ -168,6 +168,46 @@ size_t vio_write(Vio * vio, const uchar* buf, size_t size)
   DBUG_RETURN(r);
 }
 
+/*
+  Write data gathered from several buffers
+
+  Plain sockets write all buffers with one writev() call. Other
+  connection types, and sockets used by the non-blocking API, only
+  write the first non-empty buffer; like for vio_write(), the caller
+  has to continue with the rest.
+
+  Returns the number of bytes written or (size_t) -1 on error.
+*/
+
+size_t vio_writev(Vio *vio, const struct iovec *iov, int iovcnt)
+{
+  size_t r;
+  DBUG_ENTER("vio_writev");
+  DBUG_PRINT("enter", ("sd: %d  iovcnt: %d", vio->sd, iovcnt));
+
+  while (iovcnt > 1 && !iov->iov_len)
+  {
+    iov++;
+    iovcnt--;
+  }
+#ifndef __WIN__
+  if (iovcnt > 1 && !vio->async_context &&
+      (vio->type == VIO_TYPE_TCPIP || vio->type == VIO_TYPE_SOCKET))
+  {
+    r= writev(vio->sd, iov, iovcnt);
+#ifndef DBUG_OFF
+    if (r == (size_t) -1)
+    {
+      DBUG_PRINT("vio_error", ("Got error on writev: %d",socket_errno));
+    }
+#endif /* DBUG_OFF */
+    DBUG_PRINT("exit", ("%u", (uint) r));
+    DBUG_RETURN(r);
+  }
+#endif /* __WIN__ */
+  DBUG_RETURN(vio->write(vio, (const uchar*) iov->iov_base, iov->iov_len));
+}
+
 #ifdef _WIN32
 static void CALLBACK cancel_io_apc(ULONG_PTR data)
 {
@@ -784,6 +824,10 @@ my_bool vio_is_connected(Vio *vio)
   uint bytes= 0;
   DBUG_ENTER("vio_is_connected");
 
+  /* Data in the read buffer was sent by a connected peer */
+  if (vio->read_pos != vio->read_end)
+    DBUG_RETURN(TRUE);
+
   /* In the presence of errors the socket is assumed to be connected. */
 
   /*